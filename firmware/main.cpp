@@ -12,7 +12,9 @@
 #include <cmath>
 #include "pico/stdlib.h"
 #include "pico/time.h"
+#include "pico/multicore.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 
 #include "core/Navigator.hpp"
 #include "core/PersistentMemory.hpp"
@@ -37,6 +39,13 @@ using namespace maze;
  * - `CFG_MAZE_W`/`CFG_MAZE_H`: dimensões do labirinto (células).
  * - `CFG_GOAL_X`/`CFG_GOAL_Y`: coordenadas do objetivo.
  * - `CFG_TARGET_SPEED_CM_S`: velocidade alvo (cm/s) usada para escalonamento.
+ * - `CFG_MCTS_BUDGET_US`: orçamento por decisão do MCTS em µs (0 = desligado, usa `decidePlanned`). A busca
+ *   roda no core1 (`multicore_launch_core1`, pedido e resposta pela FIFO entre os núcleos); cada decisão
+ *   ocupa dois ticks, um para enviar o pedido e outro para aplicar a resposta.
+ * - `CFG_PLAN_BUDGET`: unidades de trabalho do planejador por tick (`planSliced`, padrão 256); 0 = busca completa (`planIfInvalid`).
+ * - `CFG_WEIGHTED_PLAN`: 1 = nas corridas sobre um mapa já salvo (boot com snapshot ou depois do goal) o
+ *   replanejamento (`planIfInvalid`/`planSliced`) minimiza o tempo aprendido por aresta (`edgeCosts()`);
+ *   a exploração de um mapa desconhecido sempre conta células. 0 = sempre menor número de células.
  *
  * Notas:
  * - Valores fora das faixas esperadas podem ser clampados pelo código.
@@ -80,6 +89,15 @@ using namespace maze;
 #ifndef CFG_GOAL_Y
 #define CFG_GOAL_Y 7
 #endif
+#ifndef CFG_MCTS_BUDGET_US
+#define CFG_MCTS_BUDGET_US 0
+#endif
+#ifndef CFG_PLAN_BUDGET
+#define CFG_PLAN_BUDGET 256
+#endif
+#ifndef CFG_WEIGHTED_PLAN
+#define CFG_WEIGHTED_PLAN 1
+#endif
 
 /**
  * @brief Contexto compartilhado pelo callback de controle periódico.
@@ -96,8 +114,61 @@ struct ControlContext {
     Point cur{0,0};
     uint8_t heading{1}; // 0=N,1=E,2=S,3=W (começa para Leste)
     bool planned{false};
+    uint32_t cell_t_ms{0}; // instante de entrada em `cur` (tempo de travessia por aresta)
+    // Goal atingido: o callback para os motores e não toca `nav` até o laço principal
+    // replanejar e gravar na flash (trabalho sem limite de tempo, fora da interrupção)
+    volatile bool goal_pending{false};
+    // MCTS no core1 (CFG_MCTS_BUDGET_US > 0): do pedido até a resposta na FIFO o core1 usa
+    // `nav`, `cur`, `heading` e `mcts_sr`, e o callback não os toca
+    bool mcts_busy{false};
+    bool mcts_ready{false};    // `mcts_decision` ainda não aplicada (mesma pose do pedido)
+    SensorRead mcts_sr{};      // leituras do tick do pedido
+    Decision mcts_decision{};  // escrita pelo core1
 };
 
+#if CFG_MCTS_BUDGET_US > 0
+/** @brief Decisão MCTS do pedido em `ctx` (core1). */
+static void mcts_decide(ControlContext& ctx) {
+    ctx.mcts_decision = ctx.nav->decideMcts(ctx.cur, ctx.heading, ctx.mcts_sr, MctsConfig::embedded(CFG_MCTS_BUDGET_US));
+}
+
+/**
+ * @brief Laço do core1: espera um pedido na FIFO, decide por MCTS e responde pela FIFO.
+ *
+ * O primeiro valor recebido é o `ControlContext`. Fica na RAM: entre pedidos
+ * o core1 só executa este laço, então as gravações na flash de
+ * `save_goal_run()` (o core0 só chega lá depois da resposta) não o derrubam.
+ */
+static void __not_in_flash_func(mcts_core1_main)() {
+    auto* ctx = reinterpret_cast<ControlContext*>(multicore_fifo_pop_blocking_inline());
+    while (true) {
+        multicore_fifo_pop_blocking_inline();
+        __dmb(); // lê o pedido depois da FIFO
+        mcts_decide(*ctx);
+        __dmb(); // decisão visível antes da resposta
+        multicore_fifo_push_blocking_inline(1);
+    }
+}
+#endif
+
+/**
+ * @brief Trabalho do goal, no laço principal: replaneja e persiste heurísticas/mapa/caminho/tempos.
+ *
+ * Chamado com `goal_pending` ligado, quando o callback já não usa `nav`.
+ */
+static void save_goal_run(ControlContext& ctx) {
+    // Daqui em diante o mapa está salvo: corridas rápidas usam os tempos aprendidos
+    ctx.nav->setWeightedPlanning(CFG_WEIGHTED_PLAN != 0);
+    PersistentMemory::saveHeuristics(ctx.nav->heuristics());
+    // Salva também o snapshot do mapa, o melhor caminho conhecido (2 bits por movimento)
+    // e os tempos por aresta, que pesam o caminho da próxima corrida
+    PersistentMemory::saveMapSnapshot(ctx.nav->map());
+    if (ctx.nav->planRoute()) PersistentMemory::savePath(ctx.nav->currentPlan());
+    PersistentMemory::saveEdgeCosts(ctx.nav->edgeCosts());
+    ctx.planned = false; // permitir novo plano
+    ctx.cell_t_ms = to_ms_since_boot(get_absolute_time()); // a parada não conta como travessia
+}
+
 /**
  * @brief Passo de controle periódico do robô (callback do timer).
  * @param t Ponteiro para o timer que invoca o callback (user_data deve apontar
@@ -111,10 +182,31 @@ struct ControlContext {
  * 4) Calcula centragem lateral (erro L-R) e `rotate` via `CFG_K_ROT`.
  * 5) Calcula `forward` considerando base, velocidade alvo e proximidade frontal.
  * 6) Obtém decisão (`decide`/`decidePlanned`), loga e comanda motores via `arcadeDrive`.
- * 7) Atualiza pose discreta em avanço; salva heurísticas/mapa ao atingir o goal.
+ *    Com MCTS, o tick com plano envia o pedido ao core1 e para os motores; o
+ *    seguinte (mesma pose) aplica a resposta.
+ * 7) Atualiza pose discreta em avanço e registra o tempo da aresta percorrida;
+ *    ao atingir o goal para os motores e sinaliza `goal_pending`; até o laço
+ *    principal terminar `save_goal_run()`, os ticks só mantêm os motores parados.
  */
 static bool control_step_cb(repeating_timer_t* t) {
     auto* ctx = static_cast<ControlContext*>(t->user_data);
+    if (ctx->goal_pending) {
+        ctx->motors->arcadeDrive(0.0f, 0.0f);
+        return true;
+    }
+#if CFG_MCTS_BUDGET_US > 0
+    if (ctx->mcts_busy) {
+        // Core1 ainda decide com `nav`: motores parados até a resposta
+        if (!multicore_fifo_rvalid()) {
+            ctx->motors->arcadeDrive(0.0f, 0.0f);
+            return true;
+        }
+        multicore_fifo_pop_blocking();
+        __dmb();
+        ctx->mcts_busy = false;
+        ctx->mcts_ready = true;
+    }
+#endif
     // Leitura dos sensores (booleanos: caminho livre = true)
     SensorRead sr{};
     auto vals = ctx->sensors->readAll(); // valores já filtrados via EMA
@@ -136,9 +228,13 @@ static bool control_step_cb(repeating_timer_t* t) {
 
     // Observação de paredes no mapa usando leituras relativas
     ctx->nav->observeCellWalls(ctx->cur, sr, ctx->heading);
-    if (!ctx->planned) {
-        ctx->planned = ctx->nav->planRoute();
-    }
+    // Replaneja só quando a observação invalidou o plano guardado (O(1) caso contrário).
+    // Com orçamento, a busca ARA* avança uma fatia por tick e nunca estoura o período.
+#if CFG_PLAN_BUDGET > 0
+    ctx->planned = ctx->nav->planSliced(CFG_PLAN_BUDGET);
+#else
+    ctx->planned = ctx->nav->planIfInvalid();
+#endif
 
     // Controle contínuo para centragem durante entradas (20cm de largura, robô 15cm)
     // Erro lateral: positivo => muito perto da esquerda (mais escuro/perto) vira à direita e vice-versa
@@ -167,8 +263,26 @@ static bool control_step_cb(repeating_timer_t* t) {
     if (speed_scale < 0.f) speed_scale = 0.f; else if (speed_scale > 1.f) speed_scale = 1.f;
     forward *= speed_scale;
 
+#if CFG_MCTS_BUDGET_US > 0
+    Decision d;
+    if (ctx->mcts_ready) {
+        d = ctx->mcts_decision;
+        ctx->mcts_ready = false;
+    } else if (ctx->planned) {
+        // Busca no core1; este tick só para os motores, o próximo aplica a resposta
+        ctx->mcts_sr = sr;
+        ctx->mcts_busy = true;
+        __dmb();
+        multicore_fifo_push_blocking(1);
+        ctx->motors->arcadeDrive(0.0f, 0.0f);
+        return true;
+    } else {
+        d = ctx->nav->decide(sr);
+    }
+#else
     Decision d = ctx->planned ? ctx->nav->decidePlanned(ctx->cur, ctx->heading, sr)
                               : ctx->nav->decide(sr);
+#endif
 
     // Log formato solicitado
     const char* lado = (d.action == Action::Right) ? "direita" :
@@ -192,17 +306,17 @@ static bool control_step_cb(repeating_timer_t* t) {
             // Clamps de segurança
             ctx->motors->arcadeDrive(clampf(turn_forward, -1.f, 1.f), clampf(static_cast<float>(+CFG_TURN_ROT), -1.f, 1.f)); // leve avanço ao entrar à direita
             // Atualiza heading (direita)
-            ctx->heading = (ctx->heading + 1) & 3;
+            ctx->heading = static_cast<uint8_t>(rel_to_abs(from_heading(ctx->heading), d.action));
             ctx->nav->applyReward(d.action, +0.2f);
             break;
         case Action::Left:
             ctx->motors->arcadeDrive(clampf(turn_forward, -1.f, 1.f), clampf(static_cast<float>(-CFG_TURN_ROT), -1.f, 1.f));
-            ctx->heading = (ctx->heading + 3) & 3;
+            ctx->heading = static_cast<uint8_t>(rel_to_abs(from_heading(ctx->heading), d.action));
             ctx->nav->applyReward(d.action, +0.2f);
             break;
         case Action::Back:
             ctx->motors->arcadeDrive(clampf(-0.4f, -1.f, 1.f), 0.0f);
-            ctx->heading = (ctx->heading + 2) & 3;
+            ctx->heading = static_cast<uint8_t>(rel_to_abs(from_heading(ctx->heading), d.action));
             ctx->nav->applyReward(d.action, -0.3f); // penaliza ré
             break;
         case Action::Forward:
@@ -214,20 +328,21 @@ static bool control_step_cb(repeating_timer_t* t) {
             } else {
                 ctx->motors->arcadeDrive(clampf(forward, -1.f, 1.f), clampf(rotate, -1.f, 1.f));
                 // Atualiza célula assumindo avanço de 1 passo por iteração (modelo simplificado)
-                switch (ctx->heading) {
-                    case 0: if (ctx->cur.y > 0) ctx->cur.y -= 1; break;  // N
-                    case 1: if (ctx->cur.x + 1 < CFG_MAZE_W) ctx->cur.x += 1; break; // E
-                    case 2: if (ctx->cur.y + 1 < CFG_MAZE_H) ctx->cur.y += 1; break; // S
-                    case 3: if (ctx->cur.x > 0) ctx->cur.x -= 1; break; // W
+                {
+                    const Point next = step(ctx->cur, from_heading(ctx->heading));
+                    if (next.x >= 0 && next.y >= 0 && next.x < CFG_MAZE_W && next.y < CFG_MAZE_H) {
+                        // Tempo desde a entrada na célula (inclui giros e esperas nela)
+                        const uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+                        ctx->nav->edgeCosts().record(ctx->cur, from_heading(ctx->heading), now_ms - ctx->cell_t_ms);
+                        ctx->cell_t_ms = now_ms;
+                        ctx->cur = next;
+                    }
                 }
                 ctx->nav->applyReward(d.action, +0.3f);
-                // se chegamos ao goal, persistir heurísticas e replanejar (opcional)
+                // se chegamos ao goal, parar e deixar replanejamento e gravação ao laço principal
                 if (ctx->cur.x == CFG_GOAL_X && ctx->cur.y == CFG_GOAL_Y) {
-                    auto h = ctx->nav->heuristics();
-                    PersistentMemory::saveHeuristics(h);
-                    // Salva também o snapshot do mapa
-                    PersistentMemory::saveMapSnapshot(ctx->nav->map());
-                    ctx->planned = false; // permitir novo plano
+                    ctx->motors->arcadeDrive(0.0f, 0.0f);
+                    ctx->goal_pending = true;
                 }
             }
             break;
@@ -317,15 +432,39 @@ int main() {
     }
 
     // Carregar snapshot do mapa, se houver
-    if (PersistentMemory::loadMapSnapshot(&nav.map())) {
+    const bool map_loaded = PersistentMemory::loadMapSnapshot(&nav.map());
+    if (map_loaded) {
         printf("MAP snapshot carregado.\n");
     } else {
         printf("MAP vazio.\n");
     }
 
+    // Tempos de travessia por aresta das corridas anteriores: pesam só a corrida sobre o mapa salvo
+    nav.setWeightedPlanning(CFG_WEIGHTED_PLAN != 0 && map_loaded);
+    if (PersistentMemory::loadEdgeCosts(&nav.edgeCosts())) {
+        printf("CUSTOS carregados: %u arestas medidas.\n", (unsigned)nav.edgeCosts().measured());
+    }
+
+    // Carregar caminho salvo, se houver (usado até o primeiro replanejamento).
+    // Só vale como plano se ligar start e goal pelo mapa carregado; senão o primeiro tick replaneja.
+    PathCode saved_path;
+    const bool has_saved_path = PersistentMemory::loadPath(&saved_path);
+    if (has_saved_path) {
+        const bool fits = nav.setPlan(saved_path);
+        printf("PATH carregado: %u movimentos (%s)%s\n", (unsigned)saved_path.moves(), saved_path.toText().c_str(),
+               fits ? "" : " - incompativel com o mapa, replanejando");
+    }
+
     printf("START navegacao (timer periodico)\n");
 
     ControlContext ctx{ .motors = &motors, .sensors = &sensors, .nav = &nav };
+    ctx.planned = has_saved_path;
+    ctx.cell_t_ms = to_ms_since_boot(get_absolute_time());
+#if CFG_MCTS_BUDGET_US > 0
+    // MCTS no core1: o primeiro valor da FIFO é o contexto compartilhado
+    multicore_launch_core1(mcts_core1_main);
+    multicore_fifo_push_blocking(reinterpret_cast<uintptr_t>(&ctx));
+#endif
     repeating_timer_t timer{};
     // Período configurável
     bool ok = add_repeating_timer_ms(CFG_CONTROL_PERIOD_MS, control_step_cb, &ctx, &timer);
@@ -333,6 +472,12 @@ int main() {
         printf("ERRO: nao foi possivel iniciar timer de controle.\n");
     }
 
-    // Loop ocioso; o controle roda no callback do timer
-    while (true) { tight_loop_contents(); }
+    // O controle roda no callback do timer; o laço principal só atende o goal
+    while (true) {
+        if (ctx.goal_pending) {
+            save_goal_run(ctx);
+            ctx.goal_pending = false;
+        }
+        tight_loop_contents();
+    }
 }
@@ -0,0 +1,294 @@
+/**
+ * @file simulator/AsyncWriter.hpp
+ * @brief Gravação assíncrona dos arquivos do simulador (`.plan`, `.soluct`): thread de IO,
+ *        fila limitada, escrita incremental, versionamento por hash e troca atômica (sem SDL).
+ */
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace maze {
+
+/** @brief Hash FNV-1a de 64 bits; `h` permite encadear blocos. */
+inline uint64_t fnv1a64(const void* data, size_t n, uint64_t h = 1469598103934665603ull) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+/** @brief FNV-1a de um arquivo lido em blocos (sem carregá-lo inteiro); false se não abrir. */
+inline bool fnv1a64_file(const std::filesystem::path& p, uint64_t& out) {
+    std::ifstream ifs(p, std::ios::binary);
+    if (!ifs) return false;
+    uint64_t h = fnv1a64(nullptr, 0);
+    char buf[16 * 1024];
+    while (ifs) {
+        ifs.read(buf, sizeof(buf));
+        h = fnv1a64(buf, static_cast<size_t>(ifs.gcount()), h);
+    }
+    out = h;
+    return true;
+}
+
+/**
+ * @brief Caminho versionado `<dir>/<stem><infix><n><ext>` do arquivo de mapa `mapFile`.
+ * @param infix ex.: `"_solution_"`, `"_plan_"`
+ * @param ext ex.: `".soluct"`, `".plan"`
+ */
+inline std::filesystem::path versioned_path(const std::filesystem::path& mapFile, const std::string& infix,
+                                            const std::string& ext, int index) {
+    return mapFile.parent_path() / (mapFile.stem().string() + infix + std::to_string(index) + ext);
+}
+
+/** @brief Maior `<n>` existente para `versioned_path(mapFile, infix, ext, n)`; 0 se nenhum. */
+inline int latest_version_index(const std::filesystem::path& mapFile, const std::string& infix, const std::string& ext) {
+    namespace fs = std::filesystem;
+    int best = 0;
+    const fs::path dir = mapFile.parent_path().empty() ? fs::path(".") : mapFile.parent_path();
+    const std::string prefix = mapFile.stem().string() + infix;
+    try {
+        if (!fs::is_directory(dir)) return 0;
+        for (auto& e : fs::directory_iterator(dir)) {
+            if (!e.is_regular_file() || e.path().extension() != ext) continue;
+            const std::string fname = e.path().filename().string();
+            if (fname.rfind(prefix, 0) != 0) continue;
+            const size_t end = fname.find('.', prefix.size());
+            if (end == std::string::npos || end == prefix.size()) continue;
+            const int idx = std::atoi(fname.substr(prefix.size(), end - prefix.size()).c_str());
+            if (idx > best) best = idx;
+        }
+    } catch (...) {}
+    return best;
+}
+
+/**
+ * @brief Thread de IO com fila limitada para os arquivos de saída do simulador.
+ *
+ * A thread de renderização só enfileira: `begin()` abre um fluxo, `append()`
+ * manda pedaços de texto durante o episódio e `commit()` decide o nome
+ * versionado, grava e troca o arquivo de uma vez; `writeVersioned()` faz o
+ * mesmo para um conteúdo já pronto. Toda escrita vai para `<final>.tmp` e só
+ * vira `<final>` com `rename`, então um leitor nunca vê um arquivo pela metade.
+ *
+ * Com `dedup`, o conteúdo é comparado com a última versão pelo hash FNV-1a
+ * (calculado enquanto os pedaços passam; o da versão anterior vem de um cache
+ * ou, uma única vez, da leitura em blocos do arquivo) e uma versão idêntica
+ * não cria arquivo novo.
+ *
+ * A fila guarda no máximo `max_jobs` pedidos; cheia, `append()` espera a
+ * thread de IO (contrapressão em vez de memória sem limite). Resultados de
+ * `commit()`/`writeVersioned()` são lidos com `takeResults()` a cada quadro.
+ * O destrutor grava o que já foi enfileirado e descarta fluxos não
+ * confirmados (`.tmp` removido).
+ */
+class AsyncWriter {
+public:
+    /** @brief Resultado de uma gravação versionada. */
+    struct Result {
+        uint64_t tag{0};            ///< Valor passado pelo chamador (identifica o pedido)
+        std::filesystem::path path; ///< Arquivo final (ou a última versão, se `unchanged`)
+        bool ok{false};             ///< false em erro de IO
+        bool unchanged{false};      ///< Conteúdo igual à última versão (nada gravado)
+    };
+    /** @brief Identificador de um fluxo aberto (0 = nenhum). */
+    using StreamId = uint64_t;
+
+    explicit AsyncWriter(size_t max_jobs = 256) : max_jobs_(max_jobs > 0 ? max_jobs : 1), io_([this] { run(); }) {}
+    ~AsyncWriter() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        io_.join();
+    }
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /**
+     * @brief Abre um fluxo que será gravado como `versioned_path(mapFile, infix, ext, n)`.
+     * @param dedup não cria versão nova se o conteúdo for igual ao da última
+     */
+    StreamId begin(const std::filesystem::path& mapFile, const std::string& infix, const std::string& ext, bool dedup) {
+        Job j;
+        j.kind = Job::Begin;
+        j.map_file = mapFile; j.infix = infix; j.ext = ext; j.dedup = dedup;
+        j.id = ++next_id_;
+        push(std::move(j));
+        return next_id_;
+    }
+    /** @brief Acrescenta `text` ao fluxo `id` (espera se a fila estiver cheia). */
+    void append(StreamId id, std::string text) {
+        if (id == 0 || text.empty()) return;
+        Job j; j.kind = Job::Append; j.id = id; j.text = std::move(text);
+        push(std::move(j));
+    }
+    /** @brief Fecha o fluxo `id`, escolhe o número da versão e troca o `.tmp` pelo arquivo final. */
+    void commit(StreamId id, uint64_t tag) {
+        if (id == 0) return;
+        Job j; j.kind = Job::Commit; j.id = id; j.tag = tag;
+        push(std::move(j));
+    }
+    /** @brief Descarta o fluxo `id` (remove o `.tmp`). */
+    void abort(StreamId id) {
+        if (id == 0) return;
+        Job j; j.kind = Job::Abort; j.id = id;
+        push(std::move(j));
+    }
+    /** @brief Atalho: fluxo com um único pedaço `content`, confirmado em seguida. */
+    void writeVersioned(const std::filesystem::path& mapFile, const std::string& infix, const std::string& ext,
+                        std::string content, bool dedup, uint64_t tag) {
+        const StreamId id = begin(mapFile, infix, ext, dedup);
+        append(id, std::move(content));
+        commit(id, tag);
+    }
+
+    /** @brief Resultados concluídos desde a última chamada (não bloqueia). */
+    std::vector<Result> takeResults() {
+        std::lock_guard<std::mutex> lk(mu_);
+        std::vector<Result> out;
+        out.swap(results_);
+        return out;
+    }
+    /** @brief Espera a fila esvaziar (testes e encerramento). */
+    void flush() {
+        std::unique_lock<std::mutex> lk(mu_);
+        idle_cv_.wait(lk, [this] { return queue_.empty() && !busy_; });
+    }
+
+private:
+    struct Job {
+        enum Kind { Begin, Append, Commit, Abort } kind{Begin};
+        StreamId id{0};
+        std::filesystem::path map_file;
+        std::string infix, ext, text;
+        bool dedup{false};
+        uint64_t tag{0};
+    };
+    /** @brief Estado de um fluxo, acessado só pela thread de IO. */
+    struct Stream {
+        std::filesystem::path map_file, tmp;
+        std::string infix, ext;
+        bool dedup{false};
+        std::ofstream out;
+        uint64_t hash{fnv1a64(nullptr, 0)};
+    };
+
+    void push(Job j) {
+        std::unique_lock<std::mutex> lk(mu_);
+        space_cv_.wait(lk, [this] { return queue_.size() < max_jobs_; });
+        queue_.push_back(std::move(j));
+        lk.unlock();
+        cv_.notify_one();
+    }
+
+    void run() {
+        for (;;) {
+            Job j;
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                cv_.wait(lk, [this] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) break; // stop_ e nada pendente
+                j = std::move(queue_.front());
+                queue_.pop_front();
+                busy_ = true;
+            }
+            space_cv_.notify_one();
+            handle(j);
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                busy_ = false;
+            }
+            idle_cv_.notify_all();
+        }
+        // Fluxos nunca confirmados não viram arquivo
+        for (auto& kv : streams_) discard(kv.second);
+        streams_.clear();
+    }
+
+    void handle(Job& j) {
+        namespace fs = std::filesystem;
+        if (j.kind == Job::Begin) {
+            Stream& s = streams_[j.id];
+            s.map_file = j.map_file; s.infix = j.infix; s.ext = j.ext; s.dedup = j.dedup;
+            s.tmp = j.map_file.parent_path() / (j.map_file.stem().string() + j.infix + "w" + std::to_string(j.id) + j.ext + ".tmp");
+            s.out.open(s.tmp, std::ios::binary | std::ios::trunc);
+            return;
+        }
+        auto it = streams_.find(j.id);
+        if (it == streams_.end()) return;
+        Stream& s = it->second;
+        if (j.kind == Job::Append) {
+            s.hash = fnv1a64(j.text.data(), j.text.size(), s.hash);
+            if (s.out) s.out.write(j.text.data(), static_cast<std::streamsize>(j.text.size()));
+            return;
+        }
+        if (j.kind == Job::Abort) { discard(s); streams_.erase(it); return; }
+
+        // Commit
+        Result r; r.tag = j.tag;
+        s.out.flush();
+        const bool written = static_cast<bool>(s.out);
+        s.out.close();
+        const int latest = latest_version_index(s.map_file, s.infix, s.ext);
+        if (s.dedup && latest > 0) {
+            const fs::path last = versioned_path(s.map_file, s.infix, s.ext, latest);
+            uint64_t h = 0;
+            auto c = hash_cache_.find(last.string());
+            const bool known = (c != hash_cache_.end()) ? (h = c->second, true) : fnv1a64_file(last, h);
+            if (known) hash_cache_[last.string()] = h;
+            if (known && h == s.hash) {
+                r.path = last; r.ok = true; r.unchanged = true;
+                discard(s);
+                streams_.erase(it);
+                publish(std::move(r));
+                return;
+            }
+        }
+        r.path = versioned_path(s.map_file, s.infix, s.ext, latest + 1);
+        std::error_code ec;
+        if (written) fs::rename(s.tmp, r.path, ec);
+        r.ok = written && !ec;
+        if (r.ok) hash_cache_[r.path.string()] = s.hash;
+        else fs::remove(s.tmp, ec);
+        streams_.erase(it);
+        publish(std::move(r));
+    }
+
+    static void discard(Stream& s) {
+        if (s.out.is_open()) s.out.close();
+        std::error_code ec;
+        std::filesystem::remove(s.tmp, ec);
+    }
+
+    void publish(Result r) {
+        std::lock_guard<std::mutex> lk(mu_);
+        results_.push_back(std::move(r));
+    }
+
+    const size_t max_jobs_;
+    StreamId next_id_{0};                       ///< Usado só pela thread chamadora
+    std::mutex mu_;
+    std::condition_variable cv_;                ///< Há trabalho (ou parada)
+    std::condition_variable space_cv_;          ///< A fila tem espaço
+    std::condition_variable idle_cv_;           ///< A fila esvaziou
+    std::deque<Job> queue_;
+    std::vector<Result> results_;
+    bool stop_{false};
+    bool busy_{false};
+    std::map<StreamId, Stream> streams_;        ///< Só a thread de IO
+    std::map<std::string, uint64_t> hash_cache_; ///< Hash das versões já vistas (só a thread de IO)
+    std::thread io_;                            ///< Por último: inicia depois dos demais membros
+};
+
+} // namespace maze
@@ -0,0 +1,95 @@
+/**
+ * @file simulator/Camera.hpp
+ * @brief Câmera 2D da vista do labirinto: zoom, pan, enquadramento e recorte de células visíveis (sem SDL).
+ */
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+namespace maze {
+
+/**
+ * @brief Transformação célula → pixel da área de desenho do simulador.
+ *
+ * A célula (x,y) ocupa `[ox + x*cell, ox + (x+1)*cell)` na horizontal (idem
+ * vertical com `oy`). `cell` é fracionário: abaixo de alguns pixels por célula
+ * o simulador troca os retângulos por uma textura (nível de detalhe), então a
+ * câmera não arredonda nada além da conversão final para pixels.
+ *
+ * `visible()` devolve apenas as células que cruzam a viewport, para que o
+ * custo de desenhar seja proporcional à tela e não ao labirinto.
+ */
+class Camera {
+public:
+    static constexpr double kMinCell = 0.25;  ///< Zoom mínimo (pixels por célula)
+    static constexpr double kMaxCell = 128.0; ///< Zoom máximo (pixels por célula)
+
+    /** @brief Intervalo semiaberto de células `[x0,x1) × [y0,y1)`. */
+    struct CellRange {
+        int x0{0}, y0{0}, x1{0}, y1{0};
+        bool empty() const { return x0 >= x1 || y0 >= y1; }
+    };
+
+    /** @brief Define a área da janela (pixels) reservada ao labirinto. */
+    void setViewport(int x, int y, int w, int h) { vx_ = x; vy_ = y; vw_ = w; vh_ = h; }
+
+    /**
+     * @brief Enquadra `cols × rows` células na viewport, centralizadas.
+     * @param margin margem em pixels em volta do labirinto
+     * @param max_cell zoom máximo do enquadramento (labirintos pequenos não ficam gigantes)
+     */
+    void fit(int cols, int rows, int margin = 20, double max_cell = 40.0) {
+        if (cols <= 0 || rows <= 0) return;
+        const double aw = std::max(1, vw_ - 2 * margin), ah = std::max(1, vh_ - 2 * margin);
+        cell_ = clampCell(std::min({aw / cols, ah / rows, max_cell}));
+        ox_ = vx_ + (vw_ - cols * cell_) / 2.0;
+        oy_ = vy_ + (vh_ - rows * cell_) / 2.0;
+    }
+
+    /** @brief Multiplica o zoom por `factor` mantendo fixo o ponto sob o pixel (sx,sy). */
+    void zoomAt(double factor, int sx, int sy) {
+        const double wx = (sx - ox_) / cell_, wy = (sy - oy_) / cell_;
+        cell_ = clampCell(cell_ * factor);
+        ox_ = sx - wx * cell_;
+        oy_ = sy - wy * cell_;
+    }
+    /** @brief Zoom em torno do centro da viewport. */
+    void zoom(double factor) { zoomAt(factor, vx_ + vw_ / 2, vy_ + vh_ / 2); }
+
+    /** @brief Desloca a vista em pixels (arrasto do mouse). */
+    void pan(double dx, double dy) { ox_ += dx; oy_ += dy; }
+
+    /** @brief Células de `cols × rows` que cruzam a viewport (vazio se nenhuma). */
+    CellRange visible(int cols, int rows) const {
+        CellRange r;
+        r.x0 = std::max(0, static_cast<int>(std::floor((vx_ - ox_) / cell_)));
+        r.y0 = std::max(0, static_cast<int>(std::floor((vy_ - oy_) / cell_)));
+        r.x1 = std::min(cols, static_cast<int>(std::ceil((vx_ + vw_ - ox_) / cell_)));
+        r.y1 = std::min(rows, static_cast<int>(std::ceil((vy_ + vh_ - oy_) / cell_)));
+        return r;
+    }
+
+    /** @brief Pixel X da borda esquerda da coordenada de célula `cx` (aceita fração). */
+    int toScreenX(double cx) const { return static_cast<int>(std::floor(ox_ + cx * cell_)); }
+    /** @brief Pixel Y da borda superior da coordenada de célula `cy` (aceita fração). */
+    int toScreenY(double cy) const { return static_cast<int>(std::floor(oy_ + cy * cell_)); }
+
+    /** @brief true se o pixel (sx,sy) está dentro da viewport. */
+    bool contains(int sx, int sy) const { return sx >= vx_ && sy >= vy_ && sx < vx_ + vw_ && sy < vy_ + vh_; }
+
+    /** @brief Pixels por célula. */
+    double cell() const { return cell_; }
+    int viewX() const { return vx_; }
+    int viewY() const { return vy_; }
+    int viewW() const { return vw_; }
+    int viewH() const { return vh_; }
+
+private:
+    static double clampCell(double c) { return std::min(kMaxCell, std::max(kMinCell, c)); }
+
+    int vx_{0}, vy_{0}, vw_{1}, vh_{1}; ///< Viewport (pixels)
+    double cell_{40.0};                 ///< Pixels por célula
+    double ox_{0.0}, oy_{0.0};          ///< Pixel da borda superior esquerda da célula (0,0)
+};
+
+} // namespace maze
@@ -0,0 +1,204 @@
+/**
+ * @file simulator/CheckpointLog.hpp
+ * @brief Registro de progresso só de acréscimo para lotes longos: unidades de trabalho concluídas
+ *        gravadas com `fsync` em lotes e recarregadas ao retomar (sem SDL).
+ */
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace maze {
+
+/**
+ * @brief Arquivo texto de pares chave → valor, um por linha, só acrescentado.
+ *
+ * Cada linha é `<fnv32 hex>\t<chave>\t<valor>\n`; o hash cobre `chave\tvalor`.
+ * Ao abrir, as linhas válidas são carregadas e o arquivo é truncado na
+ * primeira inválida (linha cortada por queda ou lixo depois de uma falha de
+ * energia), de modo que os acréscimos seguintes continuam de um ponto limpo.
+ * Chave repetida: vale a última.
+ *
+ * `append()` entrega a linha ao sistema na hora (`fflush`: sobrevive a um
+ * processo morto), mas só chama `fsync` a cada `sync_every` registros ou
+ * `sync_ms` milissegundos, e em `sync()`/`close()`; uma queda de energia perde
+ * no máximo o último lote, que é refeito ao retomar.
+ */
+class CheckpointLog {
+public:
+    /** @brief Primeira linha do arquivo (identifica o formato). */
+    static constexpr const char* kMagic = "# maze checkpoint v1";
+
+    /** @brief Política de `fsync` dos acréscimos. */
+    struct Options {
+        size_t sync_every{64};   ///< Registros por `fsync`
+        uint32_t sync_ms{2000};  ///< Tempo máximo entre `fsync` com registros pendentes
+    };
+
+    CheckpointLog() = default;
+    explicit CheckpointLog(const Options& opt) : opt_(opt) {}
+    CheckpointLog(const CheckpointLog&) = delete;
+    CheckpointLog& operator=(const CheckpointLog&) = delete;
+    ~CheckpointLog() { close(); }
+
+    /** @brief FNV-1a de 32 bits (hash de linha; também serve de impressão digital curta). */
+    static uint32_t hash(const std::string& s, uint32_t h = 2166136261u) {
+        for (unsigned char c : s) { h ^= c; h *= 16777619u; }
+        return h;
+    }
+
+    /**
+     * @brief Lê os registros válidos de `path` sem abri-lo para escrita.
+     * @param[out] good_bytes bytes até o fim do último registro válido
+     * @return false se o arquivo não existe ou não é um checkpoint (arquivo vazio ou com cabeçalho cortado conta como válido e vazio)
+     */
+    static bool load(const std::filesystem::path& path, std::map<std::string, std::string>& out,
+                     uint64_t* good_bytes = nullptr) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const std::string magic = std::string(kMagic) + "\n";
+        if (good_bytes) *good_bytes = 0;
+        if (data.size() < magic.size()) return magic.compare(0, data.size(), data) == 0;
+        if (data.compare(0, magic.size(), magic) != 0) return false;
+        size_t pos = magic.size();
+        for (;;) {
+            if (good_bytes) *good_bytes = pos;
+            const size_t nl = data.find('\n', pos);
+            if (nl == std::string::npos) break;
+            const size_t t1 = data.find('\t', pos);
+            if (t1 == std::string::npos || t1 >= nl || t1 - pos != 8) break;
+            const std::string body = data.substr(t1 + 1, nl - t1 - 1);
+            const size_t t2 = body.find('\t');
+            if (t2 == std::string::npos) break;
+            char* end = nullptr;
+            const std::string hex = data.substr(pos, 8);
+            const unsigned long h = std::strtoul(hex.c_str(), &end, 16);
+            if (end != hex.c_str() + 8 || static_cast<uint32_t>(h) != hash(body)) break;
+            out[body.substr(0, t2)] = body.substr(t2 + 1);
+            pos = nl + 1;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Abre (ou cria) `path`, carrega o que já foi concluído e prepara os acréscimos.
+     * @return false se `path` existe e não é um checkpoint, ou em erro de IO
+     */
+    bool open(const std::filesystem::path& path) {
+        namespace fs = std::filesystem;
+        close();
+        entries_.clear();
+        resumed_ = appended_ = pending_ = syncs_ = 0;
+        dropped_bytes_ = 0;
+        std::error_code ec;
+        const bool exists = fs::exists(path, ec);
+        uint64_t good = 0;
+        if (exists) {
+            if (!load(path, entries_, &good)) return false;
+            const uint64_t size = fs::file_size(path, ec);
+            if (ec) return false;
+            if (good < size) {
+                dropped_bytes_ = size - good;
+                fs::resize_file(path, good, ec);
+                if (ec) return false;
+            }
+            resumed_ = entries_.size();
+        }
+        f_ = std::fopen(path.string().c_str(), good == 0 ? "wb" : "ab");
+        if (!f_) return false;
+        if (good == 0) { // novo, vazio ou só com cabeçalho cortado
+            std::fprintf(f_, "%s\n", kMagic);
+            if (!sync()) return false;
+#if defined(__unix__) || defined(__APPLE__)
+            // O arquivo novo só sobrevive a uma queda com a entrada do diretório também em disco
+            const fs::path dir = path.has_parent_path() ? path.parent_path() : fs::path(".");
+            const int dfd = ::open(dir.string().c_str(), O_RDONLY);
+            if (dfd >= 0) { ::fsync(dfd); ::close(dfd); }
+#endif
+        }
+        last_sync_ = std::chrono::steady_clock::now();
+        return true;
+    }
+    bool isOpen() const { return f_ != nullptr; }
+
+    /** @brief Valor gravado para `key`, ou nullptr. */
+    const std::string* find(const std::string& key) const {
+        const auto it = entries_.find(key);
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Acrescenta `key` → `value` (sem tabulação nem quebra de linha na chave; sem quebra no valor).
+     * @return false em IO ou conteúdo inválido
+     */
+    bool append(const std::string& key, const std::string& value) {
+        if (!f_ || key.empty() || key.find_first_of("\t\n") != std::string::npos ||
+            value.find('\n') != std::string::npos) return false;
+        const std::string body = key + "\t" + value;
+        if (std::fprintf(f_, "%08x\t%s\n", static_cast<unsigned>(hash(body)), body.c_str()) < 0 || std::fflush(f_) != 0)
+            return false;
+        entries_[key] = value;
+        appended_++;
+        pending_++;
+        const auto now = std::chrono::steady_clock::now();
+        if (pending_ >= opt_.sync_every ||
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - last_sync_).count() >= opt_.sync_ms)
+            return sync();
+        return true;
+    }
+
+    /** @brief Força os registros pendentes para o disco. */
+    bool sync() {
+        if (!f_) return false;
+        if (std::fflush(f_) != 0) return false;
+#if defined(__unix__) || defined(__APPLE__)
+        if (::fsync(fileno(f_)) != 0) return false;
+#endif
+        pending_ = 0;
+        syncs_++;
+        last_sync_ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    /** @brief `sync()` e fecha; os registros carregados continuam consultáveis. */
+    void close() {
+        if (!f_) return;
+        if (pending_) sync();
+        std::fclose(f_);
+        f_ = nullptr;
+    }
+
+    /** @brief Todos os registros (carregados e acrescentados). */
+    const std::map<std::string, std::string>& entries() const { return entries_; }
+    /** @brief Registros válidos encontrados ao abrir. */
+    size_t resumed() const { return resumed_; }
+    /** @brief Registros acrescentados desde `open()`. */
+    size_t appended() const { return appended_; }
+    /** @brief Bytes descartados do fim do arquivo ao abrir (linha cortada ou corrompida). */
+    uint64_t droppedBytes() const { return dropped_bytes_; }
+    /** @brief `fsync` feitos desde `open()`. */
+    size_t syncs() const { return syncs_; }
+
+private:
+    Options opt_{};
+    std::FILE* f_{nullptr};
+    std::map<std::string, std::string> entries_;
+    size_t resumed_{0}, appended_{0}, pending_{0}, syncs_{0};
+    uint64_t dropped_bytes_{0};
+    std::chrono::steady_clock::time_point last_sync_{};
+};
+
+} // namespace maze
@@ -0,0 +1,95 @@
+/**
+ * @file simulator/MazeIO.hpp
+ * @brief Leitura de labirintos `.maze` (JSON) e listagem do corpus, compartilhadas
+ *        entre o simulador SDL2 e as ferramentas headless.
+ */
+#pragma once
+#include <cstdio>
+#include <cctype>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "core/MazeMap.hpp"
+
+namespace maze {
+
+// Parser muito simples, assume JSON bem formado vindo do nosso save
+inline bool load_maze_json(const std::filesystem::path& file, MazeMap& m, Point& entrance, Point& goal, uint8_t& heading) {
+    std::ifstream ifs(file);
+    if (!ifs) return false;
+    std::stringstream buffer; buffer << ifs.rdbuf();
+    const std::string s = buffer.str();
+    auto find_int = [&](const std::string& key, int def)->int{
+        auto p = s.find("\""+key+"\""); if (p==std::string::npos) return def;
+        p = s.find(':', p); if (p==std::string::npos) return def; ++p;
+        while (p<s.size() && std::isspace((unsigned char)s[p])) ++p;
+        int val=def; std::sscanf(s.c_str()+p, "%d", &val); return val;
+    };
+    int W = find_int("width", m.width());
+    int H = find_int("height", m.height());
+    if (W!=m.width() || H!=m.height()) {
+        m = MazeMap(W,H);
+    }
+    auto find_obj_int = [&](const std::string& obj, const std::string& key, int def)->int{
+        auto p = s.find("\""+obj+"\""); if (p==std::string::npos) return def;
+        p = s.find('{' , p); if (p==std::string::npos) return def;
+        auto q = s.find('}', p); if (q==std::string::npos) q = s.size();
+        auto k = s.find("\""+key+"\"", p); if (k==std::string::npos || k>q) return def;
+        k = s.find(':', k); if (k==std::string::npos) return def; ++k;
+        while (k<s.size() && std::isspace((unsigned char)s[k])) ++k;
+        int val=def; std::sscanf(s.c_str()+k, "%d", &val); return val;
+    };
+    entrance.x = find_obj_int("entrance", "x", 0);
+    entrance.y = find_obj_int("entrance", "y", 0);
+    heading    = (uint8_t)find_obj_int("entrance", "heading", 1);
+    goal.x     = find_obj_int("goal", "x", W-1);
+    goal.y     = find_obj_int("goal", "y", H-1);
+
+    // Limpa paredes
+    for (int y=0; y<m.height(); ++y) for (int x=0; x<m.width(); ++x) {
+        m.set_wall(x,y,'N',false); m.set_wall(x,y,'E',false); m.set_wall(x,y,'S',false); m.set_wall(x,y,'W',false);
+    }
+    // Extrai array cells
+    auto pcells = s.find("\"cells\""); if (pcells==std::string::npos) return true;
+    pcells = s.find('[', pcells); if (pcells==std::string::npos) return true;
+    size_t idx = 0; // idx em ordem linha-major
+    for (size_t p = pcells; p < s.size() && idx < (size_t)(m.width()*m.height()); ) {
+        p = s.find('{', p); if (p==std::string::npos) break; auto q = s.find('}', p); if (q==std::string::npos) break;
+        auto sub = s.substr(p, q-p+1);
+        int n=0,e=0,ss=0,w=0;
+        std::sscanf(sub.c_str(), "{%*[^0-9]%d%*[^0-9]%d%*[^0-9]%d%*[^0-9]%d", &n,&e,&ss,&w);
+        int x = idx % m.width(); int y = idx / m.width();
+        if (n) m.set_wall(x,y,'N',true);
+        if (e) m.set_wall(x,y,'E',true);
+        if (ss) m.set_wall(x,y,'S',true);
+        if (w) m.set_wall(x,y,'W',true);
+        idx++;
+        p = q+1;
+    }
+    return true;
+}
+
+/**
+ * @brief Lista os arquivos `.maze` de um diretório em ordem alfabética.
+ * @param dir diretório do corpus (padrão `maze/`)
+ */
+inline std::vector<std::filesystem::path> list_maze_files(const std::filesystem::path& dir = "maze") {
+    std::vector<std::filesystem::path> out;
+    try {
+        if (std::filesystem::exists(dir) && std::filesystem::is_directory(dir)) {
+            for (auto& e : std::filesystem::directory_iterator(dir)) {
+                if (e.is_regular_file()) {
+                    auto p = e.path();
+                    if (p.extension()==".maze") out.push_back(p); // only list .maze maps
+                }
+            }
+            std::sort(out.begin(), out.end());
+        }
+    } catch (...) {}
+    return out;
+}
+
+} // namespace maze
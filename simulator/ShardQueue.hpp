@@ -0,0 +1,250 @@
+/**
+ * @file simulator/ShardQueue.hpp
+ * @brief Fila de trabalho em arquivos para lotes distribuídos: processos em uma ou várias máquinas
+ *        reivindicam shards num diretório compartilhado (ex.: NFS), sem agendador (sem SDL).
+ */
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace maze {
+
+/**
+ * @brief Reivindicação, posse e conclusão de shards num diretório compartilhado.
+ *
+ * Layout de `dir`:
+ * - `manifest`: descrição do trabalho; todo processo precisa concordar com ela;
+ * - `claims/NNNNN`: dono atual do shard (conteúdo = ficha do processo);
+ * - `done/NNNNN`: shard concluído;
+ * - `results/shard-NNNNN.ckpt`: resultados do shard (escritos só pelo dono).
+ *
+ * A reivindicação é um `link()` de um arquivo temporário próprio do
+ * processo e do shard (`claims/.tmp-<processo>-NNNNN`) para `claims/NNNNN`:
+ * cria o nome só se ele não existe, de forma atômica também em NFS
+ * (diferente de `O_EXCL` em clientes antigos). O dono renova a data do seu
+ * arquivo temporário a cada unidade (`heartbeat()`, `utimensat`); como a
+ * reivindicação é um link para o mesmo inode, ela envelhece junto, e nenhum
+ * processo abre `claims/NNNNN` para escrita (o nome pode já apontar para o
+ * arquivo de outro). Uma reivindicação sem batimento há mais de `stale_s`
+ * segundos é tomada com `rename()` para um nome próprio, que só um processo
+ * consegue; se o arquivo movido já não tem a ficha e a data julgadas velhas
+ * (o dono bateu entre a leitura e o `rename()`), ele volta para o lugar e o
+ * shard continua ocupado. As idades comparam horários de modificação dados
+ * pelo servidor de arquivos (o de um arquivo recém-tocado serve de "agora"),
+ * então relógios desencontrados entre máquinas não importam.
+ *
+ * O dono confere `owns()` antes de cada unidade: se o shard foi tomado, ele
+ * para, e o novo dono retoma o arquivo de resultados (um `CheckpointLog`).
+ * Soltar também move a reivindicação antes de apagá-la e devolve o que não
+ * for deste processo.
+ */
+class ShardQueue {
+public:
+    /** @brief Resultado de `claim()`. */
+    enum class Claim { Acquired, Done, Busy };
+
+    ShardQueue() = default;
+    ShardQueue(const ShardQueue&) = delete;
+    ShardQueue& operator=(const ShardQueue&) = delete;
+    ~ShardQueue() {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        if (tmp_.empty()) return;
+        // Arquivos temporários de shards ainda reivindicados (`tmp_` + "-NNNNN")
+        const std::string prefix = tmp_.filename().string() + "-";
+        std::vector<fs::path> mine;
+        for (const auto& e : fs::directory_iterator(dir_ / "claims", ec))
+            if (e.path().filename().string().compare(0, prefix.size(), prefix) == 0) mine.push_back(e.path());
+        for (const auto& p : mine) fs::remove(p, ec);
+        fs::remove(tmp_, ec);
+    }
+
+    /**
+     * @brief Prepara `dir` (cria se preciso) e confere o `manifest` com o de quem chegou primeiro.
+     * @param worker nome deste processo (ex.: `host-pid`), sem `/`
+     * @param[out] err motivo da falha
+     */
+    bool open(const std::filesystem::path& dir, const std::string& worker, const std::string& manifest, std::string* err = nullptr) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        dir_ = dir;
+        for (const char* sub : {"claims", "done", "results"}) fs::create_directories(dir_ / sub, ec);
+        if (!fs::is_directory(dir_ / "claims")) return fail(err, "diretório inacessível: " + dir_.string());
+        // Ficha única: o mesmo nome de processo em duas máquinas não confunde posse
+        std::random_device rd;
+        char nonce[20];
+        std::snprintf(nonce, sizeof(nonce), "%08x%08x", rd(), rd());
+        token_ = worker + " " + nonce;
+        nonce_ = nonce;
+        tmp_ = dir_ / "claims" / (".tmp-" + worker + "-" + nonce);
+        if (!writeFile(tmp_, token_)) return fail(err, "sem escrita em " + (dir_ / "claims").string());
+        // Primeiro a chegar publica o manifesto; os demais precisam do mesmo
+        const fs::path man = dir_ / "manifest", man_tmp = dir_ / (".manifest-" + std::string(nonce));
+        if (!fs::exists(man)) {
+            if (!writeFile(man_tmp, manifest)) return fail(err, "sem escrita em " + dir_.string());
+            fs::create_hard_link(man_tmp, man, ec); // falha se outro chegou antes: vale o dele
+            fs::remove(man_tmp, ec);
+        }
+        std::string current;
+        if (!readFile(man, current)) return fail(err, "manifesto ilegível: " + man.string());
+        if (current != manifest) return fail(err, "manifesto diferente (outro corpus, orçamento ou partição?) em " + man.string());
+        return true;
+    }
+
+    /** @brief Ficha deste processo (conteúdo das suas reivindicações). */
+    const std::string& token() const { return token_; }
+
+    /**
+     * @brief Tenta se tornar dono de `shard`.
+     * @param stale_s idade máxima do último batimento de outro dono (0 = nunca tomar)
+     */
+    Claim claim(uint32_t shard, uint32_t stale_s) {
+        namespace fs = std::filesystem;
+        if (isDone(shard)) return Claim::Done;
+        const fs::path c = claimPath(shard);
+        std::error_code ec;
+        if (tryLink(shard)) return isDone(shard) ? (release(shard), Claim::Done) : Claim::Acquired;
+        if (stale_s == 0) return Claim::Busy;
+        // Idade pelo relógio do servidor: a ficha temporária é tocada agora
+        if (!touch(tmp_)) return Claim::Busy;
+        const auto now = fs::last_write_time(tmp_, ec);
+        if (ec) return Claim::Busy;
+        std::string who;
+        const auto beat = fs::last_write_time(c, ec);
+        if (ec || !readFile(c, who)) return tryLink(shard) ? Claim::Acquired : Claim::Busy; // dono acabou de soltar
+        if (now - beat < std::chrono::seconds(stale_s)) return Claim::Busy;
+        const fs::path taken = dir_ / "claims" / (".stale-" + fileName(shard) + "-" + nonce_);
+        fs::rename(c, taken, ec); // só um processo move o arquivo
+        if (ec) return Claim::Busy;
+        // O dono pode ter batido (ou soltado, e outro reivindicado) entre a leitura e o rename
+        std::string moved;
+        const auto moved_beat = fs::last_write_time(taken, ec);
+        if (ec || !readFile(taken, moved) || moved != who || moved_beat != beat) {
+            fs::create_hard_link(taken, c, ec); // devolve; falha só se outro já reivindicou o nome vago
+            fs::remove(taken, ec);
+            return Claim::Busy;
+        }
+        fs::remove(taken, ec);
+        stolen_++;
+        return tryLink(shard) ? Claim::Acquired : Claim::Busy;
+    }
+
+    /** @brief true se a reivindicação de `shard` ainda é deste processo. */
+    bool owns(uint32_t shard) const {
+        std::string who;
+        return readFile(claimPath(shard), who) && who == token_;
+    }
+    /**
+     * @brief Renova a reivindicação: toca o arquivo temporário do shard (o servidor atualiza a data).
+     *
+     * Só o inode deste processo é tocado; a posse é conferida depois, então um
+     * batimento que chega após a tomada não renova a reivindicação de outro.
+     */
+    bool heartbeat(uint32_t shard) {
+        return touch(shardTmp(shard)) && owns(shard);
+    }
+    /** @brief Marca `shard` como concluído e solta a reivindicação; false se ela já não era deste processo. */
+    bool complete(uint32_t shard) {
+        namespace fs = std::filesystem;
+        if (!owns(shard)) return false;
+        std::error_code ec;
+        fs::create_hard_link(shardTmp(shard), dir_ / "done" / fileName(shard), ec); // nunca trunca um `done` existente
+        if (ec && !isDone(shard)) return false;
+        release(shard);
+        return true;
+    }
+    /** @brief Solta a reivindicação sem concluir (outro processo pode reivindicar já). */
+    void release(uint32_t shard) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        const fs::path c = claimPath(shard), mine = shardTmp(shard);
+        if (fs::equivalent(c, mine, ec)) {
+            // Move antes de apagar: se o nome trocou de dono nesse meio tempo, devolve
+            const fs::path away = dir_ / "claims" / (".release-" + fileName(shard) + "-" + nonce_);
+            fs::rename(c, away, ec);
+            if (!ec) {
+                if (!fs::equivalent(away, mine, ec)) fs::create_hard_link(away, c, ec);
+                fs::remove(away, ec);
+            }
+        }
+        fs::remove(mine, ec);
+    }
+    bool isDone(uint32_t shard) const {
+        std::error_code ec;
+        return std::filesystem::exists(dir_ / "done" / fileName(shard), ec);
+    }
+    /** @brief Arquivo de resultados de `shard`. */
+    std::filesystem::path resultPath(uint32_t shard) const { return dir_ / "results" / ("shard-" + fileName(shard) + ".ckpt"); }
+    /** @brief Todos os arquivos de resultados existentes, em ordem de nome. */
+    std::vector<std::filesystem::path> resultFiles() const {
+        std::vector<std::filesystem::path> out;
+        std::error_code ec;
+        for (const auto& e : std::filesystem::directory_iterator(dir_ / "results", ec))
+            if (e.path().extension() == ".ckpt") out.push_back(e.path());
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+    /** @brief Reivindicações tomadas de donos sem batimento. */
+    size_t stolen() const { return stolen_; }
+
+private:
+    static bool fail(std::string* err, const std::string& msg) {
+        if (err) *err = msg;
+        return false;
+    }
+    static std::string fileName(uint32_t shard) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%05u", shard);
+        return buf;
+    }
+    std::filesystem::path claimPath(uint32_t shard) const { return dir_ / "claims" / fileName(shard); }
+    /** @brief Arquivo temporário deste processo para `shard` (a reivindicação é um link para ele). */
+    std::filesystem::path shardTmp(uint32_t shard) const { return tmp_.string() + "-" + fileName(shard); }
+    /** @brief Cria um arquivo temporário novo para `shard` e tenta ligá-lo como reivindicação. */
+    bool tryLink(uint32_t shard) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        const fs::path mine = shardTmp(shard);
+        fs::remove(mine, ec); // inode novo: o antigo pode estar com quem tomou o shard
+        if (!writeFile(mine, token_)) return false;
+        fs::create_hard_link(mine, claimPath(shard), ec);
+        if (!ec) return true;
+        fs::remove(mine, ec);
+        return false;
+    }
+    /** @brief Atualiza a data de modificação de `p` para "agora" no servidor de arquivos. */
+    static bool touch(const std::filesystem::path& p) {
+        return ::utimensat(AT_FDCWD, p.c_str(), nullptr, 0) == 0;
+    }
+    static bool writeFile(const std::filesystem::path& p, const std::string& s) {
+        std::ofstream out(p, std::ios::binary | std::ios::trunc);
+        out << s;
+        out.close();
+        return static_cast<bool>(out);
+    }
+    static bool readFile(const std::filesystem::path& p, std::string& s) {
+        std::ifstream in(p, std::ios::binary);
+        if (!in) return false;
+        std::stringstream ss;
+        ss << in.rdbuf();
+        s = ss.str();
+        return true;
+    }
+
+    std::filesystem::path dir_, tmp_;
+    std::string token_, nonce_;
+    size_t stolen_{0};
+};
+
+} // namespace maze
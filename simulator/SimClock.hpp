@@ -0,0 +1,109 @@
+/**
+ * @file simulator/SimClock.hpp
+ * @brief Relógio de simulação com passo fixo, desacoplado da renderização (sem SDL).
+ */
+#pragma once
+#include <cstddef>
+
+namespace maze {
+
+/**
+ * @brief Passo fixo de simulação com multiplicador de velocidade, pausa e passo único.
+ *
+ * O laço de renderização informa o tempo de parede de cada quadro em
+ * `update()` e executa passos enquanto `shouldStep()` for true. Cada passo
+ * avança exatamente `stepSeconds()` de tempo simulado, então `simTime()` é o
+ * tempo do robô, independente da taxa de quadros e de quanto tempo a janela
+ * ficou aberta. `alpha()` é a fração do próximo passo já acumulada, usada para
+ * interpolar a pose desenhada.
+ *
+ * Velocidade: `kSpeeds` vai de 0,1x a 100x; o último nível é ilimitado
+ * (`shouldStep()` sempre true: o chamador limita os passos por quadro pelo
+ * próprio orçamento de tempo). O acúmulo é limitado a `max_backlog` passos
+ * para não "correr atrás" depois de um quadro lento.
+ */
+class SimClock {
+public:
+    /** @brief Níveis de velocidade (0 = ilimitado). */
+    static constexpr double kSpeeds[] = { 0.1, 0.25, 0.5, 1.0, 2.0, 5.0, 10.0, 25.0, 100.0, 0.0 };
+    static constexpr int kSpeedCount = static_cast<int>(sizeof(kSpeeds) / sizeof(kSpeeds[0]));
+    /** @brief Índice de 1x em `kSpeeds`. */
+    static constexpr int kNormalSpeed = 3;
+
+    /**
+     * @param step_s duração simulada de um passo do agente (segundos)
+     * @param max_backlog passos acumulados no máximo entre quadros
+     */
+    explicit SimClock(double step_s = 0.25, int max_backlog = 8)
+        : step_s_(step_s > 0.0 ? step_s : 0.25), max_backlog_(max_backlog > 0 ? max_backlog : 1) {}
+
+    /** @brief Zera tempo simulado e acúmulo (mantém velocidade e pausa). */
+    void reset() { sim_time_ = 0.0; acc_ = 0.0; single_step_ = false; }
+
+    /** @brief Seleciona o nível de velocidade `i` (limitado a `kSpeeds`). */
+    void setSpeedIndex(int i) {
+        speed_idx_ = i < 0 ? 0 : (i >= kSpeedCount ? kSpeedCount - 1 : i);
+        acc_ = 0.0;
+    }
+    /** @brief Próximo nível de velocidade. */
+    void faster() { setSpeedIndex(speed_idx_ + 1); }
+    /** @brief Nível de velocidade anterior. */
+    void slower() { setSpeedIndex(speed_idx_ - 1); }
+    /** @brief Índice do nível atual em `kSpeeds`. */
+    int speedIndex() const { return speed_idx_; }
+    /** @brief Multiplicador atual (0 = ilimitado). */
+    double speed() const { return kSpeeds[speed_idx_]; }
+    /** @brief true no nível ilimitado. */
+    bool unlimited() const { return speed() == 0.0; }
+
+    /** @brief Pausa/retoma; pausado, só `requestStep()` produz passos. */
+    void setPaused(bool p) { paused_ = p; if (p) acc_ = 0.0; }
+    bool paused() const { return paused_; }
+    /** @brief Pede exatamente um passo (útil com a simulação pausada). */
+    void requestStep() { single_step_ = true; }
+
+    /** @brief Acumula o tempo de parede de um quadro, escalado pela velocidade. */
+    void update(double wall_dt_s) {
+        if (paused_ || unlimited() || wall_dt_s <= 0.0) return;
+        acc_ += wall_dt_s * speed();
+        const double cap = step_s_ * max_backlog_;
+        if (acc_ > cap) acc_ = cap;
+    }
+
+    /**
+     * @brief Consome um passo se houver um devido; avança `simTime()` ao consumir.
+     * @return true se o chamador deve executar um passo agora
+     */
+    bool shouldStep() {
+        if (single_step_) { single_step_ = false; sim_time_ += step_s_; return true; }
+        if (paused_) return false;
+        if (unlimited()) { sim_time_ += step_s_; return true; }
+        if (acc_ < step_s_) return false;
+        acc_ -= step_s_;
+        sim_time_ += step_s_;
+        return true;
+    }
+
+    /** @brief Fração [0,1) do próximo passo já acumulada (0 se pausado ou ilimitado). */
+    double alpha() const {
+        if (paused_ || unlimited()) return 0.0;
+        const double a = acc_ / step_s_;
+        return a < 0.0 ? 0.0 : (a >= 1.0 ? 0.999 : a);
+    }
+
+    /** @brief Tempo simulado desde `reset()` (segundos). */
+    double simTime() const { return sim_time_; }
+    /** @brief Duração simulada de um passo (segundos). */
+    double stepSeconds() const { return step_s_; }
+
+private:
+    double step_s_;
+    int max_backlog_;
+    int speed_idx_{kNormalSpeed};
+    bool paused_{false};
+    bool single_step_{false};
+    double acc_{0.0};      ///< Tempo simulado acumulado ainda não consumido
+    double sim_time_{0.0}; ///< Tempo simulado consumido em passos
+};
+
+} // namespace maze
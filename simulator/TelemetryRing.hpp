@@ -0,0 +1,357 @@
+/**
+ * @file simulator/TelemetryRing.hpp
+ * @brief Anel de telemetria em memória compartilhada POSIX (`/dev/shm`): o lote headless escreve
+ *        um registro por passo sem nunca esperar; um visualizador separado lê quando quiser (sem SDL).
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+/** @brief 1 quando a plataforma tem `shm_open`/`mmap` (telemetria disponível). */
+#  define MAZE_HAVE_SHM_TELEMETRY 1
+#else
+#  define MAZE_HAVE_SHM_TELEMETRY 0
+#endif
+
+namespace maze {
+
+/** @brief Nome padrão do segmento (`/dev/shm/maze_telemetry` no Linux). */
+inline constexpr const char* kTelemetryName = "/maze_telemetry";
+
+/** @brief Um passo de um agente num episódio. */
+struct TelemetryRecord {
+    /** @brief Bits de `flags`. */
+    enum Flag : uint8_t { kGoal = 1, kGaveUp = 2 };
+    uint32_t episode{0};   ///< Id do episódio (`TelemetryEpisode::id`)
+    uint32_t step{0};      ///< Índice do passo no episódio
+    int16_t x{0}, y{0};    ///< Célula depois do passo
+    uint8_t heading{0};    ///< Orientação depois do passo (0=N,1=E,2=S,3=W)
+    uint8_t action{0};     ///< `Action` decidida
+    uint8_t flags{0};      ///< `kGoal` no passo que chega ao objetivo, `kGaveUp` no limite de passos
+    uint8_t agent{0};      ///< Agente/modo de decisão
+    uint16_t plan_len{0};  ///< Movimentos do plano do navegador (0 = sem plano)
+    uint16_t reserved{0};
+    uint32_t decide_us{0}; ///< Tempo de observação + planejamento + decisão do passo
+    uint32_t t_us{0};      ///< Tempo de decisão acumulado no episódio
+};
+
+/** @brief Descrição de um episódio, publicada uma vez no início. */
+struct TelemetryEpisode {
+    uint32_t id{0};        ///< Atribuído por `TelemetryWriter::beginEpisode()`
+    uint8_t agent{0};      ///< Agente/modo de decisão
+    uint8_t heading{0};    ///< Orientação na entrada
+    int16_t width{0}, height{0};
+    int16_t entrance_x{0}, entrance_y{0}, goal_x{0}, goal_y{0};
+    char agent_name[16]{}; ///< Ex.: "planned", "mcts"
+    char maze[96]{};       ///< Caminho do arquivo `.maze` (o visualizador carrega as paredes dele)
+
+    void setAgentName(const std::string& s) { std::strncpy(agent_name, s.c_str(), sizeof(agent_name) - 1); }
+    void setMaze(const std::string& s) { std::strncpy(maze, s.c_str(), sizeof(maze) - 1); }
+};
+
+namespace telemetry_detail {
+
+/**
+ * @brief Entrada com seqlock: `seq` par = publicada (2n+2 para o item n), ímpar = sendo escrita.
+ *
+ * O conteúdo vive em palavras atômicas (acesso relaxado) para que a leitura
+ * concorrente com a escrita seja bem definida; o leitor descarta a cópia se
+ * `seq` mudou durante a leitura.
+ */
+template <class T>
+struct SeqSlot {
+    static constexpr size_t kWords = (sizeof(T) + 7) / 8;
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> words[kWords];
+
+    void store(uint64_t n, const T& v) {
+        uint64_t tmp[kWords] = {};
+        std::memcpy(tmp, &v, sizeof(T));
+        seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) words[i].store(tmp[i], std::memory_order_relaxed);
+        seq.store(2 * n + 2, std::memory_order_release);
+    }
+    /** @return false se o item `n` ainda não foi publicado ou foi sobrescrito */
+    bool load(uint64_t n, T& out) const {
+        const uint64_t s1 = seq.load(std::memory_order_acquire);
+        if (s1 != 2 * n + 2) return false;
+        uint64_t tmp[kWords];
+        for (size_t i = 0; i < kWords; ++i) tmp[i] = words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) != s1) return false;
+        std::memcpy(&out, tmp, sizeof(T));
+        return true;
+    }
+};
+
+/** @brief Início do segmento; os dois vetores de `SeqSlot` vêm logo depois. */
+struct Header {
+    static constexpr uint32_t kMagic = 0x4D5A544Cu; // 'MZTL'
+    static constexpr uint32_t kVersion = 1;
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;         ///< Registros no anel (potência de 2)
+    uint32_t episode_capacity; ///< Episódios guardados (potência de 2)
+    std::atomic<uint64_t> head;     ///< Registros publicados
+    std::atomic<uint64_t> episodes; ///< Episódios publicados
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "a telemetria exige atômicos de 64 bits sem trava");
+
+inline size_t records_offset() { return (sizeof(Header) + 63) & ~size_t(63); }
+inline size_t episodes_offset(uint32_t capacity) {
+    return records_offset() + sizeof(SeqSlot<TelemetryRecord>) * capacity;
+}
+inline size_t segment_size(uint32_t capacity, uint32_t episode_capacity) {
+    return episodes_offset(capacity) + sizeof(SeqSlot<TelemetryEpisode>) * episode_capacity;
+}
+inline uint32_t round_pow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v && p < (1u << 30)) p <<= 1;
+    return p;
+}
+
+} // namespace telemetry_detail
+
+/**
+ * @brief Produtor único do anel: cria o segmento e publica registros sem nunca bloquear.
+ *
+ * `push()` é um punhado de stores atômicos numa posição fixa: não há trava,
+ * espera nem chamada ao sistema. O anel sobrescreve os registros mais
+ * antigos; um leitor lento ou ausente só perde registros (e fica sabendo
+ * quantos), nunca atrasa o produtor. `open()` só cria o segmento se ele
+ * ainda não existe (dois lotes no mesmo host não tomam o anel um do outro);
+ * substituir um segmento existente é pedido explícito. O segmento fica em
+ * `/dev/shm` depois que o produtor termina, para o visualizador ainda
+ * inspecionar o fim do lote (`rm /dev/shm/maze_telemetry` o remove).
+ */
+class TelemetryWriter {
+public:
+    TelemetryWriter() = default;
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+    ~TelemetryWriter() { close(); }
+
+    /**
+     * @brief Cria o segmento `name`.
+     * @param capacity registros no anel (arredondado para potência de 2)
+     * @param episode_capacity episódios descritos (arredondado para potência de 2)
+     * @param replace remove antes um segmento `name` existente (de outro produtor, vivo ou não)
+     * @return false se a plataforma não tem memória compartilhada POSIX, se o segmento já
+     *         existe e `replace` é false (`errno == EEXIST`) ou se a criação falhou
+     */
+    bool open(const std::string& name = kTelemetryName, uint32_t capacity = 1u << 16, uint32_t episode_capacity = 256,
+              bool replace = false) {
+        close();
+#if MAZE_HAVE_SHM_TELEMETRY
+        using namespace telemetry_detail;
+        const uint32_t cap = round_pow2(capacity ? capacity : 1), ecap = round_pow2(episode_capacity ? episode_capacity : 1);
+        const size_t size = segment_size(cap, ecap);
+        if (replace) ::shm_unlink(name.c_str()); // leitores antigos mantêm o mapeamento velho até reconectar
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) { ::close(fd); ::shm_unlink(name.c_str()); return false; }
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) { ::shm_unlink(name.c_str()); return false; }
+        // ftruncate zera o segmento: seq = 0 em todas as entradas (nada publicado)
+        base_ = static_cast<uint8_t*>(p);
+        size_ = size;
+        hdr_ = new (base_) Header{Header::kMagic, Header::kVersion, cap, ecap, {0}, {0}};
+        records_ = reinterpret_cast<SeqSlot<TelemetryRecord>*>(base_ + records_offset());
+        episodes_ = reinterpret_cast<SeqSlot<TelemetryEpisode>*>(base_ + episodes_offset(cap));
+        head_ = 0;
+        next_episode_ = 0;
+        return true;
+#else
+        (void)name; (void)capacity; (void)episode_capacity; (void)replace;
+        return false;
+#endif
+    }
+    bool isOpen() const { return hdr_ != nullptr; }
+
+    /** @brief Publica a descrição de um episódio; os registros dele levam o id devolvido. */
+    uint32_t beginEpisode(TelemetryEpisode info) {
+        const uint32_t id = static_cast<uint32_t>(next_episode_);
+        if (!hdr_) return id;
+        info.id = id;
+        episodes_[next_episode_ & (hdr_->episode_capacity - 1)].store(next_episode_, info);
+        ++next_episode_;
+        hdr_->episodes.store(next_episode_, std::memory_order_release);
+        return id;
+    }
+
+    /** @brief Publica um registro (sem espera; sobrescreve o mais antigo quando o anel está cheio). */
+    void push(const TelemetryRecord& r) {
+        if (!hdr_) return;
+        records_[head_ & (hdr_->capacity - 1)].store(head_, r);
+        ++head_;
+        hdr_->head.store(head_, std::memory_order_release);
+    }
+
+    /** @brief Registros publicados desde `open()`. */
+    uint64_t published() const { return head_; }
+
+    void close() {
+#if MAZE_HAVE_SHM_TELEMETRY
+        if (base_) ::munmap(base_, size_);
+#endif
+        base_ = nullptr;
+        hdr_ = nullptr;
+        records_ = nullptr;
+        episodes_ = nullptr;
+    }
+
+private:
+    uint8_t* base_{nullptr};
+    size_t size_{0};
+    telemetry_detail::Header* hdr_{nullptr};
+    telemetry_detail::SeqSlot<TelemetryRecord>* records_{nullptr};
+    telemetry_detail::SeqSlot<TelemetryEpisode>* episodes_{nullptr};
+    uint64_t head_{0};         ///< Cópia local de `hdr_->head` (só o produtor escreve)
+    uint64_t next_episode_{0};
+};
+
+/**
+ * @brief Leitor do anel (outro processo ou thread); nunca escreve no segmento.
+ *
+ * `poll()` entrega em ordem os registros publicados desde a última chamada.
+ * Se o produtor deu a volta no anel, pula para os mais antigos ainda
+ * presentes e soma os perdidos em `lost()`.
+ */
+class TelemetryReader {
+public:
+    TelemetryReader() = default;
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+    ~TelemetryReader() { detach(); }
+
+    /**
+     * @brief Mapeia (só leitura) o segmento `name` criado por um `TelemetryWriter`.
+     * @param from_start true = começa pelos registros mais antigos ainda no anel; false = só os novos
+     * @return false se o segmento não existe ou não é um anel de telemetria
+     */
+    bool attach(const std::string& name = kTelemetryName, bool from_start = true) {
+        detach();
+#if MAZE_HAVE_SHM_TELEMETRY
+        using namespace telemetry_detail;
+        const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) { ::close(fd); return false; }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        const auto* h = static_cast<const Header*>(p);
+        if (h->magic != Header::kMagic || h->version != Header::kVersion ||
+            size < segment_size(h->capacity, h->episode_capacity)) {
+            ::munmap(p, size);
+            return false;
+        }
+        base_ = static_cast<const uint8_t*>(p);
+        size_ = size;
+        ino_ = static_cast<uint64_t>(st.st_ino);
+        name_ = name;
+        hdr_ = h;
+        records_ = reinterpret_cast<const SeqSlot<TelemetryRecord>*>(base_ + records_offset());
+        episodes_ = reinterpret_cast<const SeqSlot<TelemetryEpisode>*>(base_ + episodes_offset(h->capacity));
+        const uint64_t head = hdr_->head.load(std::memory_order_acquire);
+        next_ = from_start ? (head > hdr_->capacity ? head - hdr_->capacity : 0) : head;
+        lost_ = 0;
+        return true;
+#else
+        (void)name; (void)from_start;
+        return false;
+#endif
+    }
+    bool attached() const { return hdr_ != nullptr; }
+
+    /**
+     * @brief true se o produtor recriou o segmento desde o `attach()` (o mapeamento atual não muda mais).
+     *
+     * Faz uma chamada ao sistema: chame de tempos em tempos, não a cada quadro.
+     */
+    bool replaced() const {
+#if MAZE_HAVE_SHM_TELEMETRY
+        if (!hdr_) return false;
+        const int fd = ::shm_open(name_.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st{};
+        const bool changed = ::fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_ino) != ino_;
+        ::close(fd);
+        return changed;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Entrega a `fn(const TelemetryRecord&)` os registros novos, em ordem.
+     * @param max_records limite por chamada (o restante fica para a próxima)
+     * @return registros entregues
+     */
+    template <class Fn>
+    size_t poll(Fn&& fn, size_t max_records = SIZE_MAX) {
+        if (!hdr_) return 0;
+        const uint64_t head = hdr_->head.load(std::memory_order_acquire);
+        const uint32_t cap = hdr_->capacity;
+        size_t n = 0;
+        TelemetryRecord r;
+        while (next_ < head && n < max_records) {
+            if (head - next_ > cap) { // o produtor deu a volta: pula os sobrescritos
+                lost_ += head - next_ - cap;
+                next_ = head - cap;
+            }
+            if (records_[next_ & (cap - 1)].load(next_, r)) { fn(static_cast<const TelemetryRecord&>(r)); ++n; }
+            else lost_++; // sobrescrito durante a leitura
+            ++next_;
+        }
+        return n;
+    }
+
+    /** @brief Registros que o produtor sobrescreveu antes de serem lidos. */
+    uint64_t lost() const { return lost_; }
+    /** @brief Registros publicados até agora (lado do produtor). */
+    uint64_t published() const { return hdr_ ? hdr_->head.load(std::memory_order_acquire) : 0; }
+    /** @brief Episódios publicados até agora (ids `0..episodeCount()-1`). */
+    uint64_t episodeCount() const { return hdr_ ? hdr_->episodes.load(std::memory_order_acquire) : 0; }
+    /** @brief Descrição do episódio `id`; false se ainda não publicado ou já substituído na tabela. */
+    bool episode(uint32_t id, TelemetryEpisode& out) const {
+        if (!hdr_ || id >= episodeCount()) return false;
+        return episodes_[id & (hdr_->episode_capacity - 1)].load(id, out);
+    }
+
+    void detach() {
+#if MAZE_HAVE_SHM_TELEMETRY
+        if (base_) ::munmap(const_cast<uint8_t*>(base_), size_);
+#endif
+        base_ = nullptr;
+        hdr_ = nullptr;
+        records_ = nullptr;
+        episodes_ = nullptr;
+    }
+
+private:
+    const uint8_t* base_{nullptr};
+    size_t size_{0};
+    uint64_t ino_{0};
+    std::string name_;
+    const telemetry_detail::Header* hdr_{nullptr};
+    const telemetry_detail::SeqSlot<TelemetryRecord>* records_{nullptr};
+    const telemetry_detail::SeqSlot<TelemetryEpisode>* episodes_{nullptr};
+    uint64_t next_{0}; ///< Próximo registro a ler
+    uint64_t lost_{0};
+};
+
+} // namespace maze
@@ -0,0 +1,61 @@
+/**
+ * @file simulator/TripleBuffer.hpp
+ * @brief Buffer triplo sem trava: um escritor publica estados completos, um leitor pega sempre o mais recente (sem SDL).
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace maze {
+
+/**
+ * @brief Troca de estados entre exatamente uma thread escritora e uma leitora, sem mutex.
+ *
+ * Há três cópias de `T`: a do escritor (`back()`), a do leitor (`front()`) e
+ * uma intermediária. `publish()` troca a cópia do escritor pela intermediária
+ * e marca-a como nova; `update()` troca a do leitor pela intermediária se
+ * houver algo novo. Cada troca é um único `exchange` atômico, então nenhuma
+ * das threads espera a outra e o leitor nunca vê um estado pela metade:
+ * estados publicados entre duas leituras são simplesmente pulados.
+ *
+ * Depois de `publish()`, `back()` é uma cópia antiga (de duas publicações
+ * atrás ou o valor inicial): o escritor deve reescrever tudo o que o leitor
+ * usa, podendo aproveitar a capacidade já alocada dos contêineres.
+ */
+template <class T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /** @brief Cópia do escritor (só a thread escritora). */
+    T& back() { return slots_[back_]; }
+    /** @brief Entrega `back()` ao leitor; o escritor recebe outra cópia. */
+    void publish() {
+        back_ = static_cast<uint8_t>(mid_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndex);
+    }
+
+    /**
+     * @brief Passa a ler o último estado publicado (só a thread leitora).
+     * @return false se nada foi publicado desde a última chamada (`front()` não muda)
+     */
+    bool update() {
+        if (!(mid_.load(std::memory_order_relaxed) & kFresh)) return false;
+        front_ = static_cast<uint8_t>(mid_.exchange(front_, std::memory_order_acq_rel) & kIndex);
+        return true;
+    }
+    /** @brief Cópia do leitor: o estado obtido no último `update()` com sucesso. */
+    const T& front() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t kIndex = 0x3; ///< Bits do índice da cópia intermediária
+    static constexpr uint8_t kFresh = 0x4; ///< Intermediária ainda não lida
+
+    T slots_[3]{};
+    uint8_t front_{0};             ///< Só o leitor
+    uint8_t back_{2};              ///< Só o escritor
+    std::atomic<uint8_t> mid_{1};  ///< Índice da intermediária | kFresh
+};
+
+} // namespace maze
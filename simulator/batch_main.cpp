@@ -0,0 +1,539 @@
+/**
+ * @file simulator/batch_main.cpp
+ * @brief Ferramenta headless (sem SDL2) para processar o corpus de labirintos em lote.
+ *
+ * Subcomandos:
+ * - `analyze [dir]`: roda `maze::MazeAnalyzer` sobre cada arquivo `.maze` de `dir` (padrão `maze/`)
+ *   e imprime uma linha CSV por labirinto, com a classe usada para estratificar
+ *   benchmarks (`perfect` sem laços, `braided` com laços, `open` quando quase
+ *   não há becos).
+ * - `navigate [dir] [budget_us]`: executa um episódio de exploração por modo de
+ *   decisão (`planned`, `rollout`, `mcts`, `sliced`) em cada labirinto e imprime os passos
+ *   até o objetivo (`sliced` = `decidePlanned` com o ARA* fatiado de `planSliced`,
+ *   256 unidades por passo, o padrão de `-DPLAN_BUDGET`). O prior de parede do MCTS é a densidade média de paredes do
+ *   corpus; `budget_us` é o orçamento por decisão (padrão 2000).
+ * - `--telemetry[=nome]` (com `navigate`): publica cada passo no anel de telemetria em
+ *   memória compartilhada (`/dev/shm/maze_telemetry` por padrão, ver `TelemetryRing.hpp`)
+ *   para acompanhar ao vivo com `simulator --view`; o lote nunca espera pelo visualizador.
+ *   Falha se o segmento já existe (outro lote ou um lote anterior); `--telemetry-replace`
+ *   o substitui.
+ * - `--checkpoint[=arquivo]` (com `navigate`; padrão `navigate.ckpt`): grava cada unidade
+ *   concluída (labirinto, semente, configuração) com seu resultado em `CheckpointLog`; rodar de
+ *   novo com o mesmo arquivo pula o que já foi feito e imprime o mesmo relatório.
+ * - `--shard-dir=D` (com `navigate`): em vez de rodar tudo, vira um trabalhador que reivindica
+ *   shards de unidades em `D` (`ShardQueue`, pode ser NFS) e grava `D/results/shard-N.ckpt`;
+ *   vários processos e máquinas dividem o corpus só pelo diretório. `--worker=nome`,
+ *   `--shard-units=N` (16) e `--stale=s` (600, batimento para retomar shard abandonado).
+ * - `merge [dir] [budget_us] --shard-dir=D`: junta os resultados e imprime o relatório de
+ *   `navigate`, idêntico ao de um único processo com os mesmos valores por unidade.
+ *
+ * Como executar:
+ * - Habilite `-DBUILD_SIM=ON` no CMake (não requer SDL2).
+ * - `./maze_batch analyze maze > corpus.csv`
+ * - `./maze_batch navigate maze 2000 > navigate.csv`
+ * - `./maze_batch navigate maze 2000 --telemetry > navigate.csv` e, em outro terminal, `./simulator --view`
+ * - `./maze_batch navigate maze 2000 --checkpoint=sweep.ckpt > navigate.csv` (interrompido, o mesmo comando retoma)
+ * - Em cada máquina: `./maze_batch navigate maze 2000 --shard-dir=/nfs/sweep`; depois
+ *   `./maze_batch merge maze 2000 --shard-dir=/nfs/sweep > navigate.csv`
+ */
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+#include "core/MazeMap.hpp"
+#include "core/MazeAnalyzer.hpp"
+#include "core/Navigator.hpp"
+#include "core/Arena.hpp"
+#include "MazeIO.hpp"
+#include "TelemetryRing.hpp"
+#include "CheckpointLog.hpp"
+#include "ShardQueue.hpp"
+
+using namespace maze;
+
+/**
+ * @brief Classe estrutural do labirinto para estratificação.
+ */
+static const char* maze_class(const MazeStats& st) {
+    const int cells = st.width * st.height;
+    if (st.loops == 0) return "perfect";
+    if (st.dead_ends * 20 < cells) return "open";
+    return "braided";
+}
+
+/**
+ * @brief Analisa todos os `.maze` de `dir` e imprime CSV em stdout.
+ * @return código de saída do processo
+ */
+static int cmd_analyze(const std::string& dir) {
+    auto files = list_maze_files(dir);
+    std::printf("file,width,height,dead_ends,corridors,curves,t_junctions,crossroads,components,loops,"
+                "shortest_path,optimal_turns,longest_path,branching_factor,class\n");
+    double total_us = 0.0;
+    for (const auto& f : files) {
+        MazeMap m(1,1);
+        Point entrance{}, goal{};
+        uint8_t heading = 1;
+        if (!load_maze_json(f, m, entrance, goal, heading)) {
+            std::fprintf(stderr, "Falha ao carregar %s\n", f.string().c_str());
+            continue;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        MazeStats st = MazeAnalyzer::analyze(m, entrance, goal);
+        auto t1 = std::chrono::steady_clock::now();
+        total_us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        std::printf("%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.3f,%s\n",
+                    f.filename().string().c_str(), st.width, st.height, st.dead_ends, st.corridors, st.curves,
+                    st.t_junctions, st.crossroads, st.components, st.loops, st.shortest_path, st.optimal_turns,
+                    st.longest_path, st.branching_factor, maze_class(st));
+    }
+    std::fprintf(stderr, "%zu labirintos analisados em %.1f us\n", files.size(), total_us);
+    return 0;
+}
+
+/** @brief Leitura de sensores na célula `cell` com orientação `heading` sobre o mapa real. */
+static SensorRead sense(const MazeMap& m, Point cell, uint8_t heading) {
+    SensorRead sr{};
+    const Dir h = from_heading(heading);
+    sr.left_free  = !m.has_wall(cell.x, cell.y, rel_to_abs(h, Action::Left));
+    sr.front_free = !m.has_wall(cell.x, cell.y, h);
+    sr.right_free = !m.has_wall(cell.x, cell.y, rel_to_abs(h, Action::Right));
+    return sr;
+}
+
+/** @brief Unidades de trabalho do ARA* por passo no modo `sliced` (o padrão de `-DPLAN_BUDGET`). */
+static constexpr uint32_t kSliceBudget = 256;
+
+/**
+ * @brief Um episódio de exploração da entrada ao objetivo com o modo de decisão `mode`.
+ * @param mode 0 = `decidePlanned`, 1 = `decideRollout`, 2 = `decideMcts`, 3 = `decidePlanned` com `planSliced`
+ * @param arena arena do episódio (o navegador aloca dela; liberada ao final)
+ * @param[out] us tempo total de decisão em microssegundos
+ * @param[out] plans contadores de `planIfInvalid()`/`planSliced()` do episódio
+ * @param tel anel de telemetria (nullptr = desligado); `tel_episode` é o id do episódio nele
+ * @return passos (avanços + giros) ou -1 se o limite de passos foi atingido
+ */
+static int run_episode(const MazeMap& m, Point entrance, Point goal, uint8_t heading, int mode,
+                       const MctsConfig& mcfg, EpisodeArena& arena, double& us, PlanStats& plans,
+                       TelemetryWriter* tel = nullptr, uint32_t tel_episode = 0) {
+    struct Release { EpisodeArena& a; ~Release() { a.reset(); } } release{arena}; // após destruir `nav`
+    Navigator nav(arena.resource());
+    nav.setMapDimensions(m.width(), m.height());
+    nav.setStartGoal(entrance, goal);
+    Point cell = entrance;
+    const int limit = m.width() * m.height() * 20;
+    us = 0.0;
+    plans = PlanStats{};
+    for (int steps = 0; steps < limit; ++steps) {
+        if (cell.x == goal.x && cell.y == goal.y) return steps;
+        const SensorRead sr = sense(m, cell, heading);
+        auto t0 = std::chrono::steady_clock::now();
+        nav.observeCellWalls(cell, sr, heading);
+        if (mode == 3) nav.planSliced(kSliceBudget);
+        else           nav.planIfInvalid();
+        plans = nav.planStats();
+        Decision d;
+        if (mode == 0 || mode == 3) d = nav.decidePlanned(cell, heading, sr);
+        else if (mode == 1)         d = nav.decideRollout(cell, heading, sr);
+        else                        d = nav.decideMcts(cell, heading, sr, mcfg);
+        auto t1 = std::chrono::steady_clock::now();
+        const double step_us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        us += step_us;
+        const Dir h = from_heading(heading);
+        if (d.action == Action::Forward) {
+            const Point next = step(cell, h);
+            if (!m.has_wall(cell.x, cell.y, h) && m.in_bounds(next.x, next.y)) cell = next;
+        } else {
+            heading = idx(rel_to_abs(h, d.action));
+        }
+        if (tel) {
+            TelemetryRecord r;
+            r.episode = tel_episode;
+            r.step = static_cast<uint32_t>(steps);
+            r.x = static_cast<int16_t>(cell.x); r.y = static_cast<int16_t>(cell.y);
+            r.heading = heading;
+            r.action = static_cast<uint8_t>(d.action);
+            r.agent = static_cast<uint8_t>(mode);
+            r.plan_len = static_cast<uint16_t>(std::min<size_t>(nav.currentPlan().moves(), 0xFFFFu));
+            r.decide_us = static_cast<uint32_t>(step_us);
+            r.t_us = static_cast<uint32_t>(us);
+            if (cell.x == goal.x && cell.y == goal.y) r.flags = TelemetryRecord::kGoal;
+            else if (steps + 1 == limit) r.flags = TelemetryRecord::kGaveUp;
+            tel->push(r);
+        }
+    }
+    return -1;
+}
+
+/** @brief Resultado de uma unidade de trabalho (um labirinto, um modo), como gravado no checkpoint. */
+struct UnitResult {
+    int steps{-1};          ///< Passos até o objetivo (-1 = limite)
+    double us{0.0};         ///< Tempo total de decisão
+    long requests{0};       ///< `PlanStats::requests`
+    long replans{0};        ///< `PlanStats::replans`
+    size_t arena_peak{0};   ///< Pico da arena do processo ao concluir a unidade
+
+    /** @brief Valor do checkpoint; `%.17g` faz o `double` voltar idêntico. */
+    std::string encode() const {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "%d %.17g %ld %ld %zu", steps, us, requests, replans, arena_peak);
+        return buf;
+    }
+    bool decode(const std::string& v) {
+        return std::sscanf(v.c_str(), "%d %lf %ld %ld %zu", &steps, &us, &requests, &replans, &arena_peak) == 5;
+    }
+};
+
+/** @brief Modos de decisão comparados por `navigate`, na ordem das colunas do CSV. */
+static constexpr int kModeCount = 4;
+static const char* const kModes[kModeCount] = {"planned", "rollout", "mcts", "sliced"};
+
+/**
+ * @brief Corpus de `navigate` e as unidades de trabalho (labirinto, semente, configuração).
+ *
+ * A unidade `u` é o labirinto `u / kModeCount` com o modo `u % kModeCount`, a
+ * ordem do relatório; a partição em shards e as chaves dos checkpoints só
+ * dependem do corpus e da configuração, então são as mesmas em qualquer
+ * processo ou máquina.
+ */
+struct NavCorpus {
+    struct Entry { std::string name, path, key; MazeMap map; Point entrance, goal; uint8_t heading; };
+    std::vector<Entry> mazes;
+    MctsConfig mcfg;
+    std::string mcts_cfg; ///< Configuração do MCTS na chave (orçamento e prior); os outros modos só têm o nome
+
+    size_t units() const { return mazes.size() * kModeCount; }
+    /** @brief Chave da unidade `u` nos checkpoints: `labirinto@digital|semente|configuração`. */
+    std::string key(size_t u) const {
+        const int mode = static_cast<int>(u % kModeCount);
+        return mazes[u / kModeCount].key + "|" + std::to_string(mcfg.seed) + "|" + (mode == 2 ? mcts_cfg : kModes[mode]);
+    }
+};
+
+/** @brief Carrega todos os `.maze` de `dir` e deriva a configuração (prior de parede = densidade média). */
+static NavCorpus load_corpus(const std::string& dir, uint32_t budget_us) {
+    NavCorpus c;
+    double density = 0.0;
+    for (const auto& f : list_maze_files(dir)) {
+        NavCorpus::Entry e{f.filename().string(), f.string(), {}, MazeMap(1,1), {}, {}, 1};
+        if (!load_maze_json(f, e.map, e.entrance, e.goal, e.heading)) {
+            std::fprintf(stderr, "Falha ao carregar %s\n", f.string().c_str());
+            continue;
+        }
+        // Identidade do labirinto no checkpoint: nome + impressão digital de paredes, entrada e objetivo
+        char fp[96];
+        std::snprintf(fp, sizeof(fp), "%d,%d,%d,%d,%u", e.entrance.x, e.entrance.y, e.goal.x, e.goal.y, e.heading);
+        char hex[16];
+        std::snprintf(hex, sizeof(hex), "%08x", static_cast<unsigned>(CheckpointLog::hash(e.map.to_string_ascii() + fp)));
+        e.key = e.name + "@" + hex;
+        density += MazeAnalyzer::analyze(e.map, e.entrance, e.goal).wall_density();
+        c.mazes.push_back(std::move(e));
+    }
+    c.mcfg.budget_us = budget_us;
+    if (!c.mazes.empty()) c.mcfg.wall_prior = static_cast<float>(density / static_cast<double>(c.mazes.size()));
+    char cfg[64];
+    std::snprintf(cfg, sizeof(cfg), "mcts/b%u/p%.4f", budget_us, c.mcfg.wall_prior);
+    c.mcts_cfg = cfg;
+    return c;
+}
+
+/** @brief Executa a unidade `u` (um episódio), publicando na telemetria se houver. */
+static UnitResult run_unit(const NavCorpus& c, size_t u, EpisodeArena& arena, TelemetryWriter* tel) {
+    const NavCorpus::Entry& e = c.mazes[u / kModeCount];
+    const int mode = static_cast<int>(u % kModeCount);
+    uint32_t tel_episode = 0;
+    if (tel) {
+        TelemetryEpisode info;
+        info.agent = static_cast<uint8_t>(mode);
+        info.heading = e.heading;
+        info.width = static_cast<int16_t>(e.map.width()); info.height = static_cast<int16_t>(e.map.height());
+        info.entrance_x = static_cast<int16_t>(e.entrance.x); info.entrance_y = static_cast<int16_t>(e.entrance.y);
+        info.goal_x = static_cast<int16_t>(e.goal.x); info.goal_y = static_cast<int16_t>(e.goal.y);
+        info.setAgentName(kModes[mode]);
+        info.setMaze(e.path);
+        tel_episode = tel->beginEpisode(info);
+    }
+    UnitResult r;
+    PlanStats ps;
+    r.steps = run_episode(e.map, e.entrance, e.goal, e.heading, mode, c.mcfg, arena, r.us, ps, tel, tel_episode);
+    r.requests = ps.requests;
+    r.replans = ps.replans;
+    r.arena_peak = arena.peakBytes();
+    return r;
+}
+
+/**
+ * @brief Imprime o CSV (stdout) e o resumo (stderr) de `navigate`.
+ *
+ * Única fonte do relatório: a execução direta, a retomada e o `merge` dos
+ * shards passam por aqui com os mesmos valores de unidade, então produzem o
+ * mesmo texto.
+ *
+ * @param get `bool(size_t u, UnitResult&)` com o resultado de cada unidade, na ordem
+ * @return false se `get` falhou (relatório interrompido)
+ */
+template <class Get>
+static bool print_report(const NavCorpus& c, Get&& get) {
+    long total[kModeCount] = {};
+    double total_us[kModeCount] = {};
+    int fails[kModeCount] = {};
+    long plan_requests[kModeCount] = {}, plan_runs[kModeCount] = {};
+    size_t arena_peak = 0;
+    std::printf("file,width,height,planned_steps,rollout_steps,mcts_steps,mcts_us,sliced_steps\n");
+    for (size_t m = 0; m < c.mazes.size(); ++m) {
+        const NavCorpus::Entry& e = c.mazes[m];
+        int steps[kModeCount];
+        double us[kModeCount];
+        for (int mode = 0; mode < kModeCount; ++mode) {
+            UnitResult u;
+            if (!get(m * kModeCount + static_cast<size_t>(mode), u)) return false;
+            steps[mode] = u.steps;
+            us[mode] = u.us;
+            arena_peak = std::max(arena_peak, u.arena_peak);
+            plan_requests[mode] += u.requests;
+            plan_runs[mode] += u.replans;
+            if (steps[mode] < 0) fails[mode]++;
+            else total[mode] += steps[mode];
+            total_us[mode] += us[mode];
+        }
+        std::printf("%s,%d,%d,%d,%d,%d,%.0f,%d\n", e.name.c_str(), e.map.width(), e.map.height(),
+                    steps[0], steps[1], steps[2], us[2], steps[3]);
+    }
+    std::fprintf(stderr, "%zu labirintos, prior de parede %.3f, orcamento %u us, arena %zu bytes/episodio (pico)\n",
+                 c.mazes.size(), c.mcfg.wall_prior, c.mcfg.budget_us, arena_peak);
+    for (int mode = 0; mode < kModeCount; ++mode)
+        std::fprintf(stderr, "  %-8s passos=%ld falhas=%d decisao=%.1f ms planejamentos=%ld de %ld\n",
+                     kModes[mode], total[mode], fails[mode], total_us[mode] / 1000.0, plan_runs[mode], plan_requests[mode]);
+    return true;
+}
+
+/**
+ * @brief Compara os modos de decisão em todos os `.maze` de `dir` e imprime CSV em stdout.
+ * @param budget_us orçamento por decisão do MCTS
+ * @param ckpt checkpoint aberto (nullptr = sem retomada): unidades já gravadas não são refeitas
+ * @return código de saída do processo
+ */
+static int cmd_navigate(const std::string& dir, uint32_t budget_us, TelemetryWriter* tel, CheckpointLog* ckpt) {
+    const NavCorpus c = load_corpus(dir, budget_us);
+    EpisodeArena arena;
+    size_t resumed = 0;
+    const bool ok = print_report(c, [&](size_t u, UnitResult& r) {
+        const std::string key = c.key(u);
+        const std::string* done = ckpt ? ckpt->find(key) : nullptr;
+        if (done && r.decode(*done)) { resumed++; return true; }
+        r = run_unit(c, u, arena, tel);
+        if (ckpt && !ckpt->append(key, r.encode())) {
+            std::fprintf(stderr, "Falha ao gravar o checkpoint\n");
+            return false;
+        }
+        return true;
+    });
+    if (!ok) return 1;
+    if (ckpt) std::fprintf(stderr, "checkpoint: %zu unidades retomadas, %zu novas\n", resumed, ckpt->appended());
+    if (tel) std::fprintf(stderr, "telemetria: %llu registros publicados\n", static_cast<unsigned long long>(tel->published()));
+    return 0;
+}
+
+/** @brief Opções da execução em shards (`--shard-dir` e companhia). */
+struct ShardOptions {
+    std::string dir;          ///< Diretório compartilhado (vazio = sem shards)
+    std::string worker;       ///< Nome deste processo (padrão `host-pid`)
+    uint32_t shard_units{16}; ///< Unidades por shard (faz parte do manifesto)
+    uint32_t stale_s{600};    ///< Batimento mais antigo que isso: o shard é retomado por outro
+};
+
+/** @brief Manifesto do trabalho: todo processo de um mesmo diretório precisa gerar o mesmo texto. */
+static std::string shard_manifest(const NavCorpus& c, uint32_t shard_units) {
+    uint32_t h = CheckpointLog::hash("");
+    for (size_t u = 0; u < c.units(); ++u) h = CheckpointLog::hash(c.key(u) + "\n", h);
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "maze_batch navigate v1\nunits=%zu\nshard_units=%u\nkeys=%08x\n",
+                  c.units(), shard_units, static_cast<unsigned>(h));
+    return buf;
+}
+
+/**
+ * @brief Trabalhador de uma execução em shards: reivindica shards livres em `opt.dir` e os executa.
+ *
+ * As unidades são partidas em shards contíguos de `shard_units`; cada shard
+ * grava num `CheckpointLog` próprio, então um shard interrompido é retomado
+ * de onde parou por quem o reivindicar depois. Repete as passadas enquanto
+ * conseguir algum shard; termina quando todos estão concluídos ou nas mãos de
+ * outros processos vivos. Não imprime o CSV: use `merge`.
+ */
+static int cmd_shard_worker(const std::string& dir, uint32_t budget_us, const ShardOptions& opt, TelemetryWriter* tel) {
+    const NavCorpus c = load_corpus(dir, budget_us);
+    ShardQueue q;
+    std::string err;
+    if (!q.open(opt.dir, opt.worker, shard_manifest(c, opt.shard_units), &err)) {
+        std::fprintf(stderr, "shards: %s\n", err.c_str());
+        return 1;
+    }
+    const uint32_t shards = static_cast<uint32_t>((c.units() + opt.shard_units - 1) / opt.shard_units);
+    EpisodeArena arena;
+    size_t mine = 0, ran = 0;
+    for (bool progress = true; progress;) {
+        progress = false;
+        for (uint32_t s = 0; s < shards; ++s) {
+            if (q.claim(s, opt.stale_s) != ShardQueue::Claim::Acquired) continue;
+            progress = true;
+            CheckpointLog log;
+            if (!log.open(q.resultPath(s))) {
+                std::fprintf(stderr, "shards: falha ao abrir %s\n", q.resultPath(s).string().c_str());
+                q.release(s);
+                return 1;
+            }
+            const size_t first = static_cast<size_t>(s) * opt.shard_units;
+            const size_t last = std::min(c.units(), first + opt.shard_units);
+            bool owned = true;
+            for (size_t u = first; u < last && owned; ++u) {
+                const std::string key = c.key(u);
+                if (log.find(key)) continue;
+                if (!(owned = q.heartbeat(s))) break; // tomado por outro: ele retoma o arquivo
+                if (!log.append(key, run_unit(c, u, arena, tel).encode())) {
+                    std::fprintf(stderr, "shards: falha ao gravar %s\n", q.resultPath(s).string().c_str());
+                    q.release(s);
+                    return 1;
+                }
+                ran++;
+            }
+            log.close();
+            if (owned && q.complete(s)) mine++;
+            else std::fprintf(stderr, "shards: shard %u tomado por outro processo\n", s);
+        }
+    }
+    uint32_t done = 0;
+    for (uint32_t s = 0; s < shards; ++s) done += q.isDone(s);
+    std::fprintf(stderr, "shards: %s concluiu %zu shards (%zu unidades executadas, %zu retomados de outros); %u de %u concluidos%s\n",
+                 opt.worker.c_str(), mine, ran, q.stolen(), done, shards,
+                 done == shards ? " - rode `merge` para o relatorio" : "");
+    return 0;
+}
+
+/**
+ * @brief Junta os resultados dos shards de `shard_dir` e imprime o mesmo relatório de `navigate`.
+ * @return 1 se falta alguma unidade (shards ainda em execução ou abandonados)
+ */
+static int cmd_merge(const std::string& dir, uint32_t budget_us, const ShardOptions& opt) {
+    const NavCorpus c = load_corpus(dir, budget_us);
+    ShardQueue q;
+    std::string err;
+    if (!q.open(opt.dir, opt.worker, shard_manifest(c, opt.shard_units), &err)) {
+        std::fprintf(stderr, "merge: %s\n", err.c_str());
+        return 1;
+    }
+    std::map<std::string, std::string> results;
+    for (const auto& f : q.resultFiles()) CheckpointLog::load(f, results);
+    size_t missing = 0;
+    std::string pending;
+    size_t last_shard = SIZE_MAX;
+    for (size_t u = 0; u < c.units(); ++u) {
+        if (results.count(c.key(u))) continue;
+        missing++;
+        const size_t shard = u / opt.shard_units;
+        if (shard != last_shard && pending.size() < 80) pending += " " + std::to_string(shard);
+        last_shard = shard;
+    }
+    if (missing) {
+        std::fprintf(stderr, "merge: faltam %zu de %zu unidades (shards%s)\n", missing, c.units(), pending.c_str());
+        return 1;
+    }
+    return print_report(c, [&](size_t u, UnitResult& r) { return r.decode(results[c.key(u)]); }) ? 0 : 1;
+}
+
+static void usage(const char* argv0) {
+    std::fprintf(stderr, "uso: %s analyze [dir]\n"
+                         "     %s navigate [dir] [budget_us] [--telemetry[=nome] [--telemetry-replace]] [--checkpoint[=arquivo]]\n"
+                         "     %s navigate [dir] [budget_us] --shard-dir=D [--worker=nome] [--shard-units=N] [--stale=s]\n"
+                         "     %s merge [dir] [budget_us] --shard-dir=D [--shard-units=N]\n", argv0, argv0, argv0, argv0);
+}
+
+/** @brief Nome padrão do trabalhador: `host-pid`, só com caracteres seguros para nomes de arquivo. */
+static std::string default_worker() {
+    char host[64] = "host";
+    long pid = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    if (gethostname(host, sizeof(host)) != 0) std::strcpy(host, "host");
+    host[sizeof(host) - 1] = '\0';
+    pid = static_cast<long>(getpid());
+#endif
+    std::string w = std::string(host) + "-" + std::to_string(pid);
+    for (char& ch : w)
+        if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '-' && ch != '.' && ch != '_') ch = '_';
+    return w;
+}
+
+int main(int argc, char** argv) {
+    // Opções `--...` podem vir em qualquer posição; o resto é posicional
+    std::vector<char*> args;
+    std::string telemetry, checkpoint;
+    bool telemetry_replace = false;
+    ShardOptions shard;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--shard-dir=", 12) == 0) shard.dir = argv[i] + 12;
+        else if (std::strncmp(argv[i], "--worker=", 9) == 0) shard.worker = argv[i] + 9;
+        else if (std::strncmp(argv[i], "--shard-units=", 14) == 0) shard.shard_units = static_cast<uint32_t>(std::strtoul(argv[i] + 14, nullptr, 10));
+        else if (std::strncmp(argv[i], "--stale=", 8) == 0) shard.stale_s = static_cast<uint32_t>(std::strtoul(argv[i] + 8, nullptr, 10));
+        else if (std::strcmp(argv[i], "--checkpoint") == 0) checkpoint = "navigate.ckpt";
+        else if (std::strncmp(argv[i], "--checkpoint=", 13) == 0) checkpoint = argv[i] + 13;
+        else if (std::strcmp(argv[i], "--telemetry") == 0) telemetry = kTelemetryName;
+        else if (std::strncmp(argv[i], "--telemetry=", 12) == 0) telemetry = argv[i] + 12;
+        else if (std::strcmp(argv[i], "--telemetry-replace") == 0) telemetry_replace = true;
+        else args.push_back(argv[i]);
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+    if (argc < 2) { usage(argv[0]); return 2; }
+    const std::string cmd = argv[1];
+    if (cmd == "analyze") return cmd_analyze(argc > 2 ? argv[2] : "maze");
+    const std::string dir = argc > 2 ? argv[2] : "maze";
+    const uint32_t budget_us = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 2000u;
+    if (shard.worker.empty()) shard.worker = default_worker();
+    if (shard.shard_units == 0) shard.shard_units = 1;
+    if (cmd == "merge") {
+        if (shard.dir.empty()) { usage(argv[0]); return 2; }
+        return cmd_merge(dir, budget_us, shard);
+    }
+    if (cmd == "navigate") {
+        if (!shard.dir.empty() && !checkpoint.empty()) {
+            std::fprintf(stderr, "--checkpoint e --shard-dir são exclusivos (os shards já têm checkpoint próprio)\n");
+            return 2;
+        }
+        TelemetryWriter tel;
+        if (!telemetry.empty()) {
+            if (!tel.open(telemetry, 1u << 16, 256, telemetry_replace)) {
+                if (errno == EEXIST)
+                    std::fprintf(stderr, "O anel de telemetria %s já existe (outro lote?); use --telemetry=outro_nome "
+                                         "ou --telemetry-replace\n", telemetry.c_str());
+                else
+                    std::fprintf(stderr, "Falha ao criar o anel de telemetria %s\n", telemetry.c_str());
+                return 1;
+            }
+            std::fprintf(stderr, "telemetria em %s (simulator --view para acompanhar)\n", telemetry.c_str());
+        }
+        CheckpointLog ckpt;
+        if (!checkpoint.empty()) {
+            if (!ckpt.open(checkpoint)) {
+                std::fprintf(stderr, "Falha ao abrir o checkpoint %s (existe e não é um checkpoint?)\n", checkpoint.c_str());
+                return 1;
+            }
+            if (ckpt.droppedBytes())
+                std::fprintf(stderr, "checkpoint: %llu bytes incompletos descartados do fim\n",
+                             static_cast<unsigned long long>(ckpt.droppedBytes()));
+        }
+        if (!shard.dir.empty()) return cmd_shard_worker(dir, budget_us, shard, tel.isOpen() ? &tel : nullptr);
+        return cmd_navigate(dir, budget_us, tel.isOpen() ? &tel : nullptr, ckpt.isOpen() ? &ckpt : nullptr);
+    }
+    usage(argv[0]);
+    return 2;
+}
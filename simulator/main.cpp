@@ -15,6 +15,32 @@
  * - ESC: sair
  * - Espaço: pausar/continuar
  * - R: resetar agente/tempo
+ * - `+`/`-`: velocidade da simulação (0,1x .. 100x, ilimitada); `1`: volta a 1x
+ * - `.`: executa um único passo (útil pausado)
+ * - Roda do mouse / PageUp / PageDown: zoom (no cursor / no centro)
+ * - Botão direito ou do meio arrastando, setas: mover a vista; F: enquadrar o labirinto
+ * - K: sobrepõe as paredes já observadas pelo `Navigator` (mapa aprendido)
+ *
+ * `--verbose` imprime no stdout a posição, o rumo e a ação de cada passo
+ * (desligado por padrão: em velocidade ilimitada o terminal limitaria a taxa).
+ *
+ * Com `--view[=nome]` a janela não simula: anexa ao anel de telemetria em
+ * memória compartilhada de um `maze_batch navigate --telemetry` em execução
+ * (`TelemetryRing.hpp`) e mostra o episódio escolhido com `[`/`]` (L segue o
+ * mais recente).
+ *
+ * A vista usa uma câmera (`maze::Camera`) e desenha só as células visíveis;
+ * com menos de `kLodCellPx` pixels por célula o labirinto vira uma textura
+ * (um pixel por célula e por parede), o que mantém labirintos 512x512 fluidos.
+ *
+ * A simulação avança em passos fixos de tempo simulado (`maze::SimClock`),
+ * desacoplados da renderização; o tempo exibido e o `time_s` do `.soluct`
+ * são tempo do robô, não tempo de janela.
+ *
+ * Observação, planejamento e decisão rodam numa thread própria (`SimWorker`),
+ * que publica um `SimSnapshot` por lote de passos num `maze::TripleBuffer`;
+ * o laço de renderização só desenha o último e envia comandos, então mantém a
+ * taxa da tela mesmo em labirintos grandes ou na velocidade ilimitada.
  *
  * @since 0.1
  */
@@ -24,8 +50,16 @@
 #endif
 #include <cstdint>
 #include <cstdio>
+#include <cmath>
 #include <random>
 #include <vector>
+#include <memory_resource>
+#include <memory>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <algorithm>
 #include <string>
 #include <filesystem>
@@ -35,9 +69,20 @@
 #include <iostream>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include "core/MazeMap.hpp"
 #include "core/Navigator.hpp"
+#include "core/PathCode.hpp"
+#include "core/MazeAnalyzer.hpp"
+#include "core/Arena.hpp"
+#include "core/MapSnapshot.hpp"
+#include "MazeIO.hpp"
+#include "SimClock.hpp"
+#include "Camera.hpp"
+#include "AsyncWriter.hpp"
+#include "TripleBuffer.hpp"
+#include "TelemetryRing.hpp"
 
 using namespace maze;
 namespace fs = std::filesystem;
@@ -250,23 +295,7 @@ static bool save_maze_json(const fs::path& file, const MazeMap& m, Point entranc
     return true;
 }
 
-// --- Solution JSON helpers (versioned per map file) ---
-static fs::path make_solution_path(const fs::path& mapFile, int index) {
-    fs::path dir = mapFile.parent_path();
-    std::string stem = mapFile.stem().string();
-    std::ostringstream oss;
-    oss << stem << "_solution_" << index << ".soluct";
-    return dir / oss.str();
-}
-
-static bool read_text_file(const fs::path& p, std::string& out) {
-    std::ifstream ifs(p);
-    if (!ifs) return false;
-    std::ostringstream ss; ss << ifs.rdbuf();
-    out = ss.str();
-    return true;
-}
-
+// --- Solution JSON helpers (versioned per map file: <mapa>_solution_<n>.soluct, gravado pelo AsyncWriter) ---
 static std::string build_solution_json(const fs::path& mapFile, int W, int H, Point entrance, Point goal, uint8_t heading,
                                        const std::vector<Point>& path, int steps, int collisions, float time_s, int cost,
                                        const MetaInfo& meta) {
@@ -282,6 +311,11 @@ static std::string build_solution_json(const fs::path& mapFile, int W, int H, Po
     ofs << "    \"time_s\": " << std::fixed << std::setprecision(2) << time_s << ",\n";
     ofs << "    \"cost\": " << cost << "\n";
     ofs << "  },\n";
+    // Forma compacta (start + movimentos run-length); "path" é mantido para leitores antigos
+    if (auto code = PathCode::fromPoints(path)) {
+        ofs << "  \"path_code\": {\"start\": {\"x\": " << code->start().x << ", \"y\": " << code->start().y
+            << "}, \"moves\": " << code->moves() << ", \"rle\": \"" << code->toText() << "\"},\n";
+    }
     ofs << "  \"path\": [\n";
     for (size_t i=0; i<path.size(); ++i) {
         ofs << "    {\"x\": " << path[i].x << ", \"y\": " << path[i].y << "}";
@@ -299,55 +333,6 @@ static std::string build_solution_json(const fs::path& mapFile, int W, int H, Po
     return ofs.str();
 }
 
-static int find_latest_solution_index(const fs::path& mapFile) {
-    int best = 0;
-    fs::path dir = mapFile.parent_path();
-    std::string stem = mapFile.stem().string();
-    try {
-        if (fs::exists(dir) && fs::is_directory(dir)) {
-            for (auto& e : fs::directory_iterator(dir)) {
-                if (!e.is_regular_file()) continue;
-                auto p = e.path();
-                if (p.extension() != ".soluct") continue;
-                std::string fname = p.filename().string();
-                std::string prefix = stem + "_solution_";
-                if (fname.rfind(prefix, 0) == 0) {
-                    // extract number before .json
-                    size_t start = prefix.size();
-                    size_t end = fname.find('.');
-                    if (end != std::string::npos && end > start) {
-                        std::string num = fname.substr(start, end - start);
-                        int idx = std::atoi(num.c_str());
-                        if (idx > best) best = idx;
-                    }
-                }
-            }
-        }
-    } catch (...) {}
-    return best;
-}
-
-static fs::path save_solution_versioned(const fs::path& mapFile, const std::string& content) {
-    int latest = find_latest_solution_index(mapFile);
-    if (latest > 0) {
-        fs::path lastFile = make_solution_path(mapFile, latest);
-        std::string prev;
-        if (read_text_file(lastFile, prev)) {
-            if (prev == content) {
-                return lastFile; // unchanged; do not create new version
-            }
-        }
-    }
-    int next = latest + 1;
-    fs::path out = make_solution_path(mapFile, next);
-    std::ofstream ofs(out);
-    if (ofs) {
-        ofs << content;
-        ofs.close();
-    }
-    return out;
-}
-
 // --- Attempt plan log helpers (.plan, JSON content) ---
 struct StepLogEntry {
     Point from;
@@ -371,35 +356,42 @@ static std::string action_to_str(maze::Action a) {
     }
 }
 
-static std::string build_plan_json(const fs::path& mapFile, int W, int H, Point start, Point goal, uint8_t heading,
-                                   const std::vector<StepLogEntry>& steps, const char* result,
-                                   int total_steps, int total_collisions, double final_score, const MetaInfo& meta) {
+/**
+ * @brief Início do `.plan` (cabeçalho até a abertura de `"attempt"`), gravado no primeiro passo.
+ *
+ * O `.plan` é transmitido durante o episódio: cabeçalho, uma linha por passo
+ * (`plan_json_entry`) e, ao final, `result`/`summary`/`meta` (`plan_json_tail`).
+ */
+static std::string plan_json_head(const fs::path& mapFile, int W, int H, Point start, Point goal, uint8_t heading) {
     std::ostringstream ofs;
     ofs << "{\n";
     ofs << "  \"map_file\": \"" << escape_json(mapFile.string()) << "\",\n";
     ofs << "  \"width\": " << W << ", \"height\": " << H << ",\n";
     ofs << "  \"start\": {\"x\": " << start.x << ", \"y\": " << start.y << ", \"heading\": " << (int)heading << "},\n";
     ofs << "  \"goal\": {\"x\": " << goal.x << ", \"y\": " << goal.y << "},\n";
+    ofs << "  \"attempt\": [\n";
+    return ofs.str();
+}
+
+/** @brief Acrescenta a linha JSON de um passo a `out` (`first`: sem vírgula antes). */
+static void plan_json_entry(std::string& out, const StepLogEntry& s, bool first) {
+    char buf[320];
+    std::snprintf(buf, sizeof(buf),
+                  "%s    {\"i\": %d, \"from\": {\"x\": %d, \"y\": %d}, \"to\": {\"x\": %d, \"y\": %d}, \"heading\": %d"
+                  ", \"action\": \"%s\", \"moved\": %s, \"event\": \"%s\", \"delta_score\": %.2f, \"score_after\": %.2f"
+                  ", \"collisions\": %d }",
+                  first ? "" : ",\n", s.step_index, s.from.x, s.from.y, s.to.x, s.to.y, (int)s.heading_before,
+                  action_to_str(s.action).c_str(), s.moved ? "true" : "false", s.event ? s.event : "",
+                  s.delta_score, s.score_after, s.collisions);
+    out += buf;
+}
+
+/** @brief Fim do `.plan`: fecha `"attempt"` e grava resultado, resumo e metadados. */
+static std::string plan_json_tail(const char* result, int total_steps, int total_collisions, double final_score, const MetaInfo& meta) {
+    std::ostringstream ofs;
+    ofs << "\n  ],\n";
     ofs << "  \"result\": \"" << escape_json(result ? result : "unknown") << "\",\n";
     ofs << "  \"summary\": { \"steps\": " << total_steps << ", \"collisions\": " << total_collisions << ", \"score\": " << std::fixed << std::setprecision(2) << final_score << " },\n";
-    ofs << "  \"attempt\": [\n";
-    for (size_t i=0; i<steps.size(); ++i) {
-        const auto& s = steps[i];
-        ofs << "    {\"i\": " << s.step_index
-            << ", \"from\": {\"x\": " << s.from.x << ", \"y\": " << s.from.y << "}"
-            << ", \"to\": {\"x\": " << s.to.x << ", \"y\": " << s.to.y << "}"
-            << ", \"heading\": " << (int)s.heading_before
-            << ", \"action\": \"" << action_to_str(s.action) << "\""
-            << ", \"moved\": " << (s.moved?"true":"false")
-            << ", \"event\": \"" << (s.event? s.event: "") << "\""
-            << ", \"delta_score\": " << std::fixed << std::setprecision(2) << s.delta_score
-            << ", \"score_after\": " << std::fixed << std::setprecision(2) << s.score_after
-            << ", \"collisions\": " << s.collisions
-            << " }";
-        if (i+1<steps.size()) ofs << ",";
-        ofs << "\n";
-    }
-    ofs << "  ],\n";
     ofs << "  \"meta\": {\n";
     ofs << "    \"name\": \"" << escape_json(meta.name) << "\",\n";
     ofs << "    \"email\": \"" << escape_json(meta.email) << "\",\n";
@@ -410,126 +402,12 @@ static std::string build_plan_json(const fs::path& mapFile, int W, int H, Point
     return ofs.str();
 }
 
-static fs::path make_plan_path(const fs::path& mapFile, int index) {
-    fs::path dir = mapFile.parent_path();
-    std::string stem = mapFile.stem().string();
-    std::ostringstream oss; oss << stem << "_plan_" << index << ".plan";
-    return dir / oss.str();
-}
-
-static int find_latest_plan_index(const fs::path& mapFile) {
-    int best = 0;
-    fs::path dir = mapFile.parent_path();
-    std::string stem = mapFile.stem().string();
-    try {
-        if (fs::exists(dir) && fs::is_directory(dir)) {
-            for (auto& e : fs::directory_iterator(dir)) {
-                if (!e.is_regular_file()) continue;
-                auto p = e.path();
-                if (p.extension() != ".plan") continue;
-                std::string fname = p.filename().string();
-                std::string prefix = stem + "_plan_";
-                if (fname.rfind(prefix, 0) == 0) {
-                    size_t start = prefix.size();
-                    size_t end = fname.find('.');
-                    if (end != std::string::npos && end > start) {
-                        std::string num = fname.substr(start, end - start);
-                        int idx = std::atoi(num.c_str());
-                        if (idx > best) best = idx;
-                    }
-                }
-            }
-        }
-    } catch (...) {}
-    return best;
-}
-
-static fs::path save_plan_versioned(const fs::path& mapFile, const std::string& content) {
-    int next = find_latest_plan_index(mapFile) + 1;
-    fs::path out = make_plan_path(mapFile, next);
-    std::ofstream ofs(out);
-    if (ofs) { ofs << content; ofs.close(); }
-    return out;
-}
-
-// Parser muito simples, assume JSON bem formado vindo do nosso save
-static bool load_maze_json(const fs::path& file, MazeMap& m, Point& entrance, Point& goal, uint8_t& heading) {
-    std::ifstream ifs(file);
-    if (!ifs) return false;
-    std::stringstream buffer; buffer << ifs.rdbuf();
-    const std::string s = buffer.str();
-    auto find_int = [&](const std::string& key, int def)->int{
-        auto p = s.find("\""+key+"\""); if (p==std::string::npos) return def;
-        p = s.find(':', p); if (p==std::string::npos) return def; ++p;
-        while (p<s.size() && std::isspace((unsigned char)s[p])) ++p;
-        int val=def; std::sscanf(s.c_str()+p, "%d", &val); return val;
-    };
-    int W = find_int("width", m.width());
-    int H = find_int("height", m.height());
-    if (W!=m.width() || H!=m.height()) {
-        m = MazeMap(W,H);
-    }
-    auto find_obj_int = [&](const std::string& obj, const std::string& key, int def)->int{
-        auto p = s.find("\""+obj+"\""); if (p==std::string::npos) return def;
-        p = s.find('{' , p); if (p==std::string::npos) return def;
-        auto q = s.find('}', p); if (q==std::string::npos) q = s.size();
-        auto k = s.find("\""+key+"\"", p); if (k==std::string::npos || k>q) return def;
-        k = s.find(':', k); if (k==std::string::npos) return def; ++k;
-        while (k<s.size() && std::isspace((unsigned char)s[k])) ++k;
-        int val=def; std::sscanf(s.c_str()+k, "%d", &val); return val;
-    };
-    entrance.x = find_obj_int("entrance", "x", 0);
-    entrance.y = find_obj_int("entrance", "y", 0);
-    heading    = (uint8_t)find_obj_int("entrance", "heading", 1);
-    goal.x     = find_obj_int("goal", "x", W-1);
-    goal.y     = find_obj_int("goal", "y", H-1);
-
-    // Limpa paredes
-    for (int y=0; y<m.height(); ++y) for (int x=0; x<m.width(); ++x) {
-        m.set_wall(x,y,'N',false); m.set_wall(x,y,'E',false); m.set_wall(x,y,'S',false); m.set_wall(x,y,'W',false);
-    }
-    // Extrai array cells
-    auto pcells = s.find("\"cells\""); if (pcells==std::string::npos) return true;
-    pcells = s.find('[', pcells); if (pcells==std::string::npos) return true;
-    size_t idx = 0; // idx em ordem linha-major
-    for (size_t p = pcells; p < s.size() && idx < (size_t)(m.width()*m.height()); ) {
-        p = s.find('{', p); if (p==std::string::npos) break; auto q = s.find('}', p); if (q==std::string::npos) break;
-        auto sub = s.substr(p, q-p+1);
-        int n=0,e=0,ss=0,w=0;
-        std::sscanf(sub.c_str(), "{%*[^0-9]%d%*[^0-9]%d%*[^0-9]%d%*[^0-9]%d", &n,&e,&ss,&w);
-        int x = idx % m.width(); int y = idx / m.width();
-        if (n) m.set_wall(x,y,'N',true);
-        if (e) m.set_wall(x,y,'E',true);
-        if (ss) m.set_wall(x,y,'S',true);
-        if (w) m.set_wall(x,y,'W',true);
-        idx++;
-        p = q+1;
-    }
-    return true;
-}
-
 static void ensure_dirs() {
     try {
         fs::create_directories("maze");
     } catch (...) { /* ignore */ }
 }
 
-static std::vector<fs::path> list_maze_files() {
-    std::vector<fs::path> out;
-    try {
-        if (fs::exists("maze") && fs::is_directory("maze")) {
-            for (auto& e : fs::directory_iterator("maze")) {
-                if (e.is_regular_file()) {
-                    auto p = e.path();
-                    if (p.extension()==".maze") out.push_back(p); // only list .maze maps
-                }
-            }
-            std::sort(out.begin(), out.end());
-        }
-    } catch (...) {}
-    return out;
-}
-
 /**
  * @brief Gera um labirinto perfeito via DFS aleatório, criando entrada e saída.
  *
@@ -732,21 +610,12 @@ static void draw_sidebar(SDL_Renderer* ren, UIFont& f, const SDL_Rect& sidebar,
  * @return Estrutura `maze::SensorRead` com as flags `left_free`, `front_free`, `right_free`.
  */
 static maze::SensorRead make_sensor_read(const MazeMap& m, Point cell, uint8_t heading) {
-    // Convert absolute walls into relative free flags
+    // Paredes absolutas → flags relativas ao heading (tabelas de Direction.hpp)
     maze::SensorRead sr{};
-    const Cell& c = m.at(cell.x, cell.y);
-    auto abs_left  = (heading + 3) & 3;
-    auto abs_front = heading;
-    auto abs_right = (heading + 1) & 3;
-    // abs index 0=N,1=E,2=S,3=W
-    auto is_free = [&](int absdir){
-        switch (absdir) {
-            case 0: return !c.wall_n; case 1: return !c.wall_e; case 2: return !c.wall_s; default: return !c.wall_w;
-        }
-    };
-    sr.left_free  = is_free(abs_left);
-    sr.front_free = is_free(abs_front);
-    sr.right_free = is_free(abs_right);
+    const Dir h = from_heading(heading);
+    sr.left_free  = !m.has_wall(cell.x, cell.y, rel_to_abs(h, maze::Action::Left));
+    sr.front_free = !m.has_wall(cell.x, cell.y, h);
+    sr.right_free = !m.has_wall(cell.x, cell.y, rel_to_abs(h, maze::Action::Right));
     return sr;
 }
 
@@ -755,16 +624,11 @@ static maze::SensorRead make_sensor_read(const MazeMap& m, Point cell, uint8_t h
  *
  * @param m Mapa do labirinto.
  * @param cell Célula atual.
- * @param absdir Direção absoluta desejada ('N', 'E', 'S', 'W').
+ * @param absdir Direção absoluta desejada.
  * @return true se não houver parede nessa direção; false caso contrário.
  */
-static bool can_move(const MazeMap& m, Point cell, char absdir) {
-    const Cell& c = m.at(cell.x, cell.y);
-    if (absdir=='N') return !c.wall_n;
-    if (absdir=='E') return !c.wall_e;
-    if (absdir=='S') return !c.wall_s;
-    if (absdir=='W') return !c.wall_w;
-    return false;
+static bool can_move(const MazeMap& m, Point cell, Dir absdir) {
+    return !m.has_wall(cell.x, cell.y, absdir);
 }
 
 /**
@@ -775,65 +639,158 @@ static bool can_move(const MazeMap& m, Point cell, char absdir) {
  * @param a Ação decidida pelo `Navigator` (`Left`, `Right`, `Back`, `Forward`).
  */
 static void apply_move(Point& cell, uint8_t& heading, maze::Action a) {
-    // Update heading for Left/Right/Back, and position for Forward
-    if (a == maze::Action::Left)  heading = (heading + 3) & 3;
-    else if (a == maze::Action::Right) heading = (heading + 1) & 3;
-    else if (a == maze::Action::Back) heading = (heading + 2) & 3;
-    else {
-        // forward: move based on heading
-        if (heading==0) cell.y -= 1;
-        else if (heading==1) cell.x += 1;
-        else if (heading==2) cell.y += 1;
-        else cell.x -= 1;
-    }
+    // Giros atualizam o heading; Forward avança uma célula no heading atual
+    const Dir h = from_heading(heading);
+    if (a == maze::Action::Forward) cell = step(cell, h);
+    else heading = static_cast<uint8_t>(rel_to_abs(h, a));
+}
+
+/**
+ * @brief Desenha a grade de fundo nas células visíveis da câmera.
+ *
+ * @param ren Renderer SDL2.
+ * @param cam Câmera da vista do labirinto.
+ * @param w Número de células no eixo X.
+ * @param h Número de células no eixo Y.
+ */
+static void draw_grid(SDL_Renderer* ren, const Camera& cam, int w, int h) {
+    const Camera::CellRange r = cam.visible(w, h);
+    if (r.empty()) return;
+    SDL_SetRenderDrawColor(ren, 40, 40, 40, 255);
+    const int x0 = cam.toScreenX(r.x0), x1 = cam.toScreenX(r.x1);
+    const int y0 = cam.toScreenY(r.y0), y1 = cam.toScreenY(r.y1);
+    for (int y = r.y0; y <= r.y1; ++y) SDL_RenderDrawLine(ren, x0, cam.toScreenY(y), x1, cam.toScreenY(y));
+    for (int x = r.x0; x <= r.x1; ++x) SDL_RenderDrawLine(ren, cam.toScreenX(x), y0, cam.toScreenX(x), y1);
 }
 
 /**
  * @brief Desenha as paredes do labirinto conforme o conteúdo de `MazeMap`.
  *
+ * Só percorre as células visíveis da câmera e envia as paredes em lote
+ * (`SDL_RenderFillRects`); a espessura acompanha o zoom (3 px a 40 px/célula).
+ *
  * @param ren Renderer SDL2.
- * @param m Referência ao mapa do labirinto.
- * @param ox Offset X em pixels da origem do desenho.
- * @param oy Offset Y em pixels da origem do desenho.
- * @param cell Tamanho da célula em pixels.
- * @param thick Espessura do traço de parede (pixels). Default: 3.
+ * @param m Mapa do labirinto (`MazeMap` ou `MapVersion`).
+ * @param cam Câmera da vista do labirinto.
+ * @param color Cor das paredes.
+ * @param thick_div Divisor da espessura (paredes sobrepostas mais finas).
  */
-static void draw_maze(SDL_Renderer* ren, const MazeMap& m, int ox, int oy, int cell, int thick=3) {
-    SDL_SetRenderDrawColor(ren, 0, 200, 0, 255);
-    for (int y = 0; y < m.height(); ++y) {
-        for (int x = 0; x < m.width(); ++x) {
+template <class Map>
+static void draw_maze(SDL_Renderer* ren, const Map& m, const Camera& cam, SDL_Color color = SDL_Color{0,200,0,255}, int thick_div = 1) {
+    static std::vector<SDL_Rect> rects; // reaproveitado entre quadros
+    rects.clear();
+    const Camera::CellRange r = cam.visible(m.width(), m.height());
+    const int thick = std::max(1, static_cast<int>(std::lround(cam.cell() * 3.0 / 40.0)) / thick_div);
+    for (int y = r.y0; y < r.y1; ++y) {
+        const int y0 = cam.toScreenY(y), y1 = cam.toScreenY(y + 1);
+        for (int x = r.x0; x < r.x1; ++x) {
+            const Cell c = m.at(x,y);
+            const int x0 = cam.toScreenX(x), x1 = cam.toScreenX(x + 1);
+            if (c.wall_n) rects.push_back(SDL_Rect{ x0, y0 - thick/2, x1 - x0, thick });
+            if (c.wall_s) rects.push_back(SDL_Rect{ x0, y1 - thick/2, x1 - x0, thick });
+            if (c.wall_w) rects.push_back(SDL_Rect{ x0 - thick/2, y0, thick, y1 - y0 });
+            if (c.wall_e) rects.push_back(SDL_Rect{ x1 - thick/2, y0, thick, y1 - y0 });
+        }
+    }
+    SDL_SetRenderDrawColor(ren, color.r, color.g, color.b, color.a);
+    if (!rects.empty()) SDL_RenderFillRects(ren, rects.data(), static_cast<int>(rects.size()));
+}
+
+/** @brief Abaixo desta escala (pixels por célula) a vista usa a textura de nível de detalhe. */
+static constexpr double kLodCellPx = 6.0;
+
+/**
+ * @brief Textura de nível de detalhe: (2W+1)×(2H+1) pixels, um por célula, um por parede e um por canto.
+ *
+ * A célula (x,y) é o pixel (2x+1, 2y+1); as paredes ficam nos pixels entre
+ * células. Reconstruída só quando o mapa ou o rastro mudam e desenhada com um
+ * único `SDL_RenderCopy`, independentemente do tamanho do labirinto.
+ */
+struct LodTexture {
+    SDL_Texture* tex{nullptr};
+    int tw{0}, th{0};
+    std::vector<Uint32> px; ///< Pixels ARGB8888 (reaproveitados entre reconstruções)
+    bool dirty{true};       ///< Rastro mudou desde o último upload
+    uint64_t map_gen{0};    ///< `MazeMap::generation()` refletida nos pixels
+};
+
+static void lod_destroy(LodTexture& lod) {
+    if (lod.tex) SDL_DestroyTexture(lod.tex);
+    lod.tex = nullptr; lod.tw = lod.th = 0;
+}
+
+/**
+ * @brief Reconstrói a textura de nível de detalhe a partir do mapa e do rastro.
+ * @return false se a textura não pôde ser criada (ex.: maior que o limite do driver)
+ */
+static bool lod_update(SDL_Renderer* ren, LodTexture& lod, const MazeMap& m, const std::vector<uint8_t>& trail) {
+    const int w = m.width(), h = m.height();
+    const int tw = 2 * w + 1, th = 2 * h + 1;
+    if (!lod.tex || lod.tw != tw || lod.th != th) {
+        lod_destroy(lod);
+        lod.tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, tw, th);
+        if (!lod.tex) return false;
+        lod.tw = tw; lod.th = th; lod.dirty = true;
+    }
+    if (m.generation() != lod.map_gen) lod.dirty = true;
+    if (!lod.dirty) return true;
+    const Uint32 bg = 0xFF000000u, wall = 0xFF00C800u, green = 0xFF006E00u, yellow = 0xFF8C7800u;
+    lod.px.assign(static_cast<size_t>(tw) * th, bg);
+    auto at = [&](int tx, int ty) -> Uint32& { return lod.px[static_cast<size_t>(ty) * tw + tx]; };
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
             const Cell& c = m.at(x,y);
-            const int x0 = ox + x*cell;
-            const int y0 = oy + y*cell;
-            if (c.wall_n) { SDL_Rect r{ x0, y0 - thick/2, cell, thick }; SDL_RenderFillRect(ren, &r); }
-            if (c.wall_s) { SDL_Rect r{ x0, y0 + cell - thick/2, cell, thick }; SDL_RenderFillRect(ren, &r); }
-            if (c.wall_w) { SDL_Rect r{ x0 - thick/2, y0, thick, cell }; SDL_RenderFillRect(ren, &r); }
-            if (c.wall_e) { SDL_Rect r{ x0 + cell - thick/2, y0, thick, cell }; SDL_RenderFillRect(ren, &r); }
+            const int tx = 2 * x + 1, ty = 2 * y + 1;
+            const uint8_t t = trail[static_cast<size_t>(y) * w + x];
+            if (t) at(tx, ty) = (t == 1) ? green : yellow;
+            if (c.wall_n) at(tx, ty - 1) = wall;
+            if (c.wall_s) at(tx, ty + 1) = wall;
+            if (c.wall_w) at(tx - 1, ty) = wall;
+            if (c.wall_e) at(tx + 1, ty) = wall;
         }
     }
+    // Cantos: cor de parede se alguma parede toca o canto
+    for (int ty = 0; ty < th; ty += 2) {
+        for (int tx = 0; tx < tw; tx += 2) {
+            if ((tx > 0 && at(tx-1, ty) == wall) || (tx + 1 < tw && at(tx+1, ty) == wall) ||
+                (ty > 0 && at(tx, ty-1) == wall) || (ty + 1 < th && at(tx, ty+1) == wall)) at(tx, ty) = wall;
+        }
+    }
+    SDL_UpdateTexture(lod.tex, nullptr, lod.px.data(), tw * static_cast<int>(sizeof(Uint32)));
+    lod.dirty = false;
+    lod.map_gen = m.generation();
+    return true;
+}
+
+/** @brief Desenha a textura de nível de detalhe ocupando as W×H células da câmera. */
+static void lod_draw(SDL_Renderer* ren, const LodTexture& lod, const Camera& cam, int w, int h) {
+    const int x0 = cam.toScreenX(0), y0 = cam.toScreenY(0);
+    SDL_Rect dst{ x0, y0, std::max(1, cam.toScreenX(w) - x0), std::max(1, cam.toScreenY(h) - y0) };
+    SDL_RenderCopy(ren, lod.tex, nullptr, &dst);
 }
 
 /**
  * @brief Desenha o agente (corpo e indicação de orientação) na célula informada.
  *
+ * Em zoom baixo o corpo mantém ao menos 4 px para continuar visível.
+ *
  * @param ren Renderer SDL2.
- * @param p Posição da célula do agente.
+ * @param px Coluna do agente (fracionária durante a interpolação).
+ * @param py Linha do agente (fracionária durante a interpolação).
  * @param heading Direção absoluta (0=N,1=E,2=S,3=W).
- * @param ox Offset X em pixels.
- * @param oy Offset Y em pixels.
- * @param cell Tamanho da célula em pixels.
+ * @param cam Câmera da vista do labirinto.
  */
-static void draw_agent(SDL_Renderer* ren, Point p, int heading, int ox, int oy, int cell) {
-    // body
+static void draw_agent(SDL_Renderer* ren, float px, float py, int heading, const Camera& cam) {
+    const int cx = cam.toScreenX(px + 0.5);
+    const int cy = cam.toScreenY(py + 0.5);
+    const int half = std::max(2, static_cast<int>(cam.cell() / 4));
     SDL_SetRenderDrawColor(ren, 200, 0, 0, 255);
-    SDL_Rect body{ ox + p.x*cell + cell/4, oy + p.y*cell + cell/4, cell/2, cell/2 };
+    SDL_Rect body{ cx - half, cy - half, 2*half, 2*half };
     SDL_RenderFillRect(ren, &body);
     // heading as a small line
     SDL_SetRenderDrawColor(ren, 255, 180, 180, 255);
-    int cx = ox + p.x*cell + cell/2;
-    int cy = oy + p.y*cell + cell/2;
     int hx = cx, hy = cy;
-    const int d = cell/3;
+    const int d = std::max(3, static_cast<int>(cam.cell() / 3));
     if (heading == 0) { hy -= d; }
     else if (heading == 1) { hx += d; }
     else if (heading == 2) { hy += d; }
@@ -845,18 +802,682 @@ static void draw_agent(SDL_Renderer* ren, Point p, int heading, int ox, int oy,
  * @brief Desenha as células visitadas como retângulos translúcidos.
  */
 // trail_state: 0=none, 1=current/right path (green), 2=backtracked/wrong (yellow)
-static void draw_trail(SDL_Renderer* ren, const std::vector<uint8_t>& trail, int w, int h, int ox, int oy, int cell) {
-    SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
-    for (int y=0; y<h; ++y) {
-        for (int x=0; x<w; ++x) {
+static void draw_trail(SDL_Renderer* ren, const std::vector<uint8_t>& trail, int w, int h, const Camera& cam) {
+    static std::vector<SDL_Rect> rects[2]; // verde, amarelo (reaproveitados entre quadros)
+    rects[0].clear(); rects[1].clear();
+    const Camera::CellRange r = cam.visible(w, h);
+    const int inset = static_cast<int>(cam.cell() / 10); // 4 px a 40 px/célula
+    for (int y=r.y0; y<r.y1; ++y) {
+        const int y0 = cam.toScreenY(y), y1 = cam.toScreenY(y + 1);
+        for (int x=r.x0; x<r.x1; ++x) {
             uint8_t s = trail[y*w + x]; if (!s) continue;
-            if (s == 1) SDL_SetRenderDrawColor(ren, 0, 220, 0, 90);        // green
-            else        SDL_SetRenderDrawColor(ren, 255, 215, 0, 140);     // yellow
-            SDL_Rect r{ ox + x*cell + 4, oy + y*cell + 4, cell - 8, cell - 8 };
-            SDL_RenderFillRect(ren, &r);
+            const int x0 = cam.toScreenX(x), x1 = cam.toScreenX(x + 1);
+            rects[s == 1 ? 0 : 1].push_back(SDL_Rect{ x0 + inset, y0 + inset, x1 - x0 - 2*inset, y1 - y0 - 2*inset });
+        }
+    }
+    SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(ren, 0, 220, 0, 90);        // green
+    if (!rects[0].empty()) SDL_RenderFillRects(ren, rects[0].data(), static_cast<int>(rects[0].size()));
+    SDL_SetRenderDrawColor(ren, 255, 215, 0, 140);     // yellow
+    if (!rects[1].empty()) SDL_RenderFillRects(ren, rects[1].data(), static_cast<int>(rects[1].size()));
+}
+
+/** @brief Desenha o plano atual do `Navigator` (células visíveis) como pontos azuis. */
+static void draw_plan(SDL_Renderer* ren, const PathCode& plan, int w, int h, const Camera& cam) {
+    static std::vector<SDL_Rect> dots; // reaproveitado entre quadros
+    dots.clear();
+    const Camera::CellRange r = cam.visible(w, h);
+    const int half = std::max(1, static_cast<int>(cam.cell() / 10));
+    for (Point p : plan) {
+        if (p.x < r.x0 || p.y < r.y0 || p.x >= r.x1 || p.y >= r.y1) continue;
+        const int cx = cam.toScreenX(p.x + 0.5), cy = cam.toScreenY(p.y + 0.5);
+        dots.push_back(SDL_Rect{ cx - half, cy - half, 2*half, 2*half });
+    }
+    SDL_SetRenderDrawColor(ren, 90, 150, 255, 255);
+    if (!dots.empty()) SDL_RenderFillRects(ren, dots.data(), static_cast<int>(dots.size()));
+}
+
+/** @brief Estados do episódio (máquina de estados da UI). */
+enum class Phase { Ready, RunningExplore, RunningReplay, FinishedSuccess, FinishedFail };
+
+/**
+ * @brief Estado completo publicado pela thread de simulação e desenhado pela de renderização.
+ *
+ * Uma cópia nunca é alterada depois de publicada; o rastro e o log só são
+ * copiados quando a revisão muda.
+ */
+struct SimSnapshot {
+    std::shared_ptr<const MazeMap> map; ///< Labirinto real do episódio (nullptr antes do primeiro)
+    Point start{}, goal{};
+    Phase phase{Phase::Ready};
+    Point agent{}, agent_prev{};        ///< Pose atual e antes do último passo (interpolação)
+    uint8_t heading{0};
+    int steps{0}, collisions{0};
+    double score{0.0};
+    double time_s{0.0};                 ///< Tempo do robô (congelado no objetivo)
+    bool paused{false};
+    int speed_idx{SimClock::kNormalSpeed};
+    double alpha{0.0};                  ///< `SimClock::alpha()` no instante `wall_s`
+    double wall_s{0.0};                 ///< Relógio de parede (`wall_seconds()`) da publicação
+    double step_wall_s{0.0};            ///< Segundos de parede por passo (0: sem interpolação)
+    std::vector<uint8_t> trail;         ///< 0 nada, 1 verde (caminho atual), 2 amarelo (descartado)
+    uint64_t trail_rev{0};
+    PathCode plan;                      ///< Plano do `Navigator`
+    std::vector<LogLine> log;           ///< Últimas linhas do log lateral
+    uint64_t log_rev{0};
+};
+
+/** @brief Pedido da thread de renderização para a de simulação. */
+struct SimCommand {
+    enum Kind { StartStop, Pause, Faster, Slower, NormalSpeed, Step, Reset, NewMaze } kind{Pause};
+    std::shared_ptr<const MazeMap> map; ///< NewMaze: labirinto (não é mais alterado)
+    Point entrance{}, goal{};           ///< NewMaze
+    uint8_t heading{1};                 ///< NewMaze: heading de entrada
+    fs::path file;                      ///< NewMaze: arquivo do labirinto (versiona `.plan`/`.soluct`)
+    MetaInfo meta;                      ///< StartStop: metadados gravados no fim do episódio
+    std::string text;                   ///< NewMaze: linha de log antes das estatísticas
+    SDL_Color color{180,220,180,255};
+};
+
+/** @brief Segundos de um relógio monotônico (comum às duas threads). */
+static double wall_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** @brief `--verbose`: imprime cada decisão do `SimWorker` no stdout. */
+static bool g_verbose_steps = false;
+
+/**
+ * @brief Thread de simulação: observa, planeja e decide fora do laço de renderização.
+ *
+ * Dona do `Navigator`, do `SimClock`, do rastro, do log e do `AsyncWriter`. A
+ * renderização só envia `SimCommand` (fila com mutex, poucos por segundo) e lê
+ * o último `SimSnapshot` de um `TripleBuffer` sem trava (o mapa aprendido vem
+ * à parte, em versões de um `MapPublisher`), então um
+ * `planIfInvalid()` demorado num labirinto grande atrasa a simulação, não o
+ * quadro. Os passos são executados em lotes de até `kBatch` de trabalho; cada
+ * lote termina com uma publicação. Entre passos (velocidades finitas) a thread
+ * dorme até o próximo passo devido ou até chegar um comando.
+ */
+class SimWorker {
+public:
+    static constexpr double kBatch = 0.010;   ///< Trabalho máximo entre publicações (s)
+    static constexpr double kIdleWait = 0.05; ///< Espera máxima sem passos (resultados do `AsyncWriter`)
+    static constexpr size_t kLogTail = 64;    ///< Linhas do log copiadas em cada publicação
+
+    SimWorker() : thread_([this] { run(); }) {}
+    ~SimWorker() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+    SimWorker(const SimWorker&) = delete;
+    SimWorker& operator=(const SimWorker&) = delete;
+
+    /** @brief Enfileira um comando (thread de renderização). */
+    void post(SimCommand c) {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            cmds_.push_back(std::move(c));
+        }
+        cv_.notify_one();
+    }
+    /** @brief Estado mais recente (thread de renderização; válido até a próxima chamada). */
+    const SimSnapshot& latest() { snaps_.update(); return snaps_.front(); }
+    /** @brief Leitor das versões do mapa aprendido pelo `Navigator` (não pode sobreviver ao `SimWorker`). */
+    MapPublisher::Reader learnedReader() { return learned_.reader(); }
+
+private:
+    bool active() const { return phase_ == Phase::RunningExplore || phase_ == Phase::RunningReplay; }
+
+    void run() {
+        std::vector<SimCommand> cmds;
+        double last = wall_seconds(), wait = 0.0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                cv_.wait_for(lk, std::chrono::duration<double>(wait), [this] { return stop_ || !cmds_.empty(); });
+                if (stop_) break;
+                cmds.swap(cmds_);
+            }
+            for (SimCommand& c : cmds) apply(c);
+            cmds.clear();
+            const double now = wall_seconds();
+            clock_.setPaused(paused_);
+            clock_.update(now - last);
+            last = now;
+            while (active() && clock_.shouldStep()) {
+                step();
+                dirty_ = true;
+                // Pausa (fim de episódio) interrompe os passos; em velocidade alta, publica a cada ~kBatch
+                if (paused_ || wall_seconds() - now > kBatch) break;
+            }
+            for (const AsyncWriter::Result& r : writer_.takeResults()) {
+                if (!r.ok) { push_log("Erro ao salvar: " + r.path.string(), SDL_Color{230,160,160,255}); continue; }
+                if (r.tag == kTagSolution) push_log(std::string(r.unchanged ? "Solução inalterada: " : "Solução salva em: ") + r.path.string(), SDL_Color{180,220,180,255});
+                else if (r.tag == kTagPlanSuccess) push_log("Plano salvo em: " + r.path.string(), SDL_Color{180,220,180,255});
+                else push_log("Plano salvo (falha) em: " + r.path.string(), SDL_Color{220,200,200,255});
+            }
+            if (dirty_) {
+                learned_.publish(std::as_const(nav_).map()); // só os ladrilhos alterados no lote
+                publish();
+            }
+            // Próximo passo devido (velocidade finita), já (ilimitada) ou só comandos/resultados
+            if (active() && !paused_) {
+                wait = clock_.unlimited() ? 0.0 : (1.0 - clock_.alpha()) * clock_.stepSeconds() / clock_.speed();
+                wait = std::min(wait, kIdleWait);
+            } else {
+                wait = kIdleWait;
+            }
+        }
+    }
+
+    void publish() {
+        SimSnapshot& s = snaps_.back();
+        s.map = world_; s.start = start_; s.goal = goal_;
+        s.phase = phase_;
+        s.agent = agent_; s.agent_prev = agent_prev_; s.heading = heading_;
+        s.steps = steps_; s.collisions = collisions_; s.score = score_;
+        s.time_s = time_frozen_ ? frozen_s_ : (started_ ? (clock_.simTime() - start_s_) : 0.0);
+        s.paused = paused_;
+        s.speed_idx = clock_.speedIndex();
+        s.alpha = clock_.alpha();
+        s.wall_s = wall_seconds();
+        s.step_wall_s = (paused_ || clock_.unlimited()) ? 0.0 : clock_.stepSeconds() / clock_.speed();
+        if (s.trail_rev != trail_rev_) { s.trail = trail_; s.trail_rev = trail_rev_; }
+        s.plan = nav_.currentPlan();
+        if (s.log_rev != log_rev_) {
+            const size_t from = log_.size() > kLogTail ? log_.size() - kLogTail : 0;
+            s.log.assign(log_.begin() + static_cast<std::ptrdiff_t>(from), log_.end());
+            s.log_rev = log_rev_;
+        }
+        snaps_.publish();
+        dirty_ = false;
+    }
+
+    void push_log(const std::string& s, SDL_Color c) {
+        log_.push_back({s,c});
+        if (log_.size() > 1000) log_.erase(log_.begin(), log_.begin()+500);
+        log_rev_++; dirty_ = true;
+    }
+    // Estatísticas do labirinto (PLAN 0.0.4): recalculadas a cada carga/geração
+    void log_maze_stats() {
+        maze_stats_ = MazeAnalyzer::analyze(*world_, start_, goal_);
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "Labirinto %dx%d: %d intersecoes, %d curvas", maze_stats_.width, maze_stats_.height, maze_stats_.intersections(), maze_stats_.curves);
+        push_log(buf, SDL_Color{180,200,230,255});
+        std::snprintf(buf, sizeof(buf), "Becos %d, lacos %d, otimo %d passos (%d giros)", maze_stats_.dead_ends, maze_stats_.loops, maze_stats_.shortest_path, maze_stats_.optimal_turns);
+        push_log(buf, SDL_Color{180,200,230,255});
+    }
+
+    // Trail tracking (stack-based)
+    void set_green(Point p) { if (p.x>=0 && p.y>=0 && p.x<W_ && p.y<H_) { trail_[p.y*W_ + p.x] = 1; trail_rev_++; } }
+    void set_yellow(Point p) { if (p.x>=0 && p.y>=0 && p.x<W_ && p.y<H_) { trail_[p.y*W_ + p.x] = 2; trail_rev_++; } }
+    void clear_trail() { trail_.assign(static_cast<size_t>(W_) * H_, 0); trail_rev_++; }
+    // Novo episódio: descarta o .plan em andamento, solta os contêineres da arena, libera-a de uma vez e reinicia a pilha
+    void reset_episode() {
+        plan_abort();
+        path_stack_ = std::pmr::vector<Point>(episode_arena_.resource());
+        episode_arena_.reset();
+        path_stack_.push_back(agent_); set_green(agent_);
+    }
+    /** @brief Volta o agente e o cronômetro ao início (mantém fase e mapa aprendido). */
+    void rewind() {
+        agent_ = start_; heading_ = entrance_heading_; steps_ = 0; collisions_ = 0; paused_ = false; clock_.reset(); agent_prev_ = agent_;
+        start_s_ = 0.0; time_frozen_ = false; frozen_s_ = 0.0; started_ = false; cell_enter_s_ = 0.0;
+    }
+
+    // Log por passo (.plan) transmitido ao AsyncWriter em blocos de ~32 KB durante o episódio
+    void plan_abort() { writer_.abort(plan_stream_); plan_stream_ = 0; plan_buf_.clear(); }
+    void plan_log_step(const StepLogEntry& ent) {
+        if (file_.empty()) return;
+        if (!plan_stream_) {
+            plan_stream_ = writer_.begin(file_, "_plan_", ".plan", false);
+            plan_buf_ = plan_json_head(file_, W_, H_, start_, goal_, entrance_heading_);
+            plan_first_ = true;
+        }
+        plan_json_entry(plan_buf_, ent, plan_first_);
+        plan_first_ = false;
+        if (plan_buf_.size() >= kPlanChunk) { writer_.append(plan_stream_, std::move(plan_buf_)); plan_buf_ = std::string(); }
+    }
+    void plan_finish(const char* result, uint64_t tag) {
+        if (!plan_stream_) return;
+        plan_buf_ += plan_json_tail(result, steps_, collisions_, score_, meta_);
+        writer_.append(plan_stream_, std::move(plan_buf_));
+        writer_.commit(plan_stream_, tag);
+        plan_stream_ = 0; plan_buf_ = std::string();
+    }
+
+    void apply(SimCommand& c) {
+        dirty_ = true;
+        switch (c.kind) {
+        case SimCommand::Pause: paused_ = !paused_; break;
+        case SimCommand::Faster: clock_.faster(); break;
+        case SimCommand::Slower: clock_.slower(); break;
+        case SimCommand::NormalSpeed: clock_.setSpeedIndex(SimClock::kNormalSpeed); break;
+        case SimCommand::Step: clock_.requestStep(); break;
+        case SimCommand::Reset:
+            if (!world_) break;
+            {
+                const bool was_started = started_; // R no meio do episódio não espera o próximo movimento
+                rewind();
+                started_ = was_started;
+            }
+            clear_trail();
+            reset_episode();
+            log_.clear(); push_log("Resetado.", SDL_Color{200,200,200,255});
+            break;
+        case SimCommand::NewMaze:
+            world_ = std::move(c.map);
+            W_ = world_->width(); H_ = world_->height();
+            start_ = c.entrance; goal_ = c.goal; entrance_heading_ = c.heading; file_ = std::move(c.file);
+            nav_.setMapDimensions(W_, H_);
+            nav_.setStartGoal(start_, goal_);
+            // Tempos por aresta valem só para este labirinto; acumulam entre exploração e replays
+            nav_.edgeCosts().clear();
+            nav_.setWeightedPlanning(false); // a exploração conta células; os tempos pesam o replay
+            rewind();
+            phase_ = Phase::Ready;
+            max_steps_fail_ = W_ * H_ * 8;
+            clear_trail(); reset_episode(); score_ = 0.0;
+            if (!c.text.empty()) push_log(c.text, c.color);
+            log_maze_stats();
+            break;
+        case SimCommand::StartStop:
+            if (!world_) break;
+            if (phase_ == Phase::Ready || phase_ == Phase::FinishedSuccess) {
+                // Start exploration or replay learned path
+                const bool replay = (phase_==Phase::FinishedSuccess);
+                rewind();
+                if (replay) {
+                    // Replay: reaproveita o mapa aprendido e poda becos antes de planejar
+                    PruneStats ps = nav_.pruneDeadEnds();
+                    char buf[96];
+                    std::snprintf(buf, sizeof(buf), "Becos podados: %d de %d (restam %d)", ps.pruned, ps.cells, ps.remaining);
+                    push_log(buf, SDL_Color{180,200,230,255});
+                    nav_.setWeightedPlanning(true);
+                    nav_.planRoute();
+                } else {
+                    nav_.setWeightedPlanning(false);
+                    nav_.setMapDimensions(W_, H_);
+                    nav_.setStartGoal(start_, goal_);
+                }
+                // Não copie o mapa real; planejamento ocorrerá apenas após observações
+                phase_ = replay ? Phase::RunningReplay : Phase::RunningExplore;
+                meta_ = std::move(c.meta);
+                push_log("Execução iniciada.", SDL_Color{180,220,180,255});
+                clear_trail(); reset_episode(); score_ = 0.0;
+            } else if (active()) {
+                paused_ = true; phase_ = Phase::Ready; push_log("Execução parada.", SDL_Color{220,180,180,255});
+            } else if (phase_ == Phase::FinishedFail) {
+                // Test again
+                rewind();
+                nav_.setWeightedPlanning(false);
+                nav_.setMapDimensions(W_, H_);
+                nav_.setStartGoal(start_, goal_);
+                phase_ = Phase::RunningExplore; meta_ = std::move(c.meta); push_log("Teste reiniciado.", SDL_Color{180,220,180,255});
+                clear_trail(); reset_episode(); score_ = 0.0;
+            }
+            break;
         }
     }
+
+    // avanço baseado no Navigator e plano (fallback RightHand), um passo fixo do SimClock
+    void step() {
+        const MazeMap& map = *world_;
+        agent_prev_ = agent_;
+        maze::SensorRead sr = make_sensor_read(map, agent_, heading_);
+        // opcional: atualizar conhecimento do mapa
+        nav_.observeCellWalls(agent_, sr, heading_);
+        // replaneja só quando uma parede observada corta o plano (ou uma abertura pode encurtá-lo)
+        nav_.planIfInvalid();
+        auto dec = nav_.decidePlanned(agent_, heading_, sr);
+        // debug (`--verbose`): imprime decisão; desligado, não limita a taxa de passos
+        if (g_verbose_steps) std::printf("pos=(%d,%d) head=%u act=%d free[L=%d F=%d R=%d]\n", agent_.x, agent_.y, heading_, (int)dec.action, (int)sr.left_free, (int)sr.front_free, (int)sr.right_free);
+        // Check if action would hit a wall when moving forward
+        bool moved = false;
+        Point prev = agent_;
+        uint8_t heading_before = heading_;
+        StepLogEntry ent{}; ent.from = prev; ent.to = prev; ent.heading_before = heading_before; ent.action = dec.action; ent.moved = false; ent.delta_score = 0.0; ent.collisions = collisions_;
+        if (dec.action == maze::Action::Forward) {
+            const Dir absdir = from_heading(heading_);
+            if (can_move(map, agent_, absdir)) {
+                apply_move(agent_, heading_, dec.action);
+                moved = true;
+                // Tempo simulado desde a entrada na célula (giros e colisões nela incluídos)
+                nav_.edgeCosts().record(prev, absdir, static_cast<uint32_t>((clock_.simTime() - cell_enter_s_) * 1000.0 + 0.5));
+                cell_enter_s_ = clock_.simTime();
+                // reward for successful forward step
+                ent.event = "forward"; ent.moved = true; ent.to = agent_; ent.delta_score = 1.0;
+                score_ += 1.0; push_log("FORWARD: +1.0 (passagem livre)", SDL_Color{180,220,180,255});
+            } else {
+                collisions_++;
+                // Penalize collision
+                if (phase_==Phase::RunningExplore) {
+                    // tentativa: girar à direita para evitar loop
+                    apply_move(agent_, heading_, maze::Action::Right);
+                }
+                ent.event = "collision"; ent.moved = false; ent.to = prev; ent.delta_score = -5.0; ent.collisions = collisions_;
+                score_ -= 5.0; push_log("COLISÃO: -5.0", SDL_Color{220,150,150,255});
+            }
+        } else {
+            apply_move(agent_, heading_, dec.action);
+            moved = true;
+            ent.moved = true; ent.to = agent_;
+            if (dec.action==maze::Action::Left)  { ent.event = "left";  ent.delta_score = -0.1; score_ -= 0.1; push_log("LEFT: -0.1", SDL_Color{200,200,150,255}); }
+            else if (dec.action==maze::Action::Right) { ent.event = "right"; ent.delta_score = -0.1; score_ -= 0.1; push_log("RIGHT: -0.1", SDL_Color{200,200,150,255}); }
+            else if (dec.action==maze::Action::Back)  { ent.event = "back";  ent.delta_score = -0.2; score_ -= 0.2; push_log("BACK: -0.2", SDL_Color{200,180,150,255}); }
+        }
+        // persist per-step entry
+        ent.score_after = score_;
+        if (moved) {
+            if (!started_) { started_ = true; start_s_ = clock_.simTime(); time_frozen_ = false; }
+            steps_++;
+            ent.step_index = steps_;
+            ent.collisions = collisions_;
+            // Atualiza rastro (pilha): se voltamos para a célula anterior, pop e amarelo; senão push e verde
+            if (path_stack_.size() >= 2 && agent_.x == path_stack_[path_stack_.size()-2].x && agent_.y == path_stack_[path_stack_.size()-2].y) {
+                // backtracked
+                Point popped = path_stack_.back(); path_stack_.pop_back(); set_yellow(popped);
+                set_green(agent_); // permanece verde (caminho atual)
+            } else if (path_stack_.empty() || agent_.x != path_stack_.back().x || agent_.y != path_stack_.back().y) {
+                path_stack_.push_back(agent_); set_green(agent_);
+            }
+        }
+        else { ent.step_index = steps_; }
+        plan_log_step(ent);
+        if (agent_.x==goal_.x && agent_.y==goal_.y) {
+            float sim_time_s = static_cast<float>(clock_.simTime() - start_s_);
+            int cost = steps_ + collisions_ * 5;
+            std::printf("Reached goal in %d steps, collisions=%d, time=%.2fs, cost=%d\n", steps_, collisions_, sim_time_s, cost);
+            score_ += 10.0; push_log("OBJETIVO: +10.0", SDL_Color{180,230,180,255});
+            {
+                char buf[96];
+                std::snprintf(buf, sizeof(buf), "Passos %d (otimo %d), colisoes %d", steps_, maze_stats_.shortest_path, collisions_);
+                push_log(buf, SDL_Color{180,230,180,255});
+            }
+            // Recolorir rastro: manter verde apenas o caminho final (path_stack); o restante vira amarelo
+            std::vector<uint8_t> is_final(W_*H_, 0);
+            for (auto& p: path_stack_) { if (p.x>=0 && p.y>=0 && p.x<W_ && p.y<H_) is_final[p.y*W_ + p.x] = 1; }
+            for (int y=0; y<H_; ++y) {
+                for (int x=0; x<W_; ++x) {
+                    int i = y*W_ + x;
+                    if (trail_[i] == 1 && !is_final[i]) trail_[i] = 2; // amarelo
+                }
+            }
+            for (auto& p: path_stack_) set_green(p); // reforça verde do caminho final
+            // Freeze timer on success
+            frozen_s_ = started_ ? (clock_.simTime() - start_s_) : 0.0;
+            time_frozen_ = true;
+            paused_ = true;
+            phase_ = Phase::FinishedSuccess;
+
+            // Save solution (.soluct) and plan (.plan) with versioning tied to current map file
+            if (!file_.empty()) {
+                // Ensure path list includes the start cell at index 0
+                std::vector<Point> final_path(path_stack_.begin(), path_stack_.end());
+                if (final_path.empty() || !(final_path.front().x==start_.x && final_path.front().y==start_.y)) {
+                    final_path.insert(final_path.begin(), start_);
+                }
+                // Gravação em segundo plano; o caminho final aparece no log quando concluir
+                writer_.writeVersioned(file_, "_solution_", ".soluct",
+                                       build_solution_json(file_, W_, H_, start_, goal_, entrance_heading_, final_path, steps_, collisions_, sim_time_s, cost, meta_),
+                                       true, kTagSolution);
+                plan_finish("success", kTagPlanSuccess);
+            } else {
+                push_log("Aviso: current_map_file vazio; solução não salva.", SDL_Color{230,200,160,255});
+            }
+        }
+        if (steps_ > max_steps_fail_ && phase_==Phase::RunningExplore) {
+            paused_ = true; phase_ = Phase::FinishedFail; push_log("Falha: sem solução (limite)", SDL_Color{220,160,160,255});
+            // Save fail plan
+            if (!file_.empty()) plan_finish("fail", kTagPlanFail);
+        }
+    }
+
+    static constexpr size_t kPlanChunk = 32 * 1024;
+    static constexpr uint64_t kTagSolution = 1, kTagPlanSuccess = 2, kTagPlanFail = 3;
+
+    // Episódio (só a thread de simulação)
+    std::shared_ptr<const MazeMap> world_;
+    int W_{0}, H_{0};
+    Point start_{}, goal_{};
+    uint8_t entrance_heading_{1};
+    fs::path file_;               ///< Arquivo do labirinto atual
+    MetaInfo meta_;
+    MazeStats maze_stats_{};
+    maze::Navigator nav_;
+    // Tempo do episódio em tempo simulado: um passo do agente = 0,25 s de robô
+    SimClock clock_{0.25};
+    double start_s_{0.0}, frozen_s_{0.0};
+    double cell_enter_s_{0.0};    ///< tempo simulado da entrada na célula atual (custos por aresta)
+    bool time_frozen_{false};
+    bool started_{false};         ///< começa a contar somente quando houver o primeiro movimento
+    Point agent_{}, agent_prev_{};
+    uint8_t heading_{1};
+    int steps_{0}, collisions_{0};
+    int max_steps_fail_{0};
+    double score_{0.0};           ///< premiações (+) e penalidades (-)
+    bool paused_{false};
+    Phase phase_{Phase::Ready};
+    std::vector<uint8_t> trail_;
+    uint64_t trail_rev_{1};
+    // Memória do episódio (pilha do rastro): arena liberada a cada reinício
+    maze::EpisodeArena episode_arena_;
+    std::pmr::vector<Point> path_stack_{episode_arena_.resource()};
+    std::vector<LogLine> log_;
+    uint64_t log_rev_{1};
+    bool dirty_{true};            ///< Há algo a publicar
+    // Gravação de .plan/.soluct fora das threads de simulação e de renderização
+    AsyncWriter writer_;
+    AsyncWriter::StreamId plan_stream_{0};
+    std::string plan_buf_;
+    bool plan_first_{true};
+
+    TripleBuffer<SimSnapshot> snaps_;
+    MapPublisher learned_;        ///< Mapa aprendido, lido pela renderização sem trava
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::vector<SimCommand> cmds_;
+    bool stop_{false};
+    std::thread thread_;          ///< Por último: inicia depois dos demais membros
+};
+
+#if MAZE_HAVE_SHM_TELEMETRY
+/**
+ * @brief Modo visualizador (`--view[=nome]`): acompanha ao vivo o anel de telemetria de um `maze_batch`.
+ *
+ * Só lê a memória compartilhada (o lote nunca espera por esta janela). Mantém
+ * o último registro de cada episódio e um histórico recente de passos, de onde
+ * refaz o rastro ao trocar de episódio; as paredes vêm do `.maze` indicado no
+ * episódio. Se o lote ainda não começou, ou recomeçou, reanexa sozinho.
+ *
+ * Controles: `[`/`]` episódio anterior/seguinte, L seguir o mais recente,
+ * F enquadrar, PageUp/PageDown zoom, ESC sair.
+ */
+static int run_viewer(SDL_Window* win, SDL_Renderer* ren, UIFont& font, int win_w, int win_h, int sidebar_w, const std::string& name) {
+    /** @brief O que se sabe de um episódio do anel. */
+    struct EpisodeView {
+        TelemetryEpisode info;
+        bool have_info{false};
+        TelemetryRecord last;
+        bool have_last{false};
+    };
+    static constexpr size_t kHistory = 1u << 16; // passos guardados para refazer rastros
+    TelemetryReader rd;
+    std::vector<EpisodeView> eps;
+    std::vector<TelemetryRecord> history;
+    size_t history_next = 0;
+    int64_t selected = -1;
+    bool follow = true;
+    Uint32 last_attach_check = 0;
+
+    MazeMap world(1, 1);
+    std::string world_path;
+    bool world_ok = false;
+    std::vector<uint8_t> trail;
+    int64_t trail_episode = -1;
+
+    Camera cam;
+    cam.setViewport(0, 0, win_w - sidebar_w, win_h);
+    const SDL_Rect view{ cam.viewX(), cam.viewY(), cam.viewW(), cam.viewH() };
+    const SDL_Rect sidebar{ win_w - sidebar_w, 0, sidebar_w, win_h };
+    SDL_RendererInfo ren_info{};
+    const bool vsync = SDL_GetRendererInfo(ren, &ren_info) == 0 && (ren_info.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    auto reset = [&] {
+        eps.clear(); history.clear(); history_next = 0;
+        selected = -1; trail_episode = -1;
+    };
+    // Marca a célula do registro no rastro do episódio mostrado
+    auto mark = [&](const TelemetryRecord& r) {
+        if (world_ok && r.x >= 0 && r.y >= 0 && r.x < world.width() && r.y < world.height())
+            trail[static_cast<size_t>(r.y) * static_cast<size_t>(world.width()) + static_cast<size_t>(r.x)] = 1;
+    };
+
+    bool running = true;
+    while (running) {
+        const Uint32 frame_start = SDL_GetTicks();
+        SDL_Event e;
+        while (SDL_PollEvent(&e)) {
+            if (e.type == SDL_QUIT) running = false;
+            if (e.type == SDL_KEYDOWN) {
+                const auto key = e.key.keysym.sym;
+                if (key == SDLK_ESCAPE) running = false;
+                if (key == SDLK_LEFTBRACKET && selected > 0) { selected--; follow = false; }
+                if (key == SDLK_RIGHTBRACKET && selected + 1 < static_cast<int64_t>(eps.size())) { selected++; follow = false; }
+                if (key == SDLK_l) follow = true;
+                if (key == SDLK_f && world_ok) cam.fit(world.width(), world.height());
+                if (key == SDLK_PAGEUP) cam.zoom(1.25);
+                if (key == SDLK_PAGEDOWN) cam.zoom(0.8);
+            }
+            if (e.type == SDL_MOUSEWHEEL && e.wheel.y != 0) {
+                int mx = 0, my = 0;
+                SDL_GetMouseState(&mx, &my);
+                if (cam.contains(mx, my)) cam.zoomAt(std::pow(1.25, e.wheel.y), mx, my);
+            }
+            if (e.type == SDL_MOUSEMOTION && (e.motion.state & (SDL_BUTTON_RMASK | SDL_BUTTON_MMASK))) {
+                cam.pan(e.motion.xrel, e.motion.yrel);
+            }
+        }
+
+        // Anexa (ou reanexa, se o lote recriou o segmento) no máximo uma vez por segundo
+        if (frame_start - last_attach_check >= 1000 || last_attach_check == 0) {
+            last_attach_check = frame_start ? frame_start : 1;
+            if (!rd.attached() || rd.replaced()) {
+                if (rd.attach(name)) reset();
+            }
+        }
+
+        // Registros novos: último por episódio e histórico circular
+        rd.poll([&](const TelemetryRecord& r) {
+            if (r.episode >= eps.size()) eps.resize(r.episode + 1);
+            eps[r.episode].last = r;
+            eps[r.episode].have_last = true;
+            if (history.size() < kHistory) history.push_back(r);
+            else history[history_next] = r;
+            history_next = (history_next + 1) % kHistory;
+            if (static_cast<int64_t>(r.episode) == trail_episode) mark(r);
+        });
+        for (uint32_t id = 0; id < eps.size(); ++id)
+            if (!eps[id].have_info) eps[id].have_info = rd.episode(id, eps[id].info);
+        if (follow && !eps.empty()) selected = static_cast<int64_t>(eps.size()) - 1;
+
+        // Episódio escolhido: carrega o labirinto (se mudou) e refaz o rastro pelo histórico
+        if (selected >= 0 && selected != trail_episode && eps[selected].have_info) {
+            const TelemetryEpisode& info = eps[selected].info;
+            if (world_path != info.maze) {
+                world_path = info.maze;
+                Point en{}, go{};
+                uint8_t hd = 1;
+                world_ok = load_maze_json(world_path, world, en, go, hd);
+                if (world_ok) cam.fit(world.width(), world.height());
+            }
+            trail_episode = selected;
+            trail.assign(world_ok ? static_cast<size_t>(world.width()) * static_cast<size_t>(world.height()) : 0, 0);
+            const size_t n = history.size(), oldest = n < kHistory ? 0 : history_next;
+            for (size_t k = 0; k < n; ++k) {
+                const TelemetryRecord& r = history[(oldest + k) % n];
+                if (static_cast<int64_t>(r.episode) == trail_episode) mark(r);
+            }
+        }
+
+        SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
+        SDL_RenderClear(ren);
+        const EpisodeView* ev = selected >= 0 ? &eps[selected] : nullptr;
+        if (ev && world_ok && trail_episode == selected) {
+            SDL_RenderSetClipRect(ren, &view);
+            draw_grid(ren, cam, world.width(), world.height());
+            draw_maze(ren, world, cam);
+            draw_trail(ren, trail, world.width(), world.height(), cam);
+            if (ev->have_info) {
+                const int gx = cam.toScreenX(ev->info.goal_x), gy = cam.toScreenY(ev->info.goal_y);
+                SDL_Rect goal{ gx, gy, cam.toScreenX(ev->info.goal_x + 1) - gx, cam.toScreenY(ev->info.goal_y + 1) - gy };
+                SDL_SetRenderDrawColor(ren, 90, 150, 255, 255);
+                SDL_RenderDrawRect(ren, &goal);
+            }
+            if (ev->have_last) draw_agent(ren, ev->last.x, ev->last.y, ev->last.heading, cam);
+            else if (ev->have_info) draw_agent(ren, ev->info.entrance_x, ev->info.entrance_y, ev->info.heading, cam);
+            SDL_RenderSetClipRect(ren, nullptr);
+        }
+
+        // Barra lateral: episódios recentes e o passo atual do escolhido
+        SDL_SetRenderDrawColor(ren, 20, 20, 20, 255);
+        SDL_RenderFillRect(ren, &sidebar);
+        const SDL_Color title_c{200,200,220,255}, text_c{220,220,220,255}, sel_c{255,215,0,255};
+        const int tx = sidebar.x + 10;
+        int y = sidebar.y + 10;
+        char line[160];
+        if (!rd.attached()) {
+            draw_text(ren, font, "Aguardando telemetria...", tx, y, title_c);
+            std::snprintf(line, sizeof(line), "(%s)", name.c_str());
+            draw_text(ren, font, line, tx, y + 20, text_c);
+        } else {
+            std::snprintf(line, sizeof(line), "Episodios: %zu %s", eps.size(), follow ? "(seguindo)" : "");
+            draw_text(ren, font, line, tx, y, title_c);
+            y += 24;
+            const int rows = 14;
+            const int64_t first = std::max<int64_t>(0, std::min<int64_t>(selected - rows / 2, static_cast<int64_t>(eps.size()) - rows));
+            for (int64_t id = first; id < static_cast<int64_t>(eps.size()) && id < first + rows; ++id) {
+                const EpisodeView& v = eps[id];
+                const char* status = !v.have_last ? "" : (v.last.flags & TelemetryRecord::kGoal) ? "ok"
+                                   : (v.last.flags & TelemetryRecord::kGaveUp) ? "falha" : "...";
+                const std::string maze_name = v.have_info ? fs::path(v.info.maze).filename().string() : std::string("?");
+                std::snprintf(line, sizeof(line), "%4lld %-8s %s %s", static_cast<long long>(id),
+                              v.have_info ? v.info.agent_name : "?", status, maze_name.c_str());
+                draw_text(ren, font, line, tx, y, id == selected ? sel_c : text_c);
+                y += 18;
+            }
+            y += 12;
+            if (ev && ev->have_last) {
+                const TelemetryRecord& r = ev->last;
+                std::snprintf(line, sizeof(line), "passo %u  (%d,%d) %s", r.step, r.x, r.y,
+                              action_to_str(static_cast<maze::Action>(r.action)).c_str());
+                draw_text(ren, font, line, tx, y, text_c); y += 18;
+                std::snprintf(line, sizeof(line), "plano %u mov.  decisao %u us", r.plan_len, r.decide_us);
+                draw_text(ren, font, line, tx, y, text_c); y += 18;
+                std::snprintf(line, sizeof(line), "acumulado %.1f ms", r.t_us / 1000.0);
+                draw_text(ren, font, line, tx, y, text_c); y += 18;
+            }
+            std::snprintf(line, sizeof(line), "publicados %llu  perdidos %llu",
+                          static_cast<unsigned long long>(rd.published()), static_cast<unsigned long long>(rd.lost()));
+            draw_text(ren, font, line, tx, y, text_c);
+            if (!world_ok && ev) draw_text(ren, font, "Labirinto do episodio nao encontrado", tx, y + 18, SDL_Color{230,160,160,255});
+        }
+        draw_text(ren, font, "[ ] episodio  L seguir  F enquadrar  ESC sair", tx, win_h - 24, title_c);
+        SDL_SetWindowTitle(win, rd.attached() ? "Maze Simulator - telemetria" : "Maze Simulator - aguardando telemetria");
+        SDL_RenderPresent(ren);
+        if (!vsync) {
+            const Uint32 frame_ms = SDL_GetTicks() - frame_start;
+            if (frame_ms < 16) SDL_Delay(16 - frame_ms);
+        }
+    }
+    return 0;
 }
+#endif
 
 /**
  * @brief Ponto de entrada do simulador 2D com SDL2.
@@ -864,7 +1485,7 @@ static void draw_trail(SDL_Renderer* ren, const std::vector<uint8_t>& trail, int
  * Inicializa SDL2, constrói um mapa de exemplo, configura o `maze::Navigator` e
  * executa o loop principal com renderização e controle por teclado.
  *
- * Parâmetros de linha de comando não são utilizados neste exemplo.
+ * Com `--view[=nome]` abre só o visualizador de telemetria (`run_viewer()`).
  *
  * @param argc Quantidade de argumentos.
  * @param argv Vetor de argumentos.
@@ -897,6 +1518,27 @@ int main(int argc, char** argv) {
     const int CELL = 40;
     const int OX = 50, OY = 50;
     SDL_Rect sidebar{ win_w - sidebar_w, 0, sidebar_w, win_h };
+
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--verbose") == 0) g_verbose_steps = true;
+
+#if MAZE_HAVE_SHM_TELEMETRY
+    // `--view[=nome]`: só acompanha a telemetria de um `maze_batch`, sem simular
+    for (int i = 1; i < argc; ++i) {
+        const bool bare = std::strcmp(argv[i], "--view") == 0;
+        if (!bare && std::strncmp(argv[i], "--view=", 7) != 0) continue;
+        const int rc = run_viewer(win, ren, font, win_w, win_h, sidebar_w, bare ? kTelemetryName : argv[i] + 7);
+        ui_font_destroy(font);
+#ifdef HAVE_SDL_TTF
+        if (TTF_WasInit()) TTF_Quit();
+#endif
+        SDL_DestroyRenderer(ren);
+        SDL_DestroyWindow(win);
+        SDL_Quit();
+        return rc;
+    }
+#endif
+
     ensure_dirs();
 
     // Menu de seleção (GUI mínima via título da janela)
@@ -917,8 +1559,6 @@ int main(int argc, char** argv) {
     fs::path current_map_file; // caminho do arquivo do mapa atual
     Point entrance{}, goal_cell{};
     uint8_t entrance_heading = 1;
-    // Per-step attempt log (.plan): needs to be available during selection phase too
-    std::vector<StepLogEntry> step_log;
 
     SDL_SetWindowTitle(win, ("Escolha: " + items[sel]).c_str());
     while (choosing) {
@@ -946,7 +1586,6 @@ int main(int argc, char** argv) {
                             std::printf("Salvo: %s\n", out.string().c_str());
                         }
                         current_map_file = out;
-                        step_log.clear();
                     } else {
                         // Carrega arquivo
                         fs::path f = files[sel-1];
@@ -992,95 +1631,86 @@ int main(int argc, char** argv) {
         SDL_SetWindowTitle(win, "Maze Simulator");
     }
 
-    // Navigator e planejamento do caminho da entrada até a saída
-    maze::Navigator nav;
-    nav.setStrategy(maze::Navigator::Strategy::RightHand);
-    nav.setMapDimensions(W, H);
-    Point start = entrance;
-    Point goal = goal_cell;
-    nav.setStartGoal(start, goal);
-    Point agent = start;
-    uint8_t heading = entrance_heading;
+    // Simulação (Navigator, SimClock, rastro, log, gravação) em outra thread; aqui só entrada e desenho.
     // Não pré-planejar: aprendizado/descoberta ocorrerá passo-a-passo via observeCellWalls()
-
-    Uint32 start_ms = SDL_GetTicks();
-    Uint32 frozen_ms = 0;
-    bool time_frozen = false;
-    Uint32 last_step = start_ms;
-    bool started = false; // começa a contar somente quando houver o primeiro movimento
-    int steps = 0;
-    int collisions = 0;
-    double score = 0.0; // premiações (+) e penalidades (-)
+    SimWorker sim;
+    {
+        SimCommand c;
+        c.kind = SimCommand::NewMaze;
+        c.map = std::make_shared<const MazeMap>(map);
+        c.entrance = entrance; c.goal = goal_cell; c.heading = entrance_heading; c.file = current_map_file;
+        c.text = "Pronto. Selecione Iniciar.";
+        sim.post(std::move(c));
+    }
+    auto post = [&](SimCommand::Kind k){ SimCommand c; c.kind = k; sim.post(std::move(c)); };
+    // Mapa aprendido (tecla K): versão fixada a cada quadro, sem esperar a simulação
+    MapPublisher::Reader learned_rd = sim.learnedReader();
+    bool show_learned = false;
+    SDL_RendererInfo ren_info{};
+    const bool vsync = SDL_GetRendererInfo(ren, &ren_info) == 0 && (ren_info.flags & SDL_RENDERER_PRESENTVSYNC);
     bool running = true;
-    bool paused = false;
 
-    // UI state machine
-    enum class Phase { Ready, RunningExplore, RunningReplay, FinishedSuccess, FinishedFail };
-    Phase phase = Phase::Ready; // after maze loaded/generated
-    const int max_steps_fail = W * H * 8;
-
-    // Trail tracking (stack-based)
-    std::vector<uint8_t> trail(W*H, 0); // 0 none, 1 green (current/right), 2 yellow (wrong)
-    std::vector<Point> path_stack;
-    auto idx2 = [&](int x,int y){ return y*W + x; };
-    auto set_green = [&](Point p){ if (p.x>=0 && p.y>=0 && p.x<W && p.y<H) trail[idx2(p.x,p.y)] = 1; };
-    auto set_yellow = [&](Point p){ if (p.x>=0 && p.y>=0 && p.x<W && p.y<H) trail[idx2(p.x,p.y)] = 2; };
-    auto on_start_reset_stack = [&](){ path_stack.clear(); path_stack.push_back(agent); set_green(agent); };
-    on_start_reset_stack();
+    // Câmera da área do labirinto (à esquerda da barra lateral) e textura de nível de detalhe
+    Camera cam;
+    cam.setViewport(0, 0, win_w - sidebar_w, win_h);
+    cam.fit(W, H);
+    const SDL_Rect view{ cam.viewX(), cam.viewY(), cam.viewW(), cam.viewH() };
+    LodTexture lod;
+    bool lod_ok = true; // false se a textura não couber no driver (volta aos retângulos)
+    uint64_t lod_trail_rev = 0; // revisão do rastro refletida na textura
 
     // Buttons
     UIButton btnStart{ SDL_Rect{ sidebar.x + 20, 60, sidebar_w - 40, 34 }, true, "Iniciar" };
     UIButton btnNew{ SDL_Rect{ sidebar.x + 20, 100, sidebar_w - 40, 34 }, true, "Novo Labirinto" };
 
-    // Log buffer
-    std::vector<LogLine> log;
-    auto push_log = [&](const std::string& s, SDL_Color c){ log.push_back({s,c}); if (log.size() > 1000) log.erase(log.begin(), log.begin()+500); };
-    push_log("Pronto. Selecione Iniciar.", SDL_Color{180,220,180,255});
-    // Per-step attempt log (.plan) declared earlier to allow clearing during selection
     while (running) {
-        SDL_Event e; 
+        const Uint32 frame_start = SDL_GetTicks();
+        // Último estado publicado pela simulação (não espera por ela)
+        const SimSnapshot& snap = sim.latest();
+        const bool sim_running = snap.phase == Phase::RunningExplore || snap.phase == Phase::RunningReplay;
+        SDL_Event e;
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) running = false;
             if (e.type == SDL_KEYDOWN) {
                 if (e.key.keysym.sym == SDLK_ESCAPE) running = false;
-                if (e.key.keysym.sym == SDLK_SPACE) paused = !paused;
-                if (e.key.keysym.sym == SDLK_r) {
-                    agent = start; heading = entrance_heading; steps = 0; collisions = 0; paused = false; last_step = SDL_GetTicks();
-                    start_ms = last_step; time_frozen = false; frozen_ms = 0;
-                    std::fill(trail.begin(), trail.end(), 0);
-                    on_start_reset_stack();
-                    step_log.clear();
-                    log.clear(); push_log("Resetado.", SDL_Color{200,200,200,255});
-                }
+                if (e.key.keysym.sym == SDLK_SPACE) post(SimCommand::Pause);
+                if (e.key.keysym.sym == SDLK_PLUS || e.key.keysym.sym == SDLK_EQUALS || e.key.keysym.sym == SDLK_KP_PLUS) post(SimCommand::Faster);
+                if (e.key.keysym.sym == SDLK_MINUS || e.key.keysym.sym == SDLK_KP_MINUS) post(SimCommand::Slower);
+                if (e.key.keysym.sym == SDLK_1) post(SimCommand::NormalSpeed);
+                if (e.key.keysym.sym == SDLK_PERIOD) post(SimCommand::Step);
+                if (e.key.keysym.sym == SDLK_f) cam.fit(W, H);
+                if (e.key.keysym.sym == SDLK_PAGEUP) cam.zoom(1.25);
+                if (e.key.keysym.sym == SDLK_PAGEDOWN) cam.zoom(0.8);
+                if (e.key.keysym.sym == SDLK_LEFT) cam.pan(64, 0);
+                if (e.key.keysym.sym == SDLK_RIGHT) cam.pan(-64, 0);
+                if (e.key.keysym.sym == SDLK_UP) cam.pan(0, 64);
+                if (e.key.keysym.sym == SDLK_DOWN) cam.pan(0, -64);
+                lod.dirty = true;
+                if (e.key.keysym.sym == SDLK_r) post(SimCommand::Reset);
+                if (e.key.keysym.sym == SDLK_k) show_learned = !show_learned;
+            }
+            if (e.type == SDL_MOUSEWHEEL && e.wheel.y != 0) {
+                int mx = 0, my = 0;
+                SDL_GetMouseState(&mx, &my);
+                if (cam.contains(mx, my)) cam.zoomAt(std::pow(1.25, e.wheel.y), mx, my);
+            }
+            if (e.type == SDL_MOUSEMOTION && (e.motion.state & (SDL_BUTTON_RMASK | SDL_BUTTON_MMASK))) {
+                cam.pan(e.motion.xrel, e.motion.yrel);
             }
             if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
+                lod.dirty = true;
                 int mx = e.button.x, my = e.button.y;
                 auto in_rect = [&](const SDL_Rect& r){ return mx>=r.x && mx<r.x+r.w && my>=r.y && my<r.y+r.h; };
                 if (btnStart.enabled && in_rect(btnStart.rect)) {
-                    if (phase == Phase::Ready || phase == Phase::FinishedSuccess) {
-                        // Start exploration or replay learned path
-                        agent = start; heading = entrance_heading; steps = 0; collisions = 0; paused = false; last_step = SDL_GetTicks();
-                        start_ms = last_step; time_frozen = false; frozen_ms = 0; started = false;
-                        nav.setMapDimensions(W, H);
-                        nav.setStartGoal(start, goal);
-                        // Não copie o mapa real; planejamento ocorrerá apenas após observações
-                        phase = (phase==Phase::FinishedSuccess) ? Phase::RunningReplay : Phase::RunningExplore;
-                        btnStart.label = "Parar";
-                        push_log("Execução iniciada.", SDL_Color{180,220,180,255});
-                        std::fill(trail.begin(), trail.end(), 0); on_start_reset_stack(); score = 0.0;
-                        step_log.clear();
-                    } else if (phase == Phase::RunningExplore || phase == Phase::RunningReplay) {
-                        paused = true; phase = Phase::Ready; btnStart.label = "Iniciar"; push_log("Execução parada.", SDL_Color{220,180,180,255});
-                    } else if (phase == Phase::FinishedFail) {
-                        // Test again
-                        agent = start; heading = entrance_heading; steps = 0; collisions = 0; paused = false; last_step = SDL_GetTicks();
-                        start_ms = last_step; time_frozen = false; frozen_ms = 0;
-                        nav.setMapDimensions(W, H);
-                        nav.setStartGoal(start, goal);
-                        phase = Phase::RunningExplore; btnStart.label = "Parar"; push_log("Teste reiniciado.", SDL_Color{180,220,180,255});
-                        std::fill(trail.begin(), trail.end(), 0); on_start_reset_stack(); score = 0.0;
-                        step_log.clear();
+                    // Iniciar/Parar/Teste: a thread de simulação decide pela própria fase (a do quadro pode estar atrasada)
+                    SimCommand c;
+                    c.kind = SimCommand::StartStop;
+                    if (!sim_running) {
+                        // Metadados pedidos aqui (diálogo na thread de renderização) e gravados no fim do episódio
+                        ensure_session_meta(ren, font, win_w, win_h);
+                        c.meta = collect_meta_default();
                     }
+                    sim.post(std::move(c));
                 }
                 if (btnNew.enabled && in_rect(btnNew.rect)) {
                     // Generate a new random maze and save; then reset to Ready
@@ -1090,164 +1720,76 @@ int main(int argc, char** argv) {
                     char fname[128];
                     std::snprintf(fname, sizeof(fname), "maze_%dx%d_%ld.maze", W, H, (long)std::time(nullptr));
                     fs::path out = fs::path("maze") / fname;
+                    SimCommand c;
+                    c.kind = SimCommand::NewMaze;
                     if (!save_maze_json(out, map, entrance, goal_cell, entrance_heading, mi)) {
                         std::fprintf(stderr, "Falha ao salvar %s\n", out.string().c_str());
-                        push_log("Erro ao salvar novo labirinto.", SDL_Color{230,160,160,255});
+                        c.text = "Erro ao salvar novo labirinto."; c.color = SDL_Color{230,160,160,255};
                     } else {
-                        push_log(std::string("Novo labirinto salvo: ") + out.string(), SDL_Color{180,220,180,255});
+                        c.text = std::string("Novo labirinto salvo: ") + out.string();
                     }
                     current_map_file = out;
-                    start = entrance; goal = goal_cell; agent = start; heading = entrance_heading;
-                    nav.setMapDimensions(W, H);
-                    nav.setStartGoal(start, goal);
-                    steps = 0; collisions = 0; paused = false; last_step = SDL_GetTicks(); started = false; time_frozen = false; frozen_ms = 0;
-                    phase = Phase::Ready;
-                    btnStart.label = "Iniciar"; btnStart.enabled = true;
-                    btnNew.enabled = true; // disponível sempre
-                    trail.assign(W*H, 0); on_start_reset_stack(); score = 0.0;
-                    step_log.clear();
+                    c.map = std::make_shared<const MazeMap>(map);
+                    c.entrance = entrance; c.goal = goal_cell; c.heading = entrance_heading; c.file = current_map_file;
+                    sim.post(std::move(c));
+                    cam.fit(W, H); lod_ok = true;
                 }
             }
         }
+        btnStart.label = sim_running ? "Parar" : (snap.phase == Phase::FinishedFail ? "Teste" : "Iniciar");
+        if (snap.trail_rev != lod_trail_rev) { lod.dirty = true; lod_trail_rev = snap.trail_rev; }
 
-        // avanço baseado no Navigator e plano (fallback RightHand)
-        Uint32 now = SDL_GetTicks();
-        if (!paused && (now - last_step > 250) && (phase==Phase::RunningExplore || phase==Phase::RunningReplay)) {
-            last_step = now;
-            maze::SensorRead sr = make_sensor_read(map, agent, heading);
-            // opcional: atualizar conhecimento do mapa
-            nav.observeCellWalls(agent, sr, heading);
-            // replaneja a cada passo para refletir conhecimento atualizado (mantém movimento simultâneo)
-            nav.planRoute();
-            auto dec = nav.decidePlanned(agent, heading, sr);
-            // debug: imprime decisão
-            std::printf("pos=(%d,%d) head=%u act=%d free[L=%d F=%d R=%d]\n", agent.x, agent.y, heading, (int)dec.action, (int)sr.left_free, (int)sr.front_free, (int)sr.right_free);
-            // Check if action would hit a wall when moving forward
-            bool moved = false;
-            Point prev = agent;
-            uint8_t heading_before = heading;
-            StepLogEntry ent{}; ent.from = prev; ent.to = prev; ent.heading_before = heading_before; ent.action = dec.action; ent.moved = false; ent.delta_score = 0.0; ent.collisions = collisions;
-            if (dec.action == maze::Action::Forward) {
-                const char abs_dirs[4] = {'N','E','S','W'};
-                char absdir = abs_dirs[heading];
-                if (can_move(map, agent, absdir)) {
-                    apply_move(agent, heading, dec.action);
-                    moved = true;
-                    // reward for successful forward step
-                    ent.event = "forward"; ent.moved = true; ent.to = agent; ent.delta_score = 1.0;
-                    score += 1.0; push_log("FORWARD: +1.0 (passagem livre)", SDL_Color{180,220,180,255});
-                } else {
-                    collisions++;
-                    // Penalize collision
-                    if (phase==Phase::RunningExplore) {
-                        // tentativa: girar à direita para evitar loop
-                        apply_move(agent, heading, maze::Action::Right);
-                    }
-                    ent.event = "collision"; ent.moved = false; ent.to = prev; ent.delta_score = -5.0; ent.collisions = collisions;
-                    score -= 5.0; push_log("COLISÃO: -5.0", SDL_Color{220,150,150,255});
-                }
+        SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
+        SDL_RenderClear(ren);
+        if (snap.map) {
+            const MazeMap& world = *snap.map;
+            const int sw = world.width(), sh = world.height();
+            // Left drawing area (exclude sidebar): só o que a câmera enxerga
+            SDL_RenderSetClipRect(ren, &view);
+            if (cam.cell() < kLodCellPx && lod_ok && (lod_ok = lod_update(ren, lod, world, snap.trail))) {
+                // Zoom baixo: uma textura com o labirinto e o rastro inteiros
+                lod_draw(ren, lod, cam, sw, sh);
             } else {
-                apply_move(agent, heading, dec.action);
-                moved = true;
-                ent.moved = true; ent.to = agent;
-                if (dec.action==maze::Action::Left)  { ent.event = "left";  ent.delta_score = -0.1; score -= 0.1; push_log("LEFT: -0.1", SDL_Color{200,200,150,255}); }
-                else if (dec.action==maze::Action::Right) { ent.event = "right"; ent.delta_score = -0.1; score -= 0.1; push_log("RIGHT: -0.1", SDL_Color{200,200,150,255}); }
-                else if (dec.action==maze::Action::Back)  { ent.event = "back";  ent.delta_score = -0.2; score -= 0.2; push_log("BACK: -0.2", SDL_Color{200,180,150,255}); }
-            }
-            // persist per-step entry
-            ent.score_after = score;
-            if (moved) {
-                if (!started) { started = true; start_ms = SDL_GetTicks(); time_frozen = false; }
-                steps++;
-                ent.step_index = steps;
-                ent.collisions = collisions;
-                // Atualiza rastro (pilha): se voltamos para a célula anterior, pop e amarelo; senão push e verde
-                if (path_stack.size() >= 2 && agent.x == path_stack[path_stack.size()-2].x && agent.y == path_stack[path_stack.size()-2].y) {
-                    // backtracked
-                    Point popped = path_stack.back(); path_stack.pop_back(); set_yellow(popped);
-                    set_green(agent); // permanece verde (caminho atual)
-                } else if (path_stack.empty() || agent.x != path_stack.back().x || agent.y != path_stack.back().y) {
-                    path_stack.push_back(agent); set_green(agent);
-                }
-            }
-            else { ent.step_index = steps; }
-            step_log.push_back(ent);
-            if (agent.x==goal.x && agent.y==goal.y) {
-                float sim_time_s = (SDL_GetTicks() - start_ms) / 1000.0f;
-                int cost = steps + collisions * 5;
-                std::printf("Reached goal in %d steps, collisions=%d, time=%.2fs, cost=%d\n", steps, collisions, sim_time_s, cost);
-                score += 10.0; push_log("OBJETIVO: +10.0", SDL_Color{180,230,180,255});
-                // Recolorir rastro: manter verde apenas o caminho final (path_stack); o restante vira amarelo
-                std::vector<uint8_t> is_final(W*H, 0);
-                for (auto& p: path_stack) { if (p.x>=0 && p.y>=0 && p.x<W && p.y<H) is_final[p.y*W + p.x] = 1; }
-                for (int y=0; y<H; ++y) {
-                    for (int x=0; x<W; ++x) {
-                        int i = y*W + x;
-                        if (trail[i] == 1 && !is_final[i]) trail[i] = 2; // amarelo
-                    }
-                }
-                for (auto& p: path_stack) set_green(p); // reforça verde do caminho final
-                // Freeze timer on success
-                frozen_ms = started ? (SDL_GetTicks() - start_ms) : 0;
-                time_frozen = true;
-                paused = true;
-                phase = Phase::FinishedSuccess;
-                btnStart.label = "Iniciar"; // for replay
-
-                // Save solution (.soluct) and plan (.plan) with versioning tied to current map file
-                if (!current_map_file.empty()) {
-                    ensure_session_meta(ren, font, win_w, win_h);
-                    MetaInfo mi = collect_meta_default();
-                    // Ensure path list includes the start cell at index 0
-                    std::vector<Point> final_path = path_stack;
-                    if (final_path.empty() || !(final_path.front().x==start.x && final_path.front().y==start.y)) {
-                        final_path.insert(final_path.begin(), start);
-                    }
-                    std::string content = build_solution_json(current_map_file, W, H, start, goal, entrance_heading, final_path, steps, collisions, sim_time_s, cost, mi);
-                    fs::path out = save_solution_versioned(current_map_file, content);
-                    push_log(std::string("Solução salva em: ") + out.string(), SDL_Color{180,220,180,255});
-                    // Save attempt plan log
-                    std::string plan_json = build_plan_json(current_map_file, W, H, start, goal, entrance_heading, step_log, "success", steps, collisions, score, mi);
-                    fs::path out_plan = save_plan_versioned(current_map_file, plan_json);
-                    push_log(std::string("Plano salvo em: ") + out_plan.string(), SDL_Color{180,220,180,255});
-                } else {
-                    push_log("Aviso: current_map_file vazio; solução não salva.", SDL_Color{230,200,160,255});
+                draw_grid(ren, cam, sw, sh);
+                draw_maze(ren, world, cam);
+                // visualização do rastro (verde: caminho atual/correto; amarelo: descartado/errado)
+                draw_trail(ren, snap.trail, sw, sh, cam);
+                draw_plan(ren, snap.plan, sw, sh, cam);
+                if (show_learned) {
+                    // Paredes já observadas pelo Navigator, finas e em laranja sobre as reais
+                    const MapPublisher::Pin known = learned_rd.pin();
+                    if (known && known->width() == sw && known->height() == sh) draw_maze(ren, *known, cam, SDL_Color{255,140,0,255}, 2);
                 }
             }
-            if (steps > max_steps_fail && phase==Phase::RunningExplore) {
-                paused = true; phase = Phase::FinishedFail; btnStart.label = "Teste"; btnNew.enabled = true; push_log("Falha: sem solução (limite)", SDL_Color{220,160,160,255});
-                // Save fail plan
-                if (!current_map_file.empty()) {
-                    ensure_session_meta(ren, font, win_w, win_h);
-                    MetaInfo mi = collect_meta_default();
-                    std::string plan_json = build_plan_json(current_map_file, W, H, start, goal, entrance_heading, step_log, "fail", steps, collisions, score, mi);
-                    fs::path out_plan = save_plan_versioned(current_map_file, plan_json);
-                    push_log(std::string("Plano salvo (falha) em: ") + out_plan.string(), SDL_Color{220,200,200,255});
-                }
+            // Interpola entre a pose anterior e a atual pela fração do próximo passo, estendida pelo tempo desde a publicação
+            float alpha = 0.0f;
+            if (snap.step_wall_s > 0.0) {
+                alpha = static_cast<float>(std::min(0.999, snap.alpha + (wall_seconds() - snap.wall_s) / snap.step_wall_s));
             }
+            draw_agent(ren, snap.agent_prev.x + (snap.agent.x - snap.agent_prev.x) * alpha, snap.agent_prev.y + (snap.agent.y - snap.agent_prev.y) * alpha,
+                       snap.heading, cam);
+            SDL_RenderSetClipRect(ren, nullptr);
         }
-
-// ...
-        SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
-        SDL_RenderClear(ren);
-        // Left drawing area (exclude sidebar)
-        draw_grid(ren, OX, OY, CELL, W, H);
-        draw_maze(ren, map, OX, OY, CELL);
-        // visualização do rastro (verde: caminho atual/correto; amarelo: descartado/errado)
-        draw_trail(ren, trail, W, H, OX, OY, CELL);
-        draw_agent(ren, agent, heading, OX, OY, CELL);
-        float sim_time_s = time_frozen ? (frozen_ms / 1000.0f) : (started ? ((SDL_GetTicks() - start_ms) / 1000.0f) : 0.0f);
-        int cost = steps + collisions * 5;
         char title[160];
-        std::snprintf(title, sizeof(title), "Maze Simulator - steps=%d col=%d time=%.1fs score=%.1f %s", steps, collisions, sim_time_s, score, paused?"(paused)":"");
+        char speed_txt[16];
+        const double speed = SimClock::kSpeeds[snap.speed_idx];
+        if (speed == 0.0) std::snprintf(speed_txt, sizeof(speed_txt), "max");
+        else std::snprintf(speed_txt, sizeof(speed_txt), "%gx", speed);
+        std::snprintf(title, sizeof(title), "Maze Simulator - steps=%d col=%d time=%.1fs score=%.1f speed=%s %s", snap.steps, snap.collisions, snap.time_s, snap.score, speed_txt, snap.paused?"(paused)":"");
         SDL_SetWindowTitle(win, title);
         // Sidebar
-        draw_sidebar(ren, font, sidebar, log, (win_h-200)/18);
+        draw_sidebar(ren, font, sidebar, snap.log, (win_h-200)/18);
         // Buttons
         draw_button(ren, font, btnStart);
         draw_button(ren, font, btnNew);
         SDL_RenderPresent(ren);
+        // Sem vsync, limita a ~60 quadros/s em vez de girar o laço a toda velocidade
+        if (!vsync) {
+            const Uint32 frame_ms = SDL_GetTicks() - frame_start;
+            if (frame_ms < 16) SDL_Delay(16 - frame_ms);
+        }
     }
+    lod_destroy(lod);
     ui_font_destroy(font);
 #ifdef HAVE_SDL_TTF
     if (TTF_WasInit()) TTF_Quit();
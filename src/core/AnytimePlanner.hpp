@@ -0,0 +1,420 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <memory_resource>
+#include <cstdint>
+#include <cstdlib>
+#include "MazeMap.hpp"
+#include "CellIdx.hpp"
+#include "EdgeCost.hpp"
+#include "Planner.hpp"
+
+/**
+ * @file AnytimePlanner.hpp
+ * @brief Planejador anytime (ARA*) retomável, executado em fatias com orçamento fixo de trabalho.
+ */
+
+namespace maze {
+
+/** @brief Estado de `AnytimePlanner` após `step()`. */
+enum class PlanStatus : uint8_t {
+    Idle,       ///< Nenhuma busca iniciada (ou cancelada)
+    InProgress, ///< Busca em andamento; `path()` tem o melhor caminho até agora (se houver)
+    Done,       ///< Caminho ótimo publicado (`bound() == 1`)
+    NoPath      ///< Objetivo inalcançável
+};
+
+/** @brief Parâmetros do ARA* (`AnytimePlanner::begin`, `Navigator::planSliced`). */
+struct AnytimeConfig {
+    float eps_start{3.0f}; ///< ε da primeira solução (>= 1)
+    float eps_step{1.0f};  ///< Redução de ε a cada solução publicada (> 0)
+};
+
+/**
+ * @brief A* ponderado anytime (ARA*) com estado preservado entre chamadas de `step()`.
+ *
+ * `begin()` prepara a busca em O(1) (as estruturas por célula são marcadas
+ * com o número da busca e iniciadas sob demanda; só uma mudança de dimensões
+ * realoca). Cada `step(budget)` executa no máximo `budget` unidades de
+ * trabalho e devolve o controle, então o chamador pode dar ao planejador uma
+ * fatia fixa de cada tick sem estourar o período, qualquer que seja o
+ * labirinto. Uma unidade custa O(log n): retirar uma entrada da fila (e
+ * relaxar até 4 vizinhos), transferir uma entrada ao reordenar a fila para
+ * um ε menor, medir/copiar uma célula do caminho a publicar, ou uma unidade
+ * da busca exata final (ver `BibfsSearch::run`).
+ *
+ * A primeira solução sai com f = g + ε·h (h = Manhattan, ε inicial
+ * `AnytimeConfig::eps_start`) e custa no máximo ε vezes o ótimo. Com um
+ * `EdgeCostMap` em `begin()` cada aresta custa `(*cost)(célula, dir)` (1..255)
+ * em vez de 1; Manhattan continua admissível porque nenhuma aresta custa
+ * menos de 1. Os custos são lidos na relaxação: medições novas durante a
+ * busca valem a partir das células ainda não expandidas. A cada solução ε
+ * diminui de `eps_step` e a busca continua reaproveitando g-valores (as
+ * células melhoradas depois de fechadas vão para a lista INCONS). Quando o
+ * próximo ε seria 1 (ou `eps_start` <= 1), o ótimo vem da mesma busca de
+ * `Planner::bibfs_path_into` (sem custos) ou `Planner::dial_path_into` (com
+ * custos), retomável em fatias (`BibfsSearch`/`DialSearch`): o caminho final
+ * é exatamente o de `Navigator::planRoute()`, com os mesmos desempates entre
+ * caminhos ótimos. `path()` e `bound()` sempre descrevem o último caminho
+ * publicado; o caminho seguinte é montado à parte e trocado de uma vez.
+ *
+ * O mapa é lido por referência. Se `MazeMap::generation()` mudar entre duas
+ * chamadas, `step()` confere as paredes alteradas pelo journal do mapa
+ * (`MazeMap::changesSince`) e só recomeça do ε inicial se alguma invalida o
+ * estado da busca: uma parede nova na aresta de um predecessor (o g-valor
+ * da subárvore deixaria de ser alcançável) ou uma abertura junto a uma
+ * célula já alcançada (poderia baixar g-valores já fechados). Paredes novas
+ * fora da árvore de predecessores e qualquer mudança entre células ainda não
+ * alcançadas não afetam nenhum g-valor; o mapa novo é lido quando a busca
+ * chega lá. Na busca exata final qualquer parede alterada junto a uma célula
+ * já alcançada recomeça só essa busca (o caminho ε-subótimo continua
+ * publicado). Sem journal que cubra o intervalo, recomeça. O último caminho
+ * publicado continua em `path()` até o próximo (pode atravessar uma parede
+ * nova; quem o segue confere o mapa).
+ */
+class AnytimePlanner {
+public:
+    /** @param mr recurso de memória das estruturas da busca */
+    explicit AnytimePlanner(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : mr_(mr), stamp_(mr), g_(mr), parent_(mr), closed_(mr), incons_mark_(mr),
+          heap_(mr), pending_(mr), incons_(mr), trace_(mr), path_(mr), exact_ws_(mr) {}
+
+    /**
+     * @brief Inicia uma busca de `start` a `goal` em `map` (o mapa precisa continuar vivo).
+     * @param skip máscara opcional (w*h bytes, 1 = ignorar célula), ex.: poda de becos
+     * @param cost custos opcionais por aresta (precisa continuar vivo; outras dimensões = custo 1)
+     */
+    void begin(const MazeMap& map, Point start, Point goal, const std::vector<uint8_t>* skip = nullptr,
+               const AnytimeConfig& cfg = AnytimeConfig{}, const EdgeCostMap* cost = nullptr) {
+        if (start.x != start_.x || start.y != start_.y || goal.x != goal_.x || goal.y != goal_.y) {
+            path_.clear();
+            path_version_++;
+        }
+        map_ = &map;
+        skip_ = skip;
+        cost_ = cost;
+        start_ = start;
+        goal_ = goal;
+        cfg_ = cfg;
+        restart();
+    }
+
+    /** @brief Abandona a busca e o caminho publicado (`status()` volta a `Idle`). */
+    void cancel() {
+        status_ = PlanStatus::Idle;
+        map_ = nullptr;
+        path_.clear();
+    }
+
+    /**
+     * @brief Avança a busca por no máximo `budget` unidades de trabalho.
+     * @return `InProgress` enquanto houver trabalho; `Done`/`NoPath` ao terminar
+     */
+    PlanStatus step(uint32_t budget) {
+        last_work_ = 0;
+        if (status_ != PlanStatus::InProgress) return status_;
+        if (map_->generation() != map_gen_ || skip_size() != skip_size_) {
+            if (skip_size() != skip_size_) restart();
+            else if (edits_miss_search()) map_gen_ = map_->generation();
+            else if (phase_ == Phase::Exact) begin_exact();
+            else restart();
+        }
+        while (status_ == PlanStatus::InProgress && last_work_ < budget) {
+            last_work_++;
+            switch (phase_) {
+                case Phase::Search:  search_unit(); break;
+                case Phase::Measure: measure_unit(); break;
+                case Phase::Publish: publish_unit(); break;
+                case Phase::Rebuild: rebuild_unit(); break;
+                case Phase::Exact:   exact_unit(); break;
+            }
+        }
+        total_work_ += last_work_;
+        return status_;
+    }
+
+    /** @brief Estado da última chamada. */
+    PlanStatus status() const { return status_; }
+    /** @brief true se há caminho publicado. */
+    bool hasPath() const { return !path_.empty(); }
+    /** @brief Melhor caminho publicado (início..objetivo); vazio se nenhum. */
+    const std::pmr::vector<Point>& path() const { return path_; }
+    /** @brief Fator de subotimalidade garantido de `path()` (1 = ótimo). */
+    float bound() const { return path_bound_; }
+    /** @brief Muda a cada caminho publicado (para o chamador copiar só quando há novidade). */
+    uint32_t pathVersion() const { return path_version_; }
+    /** @brief Unidades de trabalho da última chamada a `step()` (sempre <= orçamento). */
+    uint32_t lastWork() const { return last_work_; }
+    /** @brief Unidades de trabalho desde `begin()` (inclui recomeços). */
+    uint64_t totalWork() const { return total_work_; }
+    /** @brief Origem da busca atual. */
+    Point start() const { return start_; }
+    /** @brief Objetivo da busca atual. */
+    Point goal() const { return goal_; }
+
+private:
+    static constexpr uint32_t kInf = 0xFFFFFFFFu;
+    static constexpr uint32_t kOne = 16; ///< ε em 1/16 (ε = 1)
+
+    /** @brief Entrada da fila: prioridade `key = 16·g + ε·h` e o g com que foi inserida. */
+    struct Entry {
+        uint32_t key;
+        uint32_t g;
+        uint32_t idx;
+    };
+    /** @brief Ordem de heap: menor chave primeiro; empate, maior g (mais perto do objetivo). */
+    static bool later(const Entry& a, const Entry& b) { return a.key > b.key || (a.key == b.key && a.g < b.g); }
+
+    enum class Phase : uint8_t { Search, Measure, Publish, Rebuild, Exact };
+    using CostSearch = DialSearch<uint32_t, const EdgeCostMap>;
+
+    /** @brief Tamanho da máscara de células ignoradas (0 sem máscara). */
+    size_t skip_size() const { return skip_ ? skip_->size() : 0; }
+
+    /**
+     * @brief true se nenhuma parede alterada desde `map_gen_` invalida g-valores da busca.
+     *
+     * Parede nova: só a aresta pai→filho entre duas células alcançadas conta.
+     * Abertura: qualquer extremo alcançado conta. Na busca exata (que guarda
+     * os encontros das duas frentes, não só a árvore) qualquer extremo
+     * alcançado conta. Sem cobertura do journal (ou com outras dimensões)
+     * responde false.
+     */
+    bool edits_miss_search() const {
+        if (grid_->width() != map_->width() || grid_->height() != map_->height()) return false;
+        bool miss = true;
+        const bool covered = map_->changesSince(map_gen_, [&](const WallEdit& e) {
+            if (!miss || e.old_value == e.new_value) return;
+            const Point c = map_->edgeCell(e.edge);
+            const Point n = maze::step(c, MazeMap::edgeDir(e.edge));
+            if (!map_->in_bounds(n.x, n.y)) return; // borda: nenhuma aresta da grade
+            const uint32_t a = grid_->index(c), b = grid_->index(n);
+            if (phase_ == Phase::Exact) { miss = !(exact_reached(a) || exact_reached(b)); return; }
+            const bool ra = g(a) != kInf, rb = g(b) != kInf;
+            if (e.new_value) miss = !(ra && rb && (parent_[a] == b || parent_[b] == a));
+            else             miss = !(ra || rb);
+        });
+        return covered && miss;
+    }
+
+    /** @brief Descarta o progresso e recomeça no ε inicial para o mapa atual (o caminho publicado fica). */
+    void restart() {
+        const int w = map_->width(), h = map_->height();
+        if (!grid_ || grid_->width() != w || grid_->height() != h) resize(w, h);
+        map_gen_ = map_->generation();
+        skip_size_ = skip_size();
+        heap_.clear();
+        pending_.clear();
+        incons_.clear();
+        next_iteration();
+        search_ = iter_;
+        const float e0 = cfg_.eps_start < 1.0f ? 1.0f : cfg_.eps_start;
+        eps_q_ = static_cast<uint32_t>(e0 * kOne + 0.5f);
+        eps_step_q_ = cfg_.eps_step > 0.0f ? static_cast<uint32_t>(cfg_.eps_step * kOne + 0.5f) : kOne;
+        if (eps_step_q_ == 0) eps_step_q_ = 1;
+        phase_ = Phase::Search;
+        status_ = PlanStatus::InProgress;
+        if (!map_->in_bounds(start_.x, start_.y) || !map_->in_bounds(goal_.x, goal_.y) ||
+            (skip_ && skip_->size() == grid_->size() && (*skip_)[grid_->index(goal_)])) {
+            status_ = PlanStatus::NoPath;
+            return;
+        }
+        s_ = grid_->index(start_);
+        t_ = grid_->index(goal_);
+        if (eps_q_ <= kOne) { begin_exact(); return; }
+        set_g(s_, 0, CellIdx<uint32_t>::kNone);
+        push(s_, 0);
+    }
+
+    /** @brief true se os custos de `cost_` valem para a grade atual (senão, custo 1 em tudo). */
+    bool use_cost() const {
+        return cost_ && cost_->width() == grid_->width() && cost_->height() == grid_->height();
+    }
+
+    /** @brief (Re)inicia a busca exata final sobre o mapa atual, escrevendo em `trace_`. */
+    void begin_exact() {
+        map_gen_ = map_->generation();
+        eps_q_ = kOne;
+        phase_ = Phase::Exact;
+        exact_cost_ = use_cost();
+        if (exact_cost_)
+            dial_.begin(*map_, start_, goal_, exact_ws_.dial<uint32_t>(*map_), *cost_, skip_, trace_);
+        else
+            bfs_.begin(*map_, start_, goal_, exact_ws_.scratch<uint32_t>(*map_), skip_, trace_);
+    }
+
+    bool exact_reached(uint32_t i) const { return exact_cost_ ? dial_.reached(i) : bfs_.reached(i); }
+
+    /** @brief Uma unidade da busca exata; no fim publica o caminho ótimo (ou `NoPath`). */
+    void exact_unit() {
+        if (exact_cost_) dial_.run(1); else bfs_.run(1);
+        if (!(exact_cost_ ? dial_.done() : bfs_.done())) return;
+        if (!(exact_cost_ ? dial_.found() : bfs_.found())) { status_ = PlanStatus::NoPath; return; }
+        path_.swap(trace_);
+        path_bound_ = 1.0f;
+        path_version_++;
+        status_ = PlanStatus::Done;
+    }
+
+    /** @brief Realoca as estruturas por célula para w×h (única alocação, na troca de dimensões). */
+    void resize(int w, int h) {
+        grid_.emplace(w, h, mr_);
+        const size_t n = grid_->size();
+        stamp_.assign(n, 0);
+        g_.assign(n, kInf);
+        parent_.assign(n, CellIdx<uint32_t>::kNone);
+        closed_.assign(n, 0);
+        incons_mark_.assign(n, 0);
+        heap_.reserve(n); pending_.reserve(n); incons_.reserve(n);
+        trace_.reserve(n); path_.reserve(n);
+        path_.clear(); // caminho de outra grade
+        path_version_++;
+    }
+
+    /** @brief Nova iteração (fecha conjuntos CLOSED/INCONS em O(1)); zera as marcas ao dar a volta. */
+    void next_iteration() {
+        if (++iter_ == 0) {
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            std::fill(closed_.begin(), closed_.end(), 0);
+            std::fill(incons_mark_.begin(), incons_mark_.end(), 0);
+            iter_ = 1;
+            search_ = 0; // nenhuma célula pertence à busca atual
+        }
+    }
+
+    uint32_t g(uint32_t i) const { return stamp_[i] == search_ ? g_[i] : kInf; }
+    void set_g(uint32_t i, uint32_t gv, uint32_t parent) { stamp_[i] = search_; g_[i] = gv; parent_[i] = parent; }
+    uint32_t h(uint32_t i) const {
+        const Point p = grid_->point(i);
+        return static_cast<uint32_t>(std::abs(p.x - goal_.x) + std::abs(p.y - goal_.y));
+    }
+    uint32_t key(uint32_t i, uint32_t gv) const { return gv * kOne + eps_q_ * h(i); }
+    void push(uint32_t i, uint32_t gv) {
+        heap_.push_back(Entry{key(i, gv), gv, i});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+    }
+
+    /** @brief Uma retirada da fila do ImprovePath (ou o fim dele). */
+    void search_unit() {
+        const uint32_t gt = g(t_);
+        if (heap_.empty() || (gt != kInf && uint64_t{gt} * kOne <= heap_.front().key)) {
+            if (gt == kInf) { status_ = PlanStatus::NoPath; return; }
+            trace_len_ = 1;
+            trace_cur_ = t_;
+            phase_ = Phase::Measure;
+            return;
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        const Entry e = heap_.back();
+        heap_.pop_back();
+        if (e.g != g(e.idx) || closed_[e.idx] == iter_) return; // entrada antiga
+        closed_[e.idx] = iter_;
+        const uint8_t open = grid_->openMask(*map_, e.idx);
+        const bool use_skip = skip_ && skip_->size() == grid_->size();
+        const bool use_cost = this->use_cost();
+        for (int d = 0; d < 4; ++d) {
+            if (!(open & (1u << d))) continue;
+            const uint32_t j = grid_->neighbor(e.idx, d);
+            if (use_skip && (*skip_)[j] && j != s_) continue;
+            const uint32_t ng = e.g + (use_cost ? (*cost_)(e.idx, d) : 1u);
+            if (ng >= g(j)) continue;
+            set_g(j, ng, e.idx);
+            if (closed_[j] != iter_) push(j, ng);
+            else if (incons_mark_[j] != iter_) { incons_mark_[j] = iter_; incons_.push_back(j); }
+        }
+    }
+
+    /**
+     * @brief Conta um passo da cadeia de predecessores do goal.
+     *
+     * A cadeia pode ser mais curta que g(goal): um predecessor melhorado depois
+     * não atualiza o g dos filhos já fechados (eles só voltam via INCONS).
+     */
+    void measure_unit() {
+        if (trace_cur_ != s_) {
+            trace_cur_ = parent_[trace_cur_];
+            trace_len_++;
+            return;
+        }
+        trace_.resize(trace_len_);
+        trace_pos_ = trace_len_ - 1;
+        trace_cur_ = t_;
+        phase_ = Phase::Publish;
+    }
+
+    /** @brief Copia uma célula do caminho novo; no fim troca o publicado e reduz ε (ε = 1: busca exata). */
+    void publish_unit() {
+        trace_[trace_pos_] = grid_->point(trace_cur_);
+        if (trace_pos_ > 0) {
+            trace_pos_--;
+            trace_cur_ = parent_[trace_cur_];
+            return;
+        }
+        path_.swap(trace_);
+        path_bound_ = static_cast<float>(eps_q_) / kOne;
+        path_version_++;
+        if (eps_q_ <= kOne + eps_step_q_) { begin_exact(); return; }
+        eps_q_ -= eps_step_q_;
+        // OPEN ∪ INCONS viram a fila do próximo ε; CLOSED esvazia com a nova iteração
+        prev_iter_ = iter_;
+        next_iteration();
+        if (search_ == 0) { restart(); return; } // marcas zeradas: não há como distinguir entradas válidas
+        pending_.swap(heap_);
+        heap_.clear();
+        phase_ = Phase::Rebuild;
+    }
+
+    /** @brief Transfere uma entrada de OPEN (ou INCONS) para a fila com a chave do novo ε. */
+    void rebuild_unit() {
+        if (!pending_.empty()) {
+            const Entry e = pending_.back();
+            pending_.pop_back();
+            if (e.g == g(e.idx) && closed_[e.idx] != prev_iter_) push(e.idx, e.g);
+            return;
+        }
+        if (!incons_.empty()) {
+            const uint32_t i = incons_.back();
+            incons_.pop_back();
+            push(i, g(i));
+            return;
+        }
+        phase_ = Phase::Search;
+    }
+
+    std::pmr::memory_resource* mr_;
+    const MazeMap* map_{nullptr};
+    const std::vector<uint8_t>* skip_{nullptr};
+    const EdgeCostMap* cost_{nullptr};
+    Point start_{0,0}, goal_{0,0};
+    AnytimeConfig cfg_{};
+    std::optional<CellIdx<uint32_t>> grid_;  ///< Índices/bordas da grade atual
+    std::pmr::vector<uint32_t> stamp_;       ///< Busca em que g_/parent_ da célula foram escritos
+    std::pmr::vector<uint32_t> g_;           ///< Custo a partir do start
+    std::pmr::vector<uint32_t> parent_;      ///< Predecessor no melhor caminho conhecido
+    std::pmr::vector<uint32_t> closed_;      ///< Iteração em que a célula foi fechada
+    std::pmr::vector<uint32_t> incons_mark_; ///< Iteração em que a célula entrou em INCONS
+    std::pmr::vector<Entry> heap_;           ///< OPEN (heap com entradas antigas descartadas ao sair)
+    std::pmr::vector<Entry> pending_;        ///< OPEN anterior sendo reordenado para o novo ε
+    std::pmr::vector<uint32_t> incons_;      ///< Fechadas que melhoraram (reabertas no próximo ε)
+    std::pmr::vector<Point> trace_;          ///< Caminho em montagem
+    std::pmr::vector<Point> path_;           ///< Caminho publicado
+    PlannerWorkspace exact_ws_;              ///< Estruturas da busca exata (as de `Planner::*_path_into`)
+    BibfsSearch<uint32_t> bfs_;              ///< Busca exata sem custos
+    CostSearch dial_;                        ///< Busca exata com `cost_`
+    bool exact_cost_{false};                 ///< A busca exata em andamento é `dial_`
+    uint64_t map_gen_{0};                    ///< Geração do mapa da busca atual
+    size_t skip_size_{0};                    ///< Tamanho da máscara `skip_` no início da busca
+    uint64_t total_work_{0};
+    uint32_t last_work_{0};
+    uint32_t iter_{0}, prev_iter_{0}, search_{0};
+    uint32_t eps_q_{kOne}, eps_step_q_{kOne};///< ε e passo em 1/16
+    uint32_t s_{0}, t_{0};                   ///< Índices de start e goal
+    uint32_t trace_len_{0}, trace_pos_{0}, trace_cur_{0}; ///< Comprimento e cursor do caminho em montagem
+    uint32_t path_version_{0};
+    float path_bound_{0.0f};
+    Phase phase_{Phase::Search};
+    PlanStatus status_{PlanStatus::Idle};
+};
+
+} // namespace maze
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @file Arena.hpp
+ * @brief Arena monotônica por episódio (`std::pmr`), liberada de uma vez ao fim do episódio.
+ */
+
+namespace maze {
+
+/**
+ * @brief Recurso de memória monotônico para os contêineres de um episódio.
+ *
+ * Envolve um `std::pmr::monotonic_buffer_resource` sobre um buffer inicial
+ * próprio: alocar é avançar um ponteiro, desalocar não faz nada e `reset()`
+ * devolve tudo de uma vez. Quando o buffer inicial acaba, blocos maiores vêm
+ * de `upstream` e também são devolvidos em `reset()`; depois do primeiro
+ * episódio o buffer inicial costuma bastar e o episódio não chama `malloc`.
+ *
+ * Não é thread-safe: use uma arena por thread (ex.: uma por worker do lote),
+ * o que também elimina a disputa pelo alocador global.
+ *
+ * Uso:
+ * @code
+ * EpisodeArena arena;
+ * for (...) {
+ *     {
+ *         Navigator nav(arena.resource());
+ *         // ... episódio ...
+ *     }            // contêineres destruídos antes do reset
+ *     arena.reset();
+ * }
+ * @endcode
+ *
+ * Contêineres que ainda usam a arena não podem sobreviver a `reset()`.
+ */
+class EpisodeArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @param initial_bytes tamanho do buffer inicial (> 0)
+     * @param upstream recurso para blocos além do buffer inicial
+     */
+    explicit EpisodeArena(size_t initial_bytes = 64 * 1024,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : buffer_(new std::byte[initial_bytes > 0 ? initial_bytes : 1]),
+          mono_(buffer_.get(), initial_bytes > 0 ? initial_bytes : 1, upstream) {}
+
+    EpisodeArena(const EpisodeArena&) = delete;
+    EpisodeArena& operator=(const EpisodeArena&) = delete;
+
+    /** @brief Recurso a passar aos contêineres do episódio. */
+    std::pmr::memory_resource* resource() { return this; }
+
+    /** @brief Libera todas as alocações do episódio (volta ao buffer inicial). */
+    void reset() {
+        mono_.release();
+        if (bytes_ > peak_) peak_ = bytes_;
+        bytes_ = 0;
+        allocations_ = 0;
+    }
+
+    /** @brief Bytes pedidos desde o último `reset()`. */
+    size_t bytesAllocated() const { return bytes_; }
+    /** @brief Alocações desde o último `reset()`. */
+    size_t allocations() const { return allocations_; }
+    /** @brief Maior `bytesAllocated()` entre episódios já encerrados (para dimensionar o buffer). */
+    size_t peakBytes() const { return bytes_ > peak_ ? bytes_ : peak_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        bytes_ += bytes;
+        allocations_++;
+        return mono_.allocate(bytes, alignment);
+    }
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::unique_ptr<std::byte[]> buffer_;        ///< Buffer inicial (reaproveitado a cada episódio)
+    std::pmr::monotonic_buffer_resource mono_;   ///< Alocador por avanço de ponteiro
+    size_t bytes_{0};                            ///< Bytes no episódio atual
+    size_t allocations_{0};                      ///< Alocações no episódio atual
+    size_t peak_{0};                             ///< Maior episódio encerrado
+};
+
+} // namespace maze
@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+#include <limits>
+#include "MazeMap.hpp"
+
+/**
+ * @file CellIdx.hpp
+ * @brief Índices lineares compactos de célula com vizinhança por offsets pré-calculados.
+ */
+
+namespace maze {
+
+/**
+ * @brief Espaço de índices lineares (`y*w + x`) de uma grade w×h com largura de índice `IndexT`.
+ *
+ * `IndexT` é `uint16_t` (grades de até 65535 células, ex.: 16x16 a 255x255)
+ * ou `uint32_t`. Filas e vetores `prev` dos planejadores guardam `IndexT` em
+ * vez de `Point` (8 bytes) ou `int`, ocupando 1/4 ou 1/2 da memória.
+ *
+ * Vizinhança sem aritmética de coordenadas no laço interno: `neighbor(i, d)`
+ * soma o offset pré-calculado da direção (N=-w, E=+1, S=+w, W=-1) e
+ * `border(i)` diz quais vizinhos existem (bits NESW = 1,2,4,8). Coordenadas só
+ * são recuperadas (`point()`) na reconstrução do caminho.
+ *
+ * @tparam IndexT tipo inteiro sem sinal do índice
+ */
+template <typename IndexT>
+class CellIdx {
+public:
+    using index_type = IndexT;
+    /** @brief Índice inválido (também usado como "sem predecessor"). */
+    static constexpr IndexT kNone = std::numeric_limits<IndexT>::max();
+
+    /** @brief true se uma grade w×h cabe em `IndexT` (reservando `kNone`). */
+    static bool fits(int w, int h) {
+        return w > 0 && h > 0 && static_cast<uint64_t>(w) * static_cast<uint64_t>(h) < static_cast<uint64_t>(kNone);
+    }
+
+    /**
+     * @brief Pré-calcula offsets e máscaras de borda. O(w*h).
+     * @param w largura
+     * @param h altura
+     * @param mr recurso de memória das máscaras de borda
+     */
+    CellIdx(int w, int h, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : w_(w), h_(h), border_(static_cast<size_t>(w) * h, mr) {
+        offset_[0] = -w; offset_[1] = 1; offset_[2] = w; offset_[3] = -1;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                uint8_t m = 0;
+                if (y > 0)     m |= 1u;
+                if (x + 1 < w) m |= 2u;
+                if (y + 1 < h) m |= 4u;
+                if (x > 0)     m |= 8u;
+                border_[static_cast<size_t>(y) * w + x] = m;
+            }
+        }
+    }
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    /** @brief Número de células. */
+    size_t size() const { return border_.size(); }
+
+    /** @brief Índice da célula (x,y) (sem verificação de limites). */
+    IndexT index(int x, int y) const { return static_cast<IndexT>(y * w_ + x); }
+    /** @brief Índice da célula `p` (sem verificação de limites). */
+    IndexT index(Point p) const { return index(p.x, p.y); }
+    /** @brief Coordenadas da célula `i`. */
+    Point point(IndexT i) const { return Point{static_cast<int>(i) % w_, static_cast<int>(i) / w_}; }
+
+    /** @brief Vizinho de `i` na direção `d` (0=N,1=E,2=S,3=W); válido apenas se `border(i)` tem o bit `d`. */
+    IndexT neighbor(IndexT i, int d) const { return static_cast<IndexT>(static_cast<int>(i) + offset_[d]); }
+    /** @brief Vizinhos existentes de `i` (bits NESW). */
+    uint8_t border(IndexT i) const { return border_[i]; }
+
+    /** @brief Paredes da célula como bits NESW (1,2,4,8). */
+    static uint8_t wallBits(const Cell& c) {
+        return static_cast<uint8_t>((c.wall_n ? 1u : 0u) | (c.wall_e ? 2u : 0u) | (c.wall_s ? 4u : 0u) | (c.wall_w ? 8u : 0u));
+    }
+    /** @brief Passagens de `i` para vizinhos existentes (bits NESW), segundo as paredes da própria célula. */
+    uint8_t openMask(const MazeMap& map, IndexT i) const {
+        return static_cast<uint8_t>(~wallBits(map.at_index(i)) & border_[i]);
+    }
+
+private:
+    int w_;
+    int h_;
+    int offset_[4];               ///< Deslocamento linear por direção (N,E,S,W)
+    std::pmr::vector<uint8_t> border_; ///< Vizinhos dentro da grade (bits NESW)
+};
+
+} // namespace maze
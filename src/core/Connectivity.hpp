@@ -0,0 +1,165 @@
+#pragma once
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+#include "MazeMap.hpp"
+
+/**
+ * @file Connectivity.hpp
+ * @brief Rotulagem de componentes conexas do grafo aberto via union-find.
+ */
+
+namespace maze {
+
+/**
+ * @brief Componentes conexas das células do `MazeMap` mantidas com union-find.
+ *
+ * Remoções de parede unem componentes em O(α(n)). Adições de parede podem
+ * dividir uma componente, o que o union-find não desfaz: a estrutura passa a
+ * ser "stale" e continua sendo uma sobre-aproximação segura (rótulos
+ * diferentes garantem que não há caminho). A reconstrução exata é preguiçosa
+ * e só ocorre quando `connected()` é consultado em estado stale.
+ *
+ * Uso típico no `Navigator`: `mayConnect()` antes do BFS para descartar buscas
+ * fadadas ao fracasso, e `rebuild()` após um BFS sem sucesso.
+ */
+class Connectivity {
+public:
+    /** @param mr recurso de memória dos rótulos */
+    explicit Connectivity(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : parent_(mr), rank_(mr) {}
+
+    /** @brief Descarta os rótulos; a próxima consulta reconstrói a partir do mapa. */
+    void invalidate() { valid_ = false; }
+    /** @brief true se os rótulos refletem exatamente o mapa (sem reconstrução pendente). */
+    bool exact() const { return valid_ && !stale_; }
+
+    /**
+     * @brief Reconstrói os rótulos a partir das paredes atuais do mapa. O(n·α(n)).
+     * @param map mapa de referência
+     */
+    void rebuild(const MazeMap& map) {
+        w_ = map.width();
+        h_ = map.height();
+        const int n = w_ * h_;
+        parent_.resize(n);
+        rank_.assign(n, 0);
+        for (int i = 0; i < n; ++i) parent_[i] = i;
+        components_ = n;
+        for (int y = 0; y < h_; ++y) {
+            for (int x = 0; x < w_; ++x) {
+                // Aresta aberta se qualquer lado estiver aberto (sobre-aproximação segura)
+                if (x + 1 < w_ && (!map.at(x,y).wall_e || !map.at(x+1,y).wall_w)) unite(y*w_ + x, y*w_ + x + 1);
+                if (y + 1 < h_ && (!map.at(x,y).wall_s || !map.at(x,y+1).wall_n)) unite(y*w_ + x, (y+1)*w_ + x);
+            }
+        }
+        valid_ = true;
+        stale_ = false;
+        synced_gen_ = map.generation();
+    }
+
+    /**
+     * @brief Aplica as paredes alteradas no mapa desde a última sincronização.
+     *
+     * Lê o journal do mapa (`MazeMap::changesSince`): remoções unem e adições
+     * marcam stale, como `onWallRemoved`/`onWallAdded`. Se o journal não cobre
+     * o intervalo, apenas invalida (reconstrução na próxima consulta).
+     */
+    void sync(const MazeMap& map) {
+        const bool covered = valid_ && map.changesSince(synced_gen_, [&](const WallEdit& e) {
+            const Point c = map.edgeCell(e.edge);
+            if (e.new_value) onWallAdded(c.x, c.y, MazeMap::edgeDir(e.edge));
+            else onWallRemoved(c.x, c.y, MazeMap::edgeDir(e.edge));
+        });
+        if (!covered) invalidate();
+        synced_gen_ = map.generation();
+    }
+
+    /**
+     * @brief Notifica a remoção da parede entre (x,y) e o vizinho em `dir`. O(α(n)).
+     * @param x coluna da célula base
+     * @param y linha da célula base
+     * @param dir direção do vizinho
+     */
+    void onWallRemoved(int x, int y, Dir dir) {
+        if (!valid_) return;
+        const int nx = x + dx(dir), ny = y + dy(dir);
+        if (!inside(x,y) || !inside(nx,ny)) return;
+        unite(y*w_ + x, ny*w_ + nx);
+    }
+    /** @brief Como `onWallRemoved(int,int,Dir)` com 'N','E','S','W'; letras inválidas são ignoradas. */
+    void onWallRemoved(int x, int y, char dir) {
+        if (is_dir_char(dir)) onWallRemoved(x, y, from_char(dir));
+    }
+
+    /**
+     * @brief Notifica a adição de parede; apenas marca os rótulos como stale.
+     */
+    void onWallAdded(int /*x*/, int /*y*/, Dir /*dir*/) {
+        if (valid_) stale_ = true;
+    }
+    /** @brief Como `onWallAdded(int,int,Dir)` com 'N','E','S','W'. */
+    void onWallAdded(int x, int y, char dir) {
+        if (is_dir_char(dir)) onWallAdded(x, y, from_char(dir));
+    }
+
+    /**
+     * @brief Teste rápido de alcançabilidade (sobre-aproximado). O(α(n)).
+     *
+     * `false` garante que não há caminho entre `a` e `b` no mapa; `true` pode
+     * ser falso positivo quando há paredes adicionadas desde a última
+     * reconstrução. Só reconstrói se os rótulos foram invalidados.
+     */
+    bool mayConnect(const MazeMap& map, Point a, Point b) {
+        if (!valid_ || map.width() != w_ || map.height() != h_) rebuild(map);
+        if (!inside(a.x,a.y) || !inside(b.x,b.y)) return false;
+        return find(a.y*w_ + a.x) == find(b.y*w_ + b.x);
+    }
+
+    /**
+     * @brief Teste exato de alcançabilidade; reconstrói se houver rótulos stale.
+     */
+    bool connected(const MazeMap& map, Point a, Point b) {
+        if (!exact() || map.width() != w_ || map.height() != h_) rebuild(map);
+        return mayConnect(map, a, b);
+    }
+
+    /** @brief Número exato de componentes conexas do mapa. */
+    int componentCount(const MazeMap& map) {
+        if (!exact() || map.width() != w_ || map.height() != h_) rebuild(map);
+        return components_;
+    }
+
+private:
+    bool inside(int x, int y) const { return x>=0 && y>=0 && x<w_ && y<h_; }
+
+    /** @brief Busca do representante com compressão por divisão de caminho. */
+    int find(int i) {
+        while (parent_[i] != i) {
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    /** @brief União por rank. */
+    void unite(int a, int b) {
+        a = find(a); b = find(b);
+        if (a == b) return;
+        if (rank_[a] < rank_[b]) { int t = a; a = b; b = t; }
+        parent_[b] = a;
+        if (rank_[a] == rank_[b]) rank_[a]++;
+        components_--;
+    }
+
+    int w_{0};                   ///< Largura dos rótulos atuais
+    int h_{0};                   ///< Altura dos rótulos atuais
+    std::pmr::vector<int> parent_;   ///< Pai no union-find (índice linear)
+    std::pmr::vector<uint8_t> rank_; ///< Rank por raiz
+    int components_{0};          ///< Componentes no último estado exato/unido
+    bool valid_{false};          ///< Rótulos construídos para o mapa atual
+    bool stale_{false};          ///< Paredes adicionadas desde a última reconstrução
+    uint64_t synced_gen_{0};     ///< Geração do mapa já refletida (`sync`)
+};
+
+} // namespace maze
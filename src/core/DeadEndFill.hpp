@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "MazeMap.hpp"
+
+/**
+ * @file DeadEndFill.hpp
+ * @brief Pré-processamento de preenchimento de becos sem saída (dead-end filling).
+ */
+
+namespace maze {
+
+/**
+ * @brief Estatísticas do preenchimento de becos.
+ */
+struct PruneStats {
+    int cells{0};     ///< Total de células do mapa
+    int pruned{0};    ///< Células marcadas como podadas (becos)
+    int remaining{0}; ///< Células restantes (cells - pruned)
+};
+
+/**
+ * @brief Preenche iterativamente becos sem saída e marca as células podadas.
+ *
+ * Uma célula (exceto `start`/`goal`) com no máximo uma passagem aberta para
+ * células não podadas não pode estar no interior de um caminho simples entre
+ * start e goal; ela é podada e o grau dos vizinhos é decrementado. A fila
+ * garante custo linear: cada célula entra no máximo uma vez.
+ *
+ * Em labirintos perfeitos restam apenas as células do corredor da solução.
+ * Também é seguro sobre o mapa otimista do `Navigator` (células desconhecidas
+ * sem paredes), pois paredes descobertas depois só removem arestas.
+ *
+ * @param map    mapa de entrada
+ * @param start  célula protegida (início)
+ * @param goal   célula protegida (objetivo)
+ * @param pruned saída com w*h bytes: 1 = podada, 0 = mantida
+ * @return estatísticas de poda
+ */
+inline PruneStats fill_dead_ends(const MazeMap& map, Point start, Point goal, std::vector<uint8_t>& pruned) {
+    const int w = map.width();
+    const int h = map.height();
+    const int n = w * h;
+    pruned.assign(n, 0);
+    std::vector<uint8_t> degree(n, 0);
+    auto idx = [&](int x,int y){ return y*w + x; };
+    auto is_protected = [&](int i){
+        return (map.in_bounds(start.x,start.y) && i == idx(start.x,start.y)) ||
+               (map.in_bounds(goal.x,goal.y) && i == idx(goal.x,goal.y));
+    };
+    for (int y=0; y<h; ++y) {
+        for (int x=0; x<w; ++x) {
+            const Cell& c = map.at(x,y);
+            uint8_t d = 0;
+            if (!c.wall_n && map.in_bounds(x,y-1)) d++;
+            if (!c.wall_e && map.in_bounds(x+1,y)) d++;
+            if (!c.wall_s && map.in_bounds(x,y+1)) d++;
+            if (!c.wall_w && map.in_bounds(x-1,y)) d++;
+            degree[idx(x,y)] = d;
+        }
+    }
+    std::vector<int> queue;
+    queue.reserve(n);
+    for (int i=0; i<n; ++i) {
+        if (degree[i] <= 1 && !is_protected(i)) { pruned[i] = 1; queue.push_back(i); }
+    }
+    // Cada célula podada reduz o grau dos vizinhos ainda mantidos
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int i = queue[head];
+        const int x = i % w, y = i / w;
+        const Cell& c = map.at(x,y);
+        auto relax = [&](bool open, int nx, int ny){
+            if (!open || !map.in_bounds(nx,ny)) return;
+            const int j = idx(nx,ny);
+            if (pruned[j]) return;
+            if (degree[j] > 0) degree[j]--;
+            if (degree[j] <= 1 && !is_protected(j)) { pruned[j] = 1; queue.push_back(j); }
+        };
+        relax(!c.wall_n, x, y-1);
+        relax(!c.wall_e, x+1, y);
+        relax(!c.wall_s, x, y+1);
+        relax(!c.wall_w, x-1, y);
+    }
+    PruneStats st;
+    st.cells = n;
+    st.pruned = static_cast<int>(queue.size());
+    st.remaining = n - st.pruned;
+    return st;
+}
+
+} // namespace maze
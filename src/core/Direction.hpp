@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @file Direction.hpp
+ * @brief Álgebra de direções por tabelas constexpr (giro, oposta, relativa→absoluta, dx/dy, bits de parede).
+ */
+
+namespace maze {
+
+/** @brief Ação possível do robô sobre a malha do labirinto. */
+enum class Action : uint8_t { Right, Forward, Left, Back };
+
+/**
+ * @brief Direção absoluta na grade; o valor coincide com o `heading` (0=N,1=E,2=S,3=W).
+ *
+ * Toda conversão é uma consulta a tabela `constexpr` indexada pelo valor da
+ * direção, sem `switch` nem laços sobre caracteres no caminho por passo.
+ * Convenção da grade: y cresce para o sul (N = y-1).
+ */
+enum class Dir : uint8_t { N = 0, E = 1, S = 2, W = 3 };
+
+namespace dir_tables {
+/** @brief Deslocamento em x por direção. */
+constexpr int8_t kDx[4] = { 0, 1, 0, -1 };
+/** @brief Deslocamento em y por direção. */
+constexpr int8_t kDy[4] = { -1, 0, 1, 0 };
+/** @brief Bit de parede/passagem por direção (máscaras NESW = 1,2,4,8). */
+constexpr uint8_t kWallBit[4] = { 1u, 2u, 4u, 8u };
+/** @brief Letra da direção. */
+constexpr char kChar[4] = { 'N', 'E', 'S', 'W' };
+/** @brief Quartos de volta no sentido horário de cada `Action` (Right, Forward, Left, Back). */
+constexpr uint8_t kActionTurn[4] = { 1u, 0u, 3u, 2u };
+/** @brief Ação que leva do heading à direção absoluta, indexada por (abs - heading) & 3. */
+constexpr Action kDeltaAction[4] = { Action::Forward, Action::Right, Action::Back, Action::Left };
+
+/** @brief Valor inválido em `kFromChar`. */
+constexpr uint8_t kInvalid = 0xFFu;
+/** @brief Tabela ASCII → direção ('N','E','S','W'; demais = `kInvalid`). */
+struct CharTable {
+    uint8_t v[128];
+    constexpr CharTable() : v{} {
+        for (int i = 0; i < 128; ++i) v[i] = kInvalid;
+        v[static_cast<int>('N')] = 0; v[static_cast<int>('E')] = 1;
+        v[static_cast<int>('S')] = 2; v[static_cast<int>('W')] = 3;
+    }
+};
+constexpr CharTable kFromChar{};
+} // namespace dir_tables
+
+/** @brief Índice 0..3 da direção. */
+constexpr uint8_t idx(Dir d) { return static_cast<uint8_t>(d); }
+/** @brief Direção a partir do heading (0=N,1=E,2=S,3=W; usa só os 2 bits baixos). */
+constexpr Dir from_heading(uint8_t h) { return static_cast<Dir>(h & 3u); }
+/** @brief Gira `quarter_turns` quartos de volta no sentido horário (negativo = anti-horário). */
+constexpr Dir rotate(Dir d, int quarter_turns) { return static_cast<Dir>((idx(d) + quarter_turns) & 3); }
+/** @brief Direção oposta. */
+constexpr Dir opposite(Dir d) { return rotate(d, 2); }
+/** @brief Deslocamento em x. */
+constexpr int dx(Dir d) { return dir_tables::kDx[idx(d)]; }
+/** @brief Deslocamento em y. */
+constexpr int dy(Dir d) { return dir_tables::kDy[idx(d)]; }
+/** @brief Bit de parede da direção (NESW = 1,2,4,8). */
+constexpr uint8_t wall_bit(Dir d) { return dir_tables::kWallBit[idx(d)]; }
+/** @brief Letra 'N','E','S','W'. */
+constexpr char to_char(Dir d) { return dir_tables::kChar[idx(d)]; }
+/** @brief true se `c` é uma letra de direção válida. */
+constexpr bool is_dir_char(char c) {
+    return static_cast<unsigned char>(c) < 128u && dir_tables::kFromChar.v[static_cast<unsigned char>(c)] != dir_tables::kInvalid;
+}
+/** @brief Direção da letra (pré-condição: `is_dir_char(c)`). */
+constexpr Dir from_char(char c) { return static_cast<Dir>(dir_tables::kFromChar.v[static_cast<unsigned char>(c) & 127u] & 3u); }
+
+/** @brief Direção absoluta resultante de executar `a` com orientação `heading`. */
+constexpr Dir rel_to_abs(Dir heading, Action a) {
+    return rotate(heading, dir_tables::kActionTurn[static_cast<uint8_t>(a)]);
+}
+/** @brief Ação relativa que, com orientação `heading`, leva à direção absoluta `abs`. */
+constexpr Action abs_to_action(Dir heading, Dir abs) {
+    return dir_tables::kDeltaAction[(idx(abs) - idx(heading)) & 3];
+}
+
+static_assert(rel_to_abs(Dir::N, Action::Left) == Dir::W, "esquerda de N é W");
+static_assert(rel_to_abs(Dir::W, Action::Right) == Dir::N, "direita de W é N");
+static_assert(abs_to_action(Dir::E, Dir::N) == Action::Left, "N é à esquerda de E");
+static_assert(opposite(Dir::S) == Dir::N && from_char('W') == Dir::W && !is_dir_char('X'), "tabelas de direção");
+
+} // namespace maze
@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Direction.hpp"
+#include "MazeMap.hpp"
+
+/**
+ * @file EdgeCost.hpp
+ * @brief Camada de custo por aresta aprendida dos tempos de travessia medidos (EMA em ponto fixo).
+ */
+
+namespace maze {
+
+/**
+ * @brief Parâmetros da camada de custos (`EdgeCostMap`).
+ *
+ * O custo de planejamento de uma aresta é o tempo médio medido dividido por
+ * `unit_ms` (arredondado, entre 1 e 255), para uso direto no
+ * `Planner::dial_path_into()`.
+ */
+struct EdgeCostConfig {
+    uint16_t unit_ms{10};     ///< Milissegundos por unidade de custo
+    uint16_t nominal_ms{150}; ///< Tempo assumido enquanto nenhuma aresta foi medida
+    uint8_t alpha_shift{2};   ///< Peso da amostra nova: alpha = 1 / 2^alpha_shift
+};
+
+/**
+ * @brief Tempo de travessia aprendido por aresta dirigida (célula, direção de saída).
+ *
+ * Cada entrada é uma média móvel exponencial em ponto fixo Q12.4
+ * (1/16 ms, até ~4,1 s) do tempo entre entrar na célula e entrar na vizinha,
+ * então inclui o giro feito na célula, esperas e deslizes: corredores com
+ * curvas fechadas ou zonas cegas dos sensores ficam mais caros. Zero marca
+ * aresta ainda não medida; ela usa a medida do sentido contrário, se houver,
+ * ou a média das arestas medidas (sem otimismo por falta de dados).
+ *
+ * O índice é o mesmo da tabela do `Planner::dial_path()` (`4*célula + dir`) e
+ * `operator()(cell, dir)` devolve o custo `uint8_t`, de modo que o próprio
+ * mapa serve de functor de custo. Atualizar uma aresta é O(1) e sem alocação;
+ * `raw()`/`assignRaw()` expõem as médias para `PersistentMemory`.
+ */
+class EdgeCostMap {
+public:
+    /** @brief Escala do ponto fixo: 16 unidades por milissegundo. */
+    static constexpr uint32_t kFracPerMs = 16;
+    /** @brief Maior média representável (Q12.4). */
+    static constexpr uint32_t kMaxEma = 0xFFFFu;
+
+    explicit EdgeCostMap(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : ema_(mr) {}
+
+    /**
+     * @brief Ajusta para uma grade w×h; as medições são mantidas se as dimensões não mudam.
+     *
+     * Assim vários episódios no mesmo labirinto acumulam tempos; use `clear()`
+     * ao trocar de labirinto.
+     */
+    void resize(int w, int h) {
+        if (w == w_ && h == h_) return;
+        w_ = w;
+        h_ = h;
+        ema_.assign(static_cast<size_t>(w) * static_cast<size_t>(h) * 4, 0);
+        sum_ = 0;
+        count_ = 0;
+    }
+    /** @brief Esquece todas as medições. */
+    void clear() {
+        std::fill(ema_.begin(), ema_.end(), 0);
+        sum_ = 0;
+        count_ = 0;
+    }
+
+    void setConfig(const EdgeCostConfig& cfg) { cfg_ = cfg; }
+    const EdgeCostConfig& config() const { return cfg_; }
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    /** @brief Arestas dirigidas com ao menos uma medição. */
+    size_t measured() const { return count_; }
+
+    /**
+     * @brief Incorpora uma travessia medida de `from` para o vizinho em `d`.
+     *
+     * A primeira amostra de uma aresta é usada como está; as seguintes entram
+     * com peso 1/2^alpha_shift.
+     *
+     * @param dt_ms tempo desde a entrada em `from` até a entrada no vizinho
+     * @return false se a aresta sai da grade
+     */
+    bool record(Point from, Dir d, uint32_t dt_ms) {
+        const Point to = step(from, d);
+        if (!inGrid(from) || !inGrid(to)) return false;
+        const size_t e = edge(from, d);
+        const uint32_t sample = dt_ms >= kMaxEma / kFracPerMs ? kMaxEma : (dt_ms == 0 ? 1u : dt_ms * kFracPerMs);
+        const uint32_t old = ema_[e];
+        uint32_t now = sample;
+        if (old != 0) {
+            const int32_t delta = static_cast<int32_t>(sample) - static_cast<int32_t>(old);
+            now = static_cast<uint32_t>(static_cast<int32_t>(old) + delta / (1 << cfg_.alpha_shift));
+            if (now == 0) now = 1;
+        } else {
+            count_++;
+        }
+        ema_[e] = static_cast<uint16_t>(now);
+        sum_ += now;
+        sum_ -= old;
+        return true;
+    }
+
+    /** @brief Média medida em `edge = 4*célula + dir` (Q12.4; 0 = não medida). */
+    uint16_t ema(size_t edge) const { return edge < ema_.size() ? ema_[edge] : 0; }
+
+    /** @brief Tempo estimado da aresta em Q12.4: medido, senão o sentido contrário, senão a média. */
+    uint32_t estimate(size_t cell, int dir) const {
+        const size_t e = cell * 4 + static_cast<size_t>(dir);
+        if (e >= ema_.size()) return fallback();
+        if (ema_[e] != 0) return ema_[e];
+        const int x = static_cast<int>(cell % static_cast<size_t>(w_)), y = static_cast<int>(cell / static_cast<size_t>(w_));
+        const Dir d = from_heading(static_cast<uint8_t>(dir));
+        const Point q = step(Point{x, y}, d);
+        if (inGrid(q)) {
+            const uint16_t back = ema_[edge(q, opposite(d))];
+            if (back != 0) return back;
+        }
+        return fallback();
+    }
+
+    /** @brief Custo de planejamento (1..255) da aresta dirigida; functor de `Planner::dial_path_into()`. */
+    uint8_t operator()(size_t cell, int dir) const {
+        const uint32_t unit = static_cast<uint32_t>(cfg_.unit_ms ? cfg_.unit_ms : 1) * kFracPerMs;
+        const uint32_t c = (estimate(cell, dir) + unit / 2) / unit;
+        return static_cast<uint8_t>(c < 1 ? 1 : (c > 255 ? 255 : c));
+    }
+
+    /** @brief Médias por aresta (Q12.4), `4*w*h` entradas. */
+    const std::pmr::vector<uint16_t>& raw() const { return ema_; }
+
+    /**
+     * @brief Substitui as médias por `n` valores gravados (ex.: carregados da flash).
+     * @return false se `n` não corresponde a uma grade w×h
+     */
+    bool assignRaw(int w, int h, const uint16_t* data, size_t n) {
+        if (w <= 0 || h <= 0 || n != static_cast<size_t>(w) * static_cast<size_t>(h) * 4) return false;
+        resize(w, h);
+        ema_.assign(data, data + n);
+        sum_ = 0;
+        count_ = 0;
+        for (uint16_t v : ema_) {
+            sum_ += v;
+            count_ += v != 0;
+        }
+        return true;
+    }
+
+private:
+    bool inGrid(Point p) const { return p.x >= 0 && p.y >= 0 && p.x < w_ && p.y < h_; }
+    size_t edge(Point p, Dir d) const {
+        return (static_cast<size_t>(p.y) * static_cast<size_t>(w_) + static_cast<size_t>(p.x)) * 4 + maze::idx(d);
+    }
+    uint32_t fallback() const {
+        return count_ ? static_cast<uint32_t>(sum_ / count_) : static_cast<uint32_t>(cfg_.nominal_ms) * kFracPerMs;
+    }
+
+    int w_{0}, h_{0};
+    std::pmr::vector<uint16_t> ema_; ///< Média Q12.4 por aresta dirigida (0 = não medida)
+    uint64_t sum_{0};                ///< Soma das médias medidas (para a média global)
+    size_t count_{0};                ///< Arestas medidas
+    EdgeCostConfig cfg_{};
+};
+
+} // namespace maze
@@ -0,0 +1,341 @@
+#pragma once
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "MazeMap.hpp"
+
+/**
+ * @file JumpPointSearch.hpp
+ * @brief Jump Point Search 4-conexo sobre paredes de aresta do `MazeMap`, com varredura por bitboards.
+ */
+
+namespace maze {
+
+/**
+ * @brief Jump Point Search (JPS) para grades 4-conexas com paredes entre células.
+ *
+ * Ordem canônica dos caminhos mínimos: segmentos verticais podem virar para a
+ * horizontal em qualquer célula; segmentos horizontais só viram para a
+ * vertical em células "forçadas", isto é, quando o desvio equivalente que vira
+ * uma célula antes (`prev → prev+v → c+v`) está bloqueado. Com isso:
+ * - a varredura horizontal só para no goal ou em célula forçada;
+ * - a varredura vertical para no goal ou em células de onde uma varredura
+ *   horizontal (para qualquer lado) encontra um ponto de salto.
+ *
+ * Apenas pontos de salto entram na lista aberta (A* com heurística Manhattan),
+ * então em salas abertas o número de expansões cai drasticamente; em
+ * corredores de labirinto quase toda curva é ponto de salto e o custo fica
+ * próximo do BFS. O comprimento do caminho é sempre igual ao do BFS.
+ *
+ * As varreduras usam bitboards (64 células por palavra). Por linha: "pode
+ * andar para E/W" e "célula forçada ao andar para E/W"; por coluna: "pode
+ * andar para N/S" e "existe salto horizontal a partir daqui". O próximo ponto
+ * de parada é o primeiro bit ligado depois da posição atual, limitado pelo
+ * primeiro bit desligado da máscara de passagem.
+ *
+ * As máscaras dependem só das paredes: construa uma vez por mapa e reutilize
+ * `find()` para várias consultas. Para consulta única, `Planner::jps_path()`.
+ */
+class JumpPointSearch {
+public:
+    /**
+     * @brief Constrói as máscaras por linha a partir das paredes. O(n).
+     * @param map  mapa do labirinto (semântica de paredes igual a `Planner::bfs_path`)
+     * @param skip máscara opcional (w*h bytes, 1 = célula bloqueada)
+     */
+    explicit JumpPointSearch(const MazeMap& map, const std::vector<uint8_t>* skip = nullptr)
+        : w_(map.width()), h_(map.height()), words_((map.width() + 63) / 64) {
+        const int n = w_ * h_;
+        const bool use_skip = skip && static_cast<int>(skip->size()) == n;
+        blocked_.assign(n, 0);
+        if (use_skip) blocked_ = *skip;
+        const size_t total = static_cast<size_t>(words_) * h_;
+        open_e_.assign(total, 0); open_w_.assign(total, 0);
+        open_n_.assign(total, 0); open_s_.assign(total, 0);
+        forced_e_.assign(total, 0); forced_w_.assign(total, 0);
+        auto free = [&](int x, int y){ return map.in_bounds(x,y) && !blocked_[y*w_ + x]; };
+        for (int y = 0; y < h_; ++y) {
+            for (int x = 0; x < w_; ++x) {
+                if (!free(x,y)) continue;
+                const Cell& c = map.at(x,y);
+                if (!c.wall_e && free(x+1,y)) set(open_e_, x, y);
+                if (!c.wall_w && free(x-1,y)) set(open_w_, x, y);
+                if (!c.wall_n && free(x,y-1)) set(open_n_, x, y);
+                if (!c.wall_s && free(x,y+1)) set(open_s_, x, y);
+            }
+        }
+        // Célula forçada: vira para a vertical e o desvio que vira uma célula antes está bloqueado
+        int forced_count = 0;
+        for (int y = 0; y < h_; ++y) {
+            for (int x = 0; x < w_; ++x) {
+                for (int dx = -1; dx <= 1; dx += 2) {
+                    const int px = x - dx;
+                    if (!map.in_bounds(px, y)) continue;
+                    const auto& along = dx > 0 ? open_e_ : open_w_;
+                    bool forced = false;
+                    for (int dy = -1; dy <= 1 && !forced; dy += 2) {
+                        const auto& vert = dy < 0 ? open_n_ : open_s_;
+                        if (!test(vert, x, y)) continue;
+                        const bool detour = test(vert, px, y) && test(along, px, y + dy);
+                        forced = !detour;
+                    }
+                    if (forced) { set(dx > 0 ? forced_e_ : forced_w_, x, y); forced_count++; }
+                }
+            }
+        }
+        // Por coluna: passagem vertical e "salto horizontal existe" (sem contar o goal),
+        // para que a varredura vertical também seja uma busca de bit
+        cwords_ = (h_ + 63) / 64;
+        const size_t ctotal = static_cast<size_t>(cwords_) * w_;
+        col_n_.assign(ctotal, 0); col_s_.assign(ctotal, 0); col_stop_.assign(ctotal, 0);
+        std::vector<uint8_t> jump_e(w_), jump_w(w_);
+        for (int y = 0; y < h_; ++y) {
+            for (int x = w_ - 1; x >= 0; --x)
+                jump_e[x] = test(open_e_, x, y) && (test(forced_e_, x+1, y) || jump_e[x+1]);
+            for (int x = 0; x < w_; ++x)
+                jump_w[x] = test(open_w_, x, y) && (test(forced_w_, x-1, y) || jump_w[x-1]);
+            for (int x = 0; x < w_; ++x) {
+                const size_t at = static_cast<size_t>(x)*cwords_ + (y >> 6);
+                const uint64_t bit = 1ull << (y & 63);
+                if (test(open_n_, x, y)) col_n_[at] |= bit;
+                if (test(open_s_, x, y)) col_s_[at] |= bit;
+                if (jump_e[x] || jump_w[x]) col_stop_[at] |= bit;
+            }
+        }
+        // Labirintos de corredores: quase toda célula é forçada e o A* sobre pontos de
+        // salto custa mais que um BFS simples; `find()` usa o BFS sobre as máscaras
+        corridor_mode_ = n > 0 && forced_count * 100 > kCorridorForcedPct * 2 * n;
+    }
+
+    /** @brief true se `find()` usa o BFS sobre as máscaras em vez dos saltos (mapa de corredores). */
+    bool corridorMode() const { return corridor_mode_; }
+
+    /**
+     * @brief Caminho mínimo de `start` a `goal`.
+     * @param start célula inicial
+     * @param goal  célula objetivo
+     * @param expansions saída opcional: pontos de salto expandidos
+     * @return sequência de pontos incluindo início e objetivo, ou std::nullopt se inalcançável
+     */
+    std::optional<std::vector<Point>> find(Point start, Point goal, int* expansions = nullptr) const {
+        if (expansions) *expansions = 0;
+        if (!inside(start.x,start.y) || !inside(goal.x,goal.y)) return std::nullopt;
+        const int s = start.y*w_ + start.x;
+        const int g = goal.y*w_ + goal.x;
+        if (blocked_[g]) return std::nullopt;
+        if (s == g) return std::vector<Point>{start};
+
+        // Espaço de trabalho reaproveitado entre consultas; `stamp_` evita limpar O(n) a cada chamada
+        const int n = w_ * h_;
+        if (static_cast<int>(stamp_.size()) != n) { stamp_.assign(n, 0); gcost_.resize(n); parent_.resize(n); query_ = 0; }
+        if (++query_ >= 0x7fffffffu) { std::fill(stamp_.begin(), stamp_.end(), 0u); query_ = 1; }
+        const int expanded = corridor_mode_ ? search_bfs(s, g) : search_jumps(s, goal);
+        if (expansions) *expansions = expanded;
+        if (!closed(g)) return std::nullopt;
+
+        // Reconstrói interpolando os segmentos retos entre pontos de salto
+        std::vector<Point> path;
+        path.reserve(gcost_[g] + 1);
+        for (int cur = g; cur != s; cur = parent_[cur]) {
+            int x = cur % w_, y = cur / w_;
+            const int px = parent_[cur] % w_, py = parent_[cur] / w_;
+            while (x != px || y != py) {
+                path.push_back({x,y});
+                x += sign(px - x);
+                y += sign(py - y);
+            }
+        }
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+private:
+    int w_, h_, words_, cwords_{0};
+    std::vector<uint8_t> blocked_;
+    std::vector<uint64_t> open_e_, open_w_, open_n_, open_s_; ///< Passagem aberta para o vizinho (bit x da linha y)
+    std::vector<uint64_t> forced_e_, forced_w_;               ///< Célula forçada ao chegar andando para E / W
+    std::vector<uint64_t> col_n_, col_s_, col_stop_;          ///< Por coluna (bit y): passagem N/S e salto horizontal existente
+    // Espaço de trabalho de `find()` (não faz parte do estado lógico)
+    mutable std::vector<uint32_t> stamp_;
+    mutable std::vector<int> gcost_, parent_;
+    mutable std::vector<std::pair<int,int>> heap_;
+    mutable std::vector<int> bfs_queue_;
+    mutable uint32_t query_{0};
+
+    static constexpr int kCorridorForcedPct = 35; ///< % de células forçadas acima do qual usa BFS
+    bool corridor_mode_{false};
+
+    static int sign(int v) { return (v > 0) - (v < 0); }
+    // Estados por célula na consulta atual: `seen` (na lista aberta) e `done` (fechada)
+    uint32_t seen() const { return query_ * 2; }
+    uint32_t done() const { return query_ * 2 + 1; }
+    bool closed(int i) const { return stamp_[i] == done(); }
+
+    /**
+     * @brief A* sobre pontos de salto; preenche `gcost_`/`parent_`.
+     * @return pontos de salto expandidos
+     */
+    int search_jumps(int s, Point goal) const {
+        using Entry = std::pair<int,int>; // (f, índice)
+        auto push = [&](int f, int i){ heap_.push_back({f,i}); std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>()); };
+        auto h = [&](int x, int y){ return std::abs(x - goal.x) + std::abs(y - goal.y); };
+        const int g = goal.y*w_ + goal.x;
+        heap_.clear();
+        stamp_[s] = seen();
+        gcost_[s] = 0;
+        parent_[s] = -1;
+        push(h(s % w_, s / w_), s);
+        int expanded = 0;
+        while (!heap_.empty()) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+            const int i = heap_.back().second;
+            heap_.pop_back();
+            if (closed(i)) continue;
+            stamp_[i] = done();
+            if (i == g) break;
+            expanded++;
+            const int x = i % w_, y = i / w_;
+            for (int d = 0; d < 4; ++d) {
+                const int dx = d == 1 ? 1 : d == 3 ? -1 : 0;
+                const int dy = d == 0 ? -1 : d == 2 ? 1 : 0;
+                // Não volta na direção de onde veio
+                if (parent_[i] >= 0) {
+                    const int px = parent_[i] % w_, py = parent_[i] / w_;
+                    if (sign(px - x) == dx && sign(py - y) == dy) continue;
+                }
+                const int j = dx ? jump_h(x, y, dx, goal) : jump_v(x, y, dy, goal);
+                if (j < 0 || closed(j)) continue;
+                const int jx = j % w_, jy = j / w_;
+                const int cost = gcost_[i] + std::abs(jx - x) + std::abs(jy - y);
+                if (stamp_[j] == seen() && gcost_[j] <= cost) continue;
+                stamp_[j] = seen();
+                gcost_[j] = cost;
+                parent_[j] = i;
+                push(cost + h(jx,jy), j);
+            }
+        }
+        return expanded;
+    }
+
+    /**
+     * @brief BFS simples sobre as máscaras de passagem (modo corredor); `parent_` aponta o vizinho anterior.
+     * @return células expandidas
+     */
+    int search_bfs(int s, int g) const {
+        const std::vector<uint64_t>* steps[4] = { &open_n_, &open_e_, &open_s_, &open_w_ };
+        bfs_queue_.clear();
+        bfs_queue_.push_back(s);
+        stamp_[s] = done();
+        gcost_[s] = 0;
+        parent_[s] = -1;
+        int expanded = 0;
+        for (size_t head = 0; head < bfs_queue_.size() && !closed(g); ++head) {
+            const int i = bfs_queue_[head];
+            expanded++;
+            const int x = i % w_, y = i / w_;
+            const int nb[4] = { i - w_, i + 1, i + w_, i - 1 };
+            for (int d = 0; d < 4; ++d) {
+                const int j = nb[d];
+                if (!test(*steps[d], x, y) || closed(j)) continue;
+                stamp_[j] = done();
+                gcost_[j] = gcost_[i] + 1;
+                parent_[j] = i;
+                bfs_queue_.push_back(j);
+            }
+        }
+        return expanded;
+    }
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < w_ && y < h_; }
+    void set(std::vector<uint64_t>& b, int x, int y) const { b[static_cast<size_t>(y)*words_ + (x >> 6)] |= 1ull << (x & 63); }
+    bool test(const std::vector<uint64_t>& b, int x, int y) const {
+        if (!inside(x,y)) return false;
+        return (b[static_cast<size_t>(y)*words_ + (x >> 6)] >> (x & 63)) & 1ull;
+    }
+
+    static int lowest_bit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(v);
+#else
+        int i = 0; while (!(v & 1ull)) { v >>= 1; ++i; } return i;
+#endif
+    }
+    static int highest_bit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(v);
+#else
+        int i = 63; while (!(v >> i)) --i; return i;
+#endif
+    }
+
+    /** @brief Primeira posição >= from em `bits` (len posições) com bit == want; len se não houver. */
+    static int next_bit(const uint64_t* bits, int len, int from, bool want) {
+        const int words = (len + 63) / 64;
+        for (int wi = from >> 6; wi < words; ++wi) {
+            uint64_t v = want ? bits[wi] : ~bits[wi];
+            if (wi == (from >> 6)) v &= ~0ull << (from & 63);
+            if (v) return std::min(len, (wi << 6) + lowest_bit(v));
+        }
+        return len;
+    }
+    /** @brief Última posição <= from em `bits` com bit == want; -1 se não houver. */
+    static int prev_bit(const uint64_t* bits, int from, bool want) {
+        for (int wi = from >> 6; wi >= 0; --wi) {
+            uint64_t v = want ? bits[wi] : ~bits[wi];
+            if (wi == (from >> 6) && (from & 63) != 63) v &= (1ull << ((from & 63) + 1)) - 1;
+            if (v) return (wi << 6) + highest_bit(v);
+        }
+        return -1;
+    }
+    const uint64_t* row(const std::vector<uint64_t>& b, int y) const { return &b[static_cast<size_t>(y)*words_]; }
+    const uint64_t* col(const std::vector<uint64_t>& b, int x) const { return &b[static_cast<size_t>(x)*cwords_]; }
+
+    /**
+     * @brief Salto horizontal a partir de (x,y) (exclusivo) na direção dx.
+     * @return índice do ponto de salto ou -1
+     */
+    int jump_h(int x, int y, int dx, Point goal) const {
+        if (dx > 0) {
+            const int stop = next_bit(row(open_e_, y), w_, x, false); // última célula alcançável
+            if (stop <= x) return -1;
+            int hit = next_bit(row(forced_e_, y), w_, x + 1, true);
+            if (goal.y == y && goal.x > x && goal.x < hit) hit = goal.x;
+            return hit <= stop ? y*w_ + hit : -1;
+        }
+        const int stop = prev_bit(row(open_w_, y), x, false);
+        if (stop >= x) return -1;
+        int hit = prev_bit(row(forced_w_, y), x - 1, true);
+        if (goal.y == y && goal.x < x && goal.x > hit) hit = goal.x;
+        return hit >= stop ? y*w_ + hit : -1;
+    }
+
+    /**
+     * @brief Salto vertical a partir de (x,y) (exclusivo) na direção dy.
+     *
+     * Para na primeira célula que é o goal ou de onde um salto horizontal
+     * encontra ponto de salto (bit de `col_stop_`; a linha do goal é
+     * verificada à parte, pois o goal não entra nas máscaras).
+     * @return índice do ponto de salto ou -1
+     */
+    int jump_v(int x, int y, int dy, Point goal) const {
+        int hit;
+        if (dy > 0) {
+            const int stop = next_bit(col(col_s_, x), h_, y, false);
+            if (stop <= y) return -1;
+            hit = next_bit(col(col_stop_, x), h_, y + 1, true);
+            if (goal.y > y && goal.y < hit && goal.y <= stop &&
+                (goal.x == x || jump_h(x, goal.y, 1, goal) >= 0 || jump_h(x, goal.y, -1, goal) >= 0)) hit = goal.y;
+            return hit <= stop ? hit*w_ + x : -1;
+        }
+        const int stop = prev_bit(col(col_n_, x), y, false);
+        if (stop >= y) return -1;
+        hit = prev_bit(col(col_stop_, x), y - 1, true);
+        if (goal.y < y && goal.y > hit && goal.y >= stop &&
+            (goal.x == x || jump_h(x, goal.y, 1, goal) >= 0 || jump_h(x, goal.y, -1, goal) >= 0)) hit = goal.y;
+        return hit >= stop ? hit*w_ + x : -1;
+    }
+};
+
+} // namespace maze
@@ -0,0 +1,301 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include "MazeMap.hpp"
+
+/**
+ * @file MapSnapshot.hpp
+ * @brief Versões imutáveis do `MazeMap` para leitores concorrentes (estilo RCU): ladrilhos
+ *        copiados só quando mudam, publicação atômica e liberação quando o último leitor sai.
+ *
+ * Só para o host (ferramentas com várias threads); o firmware não inclui este arquivo.
+ */
+
+namespace maze {
+
+/**
+ * @brief Bloco de `kSize × kSize` células em planos de bits, um por direção.
+ *
+ * `walls[d][ly]` tem o bit `lx` ligado se a célula local (lx,ly) tem parede
+ * na direção `d` (0=N,1=E,2=S,3=W): 128 bytes em vez de 1 KB de `Cell`. Os
+ * quatro planos reproduzem o `MazeMap` exatamente, inclusive paredes gravadas
+ * só de um lado.
+ */
+struct MapTile {
+    static constexpr int kShift = 4;
+    static constexpr int kSize = 1 << kShift; ///< Células por lado
+    uint16_t walls[4][kSize]{};
+
+    bool operator==(const MapTile& o) const {
+        for (int d = 0; d < 4; ++d)
+            for (int y = 0; y < kSize; ++y)
+                if (walls[d][y] != o.walls[d][y]) return false;
+        return true;
+    }
+};
+
+/**
+ * @brief Uma versão publicada do mapa; nunca muda depois de publicada.
+ *
+ * Ladrilhos que não mudaram entre versões são compartilhados (`shared_ptr`
+ * cuja contagem só é tocada pela thread escritora). Mesma interface de
+ * leitura do `MazeMap` (`width`, `in_bounds`, `at`, `has_wall`,
+ * `generation`); `copyTo()` materializa um `MazeMap` para algoritmos que
+ * exigem um.
+ */
+class MapVersion {
+public:
+    int width() const { return w_; }
+    int height() const { return h_; }
+    bool in_bounds(int x, int y) const { return x>=0 && y>=0 && x<w_ && y<h_; }
+    /** @brief `MazeMap::generation()` do mapa no momento da publicação. */
+    uint64_t generation() const { return gen_; }
+
+    /** @brief Como `MazeMap::has_wall`: true fora dos limites. */
+    bool has_wall(int x, int y, Dir dir) const {
+        if (!in_bounds(x,y)) return true;
+        return (tileAt(x, y).walls[idx(dir)][y & kMask] >> (x & kMask)) & 1u;
+    }
+    /** @brief Célula (x,y) por valor (sem verificação de limites). */
+    Cell at(int x, int y) const {
+        const MapTile& t = tileAt(x, y);
+        const int lx = x & kMask, ly = y & kMask;
+        Cell c;
+        c.wall_n = (t.walls[0][ly] >> lx) & 1u;
+        c.wall_e = (t.walls[1][ly] >> lx) & 1u;
+        c.wall_s = (t.walls[2][ly] >> lx) & 1u;
+        c.wall_w = (t.walls[3][ly] >> lx) & 1u;
+        return c;
+    }
+
+    /** @brief Ladrilhos por linha. */
+    int tilesX() const { return tx_; }
+    /** @brief Ladrilho (tx,ty); versões que não o alteraram devolvem o mesmo ponteiro. */
+    const MapTile* tile(int tx, int ty) const { return tiles_[static_cast<size_t>(ty) * tx_ + tx].get(); }
+
+    /** @brief Copia a versão para `out` (redimensiona; `out` recebe uma geração nova). */
+    void copyTo(MazeMap& out) const {
+        out.reset(w_, h_);
+        for (int y = 0; y < h_; ++y)
+            for (int x = 0; x < w_; ++x) out.at(x, y) = at(x, y);
+        out.touchAll();
+    }
+
+private:
+    friend class MapPublisher;
+    static constexpr int kMask = MapTile::kSize - 1;
+
+    const MapTile& tileAt(int x, int y) const {
+        return *tiles_[static_cast<size_t>(y >> MapTile::kShift) * tx_ + (x >> MapTile::kShift)];
+    }
+
+    int w_{0}, h_{0}, tx_{0};
+    uint64_t gen_{0};
+    std::vector<std::shared_ptr<const MapTile>> tiles_;
+};
+
+/**
+ * @brief Publica versões de um `MazeMap` escrito por uma thread para leitores em outras threads.
+ *
+ * Escritor (uma thread, dona do `MazeMap`): `publish(map)` depois de um lote
+ * de observações. Com o journal do mapa (`changesSince`), só os ladrilhos das
+ * arestas alteradas são refeitos; os demais vêm da versão anterior. Sem
+ * journal (reconstrução, `touchAll`, outro tamanho) todos são refeitos, mas
+ * os iguais aos anteriores continuam compartilhados. A nova versão entra com
+ * um `exchange` atômico e a anterior vai para a lista de aposentadas.
+ *
+ * Leitores: cada thread registra um `Reader` (`reader()`) e fixa a versão
+ * atual com `pin()`, que custa duas operações atômicas e não trava nem espera
+ * o escritor. Enquanto o `Pin` existir a versão é válida e imutável,
+ * mesmo que o escritor publique outras.
+ *
+ * Liberação por épocas: `pin()` anota no registro do leitor a época global;
+ * cada versão aposentada leva a época em que saiu. O escritor libera (em
+ * `publish()` ou `collect()`) as aposentadas mais antigas que a menor época
+ * fixada, ou seja, depois que o último leitor que podia vê-las soltou o
+ * `Pin`. O escritor nunca espera: no pior caso as aposentadas acumulam até
+ * os leitores soltarem (cada uma custa só o vetor de ponteiros e os
+ * ladrilhos que mudaram).
+ *
+ * Um `Reader` é de uma thread e tem no máximo um `Pin` por vez; nenhum
+ * `Reader` pode sobreviver ao `MapPublisher`.
+ */
+class MapPublisher {
+    struct Slot;
+public:
+    class Reader;
+
+    /** @brief Versão fixada; solta no destrutor. */
+    class Pin {
+    public:
+        Pin() = default;
+        Pin(Pin&& o) noexcept : slot_(std::exchange(o.slot_, nullptr)), v_(std::exchange(o.v_, nullptr)) {}
+        Pin& operator=(Pin&& o) noexcept {
+            if (this != &o) { release(); slot_ = std::exchange(o.slot_, nullptr); v_ = std::exchange(o.v_, nullptr); }
+            return *this;
+        }
+        Pin(const Pin&) = delete;
+        Pin& operator=(const Pin&) = delete;
+        ~Pin() { release(); }
+
+        /** @brief false se nada foi publicado ainda. */
+        explicit operator bool() const { return v_ != nullptr; }
+        const MapVersion& operator*() const { return *v_; }
+        const MapVersion* operator->() const { return v_; }
+        const MapVersion* get() const { return v_; }
+        /** @brief Solta a versão antes do destrutor. */
+        void release() {
+            if (slot_) slot_->epoch.store(0, std::memory_order_release);
+            slot_ = nullptr; v_ = nullptr;
+        }
+
+    private:
+        friend class Reader;
+        Pin(Slot* s, const MapVersion* v) : slot_(s), v_(v) {}
+        Slot* slot_{nullptr};
+        const MapVersion* v_{nullptr};
+    };
+
+    /** @brief Registro de uma thread leitora. */
+    class Reader {
+    public:
+        Reader(Reader&& o) noexcept : slot_(std::exchange(o.slot_, nullptr)), pub_(o.pub_) {}
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+        ~Reader() {
+            if (!slot_) return;
+            slot_->epoch.store(0, std::memory_order_release);
+            slot_->used.store(false, std::memory_order_release);
+        }
+        /** @brief Fixa a versão mais recente (sem trava). */
+        Pin pin() {
+            slot_->epoch.store(pub_->epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            return Pin(slot_, pub_->current_.load(std::memory_order_seq_cst));
+        }
+
+    private:
+        friend class MapPublisher;
+        Reader(Slot* s, const MapPublisher* p) : slot_(s), pub_(p) {}
+        Slot* slot_;
+        const MapPublisher* pub_;
+    };
+
+    MapPublisher() = default;
+    MapPublisher(const MapPublisher&) = delete;
+    MapPublisher& operator=(const MapPublisher&) = delete;
+    ~MapPublisher() {
+        retired_.clear();
+        delete current_.load(std::memory_order_relaxed);
+        for (Slot* s = slots_.load(std::memory_order_acquire); s;) { Slot* n = s->next; delete s; s = n; }
+    }
+
+    /** @brief Registra um leitor (qualquer thread); reaproveita registros de leitores destruídos. */
+    Reader reader() {
+        for (Slot* s = slots_.load(std::memory_order_acquire); s; s = s->next) {
+            bool in_use = false;
+            if (s->used.compare_exchange_strong(in_use, true, std::memory_order_acq_rel)) return Reader(s, this);
+        }
+        Slot* s = new Slot;
+        s->next = slots_.load(std::memory_order_relaxed);
+        while (!slots_.compare_exchange_weak(s->next, s, std::memory_order_acq_rel)) {}
+        return Reader(s, this);
+    }
+
+    /**
+     * @brief Publica o estado atual de `map` (só a thread escritora).
+     * @return false se `map` não mudou desde a última publicação (nada publicado)
+     */
+    bool publish(const MazeMap& map) {
+        const MapVersion* cur = current_.load(std::memory_order_relaxed);
+        const bool same_dims = cur && cur->w_ == map.width() && cur->h_ == map.height();
+        if (same_dims && cur->gen_ == map.generation()) { collect(); return false; }
+
+        auto next = std::make_unique<MapVersion>();
+        next->w_ = map.width(); next->h_ = map.height(); next->gen_ = map.generation();
+        next->tx_ = (map.width() + MapTile::kSize - 1) >> MapTile::kShift;
+        const int ty = (map.height() + MapTile::kSize - 1) >> MapTile::kShift;
+        const size_t n = static_cast<size_t>(next->tx_) * ty;
+        next->tiles_.resize(n);
+
+        dirty_.assign(n, 0);
+        auto mark = [&](Point p) {
+            if (map.in_bounds(p.x, p.y)) dirty_[static_cast<size_t>(p.y >> MapTile::kShift) * next->tx_ + (p.x >> MapTile::kShift)] = 1;
+        };
+        const bool incremental = same_dims && map.changesSince(cur->gen_, [&](const WallEdit& e) {
+            const Point c = map.edgeCell(e.edge);
+            mark(c);
+            mark(step(c, MazeMap::edgeDir(e.edge)));
+        });
+        for (size_t i = 0; i < n; ++i) {
+            if (incremental && !dirty_[i]) { next->tiles_[i] = cur->tiles_[i]; continue; }
+            MapTile t = build(map, static_cast<int>(i % next->tx_), static_cast<int>(i / next->tx_));
+            if (same_dims && *cur->tiles_[i] == t) next->tiles_[i] = cur->tiles_[i];
+            else next->tiles_[i] = std::make_shared<const MapTile>(t);
+        }
+
+        const MapVersion* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        const uint64_t e = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (old) retired_.push_back(Retired{std::unique_ptr<const MapVersion>(old), e});
+        collect();
+        return true;
+    }
+
+    /** @brief Libera as versões aposentadas que nenhum leitor pode mais ver (só a thread escritora). */
+    void collect() {
+        if (retired_.empty()) return;
+        uint64_t min_pinned = UINT64_MAX;
+        for (Slot* s = slots_.load(std::memory_order_acquire); s; s = s->next) {
+            const uint64_t e = s->epoch.load(std::memory_order_seq_cst);
+            if (e != 0 && e < min_pinned) min_pinned = e;
+        }
+        size_t keep = 0;
+        for (size_t i = 0; i < retired_.size(); ++i) {
+            if (retired_[i].epoch < min_pinned) continue; // ninguém fixou antes de ela sair
+            if (keep != i) retired_[keep] = std::move(retired_[i]);
+            keep++;
+        }
+        retired_.resize(keep);
+    }
+
+    /** @brief Versões aposentadas ainda fixadas por algum leitor (diagnóstico). */
+    size_t retiredCount() const { return retired_.size(); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> epoch{0}; ///< Época fixada (0 = nenhuma)
+        std::atomic<bool> used{true};
+        Slot* next{nullptr};
+    };
+    struct Retired {
+        std::unique_ptr<const MapVersion> v;
+        uint64_t epoch{0}; ///< Época em que deixou de ser a atual
+    };
+
+    static MapTile build(const MazeMap& map, int tx, int ty) {
+        MapTile t;
+        const int x0 = tx << MapTile::kShift, y0 = ty << MapTile::kShift;
+        for (int ly = 0; ly < MapTile::kSize && y0 + ly < map.height(); ++ly) {
+            for (int lx = 0; lx < MapTile::kSize && x0 + lx < map.width(); ++lx) {
+                const Cell& c = map.at(x0 + lx, y0 + ly);
+                const uint16_t bit = static_cast<uint16_t>(1u << lx);
+                if (c.wall_n) t.walls[0][ly] |= bit;
+                if (c.wall_e) t.walls[1][ly] |= bit;
+                if (c.wall_s) t.walls[2][ly] |= bit;
+                if (c.wall_w) t.walls[3][ly] |= bit;
+            }
+        }
+        return t;
+    }
+
+    std::atomic<const MapVersion*> current_{nullptr};
+    std::atomic<uint64_t> epoch_{1};           ///< Época global (0 é reservado para "nenhuma")
+    std::atomic<Slot*> slots_{nullptr};        ///< Registros de leitores (só crescem)
+    std::vector<Retired> retired_;             ///< Só a thread escritora
+    std::vector<uint8_t> dirty_;               ///< Rascunho de `publish()`
+};
+
+} // namespace maze
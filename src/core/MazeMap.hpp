@@ -1,7 +1,29 @@
 #pragma once
 #include <vector>
+#include <memory_resource>
 #include <cstdint>
 #include <string>
+#include <atomic>
+#include <array>
+#include <memory>
+#include "Direction.hpp"
+
+/**
+ * @brief Liga o journal de alterações de parede do `MazeMap` (`changesSince`).
+ *
+ * Padrão 1 no host. O firmware define 0 (opção CMake `MAZE_MAP_JOURNAL`) e
+ * mantém só o contador de geração: `changesSince` passa a responder "reconstrua"
+ * sempre que houver mudança, e o anel de registros não ocupa RAM. No host o
+ * anel fica fora do objeto e só é alocado na primeira parede alterada: mapas
+ * nunca editados e cópias custam um ponteiro.
+ */
+#ifndef MAZE_MAP_JOURNAL
+#define MAZE_MAP_JOURNAL 1
+#endif
+/** @brief Capacidade do journal (registros); alterações mais antigas forçam reconstrução. */
+#ifndef MAZE_MAP_JOURNAL_SIZE
+#define MAZE_MAP_JOURNAL_SIZE 256
+#endif
 
 /**
  * @file MazeMap.hpp
@@ -30,8 +52,31 @@ struct Point {
     int y{0}; ///< Coordenada y (linha)
 };
 
+/** @brief Célula vizinha de `p` na direção `d` (sem verificação de limites). */
+constexpr Point step(Point p, Dir d) { return Point{p.x + dx(d), p.y + dy(d)}; }
+
+/** @brief Uma parede alterada, como registrada no journal do `MazeMap`. */
+struct WallEdit {
+    uint32_t edge{0};       ///< Aresta (`MazeMap::edgeId`)
+    bool old_value{false};  ///< Havia parede antes
+    bool new_value{false};  ///< Há parede depois
+    uint64_t generation{0}; ///< Geração do mapa logo após a alteração
+};
+
 /**
  * @brief Mapa de labirinto em grade (largura x altura) com acesso a paredes.
+ *
+ * Estruturas derivadas do mapa (distâncias, rótulos de conectividade,
+ * texturas) acompanham as mudanças pela `generation()`: ela avança a cada
+ * parede que de fato muda em `set_wall`. Quem guardou a geração em que se
+ * atualizou chama `changesSince(g, f)` para receber só as arestas alteradas
+ * desde então; `false` significa que o journal não cobre o intervalo
+ * (transbordou, `reset`, cópia, escrita direta ou journal desligado) e o
+ * consumidor deve reconstruir do zero. Gerações vêm de um contador global,
+ * então mapas distintos (ou um mapa reatribuído) nunca compartilham valores.
+ *
+ * Escritas por `at()`/`at_index()` mutáveis não passam pelo journal: depois
+ * delas chame `touchAll()`.
  */
 class MazeMap {
 public:
@@ -39,8 +84,18 @@ public:
      * @brief Constrói um mapa vazio com dimensões fornecidas.
      * @param w largura (número de colunas)
      * @param h altura (número de linhas)
+     * @param mr recurso de memória das células (ex.: `EpisodeArena`)
      */
-    MazeMap(int w, int h) : w_(w), h_(h), grid_(w * h) {}
+    MazeMap(int w, int h, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : w_(w), h_(h), grid_(static_cast<size_t>(w * h), mr) {}
+
+    /** @brief Redimensiona para w×h sem paredes, reaproveitando a capacidade das células. */
+    void reset(int w, int h) {
+        w_ = w;
+        h_ = h;
+        grid_.assign(static_cast<size_t>(w * h), Cell{});
+        gen_.renew();
+    }
 
     /** @brief Retorna a largura do mapa. */
     int width() const { return w_; }
@@ -53,21 +108,100 @@ public:
     Cell& at(int x, int y) { return grid_[y * w_ + x]; }
     /** @brief Acesso somente-leitura à célula (x,y). */
     const Cell& at(int x, int y) const { return grid_[y * w_ + x]; }
+    /** @brief Acesso somente-leitura pelo índice linear `y*w + x` (ver `CellIdx`). */
+    const Cell& at_index(size_t i) const { return grid_[i]; }
+    /** @brief Acesso mutável pelo índice linear `y*w + x`. */
+    Cell& at_index(size_t i) { return grid_[i]; }
+
+    /**
+     * @brief Identificador da parede entre (x,y) e o vizinho em `dir`: `4*célula + dir`.
+     *
+     * N e W são normalizadas para S e E do vizinho quando ele existe, então os
+     * dois lados da mesma parede têm o mesmo id. Paredes de borda usam a
+     * própria célula.
+     */
+    uint32_t edgeId(int x, int y, Dir dir) const {
+        if ((dir == Dir::N || dir == Dir::W) && in_bounds(x + dx(dir), y + dy(dir))) {
+            x += dx(dir); y += dy(dir); dir = opposite(dir);
+        }
+        return static_cast<uint32_t>((y * w_ + x) * 4 + idx(dir));
+    }
+    /** @brief Célula base da aresta `edge` (ver `edgeId`). */
+    Point edgeCell(uint32_t edge) const {
+        const int c = static_cast<int>(edge / 4);
+        return Point{c % w_, c / w_};
+    }
+    /** @brief Direção da aresta `edge` a partir de `edgeCell(edge)`. */
+    static Dir edgeDir(uint32_t edge) { return static_cast<Dir>(edge & 3u); }
+
+    /** @brief Geração atual: muda a cada parede alterada, `reset`, cópia ou `touchAll`. */
+    uint64_t generation() const { return gen_.now; }
+
+    /** @brief Declara uma alteração em massa (escrita direta nas células): consumidores reconstroem. */
+    void touchAll() { gen_.bump(); gen_.full = gen_.now; }
+
+    /**
+     * @brief Entrega a `f(const WallEdit&)`, em ordem, as alterações após a geração `since`.
+     * @param since geração em que o consumidor se atualizou pela última vez
+     * @return true se o journal cobre o intervalo (nada a fazer se `since == generation()`);
+     *         false se o consumidor precisa reconstruir (nenhum registro é entregue)
+     */
+    template <class F>
+    bool changesSince(uint64_t since, F&& f) const {
+        if (since == gen_.now) return true;
+        if (since < gen_.full || since > gen_.now) return false;
+#if MAZE_MAP_JOURNAL
+        const uint64_t pending = gen_.now - since;
+        if (pending > journal_.count) return false;
+        size_t i = (journal_.head + kJournalSize - static_cast<size_t>(pending)) % kJournalSize;
+        for (uint64_t k = 0; k < pending; ++k, i = (i + 1) % kJournalSize) f((*journal_.ring)[i]);
+        return true;
+#else
+        (void)f;
+        return false;
+#endif
+    }
 
     /**
      * @brief Define parede bidirecional entre (x,y) e seu vizinho na direção dada.
      * @param x coluna da célula base
      * @param y linha da célula base
-     * @param dir 'N','E','S','W' indicando a direção do vizinho
+     * @param dir direção do vizinho
      * @param present true para colocar parede, false para remover
      */
-    void set_wall(int x, int y, char dir, bool present) {
+    void set_wall(int x, int y, Dir dir, bool present) {
         if (!in_bounds(x,y)) return;
-        Cell& c = at(x,y);
-        if (dir=='N') { c.wall_n = present; if (in_bounds(x,y-1)) at(x,y-1).wall_s = present; }
-        else if (dir=='E') { c.wall_e = present; if (in_bounds(x+1,y)) at(x+1,y).wall_w = present; }
-        else if (dir=='S') { c.wall_s = present; if (in_bounds(x,y+1)) at(x,y+1).wall_n = present; }
-        else if (dir=='W') { c.wall_w = present; if (in_bounds(x-1,y)) at(x-1,y).wall_e = present; }
+        bool& mine = at(x,y).*kWallOf[idx(dir)];
+        const bool old = mine;
+        bool changed = old != present;
+        mine = present;
+        const int nx = x + dx(dir), ny = y + dy(dir);
+        if (in_bounds(nx,ny)) {
+            bool& theirs = at(nx,ny).*kWallOf[idx(opposite(dir))];
+            changed = changed || theirs != present;
+            theirs = present;
+        }
+        if (changed) record(edgeId(x, y, dir), old, present);
+    }
+    /** @brief Como `set_wall(int,int,Dir,bool)` com 'N','E','S','W'; letras inválidas são ignoradas. */
+    void set_wall(int x, int y, char dir, bool present) {
+        if (is_dir_char(dir)) set_wall(x, y, from_char(dir), present);
+    }
+
+    /**
+     * @brief Consulta a parede da célula (x,y) na direção dada.
+     * @param x coluna da célula
+     * @param y linha da célula
+     * @param dir direção
+     * @return true se há parede (ou se (x,y) está fora dos limites)
+     */
+    bool has_wall(int x, int y, Dir dir) const {
+        if (!in_bounds(x,y)) return true;
+        return at(x,y).*kWallOf[idx(dir)];
+    }
+    /** @brief Como `has_wall(int,int,Dir)` com 'N','E','S','W'; letras inválidas contam como parede. */
+    bool has_wall(int x, int y, char dir) const {
+        return !is_dir_char(dir) || has_wall(x, y, from_char(dir));
     }
 
     /**
@@ -110,9 +244,76 @@ public:
     }
 
 private:
+    /** @brief Campo de parede de `Cell` por direção (N,E,S,W). */
+    static constexpr bool Cell::* kWallOf[4] = { &Cell::wall_n, &Cell::wall_e, &Cell::wall_s, &Cell::wall_w };
+    static constexpr size_t kJournalSize = MAZE_MAP_JOURNAL_SIZE;
+
+    /**
+     * @brief Geração atual e última alteração em massa.
+     *
+     * Cópias recebem uma geração nova (com `full == now`): o conteúdo é o
+     * mesmo, mas o journal da origem não descreve o histórico da cópia.
+     */
+    struct Generation {
+        uint64_t now{0};  ///< Geração atual
+        uint64_t full{0}; ///< Geração da última alteração sem journal
+        Generation() { renew(); }
+        Generation(const Generation&) { renew(); }
+        Generation& operator=(const Generation&) { renew(); return *this; }
+        /** @brief Nova faixa de gerações, disjunta de todas as já usadas no processo. */
+        void renew() { now = full = fresh(); }
+        void bump() { if (++now % kEpochSpan == 0) renew(); }
+        static constexpr uint64_t kEpochSpan = uint64_t{1} << 32;
+        static uint64_t fresh() {
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+            static uint32_t next = 1; // mapas só na thread de controle; M0+ não tem atômicos nativos
+            return uint64_t{next++} * kEpochSpan;
+#else
+            static std::atomic<uint32_t> next{1};
+            return uint64_t{next.fetch_add(1, std::memory_order_relaxed)} * kEpochSpan;
+#endif
+        }
+    };
+
+#if MAZE_MAP_JOURNAL
+    /**
+     * @brief Anel do journal, alocado na primeira alteração registrada.
+     *
+     * Cópias começam vazias (a geração da cópia é nova, o histórico da origem
+     * não se aplica a ela), então copiar um mapa não duplica os registros.
+     */
+    struct Journal {
+        std::unique_ptr<std::array<WallEdit, kJournalSize>> ring; ///< Registros (nulo até a primeira alteração)
+        size_t head{0};  ///< Próxima posição de escrita
+        size_t count{0}; ///< Registros válidos (até `kJournalSize`)
+        Journal() = default;
+        Journal(const Journal&) {}
+        Journal& operator=(const Journal&) { head = count = 0; return *this; }
+        Journal(Journal&&) = default;
+        Journal& operator=(Journal&&) = default;
+    };
+#endif
+
+    /** @brief Avança a geração e guarda a alteração no journal. */
+    void record(uint32_t edge, bool old_value, bool new_value) {
+        gen_.bump();
+#if MAZE_MAP_JOURNAL
+        if (!journal_.ring) journal_.ring = std::make_unique<std::array<WallEdit, kJournalSize>>();
+        (*journal_.ring)[journal_.head] = WallEdit{edge, old_value, new_value, gen_.now};
+        journal_.head = (journal_.head + 1) % kJournalSize;
+        if (journal_.count < kJournalSize) journal_.count++;
+#else
+        (void)edge; (void)old_value; (void)new_value;
+#endif
+    }
+
     int w_;                 ///< Largura em células
     int h_;                 ///< Altura em células
-    std::vector<Cell> grid_;///< Armazenamento linear de células (linha-major)
+    std::pmr::vector<Cell> grid_;///< Armazenamento linear de células (linha-major)
+    Generation gen_;        ///< Geração (ver `changesSince`)
+#if MAZE_MAP_JOURNAL
+    Journal journal_;       ///< Últimas alterações de parede
+#endif
 };
 
 } // namespace maze
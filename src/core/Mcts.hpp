@@ -0,0 +1,346 @@
+#pragma once
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+#include <cmath>
+#include "MazeMap.hpp"
+#include "Direction.hpp"
+#include "MazeAnalyzer.hpp"
+#ifdef PICO_BUILD
+#  include "pico/time.h"
+#else
+#  include <chrono>
+#endif
+
+/**
+ * @file Mcts.hpp
+ * @brief Monte Carlo Tree Search com orçamento em microssegundos para labirintos parcialmente conhecidos.
+ */
+
+namespace maze {
+
+/**
+ * @brief Parâmetros da busca MCTS (`MctsPlanner::search`, `Navigator::decideMcts`).
+ */
+struct MctsConfig {
+    uint32_t budget_us{2000};     ///< Orçamento por decisão em µs (0 = só `max_iterations`)
+    uint32_t max_iterations{0};   ///< Limite de iterações (0 = sem limite); com budget 0 torna a busca determinística
+    uint16_t max_nodes{4096};     ///< Nós da árvore (pool reaproveitado entre decisões)
+    uint16_t max_depth{16};       ///< Profundidade máxima da árvore
+    uint16_t rollout_depth{4};    ///< Passos de rollout a partir da folha (depois, distância otimista inflada)
+    float wall_prior{0.45f};      ///< P(parede) de aresta desconhecida (ver `MazeStats::wall_density`)
+    float exploration{0.7f};      ///< Constante UCT, relativa à distância otimista até o goal
+    float epsilon{0.15f};         ///< Probabilidade de passo aleatório no rollout
+    uint32_t seed{1};             ///< Semente (determinizações e rollouts)
+    uint32_t (*clock_us)(){nullptr}; ///< Relógio em µs; nullptr = relógio da plataforma
+
+    /**
+     * @brief Forma reduzida para o RP2040 (pool de 512 nós ≈ 12 KB, árvore e rollouts rasos).
+     * @param budget orçamento por decisão em µs
+     */
+    static MctsConfig embedded(uint32_t budget) {
+        MctsConfig c;
+        c.budget_us = budget;
+        c.max_nodes = 512;
+        c.max_depth = 12;
+        c.rollout_depth = 2;
+        return c;
+    }
+};
+
+/**
+ * @brief MCTS sobre determinizações do labirinto parcialmente conhecido.
+ *
+ * Arestas de células já visitadas (`known`) usam as paredes do mapa; as
+ * demais são paredes com probabilidade `wall_prior`. Cada iteração sorteia
+ * uma determinização (hash da aresta com a semente da iteração, sem
+ * armazenar nada), desce a árvore por UCT entre as ações abertas nela,
+ * expande um nó e faz um rollout curto guloso na distância otimista até o
+ * goal (BFS no mapa conhecido com desconhecidas abertas) com passos
+ * aleatórios; o restante é a distância otimista inflada pelo prior. Cada
+ * determinização é avaliada uma vez por ação da raiz (números aleatórios
+ * comuns), o que reduz a variância da comparação entre ações.
+ * O custo é o número de decisões do laço real: avanço = 1, avanço com giro = 2.
+ * A ação escolhida é a que minimiza o número esperado de passos até o goal sob
+ * o prior, somado a um passo por visita anterior à célula de destino (evita
+ * voltar repetidamente por trechos já explorados).
+ *
+ * Toda a memória (nós, distâncias, fila) é reaproveitada entre chamadas.
+ */
+class MctsPlanner {
+public:
+    /** @brief Resultado de uma busca. */
+    struct Result {
+        int dir{-1};               ///< Direção absoluta escolhida (0=N,1=E,2=S,3=W; -1 se nenhuma)
+        float expected_cost{0.f};  ///< Custo médio estimado da ação escolhida
+        uint32_t iterations{0};    ///< Iterações executadas
+        uint32_t nodes{0};         ///< Nós usados na árvore
+        uint32_t elapsed_us{0};    ///< Tempo gasto
+    };
+
+    /** @param mr recurso de memória da árvore e dos buffers da busca */
+    explicit MctsPlanner(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : nodes_(mr), dist_(mr), queue_(mr), path_(mr), gcost_(mr) {}
+
+    /**
+     * @brief Prior de parede a partir das estatísticas de um labirinto (ou média do corpus).
+     */
+    static float priorFromStats(const MazeStats& st) { return st.wall_density(); }
+
+    /**
+     * @brief Busca a melhor direção a partir de (start, heading).
+     * @param map     mapa conhecido (desconhecidas sem paredes)
+     * @param known   contador/flag de visita por célula (`y*w+x`, w*h bytes); != 0 = paredes conhecidas
+     * @param start   célula atual (paredes conhecidas)
+     * @param heading orientação atual
+     * @param goal    célula objetivo
+     * @param cfg     parâmetros
+     * @return direção escolhida e estatísticas da busca
+     */
+    Result search(const MazeMap& map, const uint8_t* known, Point start, Dir heading,
+                  Point goal, const MctsConfig& cfg) {
+        Result res;
+        const uint32_t t0 = now(cfg);
+        w_ = map.width();
+        h_ = map.height();
+        if (!map.in_bounds(start.x, start.y) || !map.in_bounds(goal.x, goal.y)) return res;
+        map_ = &map;
+        known_ = known;
+        goal_ = goal;
+        prior16_ = static_cast<uint32_t>(cfg.wall_prior * 65536.0f);
+        optimistic_distances(goal);
+
+        nodes_.clear();
+        nodes_.reserve(cfg.max_nodes < 8 ? 8 : cfg.max_nodes);
+        nodes_.push_back(Node{static_cast<int16_t>(start.x), static_cast<int16_t>(start.y), idx(heading)});
+        // Ações da raiz: saídas abertas de verdade (a célula atual já foi observada)
+        uint8_t root_dirs[4];
+        int nroot = 0;
+        for (uint8_t d = 0; d < 4; ++d) {
+            const Point q = step(start, from_heading(d));
+            if (map.has_wall(start.x, start.y, from_heading(d)) || !map.in_bounds(q.x, q.y)) continue;
+            root_dirs[nroot++] = d;
+            nodes_[0].child[d] = static_cast<uint16_t>(nodes_.size());
+            nodes_.push_back(Node{static_cast<int16_t>(q.x), static_cast<int16_t>(q.y), d});
+        }
+        if (nroot == 0) return res;
+        const float scale = cfg.exploration * static_cast<float>(dist_at(start) > 0 ? dist_at(start) : 1);
+        const uint32_t max_it = (cfg.max_iterations == 0 && cfg.budget_us == 0) ? 256u : cfg.max_iterations;
+        const uint32_t seed = cfg.seed ? cfg.seed : 1u;
+        path_.reserve(cfg.max_depth + 1u);
+        gcost_.reserve(cfg.max_depth + 1u);
+
+        // Cada determinização é avaliada uma vez por ação da raiz (números
+        // aleatórios comuns): as ações são comparadas nos mesmos mundos.
+        for (;;) {
+            const uint32_t i = res.iterations;
+            const uint32_t group = i / static_cast<uint32_t>(nroot);
+            if (max_it && i >= max_it) break;
+            if (cfg.budget_us && i % nroot == 0 && (group & 3u) == 0 && now(cfg) - t0 >= cfg.budget_us) break;
+            const uint32_t world = mix(seed * 0x9e3779b9u + group);
+            uint32_t rng = world | 1u;
+            iterate(cfg, scale, world, root_dirs[i % nroot], rng);
+            res.iterations++;
+        }
+
+        // Ação = filho de menor custo esperado entre as direções abertas de verdade
+        // na raiz, mais um passo por visita anterior ao destino (novidade)
+        const Node& root = nodes_[0];
+        float best = 0.f;
+        for (uint8_t d = 0; d < 4; ++d) {
+            const uint16_t c = root.child[d];
+            if (!c || map.has_wall(start.x, start.y, from_heading(d))) continue;
+            const Node& ch = nodes_[c];
+            if (ch.visits == 0) continue;
+            const float expected = ch.cost_sum / ch.visits + step_cost(root.h, d);
+            const float value = expected + known[cell(ch.x, ch.y)];
+            if (res.dir < 0 || value < best) {
+                best = value;
+                res.dir = d;
+                res.expected_cost = expected;
+            }
+        }
+        res.nodes = static_cast<uint32_t>(nodes_.size());
+        res.elapsed_us = now(cfg) - t0;
+        return res;
+    }
+
+private:
+    /** @brief Nó da árvore: estado (célula, heading) e estatísticas. 24 bytes. */
+    struct Node {
+        int16_t x{0}, y{0};
+        uint8_t h{0};            ///< Heading ao chegar na célula
+        uint16_t child[4]{0,0,0,0}; ///< Filho por direção absoluta (0 = não expandido; a raiz nunca é filho)
+        uint32_t visits{0};
+        float cost_sum{0.f};     ///< Soma dos custos a partir deste nó
+        Node() = default;
+        Node(int16_t x_, int16_t y_, uint8_t h_) : x(x_), y(y_), h(h_) {}
+    };
+
+    static uint32_t now(const MctsConfig& cfg) {
+        if (cfg.clock_us) return cfg.clock_us();
+#ifdef PICO_BUILD
+        return time_us_32();
+#else
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+    static uint32_t next(uint32_t& s) { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+    static uint32_t mix(uint32_t v) {
+        v ^= v >> 16; v *= 0x7feb352dU; v ^= v >> 15; v *= 0x846ca68bU; v ^= v >> 16;
+        return v;
+    }
+    /** @brief Custo de decisões para sair com heading `h` na direção `d`: 1, ou 2 se precisa girar. */
+    static int step_cost(uint8_t h, uint8_t d) { return h == d ? 1 : 2; }
+
+    int cell(int x, int y) const { return y * w_ + x; }
+    int dist_at(Point p) const { return dist_[cell(p.x, p.y)]; }
+
+    /** @brief Aresta (x,y)→d aberta na determinização `world`. */
+    bool open(int x, int y, uint8_t d, uint32_t world) const {
+        const Dir dir = from_heading(d);
+        const int nx = x + dx(dir), ny = y + dy(dir);
+        if (nx < 0 || ny < 0 || nx >= w_ || ny >= h_) return false;
+        const uint8_t* k = known_;
+        if (k[cell(x, y)] || k[cell(nx, ny)]) return !map_->has_wall(x, y, dir);
+        // Chave canônica da aresta: célula norte/oeste + orientação
+        const uint32_t key = (d == 0 || d == 3)
+            ? static_cast<uint32_t>(cell(x, y)) * 2u + (d == 3 ? 1u : 0u)
+            : static_cast<uint32_t>(cell(nx, ny)) * 2u + (d == 1 ? 1u : 0u);
+        return (mix(key ^ world) & 0xFFFFu) >= prior16_;
+    }
+
+    /** @brief BFS a partir do goal no mapa conhecido (desconhecidas abertas). */
+    void optimistic_distances(Point goal) {
+        dist_.assign(static_cast<size_t>(w_) * h_, -1);
+        queue_.clear();
+        dist_[cell(goal.x, goal.y)] = 0;
+        queue_.push_back(cell(goal.x, goal.y));
+        for (size_t qi = 0; qi < queue_.size(); ++qi) {
+            const int c = queue_[qi];
+            const int x = c % w_, y = c / w_;
+            for (uint8_t d = 0; d < 4; ++d) {
+                const Dir dir = from_heading(d);
+                const int nx = x + dx(dir), ny = y + dy(dir);
+                if (map_->has_wall(x, y, dir) || nx < 0 || ny < 0 || nx >= w_ || ny >= h_) continue;
+                const int n = cell(nx, ny);
+                if (dist_[n] >= 0) continue;
+                dist_[n] = dist_[c] + 1;
+                queue_.push_back(n);
+            }
+        }
+    }
+
+    /** @brief Uma iteração: seleção/expansão UCT, rollout e retropropagação. */
+    void iterate(const MctsConfig& cfg, float scale, uint32_t world, uint8_t root_dir, uint32_t& rng) {
+        path_.clear();
+        gcost_.clear();
+        uint16_t n = 0;
+        int g = 0;
+        path_.push_back(n);
+        gcost_.push_back(0);
+        bool reached = false;
+        while (path_.size() <= cfg.max_depth) {
+            const Node cur = nodes_[n];
+            if (cur.x == goal_x() && cur.y == goal_y()) { reached = true; break; }
+            // Expansão: primeira direção aberta ainda sem filho (frente primeiro);
+            // na raiz a ação é a da vez
+            int pick = n == 0 ? root_dir : -1;
+            bool expanded = false;
+            for (uint8_t k = 0; k < 4 && pick < 0 && nodes_.size() < cfg.max_nodes; ++k) {
+                const uint8_t d = static_cast<uint8_t>((cur.h + k) & 3u);
+                if (cur.child[d] || !open(cur.x, cur.y, d, world)) continue;
+                const Dir dir = from_heading(d);
+                nodes_[n].child[d] = static_cast<uint16_t>(nodes_.size());
+                nodes_.push_back(Node{static_cast<int16_t>(cur.x + dx(dir)), static_cast<int16_t>(cur.y + dy(dir)), d});
+                pick = d;
+                expanded = true;
+                break;
+            }
+            if (pick < 0) {
+                // Seleção UCT (minimiza custo) entre filhos abertos nesta determinização
+                float best = 0.f;
+                const float ln_n = std::log(static_cast<float>(cur.visits + 1));
+                for (uint8_t d = 0; d < 4; ++d) {
+                    const uint16_t c = cur.child[d];
+                    if (!c || !open(cur.x, cur.y, d, world)) continue;
+                    const Node& ch = nodes_[c];
+                    const float mean = ch.visits ? ch.cost_sum / ch.visits : 0.f;
+                    const float ucb = step_cost(cur.h, d) + mean - scale * std::sqrt(ln_n / (ch.visits + 1));
+                    if (pick < 0 || ucb < best) { best = ucb; pick = d; }
+                }
+            }
+            if (pick < 0) break; // sem saída nesta determinização (ou pool cheio sem filhos)
+            g += step_cost(cur.h, static_cast<uint8_t>(pick));
+            n = nodes_[n].child[pick];
+            path_.push_back(n);
+            gcost_.push_back(g);
+            if (expanded) break;
+        }
+        const Node& leaf = nodes_[n];
+        int total = g;
+        if (!reached && !(leaf.x == goal_x() && leaf.y == goal_y())) total += rollout(cfg, leaf.x, leaf.y, leaf.h, world, rng);
+        for (size_t i = 0; i < path_.size(); ++i) {
+            Node& nd = nodes_[path_[i]];
+            nd.visits++;
+            nd.cost_sum += static_cast<float>(total - gcost_[i]);
+        }
+    }
+
+    /** @brief Rollout guloso na distância otimista (sem voltar, salvo em beco) com passos aleatórios. */
+    int rollout(const MctsConfig& cfg, int x, int y, uint8_t h, uint32_t world, uint32_t& rng) const {
+        const uint32_t eps16 = static_cast<uint32_t>(cfg.epsilon * 65536.0f);
+        int cost = 0;
+        for (int t = 0; t < cfg.rollout_depth; ++t) {
+            if (x == goal_x() && y == goal_y()) return cost;
+            uint8_t opts[4];
+            int k = 0;
+            for (uint8_t j = 0; j < 4; ++j) {
+                const uint8_t d = static_cast<uint8_t>((h + j) & 3u);
+                if (j != 2 && open(x, y, d, world)) opts[k++] = d;
+            }
+            if (k == 0) {
+                const uint8_t back = static_cast<uint8_t>((h + 2) & 3u);
+                if (!open(x, y, back, world)) break;
+                opts[k++] = back;
+            }
+            uint8_t d = opts[0];
+            if (k > 1 && (next(rng) & 0xFFFFu) < eps16) d = opts[next(rng) % k];
+            else {
+                int best = INT32_MAX;
+                for (int j = 0; j < k; ++j) {
+                    const Dir dir = from_heading(opts[j]);
+                    const int v = dist_[cell(x + dx(dir), y + dy(dir))];
+                    const int c = v < 0 ? INT32_MAX : v;
+                    if (c < best) { best = c; d = opts[j]; }
+                }
+            }
+            cost += step_cost(h, d);
+            h = d;
+            x += dx(from_heading(d));
+            y += dy(from_heading(d));
+        }
+        if (x == goal_x() && y == goal_y()) return cost;
+        // Horizonte esgotado: distância otimista inflada pelo prior (desvios esperados)
+        const int rest = dist_[cell(x, y)];
+        const float inflate = 1.0f + 2.0f * (static_cast<float>(prior16_) / 65536.0f);
+        return cost + (rest < 0 ? 4 * (w_ + h_) : static_cast<int>(rest * inflate));
+    }
+
+    int goal_x() const { return goal_.x; }
+    int goal_y() const { return goal_.y; }
+
+    int w_{0}, h_{0};
+    const MazeMap* map_{nullptr};
+    const uint8_t* known_{nullptr};
+    uint32_t prior16_{0};
+    Point goal_{};
+    std::pmr::vector<Node> nodes_;
+    std::pmr::vector<int> dist_;
+    std::pmr::vector<int> queue_;
+    std::pmr::vector<uint16_t> path_;
+    std::pmr::vector<int> gcost_;
+};
+
+} // namespace maze
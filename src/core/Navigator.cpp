@@ -1,5 +1,7 @@
 #include "Navigator.hpp"
 #include <algorithm>
+#include <cstdlib>
+#include <climits>
 
 namespace maze {
 
@@ -57,49 +59,283 @@ Decision Navigator::decide(const SensorRead& sr) {
  * Mapeia esquerda/frente/direita relativas para N/E/S/W absolutas a partir do
  * `heading` fornecido e chama `MazeMap::set_wall()` para refletir as obstruções.
  *
+ * Cada parede alterada é conferida contra o plano guardado (ver `planIfInvalid()`).
+ *
  * @param cell coordenadas da célula atual
  * @param sr leitura de sensores (true indica livre)
  * @param heading orientação absoluta: 0=N,1=E,2=S,3=W
+ * @return máscaras das paredes adicionadas/removidas
  */
-void Navigator::observeCellWalls(Point cell, const SensorRead& sr, uint8_t heading) {
-    auto set_dir = [&](char dir, bool free_flag){ map_.set_wall(cell.x, cell.y, dir, !free_flag); };
-    // Map left/front/right relative to heading into absolute N/E/S/W
-    // Order rel: Left, Front, Right
-    const char abs_dirs[4] = {'N','E','S','W'};
-    auto rel_to_abs = [&](int rel){ // 0=Left,1=Front,2=Right
-        int base = (int)heading;
-        int d = 0;
-        if (rel==0) d = (base + 3) & 3; // left
-        else if (rel==1) d = base;      // front
-        else d = (base + 1) & 3;        // right
-        return abs_dirs[d];
+WallChanges Navigator::observeCellWalls(Point cell, const SensorRead& sr, uint8_t heading) {
+    sync_map();
+    WallChanges ch;
+    auto set_dir = [&](Dir dir, bool free_flag){
+        const bool had = map_.has_wall(cell.x, cell.y, dir);
+        journal_set_wall(cell.x, cell.y, dir, !free_flag);
+        if (had && free_flag) {
+            ch.removed |= static_cast<uint8_t>(1u << maze::idx(dir));
+            on_wall_changed(cell, dir, true);
+        } else if (!had && !free_flag) {
+            ch.added |= static_cast<uint8_t>(1u << maze::idx(dir));
+            on_wall_changed(cell, dir, false);
+        }
     };
-    set_dir(rel_to_abs(0), sr.left_free);
-    set_dir(rel_to_abs(1), sr.front_free);
-    set_dir(rel_to_abs(2), sr.right_free);
+    // Esquerda/frente/direita relativas → N/E/S/W absolutas (tabelas de Direction.hpp)
+    const Dir h = from_heading(heading);
+    set_dir(rel_to_abs(h, Action::Left), sr.left_free);
+    set_dir(rel_to_abs(h, Action::Forward), sr.front_free);
+    set_dir(rel_to_abs(h, Action::Right), sr.right_free);
     // marca visita da célula atual
     if (!seen_.empty() && map_.in_bounds(cell.x, cell.y)) {
         int id = idx(cell.x, cell.y);
-        if (id >= 0 && id < (int)seen_.size() && seen_[id] < 255) seen_[id]++;
+        if (id >= 0 && id < (int)seen_.size() && seen_[id] < 255) {
+            if (snapshots_ > 0) {
+                UndoEntry e; e.kind = UndoEntry::Kind::Seen; e.index = static_cast<uint32_t>(id); e.seen = seen_[id];
+                undo_.push_back(e);
+            }
+            seen_[id]++;
+        }
     }
+    map_gen_ = map_.generation();
+    return ch;
 }
 
 /**
- * @brief Planeja uma rota do início ao objetivo usando `Planner::bfs_path`.
+ * @brief Mantém o estado derivado do mapa após a parede (p,d) mudar.
+ *
+ * Rótulos de conectividade: remoção une, adição marca stale. Plano: uma
+ * adição só o invalida se cortar uma aresta dele; uma remoção, se puder
+ * encurtá-lo (ou se havia poda). Remoções descartam a poda de becos.
+ */
+void Navigator::on_wall_changed(Point p, Dir d, bool removed) {
+    if (removed) {
+        reach_.onWallRemoved(p.x, p.y, d);
+        if (plan_valid_ && (!pruned_.empty() || opening_may_shorten(p, d))) plan_valid_ = false;
+        clear_pruned();
+    } else {
+        reach_.onWallAdded(p.x, p.y, d);
+        if (plan_valid_ && edge_on_plan(p, d)) plan_valid_ = false;
+    }
+}
+
+/**
+ * @brief Confere as paredes alteradas por fora do navegador (via `map()`).
+ *
+ * Lê o journal do mapa desde `map_gen_` e aplica cada aresta como uma
+ * observação; se o journal não cobre o intervalo (cópia, `touchAll`,
+ * transbordo, journal desligado) descarta plano, poda e rótulos. O(1) quando
+ * nada mudou.
+ */
+void Navigator::sync_map() {
+    const uint64_t g = map_.generation();
+    if (g == map_gen_) return;
+    const bool covered = map_.changesSince(map_gen_, [&](const WallEdit& e) {
+        if (e.old_value != e.new_value) on_wall_changed(map_.edgeCell(e.edge), MazeMap::edgeDir(e.edge), !e.new_value);
+    });
+    if (!covered) {
+        reach_.invalidate();
+        clear_pruned();
+        plan_valid_ = false;
+        anytime_.cancel();
+    }
+    map_gen_ = g;
+}
+
+/**
+ * @brief Planeja uma rota do início ao objetivo usando `Planner::bibfs_path_into`.
  *
  * Requer que um objetivo tenha sido definido. Ao sucesso, popula `plan_` com
- * a sequência de pontos do caminho.
+ * a sequência de pontos do caminho, reaproveitando `planner_ws_`, `route_` e a
+ * capacidade do próprio plano (sem alocação depois do primeiro planejamento). Antes do BFS consulta os rótulos de
+ * conectividade: se start e goal estão em componentes distintas o BFS é
+ * evitado. Após um BFS sem sucesso os rótulos são reconstruídos, de modo que
+ * as chamadas seguintes com o goal isolado custam O(α(n)).
+ *
+ * Com `setWeightedPlanning(true)` e tempos medidos em `edge_costs_`, a busca
+ * é o Dijkstra de Dial (`Planner::dial_path_into`) sobre esses custos, no
+ * mesmo workspace: o plano minimiza o tempo estimado, não o número de células.
+ *
+ * O resultado (plano ou ausência de rota) fica marcado como válido e as
+ * arestas do plano são registradas em `plan_edges_` para `planIfInvalid()`.
  *
  * @return true se um plano não vazio foi gerado; false caso contrário
  */
 bool Navigator::planRoute() {
+    sync_map();
+    if (!has_goal_) return false;
+    journal_plan();
+    mark_plan_edges(false);
+    plan_valid_ = true;
+    if (!reach_.mayConnect(map_, start_, goal_)) { plan_.clear(); return false; }
+    const std::vector<uint8_t>* skip = pruned_.empty() ? nullptr : &pruned_;
+    const bool found = use_edge_costs()
+        ? Planner::dial_path_into(map_, start_, goal_, route_, planner_ws_, edge_costs_, skip)
+        : Planner::bibfs_path_into(map_, start_, goal_, route_, planner_ws_, skip);
+    if (!found) {
+        plan_.clear();
+        reach_.rebuild(map_);
+        return false;
+    }
+    plan_.assign(route_.data(), route_.size());
+    mark_plan_edges(true);
+    return !plan_.empty();
+}
+
+/**
+ * @brief Replaneja apenas quando `plan_valid_` foi derrubado desde o último planejamento.
+ *
+ * @return true se há plano
+ */
+bool Navigator::planIfInvalid() {
+    plan_stats_.requests++;
+    sync_map();
+    if (plan_valid_) return !plan_.empty();
+    plan_stats_.replans++;
+    return planRoute();
+}
+
+/**
+ * @brief Replaneja com o ARA* fatiado quando `plan_valid_` foi derrubado.
+ *
+ * Cada caminho novo publicado pelo `anytime_` substitui `plan_` (com as
+ * marcas de `plan_edges_`); `Done`/`NoPath` tornam o resultado válido. Com
+ * planejamento ponderado a busca usa os custos de `edge_costs_`, como o Dial
+ * de `planRoute()`.
+ *
+ * @return true se há plano
+ */
+bool Navigator::planSliced(uint32_t budget, const AnytimeConfig& cfg) {
+    plan_stats_.requests++;
+    sync_map();
+    if (plan_valid_) return !plan_.empty();
     if (!has_goal_) return false;
-    auto p = Planner::bfs_path(map_, start_, goal_);
-    if (!p) { plan_.clear(); return false; }
-    plan_ = *p;
+    if (anytime_.status() != PlanStatus::InProgress) {
+        plan_stats_.replans++;
+        anytime_.begin(map_, start_, goal_, pruned_.empty() ? nullptr : &pruned_, cfg,
+                       use_edge_costs() ? &edge_costs_ : nullptr);
+    }
+    const PlanStatus st = anytime_.step(budget);
+    if (anytime_.pathVersion() != anytime_version_) {
+        anytime_version_ = anytime_.pathVersion();
+        if (anytime_.hasPath()) {
+            journal_plan();
+            mark_plan_edges(false);
+            plan_.assign(anytime_.path().data(), anytime_.path().size());
+            mark_plan_edges(true);
+        }
+    }
+    if (st == PlanStatus::NoPath) {
+        journal_plan();
+        mark_plan_edges(false);
+        plan_.clear();
+    }
+    if (st == PlanStatus::Done || st == PlanStatus::NoPath) plan_valid_ = true;
     return !plan_.empty();
 }
 
+/**
+ * @brief Troca o plano e confere se ele ainda serve ao mapa carregado.
+ *
+ * @return true se o plano ficou válido
+ */
+bool Navigator::setPlan(const PathCode& p) {
+    sync_map();
+    journal_plan();
+    mark_plan_edges(false);
+    plan_ = p;
+    mark_plan_edges(true);
+    plan_valid_ = plan_fits_map();
+    return plan_valid_;
+}
+
+/** @brief Percorre `plan_` conferindo extremos, limites e paredes. O(comprimento). */
+bool Navigator::plan_fits_map() const {
+    if (!has_goal_ || plan_.empty()) return false;
+    const Point a = plan_.start(), b = plan_.back();
+    if (a.x != start_.x || a.y != start_.y || b.x != goal_.x || b.y != goal_.y) return false;
+    Point c = a;
+    for (size_t i = 0; i < plan_.moves(); ++i) {
+        const Dir d = from_heading(plan_.move(i));
+        const Point n = step(c, d);
+        if (!map_.in_bounds(c.x, c.y) || !map_.in_bounds(n.x, n.y) || map_.has_wall(c.x, c.y, d)) return false;
+        c = n;
+    }
+    return true;
+}
+
+/**
+ * @brief Índice da aresta (p,d) em `plan_edges_`: arestas N/W são as S/E do vizinho.
+ *
+ * @return 2*célula (leste) ou 2*célula+1 (sul); -1 se a aresta sai do mapa
+ */
+long Navigator::edge_index(Point p, Dir d) const {
+    if (d == Dir::N || d == Dir::W) { p = step(p, d); d = opposite(d); }
+    const Point q = step(p, d);
+    if (!map_.in_bounds(p.x, p.y) || !map_.in_bounds(q.x, q.y)) return -1;
+    const long e = 2L * idx(p.x, p.y) + (d == Dir::S ? 1 : 0);
+    return (static_cast<size_t>(e >> 6) < plan_edges_.size()) ? e : -1;
+}
+
+/** @brief Percorre `plan_` ligando (`on`) ou desligando os bits das suas arestas. O(comprimento). */
+void Navigator::mark_plan_edges(bool on) {
+    if (plan_edges_.empty() || plan_.empty()) return;
+    Point p = plan_.start();
+    for (size_t i = 0; i < plan_.moves(); ++i) {
+        const Dir d = from_heading(plan_.move(i));
+        const long e = edge_index(p, d);
+        if (e >= 0) {
+            const uint64_t bit = 1ull << (e & 63);
+            if (on) plan_edges_[static_cast<size_t>(e >> 6)] |= bit;
+            else    plan_edges_[static_cast<size_t>(e >> 6)] &= ~bit;
+        }
+        p = step(p, d);
+    }
+}
+
+/** @brief Consulta o bit da aresta (p,d) em `plan_edges_`. */
+bool Navigator::edge_on_plan(Point p, Dir d) const {
+    const long e = edge_index(p, d);
+    return e >= 0 && ((plan_edges_[static_cast<size_t>(e >> 6)] >> (e & 63)) & 1u);
+}
+
+/**
+ * @brief Limite inferior do caminho que usa a aresta recém-aberta (p,d).
+ *
+ * Qualquer rota por ela mede ao menos `|start-p| + 1 + |q-goal|` (ou o
+ * sentido inverso) em distância de Manhattan; se isso não for menor que o
+ * plano atual, o plano continua ótimo. Sem plano, qualquer abertura conta.
+ */
+bool Navigator::opening_may_shorten(Point p, Dir d) const {
+    if (plan_.empty()) return true;
+    const Point q = step(p, d);
+    auto manhattan = [](Point a, Point b) { return std::abs(a.x - b.x) + std::abs(a.y - b.y); };
+    const long lb = 1L + std::min(manhattan(start_, p) + manhattan(q, goal_), manhattan(start_, q) + manhattan(p, goal_));
+    if (!use_edge_costs()) return lb < static_cast<long>(plan_.moves());
+    // Ponderado: toda aresta custa ao menos 1, então o limite vale contra o custo atual do plano
+    long cost = 0;
+    Point c = plan_.start();
+    for (size_t i = 0; i < plan_.moves(); ++i) {
+        const uint8_t d = plan_.move(i);
+        cost += edge_costs_(static_cast<size_t>(idx(c.x, c.y)), d);
+        c = step(c, from_heading(d));
+    }
+    return lb < cost;
+}
+
+/**
+ * @brief Executa o dead-end filling sobre o mapa conhecido e guarda a máscara.
+ *
+ * @return estatísticas da poda (ver `fill_dead_ends()`)
+ */
+PruneStats Navigator::pruneDeadEnds() {
+    sync_map();
+    plan_valid_ = false;
+    anytime_.cancel();
+    const PruneStats st = fill_dead_ends(map_, start_, goal_, pruned_next_);
+    replace_pruned();
+    return st;
+}
+
 /**
  * @brief Decide ação seguindo o plano pré-computado, com fallback heurístico.
  *
@@ -113,64 +349,51 @@ bool Navigator::planRoute() {
  * @return decisão planejada (pontuação alta), ou heurística caso não aplicável
  */
 Decision Navigator::decidePlanned(Point current, uint8_t heading, const SensorRead& sr) {
-    // Helper: absolute move wanted by plan from current -> next
-    auto plan_wanted_abs = [&]() -> char {
-        if (plan_.empty()) return 'X';
-        auto it = std::find_if(plan_.begin(), plan_.end(), [&](const Point& pt){ return pt.x==current.x && pt.y==current.y; });
-        if (it == plan_.end() || std::next(it) == plan_.end()) return 'X';
-        Point next = *std::next(it);
-        if (next.x == current.x && next.y == current.y-1) return 'N';
-        if (next.x == current.x+1 && next.y == current.y) return 'E';
-        if (next.x == current.x && next.y == current.y+1) return 'S';
-        if (next.x == current.x-1 && next.y == current.y) return 'W';
-        return 'X';
+    sync_map();
+    // Movimento absoluto desejado pelo plano a partir de `current` (-1 se fora do plano)
+    const int plan_wanted_abs = [&]() -> int {
+        const int i = plan_.find(current);
+        if (i < 0 || static_cast<size_t>(i) >= plan_.moves()) return -1;
+        return plan_.move(static_cast<size_t>(i));
     }();
+    const Dir h = from_heading(heading);
 
-    const char abs_dirs[4] = {'N','E','S','W'};
-    auto rel_to_abs = [&](int rel){ // 0=Left,1=Front,2=Right
-        int base = (int)heading;
-        int d = (rel==0) ? (base + 3) & 3 : (rel==1) ? base : (base + 1) & 3;
-        return abs_dirs[d];
-    };
-    auto abs_to_rel_action = [&](char abs){
-        int base = (int)heading;
-        int idx_dir = 0; for (int i=0;i<4;++i) if (abs_dirs[i]==abs) { idx_dir=i; break; }
-        int rel = (idx_dir - base + 4) & 3; // 0=Front,1=Right,2=Back,3=Left
-        if (rel==0) return Action::Forward;
-        if (rel==1) return Action::Right;
-        if (rel==3) return Action::Left;
-        return Action::Back;
-    };
-
+    // No máximo três candidatas: buffer fixo na pilha, sem alocação por decisão
     struct Cand { Action a; int seen; bool matches_plan; };
-    std::vector<Cand> cands;
-    cands.reserve(3);
+    Cand cands[3];
+    int ncands = 0;
+
+    // Células podadas só são evitadas quando o agente está fora delas
+    const bool skip_pruned = !pruned_.empty() && map_.in_bounds(current.x, current.y) && !pruned_[idx(current.x, current.y)];
 
     // For each of Left, Front, Right if free, compute target and seen count
-    auto push_cand = [&](int rel, bool free_flag){
+    auto push_cand = [&](Action a, bool free_flag){
         if (!free_flag) return;
-        char abs = rel_to_abs(rel);
-        int nx = current.x, ny = current.y;
-        if (abs=='N') ny--; else if (abs=='E') nx++; else if (abs=='S') ny++; else if (abs=='W') nx--;
+        const Dir abs = rel_to_abs(h, a);
+        const Point n = step(current, abs);
+        if (skip_pruned && map_.in_bounds(n.x,n.y) && pruned_[idx(n.x,n.y)]) return;
         int s = 255;
-        if (!seen_.empty() && map_.in_bounds(nx,ny)) s = seen_[idx(nx,ny)];
-        cands.push_back(Cand{ rel==0?Action::Left : rel==1?Action::Forward : Action::Right, s, (abs==plan_wanted_abs) });
+        if (!seen_.empty() && map_.in_bounds(n.x,n.y)) s = seen_[idx(n.x,n.y)];
+        cands[ncands++] = Cand{ a, s, (static_cast<int>(abs)==plan_wanted_abs) };
     };
-    push_cand(0, sr.left_free);
-    push_cand(1, sr.front_free);
-    push_cand(2, sr.right_free);
+    push_cand(Action::Left, sr.left_free);
+    push_cand(Action::Forward, sr.front_free);
+    push_cand(Action::Right, sr.right_free);
 
-    if (!cands.empty()) {
+    if (ncands > 0) {
         // Prefer unseen (seen==0), else least seen; tie-break by plan match, then heuristic score
-        std::stable_sort(cands.begin(), cands.end(), [&](const Cand& a, const Cand& b){
+        auto better = [&](const Cand& a, const Cand& b){
             bool au = (a.seen==0), bu = (b.seen==0);
             if (au!=bu) return au; // unseen first
             if (a.seen != b.seen) return a.seen < b.seen; // least seen first
             if (a.matches_plan != b.matches_plan) return a.matches_plan; // prefer plan alignment
             // fallback to heuristic score_for
             return score_for(a.a, sr) > score_for(b.a, sr);
-        });
-        Decision d; d.action = cands.front().a; d.score = score_for(d.action, sr); return d;
+        };
+        // Primeira melhor candidata na ordem L/F/R (equivale ao stable_sort anterior, sem buffer temporário)
+        int best = 0;
+        for (int i = 1; i < ncands; ++i) if (better(cands[i], cands[best])) best = i;
+        Decision d; d.action = cands[best].a; d.score = score_for(d.action, sr); return d;
     }
 
     // No left/front/right free: must go back
@@ -198,4 +421,334 @@ void Navigator::applyReward(Action a, float reward) {
     update_heuristic(heur_, idx, reward);
 }
 
+/**
+ * @brief Define parede bidirecional registrando no log os dois lados anteriores.
+ *
+ * Só registra quando há snapshot ativo e a parede de fato muda, de modo que
+ * releituras da mesma parede (comuns em rollouts) não crescem o log.
+ */
+void Navigator::journal_set_wall(int x, int y, Dir dir, bool present) {
+    if (snapshots_ > 0 && map_.in_bounds(x, y)) {
+        const Point n = step(Point{x, y}, dir);
+        const bool mine = map_.has_wall(x, y, dir);
+        const bool theirs = map_.in_bounds(n.x, n.y) ? map_.has_wall(n.x, n.y, opposite(dir)) : mine;
+        if (mine != present || theirs != present) {
+            UndoEntry e; e.kind = UndoEntry::Kind::Wall;
+            e.index = static_cast<uint32_t>(idx(x, y)); e.dir = static_cast<uint8_t>(dir);
+            e.wall = mine; e.wall_nb = theirs;
+            undo_.push_back(e);
+        }
+    }
+    map_.set_wall(x, y, dir, present);
+}
+
+/** @brief Esvazia `pruned_`; com snapshot, registra cada célula podada e o tamanho anterior. */
+void Navigator::clear_pruned() {
+    if (pruned_.empty()) return;
+    if (snapshots_ > 0) {
+        UndoEntry e; e.kind = UndoEntry::Kind::Pruned;
+        for (size_t i = 0; i < pruned_.size(); ++i) {
+            if (!pruned_[i]) continue;
+            e.index = static_cast<uint32_t>(i); e.seen = pruned_[i];
+            undo_.push_back(e);
+        }
+        e.kind = UndoEntry::Kind::PrunedSize; e.index = static_cast<uint32_t>(pruned_.size());
+        undo_.push_back(e);
+    }
+    pruned_.clear();
+}
+
+/** @brief Adota `pruned_next_` (troca de buffers); com snapshot, registra só as células diferentes. */
+void Navigator::replace_pruned() {
+    if (snapshots_ > 0) {
+        UndoEntry e;
+        if (pruned_.size() != pruned_next_.size()) {
+            clear_pruned();
+            e.kind = UndoEntry::Kind::PrunedSize; e.index = 0;
+            undo_.push_back(e);
+            pruned_.assign(pruned_next_.size(), 0);
+        }
+        e.kind = UndoEntry::Kind::Pruned;
+        for (size_t i = 0; i < pruned_.size(); ++i) {
+            if (pruned_[i] == pruned_next_[i]) continue;
+            e.index = static_cast<uint32_t>(i); e.seen = pruned_[i];
+            undo_.push_back(e);
+        }
+    }
+    pruned_.swap(pruned_next_);
+}
+
+/** @brief Guarda o plano atual antes de ele ser substituído (se houver snapshot). */
+void Navigator::journal_plan() {
+    if (snapshots_ == 0) return;
+    plan_stash_.push_back(plan_);
+    UndoEntry e; e.kind = UndoEntry::Kind::Plan;
+    undo_.push_back(e);
+}
+
+/**
+ * @brief Captura o estado atual (marca no log + campos pequenos).
+ *
+ * @return snapshot a ser passado para `restore()`/`release()`
+ */
+Navigator::Snapshot Navigator::snapshot() {
+    sync_map();
+    snapshots_++;
+    Snapshot s;
+    s.log_mark = undo_.size();
+    s.heur = heur_;
+    s.start = start_;
+    s.goal = goal_;
+    s.has_goal = has_goal_;
+    s.plan_valid = plan_valid_;
+    return s;
+}
+
+/**
+ * @brief Desfaz as alterações registradas desde `s`, da mais recente para a mais antiga.
+ *
+ * @param s snapshot obtido de `snapshot()` (continua válido)
+ */
+void Navigator::restore(const Snapshot& s) {
+    bool direct = false;
+    while (undo_.size() > s.log_mark) {
+        const UndoEntry& e = undo_.back();
+        switch (e.kind) {
+            case UndoEntry::Kind::Wall: {
+                const int w = map_.width();
+                const Point c{static_cast<int>(e.index) % w, static_cast<int>(e.index) / w};
+                const Dir d = static_cast<Dir>(e.dir);
+                // Pelo `set_wall`: entra no journal do mapa e os rótulos seguem como numa observação
+                const bool had = map_.has_wall(c.x, c.y, d);
+                map_.set_wall(c.x, c.y, d, e.wall);
+                if (had && !e.wall) reach_.onWallRemoved(c.x, c.y, d);
+                else if (!had && e.wall) reach_.onWallAdded(c.x, c.y, d);
+                if (e.wall_nb != e.wall) { // lados diferentes só por escrita direta: volta do mesmo modo
+                    const Point n = step(c, d);
+                    Cell& nc = map_.at(n.x, n.y);
+                    switch (opposite(d)) {
+                        case Dir::N: nc.wall_n = e.wall_nb; break;
+                        case Dir::E: nc.wall_e = e.wall_nb; break;
+                        case Dir::S: nc.wall_s = e.wall_nb; break;
+                        case Dir::W: nc.wall_w = e.wall_nb; break;
+                    }
+                    direct = true;
+                }
+                break;
+            }
+            case UndoEntry::Kind::Seen:       seen_[e.index] = e.seen; break;
+            case UndoEntry::Kind::Pruned:     pruned_[e.index] = e.seen; break;
+            case UndoEntry::Kind::PrunedSize: pruned_.assign(e.index, 0); break;
+            case UndoEntry::Kind::Plan:
+                mark_plan_edges(false);
+                plan_ = std::move(plan_stash_.back()); plan_stash_.pop_back();
+                mark_plan_edges(true);
+                break;
+        }
+        undo_.pop_back();
+    }
+    // Paredes voltaram pelo journal do mapa (consumidores seguem incrementais);
+    // só um lado assimétrico escrito direto pede reconstrução.
+    if (direct) { reach_.invalidate(); map_.touchAll(); }
+    map_gen_ = map_.generation();
+    heur_ = s.heur;
+    start_ = s.start;
+    goal_ = s.goal;
+    has_goal_ = s.has_goal;
+    plan_valid_ = s.plan_valid;
+}
+
+/**
+ * @brief Encerra um snapshot; sem snapshots ativos o log é esvaziado (capacidade mantida).
+ */
+void Navigator::release(const Snapshot& /*s*/) {
+    if (snapshots_ > 0) snapshots_--;
+    if (snapshots_ == 0) { undo_.clear(); plan_stash_.clear(); }
+}
+
+/**
+ * @brief true se a decisão anterior foi um giro nesta célula rumo ao heading atual.
+ *
+ * No laço real um giro não sai da célula: a decisão seguinte completa o
+ * movimento escolhido sem refazer a busca (evita alternar entre giros quando
+ * duas saídas têm custo estimado parecido). O compromisso vale só para a
+ * decisão seguinte: a consulta o consome.
+ */
+bool Navigator::committed_forward(Point current, uint8_t heading, const SensorRead& sr) {
+    const bool hit = sr.front_free && commit_dir_ == static_cast<int8_t>(heading & 3u) &&
+                     commit_cell_.x == current.x && commit_cell_.y == current.y;
+    commit_dir_ = -1;
+    return hit;
+}
+
+/** @brief Registra o giro `a` (ou limpa o compromisso se `a` é avançar). */
+void Navigator::commit_turn(Point current, uint8_t heading, Action a) {
+    if (a == Action::Forward) { commit_dir_ = -1; return; }
+    commit_cell_ = current;
+    commit_dir_ = static_cast<int8_t>(rel_to_abs(from_heading(heading), a));
+}
+
+/** @brief Gerador xorshift32 dos rollouts (determinístico, sem estado global). */
+static uint32_t rollout_rand(uint32_t& s) {
+    s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+    return s;
+}
+
+/**
+ * @brief Decide por rollouts: K futuros por ação candidata, menor custo vence.
+ *
+ * Empates ficam com a ação de `decidePlanned()`, avaliada primeiro.
+ *
+ * @param current célula atual
+ * @param heading orientação absoluta: 0=N,1=E,2=S,3=W
+ * @param sr leitura dos sensores
+ * @param cfg parâmetros dos rollouts
+ * @return decisão de menor custo estimado
+ */
+Decision Navigator::decideRollout(Point current, uint8_t heading, const SensorRead& sr, const RolloutConfig& cfg) {
+    const Decision base = decidePlanned(current, heading, sr);
+    const bool committed = committed_forward(current, heading, sr);
+    if (!has_goal_ || cfg.rollouts == 0 || !map_.in_bounds(current.x, current.y) || !map_.in_bounds(goal_.x, goal_.y))
+        return base;
+    // Aberturas na borda (ex.: entrada do labirinto) não levam a células da grade
+    auto inside = [&](Action a) {
+        const Point q = step(current, rel_to_abs(from_heading(heading), a));
+        return map_.in_bounds(q.x, q.y);
+    };
+    if (committed && inside(Action::Forward)) {
+        Decision d; d.action = Action::Forward; d.score = score_for(d.action, sr); return d;
+    }
+
+    // A ação de `decidePlanned()` vem primeiro (vence empates), se levar a uma célula da grade
+    Action cands[3];
+    int n = 0;
+    if (inside(base.action)) cands[n++] = base.action;
+    if (sr.left_free && base.action != Action::Left && inside(Action::Left)) cands[n++] = Action::Left;
+    if (sr.front_free && base.action != Action::Forward && inside(Action::Forward)) cands[n++] = Action::Forward;
+    if (sr.right_free && base.action != Action::Right && inside(Action::Right)) cands[n++] = Action::Right;
+    if (n == 0 || (n == 1 && cands[0] == base.action)) return base;
+    if (n == 1) { Decision d; d.action = cands[0]; d.score = score_for(d.action, sr); return d; }
+
+    const uint32_t noise = static_cast<uint32_t>(cfg.epsilon * 65536.0f);
+    uint32_t rng = 1u;
+    auto read = [&](Point p, Dir h) {
+        SensorRead r;
+        r.left_free  = !map_.has_wall(p.x, p.y, rel_to_abs(h, Action::Left));
+        r.front_free = !map_.has_wall(p.x, p.y, h);
+        r.right_free = !map_.has_wall(p.x, p.y, rel_to_abs(h, Action::Right));
+        return r;
+    };
+    // Distância até o goal no mapa conhecido: guia a política dos rollouts
+    const int w = map_.width(), hgt = map_.height();
+    rollout_dist_.assign(static_cast<size_t>(w) * hgt, -1);
+    rollout_queue_.clear();
+    rollout_dist_[idx(goal_.x, goal_.y)] = 0;
+    rollout_queue_.push_back(goal_);
+    for (size_t qi = 0; qi < rollout_queue_.size(); ++qi) {
+        const Point p = rollout_queue_[qi];
+        for (uint8_t k = 0; k < 4; ++k) {
+            const Dir d = from_heading(k);
+            const Point q = step(p, d);
+            if (map_.has_wall(p.x, p.y, d) || !map_.in_bounds(q.x, q.y) || rollout_dist_[idx(q.x, q.y)] >= 0) continue;
+            rollout_dist_[idx(q.x, q.y)] = rollout_dist_[idx(p.x, p.y)] + 1;
+            rollout_queue_.push_back(q);
+        }
+    }
+    // Sem caminho conhecido até o goal os rollouts não distinguem as ações
+    if (rollout_dist_[idx(current.x, current.y)] < 0) return base;
+    auto dist_after = [&](Point p, Dir h, Action a) {
+        const Dir d = rel_to_abs(h, a);
+        const Point q = step(p, d);
+        const int v = map_.in_bounds(q.x, q.y) ? rollout_dist_[idx(q.x, q.y)] : -1;
+        return v < 0 ? INT_MAX : v;
+    };
+
+    // Um futuro: primeira ação fixa, depois descida gulosa na distância com
+    // ação aleatória (prob. ε; o primeiro futuro de cada ação é sem ruído).
+    // Custo = avanços + giros (um por quarto de volta), como no laço real em
+    // que girar consome uma decisão. O mapa conhecido é determinístico, então
+    // cada ação vale o menor custo entre os seus futuros.
+    auto rollout = [&](Action first, uint32_t eps) -> int {
+        Point p = current;
+        Dir h = from_heading(heading);
+        int cost = 0;
+        for (int t = 0; t < cfg.horizon; ++t) {
+            if (p.x == goal_.x && p.y == goal_.y) return cost;
+            const SensorRead r = read(p, h);
+            observeCellWalls(p, r, static_cast<uint8_t>(h));
+            Action free_acts[3];
+            int k = 0;
+            if (r.front_free) free_acts[k++] = Action::Forward;
+            if (r.left_free)  free_acts[k++] = Action::Left;
+            if (r.right_free) free_acts[k++] = Action::Right;
+            Action a = first;
+            if (t > 0) {
+                if (k == 0) a = Action::Back;
+                else if ((rollout_rand(rng) & 0xFFFFu) < eps) a = free_acts[rollout_rand(rng) % k];
+                else {
+                    a = free_acts[0];
+                    for (int j = 1; j < k; ++j) if (dist_after(p, h, free_acts[j]) < dist_after(p, h, a)) a = free_acts[j];
+                    if (dist_after(p, h, Action::Back) < dist_after(p, h, a)) a = Action::Back;
+                }
+            }
+            cost += 1 + (a == Action::Back ? 2 : a == Action::Forward ? 0 : 1);
+            h = rel_to_abs(h, a);
+            const Point q = step(p, h);
+            if (map_.has_wall(p.x, p.y, h) || !map_.in_bounds(q.x, q.y)) break;
+            p = q;
+        }
+        if (p.x == goal_.x && p.y == goal_.y) return cost;
+        const int rest = rollout_dist_[idx(p.x, p.y)];
+        return cost + (rest < 0 ? 2 * (w + hgt) : rest);
+    };
+
+    const Snapshot snap = snapshot();
+    Action best = cands[0];
+    int best_cost = INT_MAX;
+    for (int i = 0; i < n; ++i) {
+        // Mesmas sementes para todas as candidatas (números aleatórios comuns)
+        rng = cfg.seed ? cfg.seed : 1u;
+        int cost = INT_MAX;
+        for (int k = 0; k < cfg.rollouts; ++k) {
+            cost = std::min(cost, rollout(cands[i], k == 0 ? 0u : noise));
+            restore(snap);
+        }
+        // Novidade: cada visita anterior à célula de destino custa um passo
+        const Point t = step(current, rel_to_abs(from_heading(heading), cands[i]));
+        if (map_.in_bounds(t.x, t.y)) cost += seen_[idx(t.x, t.y)];
+        if (cost < best_cost) { best_cost = cost; best = cands[i]; }
+    }
+    release(snap);
+
+    commit_turn(current, heading, best);
+    Decision d; d.action = best; d.score = score_for(best, sr); return d;
+}
+
+/**
+ * @brief Decide por MCTS: a direção absoluta da busca vira ação relativa ao heading.
+ *
+ * @param current célula atual
+ * @param heading orientação absoluta: 0=N,1=E,2=S,3=W
+ * @param sr leitura dos sensores
+ * @param cfg parâmetros da busca
+ * @param info estatísticas da busca (opcional)
+ * @return decisão de menor custo esperado
+ */
+Decision Navigator::decideMcts(Point current, uint8_t heading, const SensorRead& sr, const MctsConfig& cfg,
+                               MctsPlanner::Result* info) {
+    const bool committed = committed_forward(current, heading, sr);
+    if (!has_goal_ || seen_.empty()) return decidePlanned(current, heading, sr);
+    Decision d;
+    if (committed) {
+        d.action = Action::Forward; d.score = score_for(d.action, sr); return d;
+    }
+    const MctsPlanner::Result r = mcts_.search(map_, seen_.data(), current, from_heading(heading), goal_, cfg);
+    if (info) *info = r;
+    if (r.dir < 0) return decidePlanned(current, heading, sr);
+    d.action = abs_to_action(from_heading(heading), from_heading(static_cast<uint8_t>(r.dir)));
+    d.score = score_for(d.action, sr);
+    commit_turn(current, heading, d.action);
+    return d;
+}
+
 } // namespace maze
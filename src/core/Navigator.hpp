@@ -5,15 +5,20 @@
 #pragma once
 #include <cstdint>
 #include <vector>
+#include <memory_resource>
 #include "MazeMap.hpp"
+#include "Direction.hpp"
 #include "Planner.hpp"
 #include "Learning.hpp"
+#include "Connectivity.hpp"
+#include "DeadEndFill.hpp"
+#include "PathCode.hpp"
+#include "Mcts.hpp"
+#include "AnytimePlanner.hpp"
+#include "EdgeCost.hpp"
 
 namespace maze {
 
-/** @brief Ação possível do robô sobre a malha do labirinto. */
-enum class Action : uint8_t { Right, Forward, Left, Back };
-
 /** @brief Leituras discretizadas dos sensores de obstáculos. */
 struct SensorRead {
     bool left_free{false};   ///< true se não há obstáculo à esquerda
@@ -31,6 +36,34 @@ struct Decision {
     uint8_t score{6};               ///< Nota de 0..10 para a ação
 };
 
+/**
+ * @brief Paredes alteradas por uma observação (`Navigator::observeCellWalls`).
+ *
+ * Cada campo é uma máscara de direções absolutas da célula observada
+ * (bit `1 << idx(Dir)`).
+ */
+struct WallChanges {
+    uint8_t added{0};   ///< Paredes novas
+    uint8_t removed{0}; ///< Paredes que deixaram de existir (aberturas)
+    bool any() const { return (added | removed) != 0; }
+};
+
+/** @brief Contadores do replanejamento sob demanda (`Navigator::planIfInvalid`). */
+struct PlanStats {
+    uint32_t requests{0}; ///< Chamadas a `planIfInvalid()`
+    uint32_t replans{0};  ///< Chamadas que rodaram o planejador
+};
+
+/**
+ * @brief Parâmetros do modo de decisão por rollouts (`Navigator::decideRollout`).
+ */
+struct RolloutConfig {
+    uint8_t rollouts{8};    ///< Futuros simulados por ação candidata (K)
+    uint16_t horizon{64};   ///< Passos máximos por futuro
+    float epsilon{0.25f};   ///< Probabilidade de ação aleatória na política de rollout
+    uint32_t seed{1};       ///< Semente do gerador (rollouts determinísticos)
+};
+
 /**
  * @brief Estratégias de navegação disponíveis.
  */
@@ -39,6 +72,22 @@ public:
     /// Estratégia ativa
     enum class Strategy : uint8_t { RightHand /* Mão Direita */ };
 
+    /**
+     * @brief Cria o navegador com os contêineres internos no recurso `mr`.
+     *
+     * Mapa, visitas, rótulos de conectividade, log de desfazer, buffers dos
+     * rollouts/MCTS e as estruturas temporárias do planejador alocam de `mr`.
+     * Com uma `EpisodeArena`, o navegador deve ser destruído antes de
+     * `EpisodeArena::reset()`.
+     *
+     * @param mr recurso de memória (padrão: alocador global)
+     */
+    explicit Navigator(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : map_(1, 1, mr), reach_(mr), seen_(mr), undo_(mr), rollout_dist_(mr), rollout_queue_(mr),
+          planner_ws_(mr), route_(mr), plan_edges_(mr), anytime_(mr), mcts_(mr), edge_costs_(mr), mr_(mr) {
+        map_gen_ = map_.generation();
+    }
+
     /**
      * @brief Define a estratégia de navegação.
      * @param s estratégia desejada
@@ -53,33 +102,155 @@ public:
     Decision decide(const SensorRead& sr);
 
     // ---------- Integração com mapa e planner (opcionais) ----------
-    /** @brief Define as dimensões do mapa interno e reinicia estatísticas de visita. */
+    /**
+     * @brief Define as dimensões do mapa interno e reinicia estatísticas de visita.
+     *
+     * Reaproveita a memória já alocada e reserva o caminho máximo (w*h células)
+     * para o plano, de modo que `planRoute()` e `decidePlanned()` não alocam
+     * depois do primeiro planejamento. Os tempos de `edgeCosts()` são
+     * mantidos se as dimensões não mudam.
+     */
     void setMapDimensions(int w, int h) {
-        map_ = MazeMap(w,h);
-        seen_.assign(w * h, 0);
+        map_.reset(w, h);
+        edge_costs_.resize(w, h);
+        seen_.assign(static_cast<size_t>(w * h), 0);
+        route_.reserve(static_cast<size_t>(w * h));
+        plan_.reserve(static_cast<size_t>(w * h));
+        plan_edges_.assign((static_cast<size_t>(w * h) * 2 + 63) / 64, 0);
+        plan_valid_ = false;
+        anytime_.cancel();
+        reach_.invalidate();
+        pruned_.clear();
+        map_gen_ = map_.generation();
+        commit_dir_ = -1;
     }
     /** @brief Define célula inicial e objetivo e habilita o estado de objetivo. */
-    void setStartGoal(Point s, Point g) { start_ = s; goal_ = g; has_goal_ = true; }
+    void setStartGoal(Point s, Point g) {
+        start_ = s; goal_ = g; has_goal_ = true; plan_valid_ = false; anytime_.cancel(); commit_dir_ = -1;
+    }
 
     /**
      * @brief Observa paredes a partir das leituras e orientação atual.
+     *
+     * Também decide se o plano guardado continua válido: uma parede nova só o
+     * invalida se cortar uma aresta do plano; uma abertura só o invalida se um
+     * caminho por ela puder ser mais curto (limite inferior por distância de
+     * Manhattan start→aresta→goal menor que o plano).
+     *
      * @param cell célula atual (x,y)
      * @param sr leituras discretizadas
      * @param heading orientação atual (0=N,1=E,2=S,3=W)
+     * @return paredes adicionadas/removidas nesta observação
      */
-    void observeCellWalls(Point cell, const SensorRead& sr, uint8_t heading);
+    WallChanges observeCellWalls(Point cell, const SensorRead& sr, uint8_t heading);
     /** @brief Planeja rota do start ao goal. @return true se uma rota foi encontrada */
     bool planRoute();
+    /**
+     * @brief Replaneja só se o resultado guardado deixou de valer para o mapa conhecido.
+     *
+     * Depois de um `planRoute()`, o plano (ou a ausência de rota) continua
+     * exato até que `observeCellWalls()` corte uma aresta do plano ou abra uma
+     * passagem que possa encurtá-lo; `setStartGoal()`, `setMapDimensions()` e
+     * `pruneDeadEnds()` também invalidam. Paredes alteradas por fora (via
+     * `map()`) são conferidas do mesmo modo pelo journal do mapa
+     * (`MazeMap::changesSince`); sem journal, invalidam. Enquanto válido,
+     * custa O(1) e devolve o resultado guardado.
+     *
+     * @return true se há plano
+     */
+    bool planIfInvalid();
+    /**
+     * @brief Como `planIfInvalid()`, mas replaneja em fatias de no máximo `budget` unidades (ARA*).
+     *
+     * A busca (`AnytimePlanner`) continua de onde parou a cada chamada, então o
+     * custo por chamada é limitado qualquer que seja o labirinto. Enquanto ela
+     * não termina, o plano é o melhor caminho já publicado (custo <= ε·ótimo;
+     * sem publicação, fica o plano anterior) e `planValid()` continua false. Ao
+     * provar o ótimo, ou a falta de rota, o resultado fica válido como em
+     * `planRoute()`. Não consulta os rótulos de conectividade (a reconstrução
+     * deles não cabe numa fatia).
+     *
+     * @param budget unidades de trabalho desta chamada (ver `AnytimePlanner::step`)
+     * @param cfg ε inicial e passo de redução
+     * @return true se há plano
+     */
+    bool planSliced(uint32_t budget, const AnytimeConfig& cfg = AnytimeConfig{});
+    /** @brief Planejador fatiado usado por `planSliced()` (ε e trabalho, para diagnóstico). */
+    const AnytimePlanner& anytimePlanner() const { return anytime_; }
+
+    /**
+     * @brief Tempos de travessia aprendidos por aresta (ver `EdgeCostMap`).
+     *
+     * O laço de controle chama `edgeCosts().record(célula, direção, ms)` a cada
+     * célula nova; `PersistentMemory::saveEdgeCosts()` os guarda entre corridas.
+     * Mudar os tempos não invalida o plano: eles valem a partir do próximo
+     * `planRoute()`.
+     */
+    EdgeCostMap& edgeCosts() { return edge_costs_; }
+    const EdgeCostMap& edgeCosts() const { return edge_costs_; }
+    /**
+     * @brief Liga o planejamento ponderado: `planRoute()`/`planIfInvalid()` (Dijkstra de Dial)
+     *        e `planSliced()` (ARA*) minimizam o tempo estimado por `edgeCosts()` em vez do
+     *        número de células.
+     *
+     * Sem nenhuma aresta medida continua usando custo uniforme. Uma busca
+     * fatiada em andamento é descartada.
+     */
+    void setWeightedPlanning(bool on) { weighted_ = on; plan_valid_ = false; anytime_.cancel(); }
+    bool weightedPlanning() const { return weighted_; }
+    /** @brief true se o plano guardado ainda é exato para o mapa conhecido (alterações externas pendentes contam como inválido). */
+    bool planValid() const { return plan_valid_ && map_gen_ == map_.generation(); }
+    /** @brief Contadores de `planIfInvalid()` (chamadas e replanejamentos). */
+    const PlanStats& planStats() const { return plan_stats_; }
+    /** @brief Zera os contadores de `planIfInvalid()`. */
+    void resetPlanStats() { plan_stats_ = PlanStats{}; }
+    /**
+     * @brief Indica se o objetivo é alcançável no mapa conhecido.
+     *
+     * Consulta os rótulos de componentes conexas (union-find). Custa O(α(n))
+     * quando nenhuma parede foi adicionada desde a última reconstrução; caso
+     * contrário (inclusive por alteração externa via `map()`) reconstrói os
+     * rótulos uma vez.
+     */
+    bool isGoalReachable() const {
+        if (map_gen_ != map_.generation()) reach_.invalidate();
+        return has_goal_ && reach_.connected(map_, start_, goal_);
+    }
+    /**
+     * @brief Poda becos sem saída do mapa conhecido (dead-end filling).
+     *
+     * Indicado para mapas já explorados (fase de replay/speed-run). Enquanto
+     * a poda estiver ativa, `planRoute()` e `decidePlanned()` ignoram as células
+     * podadas. A poda é descartada quando uma parede é removida do mapa.
+     *
+     * @return estatísticas (total, podadas, restantes)
+     */
+    PruneStats pruneDeadEnds();
+    /** @brief Máscara de células podadas (vazia quando não há poda ativa). */
+    const std::vector<uint8_t>& prunedCells() const { return pruned_; }
     /** @brief Indica se há um plano válido armazenado. */
     bool hasPlan() const { return !plan_.empty(); }
 
     /**
-     * @brief Acessa a sequência de pontos do plano atual (somente leitura).
+     * @brief Acessa o plano atual (somente leitura).
+     *
+     * Útil para visualização em simuladores e para persistência
+     * (`PersistentMemory::savePath`). Itera as células do caminho; será vazio
+     * quando não houver plano. Use `toPoints()` se precisar de um vetor.
+     */
+    const PathCode& currentPlan() const { return plan_; }
+    /**
+     * @brief Substitui o plano atual (ex.: caminho carregado da flash).
+     *
+     * O plano só é tomado como válido (`planValid()`) se começa em `start`,
+     * termina no `goal` e todas as arestas estão dentro do mapa e abertas no
+     * mapa conhecido; caso contrário fica como sugestão para `decidePlanned()`
+     * e o próximo `planIfInvalid()` replaneja.
      *
-     * Útil para visualização em simuladores. Retorna uma referência const ao
-     * vetor interno; será vazio quando não houver plano.
+     * @param p caminho do start ao goal
+     * @return true se o caminho é coerente com start, goal e o mapa conhecido
      */
-    const std::vector<Point>& currentPlan() const { return plan_; }
+    bool setPlan(const PathCode& p);
 
     /**
      * @brief Decide considerando rota planejada (se existir); senão, fallback RightHand.
@@ -98,8 +269,105 @@ public:
     /** @brief Aplica recompensa a uma ação tomada (atualiza heurísticas). */
     void applyReward(Action a, float reward);
 
+    // ---------- Snapshots e rollouts ----------
+    /**
+     * @brief Marca de estado para `restore()`.
+     *
+     * Guarda a posição no log de desfazer e os campos pequenos (heurísticas,
+     * start/goal); mapa, visitas, poda e plano são restaurados pelo log.
+     */
+    struct Snapshot {
+        size_t log_mark{0};    ///< Tamanho do log de desfazer na captura
+        Heuristics heur{};     ///< Heurísticas na captura
+        Point start{};         ///< Start na captura
+        Point goal{};          ///< Goal na captura
+        bool has_goal{false};  ///< has_goal na captura
+        bool plan_valid{false}; ///< Validade do plano na captura
+    };
+
+    /**
+     * @brief Captura o estado atual e liga o log de desfazer. O(1).
+     *
+     * Enquanto houver snapshots ativos, toda alteração feita por
+     * `observeCellWalls()`, `planRoute()`, `setPlan()` e `pruneDeadEnds()` registra
+     * o valor anterior (paredes, contador de visita, células da máscara de poda,
+     * plano). Snapshots podem ser aninhados. Alterações via `map()` mutável ou
+     * `setMapDimensions()` não são registradas.
+     */
+    Snapshot snapshot();
+    /**
+     * @brief Volta ao estado de `s` desfazendo o log. O(alterações desde `s`).
+     *
+     * `s` continua válido (pode ser restaurado de novo, ex.: um rollout por vez).
+     * Paredes voltam por `MazeMap::set_wall` (entram no journal do mapa, e os
+     * rótulos de conectividade as recebem como observações); a poda volta
+     * célula a célula.
+     */
+    void restore(const Snapshot& s);
+    /** @brief Encerra `s` (sem restaurar); ao encerrar o último, o log é descartado. */
+    void release(const Snapshot& s);
+    /** @brief Número de visitas registradas na célula (x,y) (0 se fora do mapa). */
+    uint8_t seenCount(int x, int y) const {
+        return (map_.in_bounds(x,y) && !seen_.empty()) ? seen_[idx(x,y)] : 0;
+    }
+
+    /**
+     * @brief Decide simulando K futuros por ação candidata sobre o mapa conhecido.
+     *
+     * Para cada ação livre (esquerda/frente/direita, ou trás se nenhuma), executa
+     * `cfg.rollouts` futuros de até `cfg.horizon` passos: a política do rollout
+     * desce a distância BFS até o goal no mapa conhecido, com ação aleatória com
+     * probabilidade `cfg.epsilon` (o primeiro futuro é sem ruído), e os sensores
+     * são lidos do próprio mapa conhecido. O custo de um futuro é avanços +
+     * giros até o goal (ou a distância restante, se o horizonte acabar). Como o
+     * mapa conhecido é determinístico, cada ação vale o menor custo entre os
+     * seus futuros mais um passo por visita anterior à célula de destino
+     * (novidade); as mesmas sementes valem para todas as candidatas. Depois de
+     * decidir um giro, a chamada seguinte na mesma célula avança sem nova busca.
+     * Cada futuro roda entre `snapshot()` e `restore()`, então o estado do
+     * navegador não muda. Sem goal definido (ou sem caminho conhecido até ele), equivale
+     * a `decidePlanned()`.
+     *
+     * @param current célula atual
+     * @param heading orientação atual (0=N,1=E,2=S,3=W)
+     * @param sr leituras discretizadas
+     * @param cfg parâmetros dos rollouts
+     * @return Decisão com ação e nota [0..10]
+     */
+    Decision decideRollout(Point current, uint8_t heading, const SensorRead& sr, const RolloutConfig& cfg = {});
+
+    /**
+     * @brief Decide por MCTS com orçamento em microssegundos (ver `MctsPlanner`).
+     *
+     * Células ainda não visitadas têm paredes desconhecidas, tratadas como
+     * parede com probabilidade `cfg.wall_prior` (use
+     * `MctsPlanner::priorFromStats()` sobre labirintos conhecidos). Escolhe a
+     * ação que minimiza o número esperado de passos até o goal. Para o RP2040
+     * use `MctsConfig::embedded()`. Como em `decideRollout()`, um giro decidido
+     * é completado na chamada seguinte sem nova busca. Sem goal definido, ou se
+     * a busca não encontrar ação, equivale a `decidePlanned()`.
+     *
+     * @param current célula atual
+     * @param heading orientação atual (0=N,1=E,2=S,3=W)
+     * @param sr leituras discretizadas
+     * @param cfg parâmetros da busca
+     * @param info se não nulo, recebe as estatísticas da busca
+     * @return Decisão com ação e nota [0..10]
+     */
+    Decision decideMcts(Point current, uint8_t heading, const SensorRead& sr, const MctsConfig& cfg = {},
+                        MctsPlanner::Result* info = nullptr);
+
     // ---------- Acesso ao mapa para persistência ----------
-    /** @brief Acesso ao mapa interno para leitura/escrita. */
+    /**
+     * @brief Acesso ao mapa interno para leitura/escrita.
+     *
+     * O acesso em si não descarta nada: as paredes alteradas pelo chamador
+     * mudam `MazeMap::generation()`, e a próxima chamada que depende do mapa
+     * (observação, planejamento, decisão) confere essas alterações contra o
+     * plano, a poda e os rótulos de conectividade, como em
+     * `observeCellWalls()`. Escritas diretas nas células exigem
+     * `MazeMap::touchAll()`.
+     */
     MazeMap& map() { return map_; }
     /** @brief Acesso somente-leitura ao mapa interno. */
     const MazeMap& map() const { return map_; }
@@ -107,19 +375,84 @@ public:
 private:
     Strategy strategy_{Strategy::RightHand}; ///< Estratégia atual
     // Estado do mapa/rota
-    MazeMap map_{1,1};                    ///< Mapa conhecido
+    MazeMap map_;                         ///< Mapa conhecido
     Point start_{0,0};                    ///< Célula inicial
     Point goal_{0,0};                     ///< Célula objetivo
     bool has_goal_{false};                ///< Indica se goal foi definido
-    std::vector<Point> plan_{};           ///< Sequência de células (inclui start e goal)
+    PathCode plan_{};                     ///< Caminho planejado (start + movimentos de 2 bits)
+    mutable Connectivity reach_;          ///< Componentes conexas do mapa conhecido (cache)
+    std::vector<uint8_t> pruned_{};       ///< Células podadas por dead-end filling (vazio = sem poda)
 
     Heuristics heur_{};                   ///< Pesos para ações
 
     /** @brief Contador de visitas por célula (para explorar novidades primeiro). */
-    std::vector<uint8_t> seen_{};
+    std::pmr::vector<uint8_t> seen_;
     /** @brief Índice linear em `seen_`. */
     inline int idx(int x, int y) const { return y * map_.width() + x; }
 
+    /** @brief Entrada do log de desfazer (valor anterior de uma alteração). */
+    struct UndoEntry {
+        enum class Kind : uint8_t { Wall, Seen, Pruned, PrunedSize, Plan };
+        Kind kind{Kind::Wall};
+        uint32_t index{0}; ///< Índice linear da célula (Wall/Seen/Pruned); tamanho anterior (PrunedSize)
+        uint8_t seen{0};   ///< Contador anterior (Seen) ou byte anterior da máscara (Pruned)
+        uint8_t dir{0};    ///< Direção da parede a partir da célula (Wall)
+        bool wall{false};  ///< Parede anterior do lado da célula (Wall)
+        bool wall_nb{false}; ///< Parede anterior do lado do vizinho (Wall; igual a `wall` fora da grade)
+    };
+    int snapshots_{0};                        ///< Snapshots ativos (>0 liga o log)
+    std::pmr::vector<UndoEntry> undo_;        ///< Log de desfazer (capacidade reaproveitada)
+    std::vector<uint8_t> pruned_next_{};      ///< Máscara nova de `pruneDeadEnds()` (comparada célula a célula)
+    std::vector<PathCode> plan_stash_{};      ///< Planos substituídos
+    std::pmr::vector<int> rollout_dist_;      ///< Distância ao goal no mapa conhecido (rollouts)
+    std::pmr::vector<Point> rollout_queue_;   ///< Fila do BFS de `rollout_dist_`
+    PlannerWorkspace planner_ws_;             ///< Estruturas do BFS reaproveitadas por `planRoute()`
+    std::pmr::vector<Point> route_;           ///< Caminho do último BFS (antes de virar `plan_`)
+    std::pmr::vector<uint64_t> plan_edges_;   ///< Bit por aresta (E e S de cada célula) usada por `plan_`
+    bool plan_valid_{false};                  ///< `plan_` (ou a falta de rota) é exato para `map_`
+    PlanStats plan_stats_{};                  ///< Contadores de `planIfInvalid()`
+    uint64_t map_gen_{0};                     ///< Geração de `map_` já refletida em plano, poda e rótulos
+    AnytimePlanner anytime_;                  ///< Busca ARA* retomável de `planSliced()`
+    uint32_t anytime_version_{0};             ///< Último caminho do `anytime_` copiado para `plan_`
+    MctsPlanner mcts_;                        ///< Árvore e buffers do MCTS (reaproveitados)
+    EdgeCostMap edge_costs_;                  ///< Tempos de travessia aprendidos por aresta
+    bool weighted_{false};                    ///< `planRoute()`/`planSliced()` usam `edge_costs_`
+    std::pmr::memory_resource* mr_;           ///< Recurso dos contêineres e do planejador
+    Point commit_cell_{-1,-1};                ///< Célula do último giro decidido por busca
+    int8_t commit_dir_{-1};                   ///< Direção absoluta do último giro (-1 = nenhum)
+
+    /** @brief true se a decisão anterior foi um giro nesta célula rumo ao heading atual (consome o registro). */
+    bool committed_forward(Point current, uint8_t heading, const SensorRead& sr);
+    /** @brief Registra o giro decidido (avançar limpa o registro). */
+    void commit_turn(Point current, uint8_t heading, Action a);
+
+    /** @brief Aplica ao plano, à poda e aos rótulos as paredes alteradas por fora desde `map_gen_`. */
+    void sync_map();
+    /** @brief Efeito de uma parede adicionada (`removed == false`) ou removida em (p,d) no estado derivado. */
+    void on_wall_changed(Point p, Dir d, bool removed);
+
+    /** @brief Define parede registrando as células alteradas no log. */
+    void journal_set_wall(int x, int y, Dir dir, bool present);
+    /** @brief Descarta a poda registrando no log só as células podadas. */
+    void clear_pruned();
+    /** @brief Troca a máscara de poda por `pruned_next_` registrando só as células que mudam. */
+    void replace_pruned();
+    /** @brief Registra o plano antes de substituí-lo. */
+    void journal_plan();
+
+    /** @brief Índice em `plan_edges_` da aresta entre `p` e o vizinho em `d` (-1 se sair do mapa). */
+    long edge_index(Point p, Dir d) const;
+    /** @brief Liga/desliga em `plan_edges_` os bits das arestas de `plan_`. */
+    void mark_plan_edges(bool on);
+    /** @brief true se `plan_` vai de `start_` a `goal_` só por arestas abertas de `map_`. */
+    bool plan_fits_map() const;
+    /** @brief true se a aresta (p,d) faz parte de `plan_`. */
+    bool edge_on_plan(Point p, Dir d) const;
+    /** @brief true se o planejamento usa os custos aprendidos (ligado e com alguma medição). */
+    bool use_edge_costs() const { return weighted_ && edge_costs_.measured() > 0; }
+    /** @brief true se abrir a aresta (p,d) pode gerar caminho mais curto que `plan_` (limite de Manhattan). */
+    bool opening_may_shorten(Point p, Dir d) const;
+
     /** @brief Calcula nota para uma ação dado o estado sensorial. */
     uint8_t score_for(Action a, const SensorRead& sr) const;
 };
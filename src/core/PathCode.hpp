@@ -0,0 +1,280 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <optional>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include "MazeMap.hpp"
+
+/**
+ * @file PathCode.hpp
+ * @brief Representação compacta de caminhos: célula inicial + movimentos absolutos de 2 bits.
+ */
+
+namespace maze {
+
+/**
+ * @brief Caminho em grade codificado como start + sequência de movimentos N/E/S/W (2 bits cada).
+ *
+ * Cada movimento usa a mesma codificação do heading (0=N, 1=E, 2=S, 3=W) e
+ * ocupa 2 bits, quatro por byte. Em relação a `std::vector<Point>` (8 bytes
+ * por célula) o caminho fica 32x menor, cabe numa página de flash do RP2040 e
+ * copiar `Navigator::plan_` custa quase nada.
+ *
+ * - `move(i)` é O(1); as células são obtidas percorrendo os movimentos
+ *   (`begin()/end()`), sem materializar vetores.
+ * - `runs()` agrupa movimentos iguais consecutivos (retas), útil para
+ *   comandar trechos contínuos no robô.
+ * - `toText()/fromText()` produzem a forma textual run-length usada no
+ *   `.soluct` (ex.: `"E3S2W"`: três a leste, dois ao sul, um a oeste).
+ */
+class PathCode {
+public:
+    /** @brief Trecho reto: `count` movimentos consecutivos na direção `dir`. */
+    struct Run {
+        uint8_t dir{0};    ///< Direção absoluta (0=N,1=E,2=S,3=W)
+        uint32_t count{0}; ///< Número de movimentos
+    };
+
+    /** @brief Caminho vazio (sem célula inicial). */
+    PathCode() = default;
+    /** @brief Caminho com apenas a célula inicial. */
+    explicit PathCode(Point start) : start_(start), end_(start), has_start_(true) {}
+
+    /**
+     * @brief Converte uma sequência de células contíguas (4-vizinhança).
+     * @param pts células do caminho (inclui início e fim)
+     * @return código do caminho, ou std::nullopt se duas células seguidas não forem vizinhas
+     */
+    static std::optional<PathCode> fromPoints(const std::vector<Point>& pts) {
+        PathCode pc;
+        if (!pc.assign(pts.data(), pts.size())) return std::nullopt;
+        return pc;
+    }
+
+    /**
+     * @brief Substitui o conteúdo por `n` células contíguas, reaproveitando a capacidade.
+     *
+     * Não aloca se a capacidade atual (`reserve()`) comporta `n - 1` movimentos.
+     *
+     * @param pts células do caminho (inclui início e fim)
+     * @param n número de células (0 = caminho vazio)
+     * @return false (e caminho vazio) se duas células seguidas não forem vizinhas
+     */
+    bool assign(const Point* pts, size_t n) {
+        clear();
+        if (n == 0) return true;
+        start_ = end_ = pts[0];
+        has_start_ = true;
+        reserve(n - 1);
+        for (size_t i = 1; i < n; ++i) {
+            const int d = dirBetween(pts[i-1], pts[i]);
+            if (d < 0) { clear(); return false; }
+            push(static_cast<uint8_t>(d));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reconstrói a partir dos bytes empacotados (ex.: lidos da flash).
+     * @param start célula inicial
+     * @param moves número de movimentos
+     * @param data bytes empacotados (4 movimentos por byte, LSB primeiro)
+     * @param len tamanho de `data` em bytes
+     * @return código do caminho, ou std::nullopt se `len` for insuficiente
+     */
+    static std::optional<PathCode> fromBytes(Point start, size_t moves, const uint8_t* data, size_t len) {
+        if (len < (moves + 3) / 4) return std::nullopt;
+        PathCode pc(start);
+        pc.reserve(moves);
+        for (size_t i = 0; i < moves; ++i) pc.push((data[i >> 2] >> ((i & 3) * 2)) & 3u);
+        return pc;
+    }
+
+    /** @brief Limite padrão de movimentos em `fromText()` (o campo de tamanho da flash tem 16 bits). */
+    static constexpr size_t kMaxTextMoves = 0xFFFF;
+
+    /**
+     * @brief Lê a forma textual run-length (`toText()`).
+     * @param start célula inicial
+     * @param text letras N/E/S/W, cada uma seguida opcionalmente de uma contagem decimal
+     * @param max_moves total máximo de movimentos aceito (ex.: `w*h` do labirinto)
+     * @return código do caminho, ou std::nullopt se o texto for inválido ou passar de `max_moves`
+     */
+    static std::optional<PathCode> fromText(Point start, const std::string& text, size_t max_moves = kMaxTextMoves) {
+        PathCode pc(start);
+        size_t i = 0, total = 0;
+        while (i < text.size()) {
+            const int d = dirFromChar(text[i++]);
+            if (d < 0) return std::nullopt;
+            size_t count = 0;
+            bool digits = false;
+            while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+                count = count * 10u + static_cast<size_t>(text[i++] - '0');
+                if (count > max_moves) return std::nullopt; // também evita estouro da contagem
+                digits = true;
+            }
+            if (!digits || count == 0) count = 1;
+            if (count > max_moves - total) return std::nullopt;
+            total += count;
+            for (size_t k = 0; k < count; ++k) pc.push(static_cast<uint8_t>(d));
+        }
+        return pc;
+    }
+
+    /** @brief Forma textual run-length (ex.: `"E3S2W"`); vazia se não houver movimentos. */
+    std::string toText() const {
+        std::string out;
+        for (const Run& r : runs()) {
+            out += dirChar(r.dir);
+            if (r.count > 1) out += std::to_string(r.count);
+        }
+        return out;
+    }
+
+    /** @brief Expande para a lista de células (inclui início e fim). */
+    std::vector<Point> toPoints() const {
+        std::vector<Point> out;
+        out.reserve(size());
+        for (Point p : *this) out.push_back(p);
+        return out;
+    }
+
+    /** @brief Remove todas as células (inclusive a inicial). */
+    void clear() { bits_.clear(); moves_ = 0; has_start_ = false; start_ = end_ = Point{}; }
+    /** @brief Reserva espaço para `moves` movimentos. */
+    void reserve(size_t moves) { bits_.reserve((moves + 3) / 4); }
+
+    /**
+     * @brief Acrescenta um movimento ao final do caminho.
+     * @param dir direção absoluta (0=N,1=E,2=S,3=W)
+     */
+    void push(uint8_t dir) {
+        dir &= 3u;
+        if ((moves_ & 3u) == 0) bits_.push_back(0);
+        bits_.back() |= static_cast<uint8_t>(dir << ((moves_ & 3u) * 2));
+        moves_++;
+        end_ = step(end_, dir);
+    }
+
+    /** @brief true se não há célula inicial. */
+    bool empty() const { return !has_start_; }
+    /** @brief Número de células (movimentos + 1), ou 0 se vazio. */
+    size_t size() const { return has_start_ ? moves_ + 1 : 0; }
+    /** @brief Número de movimentos. */
+    size_t moves() const { return moves_; }
+    /** @brief Célula inicial. */
+    Point start() const { return start_; }
+    /** @brief Última célula. */
+    Point back() const { return end_; }
+    /** @brief Movimento `i` (0=N,1=E,2=S,3=W). O(1). */
+    uint8_t move(size_t i) const { return (bits_[i >> 2] >> ((i & 3) * 2)) & 3u; }
+    /** @brief Bytes empacotados (4 movimentos por byte, LSB primeiro). */
+    const std::vector<uint8_t>& bytes() const { return bits_; }
+
+    /**
+     * @brief Índice da primeira ocorrência de `p` no caminho.
+     * @return índice da célula (0 = start) ou -1 se ausente
+     */
+    int find(Point p) const {
+        int i = 0;
+        for (Point q : *this) { if (q.x == p.x && q.y == p.y) return i; ++i; }
+        return -1;
+    }
+
+    bool operator==(const PathCode& o) const {
+        return has_start_ == o.has_start_ && moves_ == o.moves_ && bits_ == o.bits_ &&
+               start_.x == o.start_.x && start_.y == o.start_.y;
+    }
+    bool operator!=(const PathCode& o) const { return !(*this == o); }
+
+    /** @brief Iterador (somente leitura) sobre as células do caminho. */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Point;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Point*;
+        using reference = const Point&;
+        const_iterator(const PathCode* pc, size_t i, Point p) : pc_(pc), i_(i), p_(p) {}
+        reference operator*() const { return p_; }
+        pointer operator->() const { return &p_; }
+        const_iterator& operator++() {
+            if (i_ < pc_->moves_) p_ = step(p_, pc_->move(i_));
+            ++i_;
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator t = *this; ++*this; return t; }
+        bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+        bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+    private:
+        const PathCode* pc_;
+        size_t i_; ///< Índice da célula atual
+        Point p_;  ///< Célula atual
+    };
+    const_iterator begin() const { return const_iterator(this, 0, start_); }
+    const_iterator end() const { return const_iterator(this, size(), end_); }
+
+    /** @brief Visão run-length dos movimentos (trechos retos), sem alocação. */
+    class RunView {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Run;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Run*;
+            using reference = const Run&;
+            iterator(const PathCode* pc, size_t i) : pc_(pc), i_(i) { load(); }
+            reference operator*() const { return run_; }
+            pointer operator->() const { return &run_; }
+            iterator& operator++() { i_ += run_.count; load(); return *this; }
+            bool operator==(const iterator& o) const { return i_ == o.i_; }
+            bool operator!=(const iterator& o) const { return i_ != o.i_; }
+        private:
+            void load() {
+                run_ = Run{};
+                if (i_ >= pc_->moves_) return;
+                run_.dir = pc_->move(i_);
+                size_t j = i_;
+                while (j < pc_->moves_ && pc_->move(j) == run_.dir) ++j;
+                run_.count = static_cast<uint32_t>(j - i_);
+            }
+            const PathCode* pc_;
+            size_t i_; ///< Índice do primeiro movimento do trecho
+            Run run_;
+        };
+        explicit RunView(const PathCode* pc) : pc_(pc) {}
+        iterator begin() const { return iterator(pc_, 0); }
+        iterator end() const { return iterator(pc_, pc_->moves_); }
+    private:
+        const PathCode* pc_;
+    };
+    /** @brief Trechos retos do caminho (ex.: E×3, S×2, W×1). */
+    RunView runs() const { return RunView(this); }
+
+    /** @brief Letra da direção (0..3 → 'N','E','S','W'). */
+    static char dirChar(uint8_t d) { return to_char(from_heading(d)); }
+    /** @brief Direção de uma letra N/E/S/W; -1 se inválida. */
+    static int dirFromChar(char c) { return is_dir_char(c) ? static_cast<int>(from_char(c)) : -1; }
+    /** @brief Direção de `a` para o vizinho `b`; -1 se não forem vizinhos. */
+    static int dirBetween(Point a, Point b) {
+        for (uint8_t d = 0; d < 4; ++d) {
+            const Point n = maze::step(a, from_heading(d));
+            if (n.x == b.x && n.y == b.y) return d;
+        }
+        return -1;
+    }
+    /** @brief Célula vizinha de `p` na direção `d`. */
+    static Point step(Point p, uint8_t d) { return maze::step(p, from_heading(d)); }
+
+private:
+    Point start_{};              ///< Célula inicial
+    Point end_{};                ///< Última célula (mantida incrementalmente)
+    bool has_start_{false};      ///< false = caminho vazio
+    size_t moves_{0};            ///< Número de movimentos
+    std::vector<uint8_t> bits_;  ///< Movimentos empacotados, 2 bits cada
+};
+
+} // namespace maze
@@ -85,6 +85,11 @@ static constexpr uint32_t MAP_MAGIC = 0x4D5A4D50u; // 'MZMP'
 /** @brief Versão do snapshot de mapa. */
 static constexpr uint16_t MAP_VER   = 0x0001u;
 
+/**
+ * @brief Offset (no setor) da página do caminho: heurísticas na 1ª, mapa na 2ª.
+ */
+static constexpr uint32_t PATH_PAGE_OFFSET = 2u * PAGE_SIZE;
+
 /**
  * @brief Ponteiro base para o setor reservado na XIP flash.
  */
@@ -231,6 +236,190 @@ bool PersistentMemory::loadMapSnapshot(MazeMap* out) {
 #endif
 }
 
+// -----------------------------
+// Path record (host and pico)
+/**
+ * @brief Cabeçalho do registro de caminho (`PathCode`).
+ */
+struct PathHeader {
+    uint32_t magic;   ///< 'M','Z','P','T'
+    uint16_t version; ///< Versão do registro (0x0001)
+    uint16_t x;       ///< Coluna da célula inicial
+    uint16_t y;       ///< Linha da célula inicial
+    uint16_t moves;   ///< Número de movimentos (payload = (moves+3)/4 bytes)
+};
+/** @brief Magic para caminho ('M','Z','P','T'). */
+static constexpr uint32_t PATH_MAGIC = 0x4D5A5054u; // 'MZPT'
+/** @brief Versão do registro de caminho. */
+static constexpr uint16_t PATH_VER   = 0x0001u;
+
+/** @copydoc PersistentMemory::savePath */
+bool PersistentMemory::savePath(const PathCode& path) {
+    if (path.empty() || path.moves() > 0xFFFFu) return false;
+    PathHeader ph{PATH_MAGIC, PATH_VER, static_cast<uint16_t>(path.start().x), static_cast<uint16_t>(path.start().y),
+                  static_cast<uint16_t>(path.moves())};
+    const std::vector<uint8_t>& bytes = path.bytes();
+#ifdef PICO_BUILD
+    if (sizeof(PathHeader) + bytes.size() > PAGE_SIZE) {
+        std::printf("PMEM[PICO]: savePath too large (%u moves)\n", (unsigned)path.moves());
+        return false;
+    }
+    alignas(4) uint8_t page3[PAGE_SIZE];
+    std::memset(page3, 0xFF, sizeof(page3));
+    std::memcpy(page3, &ph, sizeof(ph));
+    std::memcpy(page3 + sizeof(ph), bytes.data(), bytes.size());
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_program(FLASH_TARGET_OFFSET + PATH_PAGE_OFFSET, page3, PAGE_SIZE);
+    restore_interrupts(ints);
+    std::printf("PMEM[PICO]: savePath ok (%u moves, %u bytes)\n", (unsigned)path.moves(), (unsigned)bytes.size());
+    return true;
+#else
+    const char* home = std::getenv("HOME");
+    if (!home) return false;
+    std::filesystem::path dir = std::filesystem::path(home) / ".rp2040_maze";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) return false;
+    std::filesystem::path file = dir / "path.bin";
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if (!ofs) return false;
+    ofs.write(reinterpret_cast<const char*>(&ph), sizeof(ph));
+    ofs.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    ofs.close();
+    std::printf("PMEM[HOST]: savePath ok -> %s (%u moves)\n", file.string().c_str(), (unsigned)path.moves());
+    return true;
+#endif
+}
+
+/** @copydoc PersistentMemory::loadPath */
+bool PersistentMemory::loadPath(PathCode* out) {
+    if (!out) return false;
+    PathHeader ph{};
+#ifdef PICO_BUILD
+    const uint8_t* base = flash_ptr() + PATH_PAGE_OFFSET;
+    std::memcpy(&ph, base, sizeof(ph));
+    if (!(ph.magic == PATH_MAGIC && ph.version == PATH_VER)) return false;
+    const size_t len = (static_cast<size_t>(ph.moves) + 3) / 4;
+    if (sizeof(PathHeader) + len > PAGE_SIZE) return false;
+    auto pc = PathCode::fromBytes(Point{ph.x, ph.y}, ph.moves, base + sizeof(PathHeader), len);
+#else
+    const char* home = std::getenv("HOME");
+    if (!home) return false;
+    std::filesystem::path file = std::filesystem::path(home) / ".rp2040_maze" / "path.bin";
+    std::ifstream ifs(file, std::ios::binary);
+    if (!ifs) return false;
+    ifs.read(reinterpret_cast<char*>(&ph), sizeof(ph));
+    if (!(ph.magic == PATH_MAGIC && ph.version == PATH_VER)) return false;
+    std::vector<uint8_t> bytes((static_cast<size_t>(ph.moves) + 3) / 4);
+    ifs.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (ifs.gcount() != static_cast<std::streamsize>(bytes.size())) return false;
+    auto pc = PathCode::fromBytes(Point{ph.x, ph.y}, ph.moves, bytes.data(), bytes.size());
+#endif
+    if (!pc) return false;
+    *out = *pc;
+    return true;
+}
+
+// -----------------------------
+// Edge cost record (host and pico)
+/**
+ * @brief Cabeçalho do registro de custos por aresta (`EdgeCostMap`).
+ */
+struct EdgeCostHeader {
+    uint32_t magic;   ///< 'M','Z','E','C'
+    uint16_t version; ///< Versão do registro (0x0001)
+    uint16_t w;       ///< Largura
+    uint16_t h;       ///< Altura
+    uint16_t size;    ///< Tamanho do payload em bytes (4*w*h médias `uint16_t`)
+};
+/** @brief Magic para custos por aresta ('M','Z','E','C'). */
+static constexpr uint32_t EDGE_MAGIC = 0x4D5A4543u; // 'MZEC'
+/** @brief Versão do registro de custos por aresta. */
+static constexpr uint16_t EDGE_VER   = 0x0001u;
+
+#ifdef PICO_BUILD
+/**
+ * @brief Offset (no setor) do registro de custos: da quarta página até o fim do setor.
+ */
+static constexpr uint32_t EDGE_PAGE_OFFSET = 3u * PAGE_SIZE;
+#endif
+
+/** @copydoc PersistentMemory::saveEdgeCosts */
+bool PersistentMemory::saveEdgeCosts(const EdgeCostMap& costs) {
+    const auto& ema = costs.raw();
+    const size_t payload = ema.size() * sizeof(uint16_t);
+    if (ema.empty() || payload > 0xFFFFu) return false;
+    EdgeCostHeader eh{EDGE_MAGIC, EDGE_VER, static_cast<uint16_t>(costs.width()), static_cast<uint16_t>(costs.height()),
+                      static_cast<uint16_t>(payload)};
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(ema.data());
+#ifdef PICO_BUILD
+    if (sizeof(EdgeCostHeader) + payload > SECTOR_SIZE - EDGE_PAGE_OFFSET) {
+        std::printf("PMEM[PICO]: saveEdgeCosts too large (%ux%u)\n", (unsigned)eh.w, (unsigned)eh.h);
+        return false;
+    }
+    // Uma página por vez: o registro inteiro não cabe com folga na pilha
+    const size_t total = sizeof(EdgeCostHeader) + payload;
+    alignas(4) uint8_t page[PAGE_SIZE];
+    for (size_t off = 0; off < total; off += PAGE_SIZE) {
+        std::memset(page, 0xFF, sizeof(page));
+        for (size_t i = 0; i < PAGE_SIZE && off + i < total; ++i) {
+            const size_t k = off + i;
+            page[i] = k < sizeof(EdgeCostHeader) ? reinterpret_cast<const uint8_t*>(&eh)[k] : bytes[k - sizeof(EdgeCostHeader)];
+        }
+        uint32_t ints = save_and_disable_interrupts();
+        flash_range_program(FLASH_TARGET_OFFSET + EDGE_PAGE_OFFSET + static_cast<uint32_t>(off), page, PAGE_SIZE);
+        restore_interrupts(ints);
+    }
+    std::printf("PMEM[PICO]: saveEdgeCosts ok (%ux%u, %u medidas)\n", (unsigned)eh.w, (unsigned)eh.h, (unsigned)costs.measured());
+    return true;
+#else
+    const char* home = std::getenv("HOME");
+    if (!home) return false;
+    std::filesystem::path dir = std::filesystem::path(home) / ".rp2040_maze";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) return false;
+    std::filesystem::path file = dir / "edge_costs.bin";
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if (!ofs) return false;
+    ofs.write(reinterpret_cast<const char*>(&eh), sizeof(eh));
+    ofs.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(payload));
+    ofs.close();
+    std::printf("PMEM[HOST]: saveEdgeCosts ok -> %s (%u medidas)\n", file.string().c_str(), (unsigned)costs.measured());
+    return true;
+#endif
+}
+
+/** @copydoc PersistentMemory::loadEdgeCosts */
+bool PersistentMemory::loadEdgeCosts(EdgeCostMap* out) {
+    if (!out) return false;
+    EdgeCostHeader eh{};
+#ifdef PICO_BUILD
+    const uint8_t* base = flash_ptr() + EDGE_PAGE_OFFSET;
+    std::memcpy(&eh, base, sizeof(eh));
+    if (!(eh.magic == EDGE_MAGIC && eh.version == EDGE_VER)) return false;
+    if (eh.w != out->width() || eh.h != out->height()) return false;
+    if (eh.size != static_cast<size_t>(eh.w) * eh.h * 4 * sizeof(uint16_t)) return false;
+    if (sizeof(EdgeCostHeader) + eh.size > SECTOR_SIZE - EDGE_PAGE_OFFSET) return false;
+    std::vector<uint16_t> ema(eh.size / sizeof(uint16_t));
+    std::memcpy(ema.data(), base + sizeof(EdgeCostHeader), eh.size);
+#else
+    const char* home = std::getenv("HOME");
+    if (!home) return false;
+    std::filesystem::path file = std::filesystem::path(home) / ".rp2040_maze" / "edge_costs.bin";
+    std::ifstream ifs(file, std::ios::binary);
+    if (!ifs) return false;
+    ifs.read(reinterpret_cast<char*>(&eh), sizeof(eh));
+    if (!(eh.magic == EDGE_MAGIC && eh.version == EDGE_VER)) return false;
+    if (eh.w != out->width() || eh.h != out->height()) return false;
+    if (eh.size != static_cast<size_t>(eh.w) * eh.h * 4 * sizeof(uint16_t)) return false;
+    std::vector<uint16_t> ema(eh.size / sizeof(uint16_t));
+    ifs.read(reinterpret_cast<char*>(ema.data()), static_cast<std::streamsize>(eh.size));
+    if (ifs.gcount() != static_cast<std::streamsize>(eh.size)) return false;
+#endif
+    return out->assignRaw(eh.w, eh.h, ema.data(), ema.size());
+}
+
 /**
  * @brief Verifica se há registro de heurísticas válido na flash (RP2040).
  */
@@ -258,9 +447,11 @@ bool PersistentMemory::eraseAll() {
     std::filesystem::path dir = std::filesystem::path(home) / ".rp2040_maze";
     std::filesystem::path file_h = dir / "heuristics.bin";
     std::filesystem::path file_m = dir / "map.bin";
-    std::error_code ec1, ec2;
+    std::error_code ec1, ec2, ec3, ec4;
     bool r1 = std::filesystem::remove(file_h, ec1);
     bool r2 = std::filesystem::remove(file_m, ec2);
+    std::filesystem::remove(dir / "path.bin", ec3);
+    std::filesystem::remove(dir / "edge_costs.bin", ec4);
     std::printf("PMEM[HOST]: eraseAll() heur=%s map=%s\n", (r1 && !ec1) ? "ok" : "noop", (r2 && !ec2) ? "ok" : "noop");
     return ((r1 && !ec1) || !std::filesystem::exists(file_h)) && ((r2 && !ec2) || !std::filesystem::exists(file_m));
 #endif
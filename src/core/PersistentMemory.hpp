@@ -4,8 +4,10 @@
  */
 #pragma once
 #include <cstdint>
+#include "EdgeCost.hpp"
 #include "Learning.hpp"
 #include "MazeMap.hpp"
+#include "PathCode.hpp"
 
 namespace maze {
 
@@ -69,6 +71,46 @@ public:
      * @return false se inexistente, dimensões divergentes ou erro de leitura
      */
     static bool loadMapSnapshot(MazeMap* out);
+
+    /**
+     * @brief Salva o melhor caminho conhecido (start + movimentos de 2 bits).
+     *
+     * Na plataforma RP2040 ocupa a terceira página do setor (até 976
+     * movimentos). Assim como o snapshot do mapa, deve ser gravado depois das
+     * heurísticas, que apagam o setor.
+     *
+     * @param path caminho a gravar
+     * @return false se o caminho estiver vazio ou não couber na página
+     */
+    static bool savePath(const PathCode& path);
+
+    /**
+     * @brief Carrega o caminho salvo por `savePath()`.
+     * @param out ponteiro de saída
+     * @return false se inexistente ou inválido
+     */
+    static bool loadPath(PathCode* out);
+
+    /**
+     * @brief Salva os tempos de travessia aprendidos por aresta (`EdgeCostMap::raw()`).
+     *
+     * Na plataforma RP2040 ocupa as páginas 4 a 16 do setor (até 1658
+     * médias, ou seja, grades de até 414 células). Como o mapa e o caminho,
+     * deve ser gravado depois das heurísticas, que apagam o setor.
+     *
+     * @param costs camada de custos a gravar
+     * @return false se vazia ou grande demais
+     */
+    static bool saveEdgeCosts(const EdgeCostMap& costs);
+
+    /**
+     * @brief Carrega os tempos salvos por `saveEdgeCosts()`.
+     *
+     * Requer que `out` tenha as mesmas dimensões salvas (ver `EdgeCostMap::resize`).
+     * @param out camada de custos de saída
+     * @return false se inexistente, dimensões divergentes ou erro de leitura
+     */
+    static bool loadEdgeCosts(EdgeCostMap* out);
 };
 
 } // namespace maze
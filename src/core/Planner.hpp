@@ -1,18 +1,461 @@
 #pragma once
 #include <vector>
 #include <algorithm>
-#include <queue>
 #include <optional>
+#include <memory_resource>
 #include <cstdint>
 #include "MazeMap.hpp"
+#include "JumpPointSearch.hpp"
+#include "CellIdx.hpp"
 
 /**
  * @file Planner.hpp
- * @brief Planejador de caminho em grade usando BFS sobre `MazeMap`.
+ * @brief Planejador de caminho em grade usando BFS (unidirecional e bidirecional), JPS e
+ *        Dijkstra com fila de baldes (Dial) para custos `uint8_t` sobre `MazeMap`.
  */
 
 namespace maze {
 
+/**
+ * @brief Estruturas temporárias de uma busca BFS com índices `IndexT` (ver `PlannerWorkspace`).
+ */
+template <typename IndexT>
+struct BfsScratch {
+    using Vec = std::pmr::vector<IndexT>;
+    explicit BfsScratch(std::pmr::memory_resource* mr)
+        : mr(mr), dist{Vec(mr), Vec(mr)}, prev{Vec(mr), Vec(mr)}, frontier{Vec(mr), Vec(mr)}, next(mr), visited(mr) {}
+
+    /** @brief Prepara para uma grade w×h; só aloca quando as dimensões mudam. */
+    void prepare(int w, int h) {
+        if (grid && grid->width() == w && grid->height() == h) return;
+        grid.emplace(w, h, mr);
+        const size_t n = grid->size();
+        for (int k = 0; k < 2; ++k) {
+            dist[k].reserve(n); prev[k].reserve(n); frontier[k].reserve(n);
+        }
+        next.reserve(n);
+        visited.reserve(n);
+    }
+
+    std::pmr::memory_resource* mr;   ///< Recurso das estruturas
+    std::optional<CellIdx<IndexT>> grid; ///< Índices/bordas da grade atual
+    Vec dist[2];                     ///< Distâncias (BFS bidirecional)
+    Vec prev[2];                     ///< Predecessores (lado start, lado goal)
+    Vec frontier[2];                 ///< Fronteiras (ou fila, no BFS unidirecional)
+    Vec next;                        ///< Próxima camada
+    std::pmr::vector<uint8_t> visited; ///< Visitados (BFS unidirecional)
+};
+
+/**
+ * @brief Estruturas temporárias do Dijkstra de Dial com índices `IndexT` (ver `Planner::dial_path_into`).
+ *
+ * Os baldes são listas duplamente encadeadas intrusivas (`link_next`/`link_prev`,
+ * uma entrada por célula), então a memória é fixa: `n·(4 + 3·sizeof(IndexT) + 1)`
+ * bytes mais 256 cabeças, sem nós alocados durante a busca.
+ */
+template <typename IndexT>
+struct DialScratch {
+    static constexpr int kBuckets = 256; ///< Custo máximo de aresta + 1 (fila circular)
+
+    explicit DialScratch(std::pmr::memory_resource* mr)
+        : mr(mr), dist(mr), prev(mr), link_next(mr), link_prev(mr), state(mr) {}
+
+    /** @brief Prepara para uma grade w×h; só aloca quando as dimensões mudam. */
+    void prepare(int w, int h) {
+        if (grid && grid->width() == w && grid->height() == h) return;
+        grid.emplace(w, h, mr);
+        const size_t n = grid->size();
+        dist.reserve(n); prev.reserve(n); link_next.reserve(n); link_prev.reserve(n); state.reserve(n);
+    }
+
+    std::pmr::memory_resource* mr;   ///< Recurso das estruturas
+    std::optional<CellIdx<IndexT>> grid; ///< Índices/bordas da grade atual
+    std::pmr::vector<uint32_t> dist; ///< Custo acumulado desde o start
+    std::pmr::vector<IndexT> prev;   ///< Predecessor no caminho de menor custo
+    std::pmr::vector<IndexT> link_next, link_prev; ///< Encadeamento do balde em que a célula está
+    std::pmr::vector<uint8_t> state; ///< 0 não vista, 1 num balde, 2 fechada
+    IndexT head[kBuckets];           ///< Primeira célula de cada balde (`dist % 256`)
+};
+
+/**
+ * @brief Estruturas reaproveitadas entre buscas de `Planner::*_path_into()`.
+ *
+ * Mantenha uma por chamador (ex.: `Navigator`): depois da primeira busca com
+ * as mesmas dimensões de mapa, replanejar não aloca memória.
+ */
+class PlannerWorkspace {
+public:
+    /** @param mr recurso de memória das estruturas */
+    explicit PlannerWorkspace(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : s16_(mr), s32_(mr), d16_(mr), d32_(mr) {}
+
+    /** @brief Estruturas de largura `IndexT` preparadas para `map`. */
+    template <typename IndexT>
+    BfsScratch<IndexT>& scratch(const MazeMap& map) {
+        BfsScratch<IndexT>& sc = select(static_cast<IndexT*>(nullptr));
+        sc.prepare(map.width(), map.height());
+        return sc;
+    }
+
+    /** @brief Estruturas do Dijkstra de Dial de largura `IndexT` preparadas para `map` (alocadas só no primeiro uso). */
+    template <typename IndexT>
+    DialScratch<IndexT>& dial(const MazeMap& map) {
+        DialScratch<IndexT>& sc = selectDial(static_cast<IndexT*>(nullptr));
+        sc.prepare(map.width(), map.height());
+        return sc;
+    }
+
+private:
+    BfsScratch<uint16_t>& select(uint16_t*) { return s16_; }
+    BfsScratch<uint32_t>& select(uint32_t*) { return s32_; }
+    DialScratch<uint16_t>& selectDial(uint16_t*) { return d16_; }
+    DialScratch<uint32_t>& selectDial(uint32_t*) { return d32_; }
+
+    BfsScratch<uint16_t> s16_; ///< Grades até 65534 células
+    BfsScratch<uint32_t> s32_; ///< Grades maiores
+    DialScratch<uint16_t> d16_;
+    DialScratch<uint32_t> d32_;
+};
+
+/**
+ * @brief BFS bidirecional retomável sobre um `BfsScratch` (o mesmo de `Planner::bibfs_path_into`).
+ *
+ * `run(budget)` executa no máximo `budget` unidades e devolve quantas usou:
+ * iniciar um bloco de `kInitChunk` células, expandir uma célula (até 4
+ * vizinhos) ou escrever uma célula do caminho. `bibfs_path_into()` roda até o
+ * fim numa chamada; o `AnytimePlanner` roda em fatias e obtém exatamente o
+ * mesmo caminho, com os mesmos desempates.
+ */
+template <typename IndexT>
+class BibfsSearch {
+public:
+    static constexpr uint32_t kInitChunk = 32; ///< Células iniciadas por unidade de trabalho
+
+    /**
+     * @brief Prepara a busca; `out` recebe o caminho e precisa continuar vivo até `done()`.
+     *
+     * O(1) (o `sc` já preparado para as dimensões de `map`); a primeira busca
+     * numa grade nova dimensiona os vetores de uma vez.
+     */
+    void begin(const MazeMap& map, Point start, Point goal, BfsScratch<IndexT>& sc,
+               const std::vector<uint8_t>* skip, std::pmr::vector<Point>& out) {
+        map_ = &map; sc_ = &sc; skip_ = skip; out_ = &out;
+        out.clear();
+        expanded_ = 0;
+        found_ = false;
+        stage_ = Stage::Done;
+        if (!map.in_bounds(start.x, start.y) || !map.in_bounds(goal.x, goal.y)) return;
+        const size_t n = sc.grid->size();
+        s_ = sc.grid->index(start);
+        g_ = sc.grid->index(goal);
+        use_skip_ = skip && skip->size() == n;
+        if (use_skip_ && (*skip)[g_]) return;
+        if (s_ == g_) { out.push_back(start); found_ = true; return; }
+        for (int k = 0; k < 2; ++k) {
+            sc.dist[k].resize(n);
+            sc.prev[k].resize(n);
+            sc.frontier[k].clear();
+        }
+        sc.next.clear();
+        pos_ = 0;
+        stage_ = Stage::Init;
+    }
+
+    /** @brief Avança no máximo `budget` unidades; devolve as usadas. */
+    uint32_t run(uint32_t budget) {
+        uint32_t used = 0;
+        while (stage_ != Stage::Done && used < budget) {
+            used++;
+            switch (stage_) {
+                case Stage::Init:   init_unit(); break;
+                case Stage::Search: search_unit(); break;
+                case Stage::Write:  write_unit(); break;
+                case Stage::Done:   break;
+            }
+        }
+        return used;
+    }
+
+    bool done() const { return stage_ == Stage::Done; }
+    /** @brief Depois de `done()`: true se há caminho (escrito em `out`). */
+    bool found() const { return found_; }
+    int expanded() const { return expanded_; }
+    /** @brief true se a célula `i` já foi alcançada por algum lado (só ela pode ter lido paredes). */
+    bool reached(uint32_t i) const {
+        if (stage_ == Stage::Init) return false;
+        if (stage_ == Stage::Done) return true; // sem estado para conferir
+        return sc_->dist[0][i] != kNone || sc_->dist[1][i] != kNone;
+    }
+
+private:
+    static constexpr IndexT kNone = CellIdx<IndexT>::kNone;
+    enum class Stage : uint8_t { Init, Search, Write, Done };
+
+    void init_unit() {
+        BfsScratch<IndexT>& sc = *sc_;
+        const size_t n = sc.grid->size();
+        const size_t end = std::min(n, pos_ + kInitChunk);
+        for (int k = 0; k < 2; ++k) {
+            std::fill(sc.dist[k].begin() + pos_, sc.dist[k].begin() + end, kNone);
+            std::fill(sc.prev[k].begin() + pos_, sc.prev[k].begin() + end, kNone);
+        }
+        pos_ = end;
+        if (pos_ < n) return;
+        // Índice 0: busca a partir do start; 1: a partir do goal. dist < n cabe em IndexT.
+        sc.frontier[0].push_back(s_);
+        sc.frontier[1].push_back(g_);
+        sc.dist[0][s_] = 0;
+        sc.dist[1][g_] = 0;
+        best_ = -1;
+        meet_a_ = meet_b_ = kNone; // aresta de encontro (lado start, lado goal)
+        next_layer();
+    }
+
+    /** @brief Escolhe o lado da próxima camada (sempre a menor fronteira) ou termina sem caminho. */
+    void next_layer() {
+        BfsScratch<IndexT>& sc = *sc_;
+        if (sc.frontier[0].empty() || sc.frontier[1].empty()) { stage_ = Stage::Done; return; }
+        side_ = sc.frontier[0].size() <= sc.frontier[1].size() ? 0 : 1;
+        sc.next.clear();
+        pos_ = 0;
+        stage_ = Stage::Search;
+    }
+
+    void search_unit() {
+        BfsScratch<IndexT>& sc = *sc_;
+        auto& frontier = sc.frontier[side_];
+        if (pos_ == frontier.size()) {
+            if (best_ >= 0) { begin_write(); return; } // camada completa: o melhor encontro desta camada é ótimo
+            frontier.swap(sc.next);
+            next_layer();
+            return;
+        }
+        const CellIdx<IndexT>& grid = *sc.grid;
+        const int side = side_, other = 1 - side_;
+        const IndexT i = frontier[pos_++];
+        expanded_++;
+        const uint8_t border = grid.border(i);
+        const uint8_t walls = CellIdx<IndexT>::wallBits(map_->at_index(i));
+        for (int d = 0; d < 4; ++d) {
+            if (!(border & (1u << d))) continue;
+            const IndexT j = grid.neighbor(i, d);
+            // Lado do goal anda ao contrário: testa a parede do vizinho voltada para `i`
+            const bool open = side == 0 ? !(walls & (1u << d))
+                                        : !(CellIdx<IndexT>::wallBits(map_->at_index(j)) & (1u << ((d + 2) & 3)));
+            if (!open) continue;
+            if (use_skip_ && (*skip_)[j] && j != s_) continue;
+            if (sc.dist[other][j] != kNone) {
+                const long len = static_cast<long>(sc.dist[side][i]) + 1 + sc.dist[other][j];
+                if (best_ < 0 || len < best_) {
+                    best_ = len;
+                    meet_a_ = side == 0 ? i : j;
+                    meet_b_ = side == 0 ? j : i;
+                }
+            }
+            if (sc.dist[side][j] != kNone) continue;
+            sc.dist[side][j] = static_cast<IndexT>(sc.dist[side][i] + 1);
+            sc.prev[side][j] = i;
+            sc.next.push_back(j);
+        }
+    }
+
+    /** @brief start..meet_a escrito de trás para frente a partir de dist[0][meet_a]; meet_b..goal em seguida. */
+    void begin_write() {
+        out_->resize(static_cast<size_t>(best_) + 1);
+        cur_ = meet_a_;
+        k_ = sc_->dist[0][meet_a_];
+        seg_ = 0;
+        stage_ = Stage::Write;
+    }
+
+    void write_unit() {
+        BfsScratch<IndexT>& sc = *sc_;
+        (*out_)[k_] = sc.grid->point(cur_);
+        cur_ = sc.prev[seg_][cur_];
+        if (seg_ == 0) {
+            if (cur_ != kNone) { k_--; return; }
+            seg_ = 1;
+            cur_ = meet_b_;
+            k_ = static_cast<size_t>(sc.dist[0][meet_a_]) + 1;
+            return;
+        }
+        k_++;
+        if (cur_ == kNone) { found_ = true; stage_ = Stage::Done; }
+    }
+
+    const MazeMap* map_{nullptr};
+    BfsScratch<IndexT>* sc_{nullptr};
+    const std::vector<uint8_t>* skip_{nullptr};
+    std::pmr::vector<Point>* out_{nullptr};
+    bool use_skip_{false}, found_{false};
+    Stage stage_{Stage::Done};
+    IndexT s_{0}, g_{0}, meet_a_{kNone}, meet_b_{kNone}, cur_{kNone};
+    int side_{0}, seg_{0}, expanded_{0};
+    long best_{-1};
+    size_t pos_{0}, k_{0};
+};
+
+/**
+ * @brief Dijkstra de Dial retomável sobre um `DialScratch` (o mesmo de `Planner::dial_path_into`).
+ *
+ * Unidades como em `BibfsSearch`: iniciar um bloco de células, fechar uma
+ * célula (varrendo no máximo 255 baldes vazios), medir ou escrever uma célula
+ * do caminho. `cost` precisa continuar vivo até `done()`.
+ */
+template <typename IndexT, class CostFn>
+class DialSearch {
+public:
+    static constexpr uint32_t kInitChunk = 32; ///< Células iniciadas por unidade de trabalho
+
+    /** @brief Prepara a busca em O(1) (ver `BibfsSearch::begin`). */
+    void begin(const MazeMap& map, Point start, Point goal, DialScratch<IndexT>& sc, CostFn& cost,
+               const std::vector<uint8_t>* skip, std::pmr::vector<Point>& out) {
+        map_ = &map; sc_ = &sc; cost_ = &cost; skip_ = skip; out_ = &out;
+        out.clear();
+        expanded_ = 0;
+        found_ = false;
+        stage_ = Stage::Done;
+        if (!map.in_bounds(start.x, start.y) || !map.in_bounds(goal.x, goal.y)) return;
+        const size_t n = sc.grid->size();
+        s_ = sc.grid->index(start);
+        g_ = sc.grid->index(goal);
+        use_skip_ = skip && skip->size() == n;
+        if (use_skip_ && (*skip)[g_]) return;
+        sc.dist.resize(n);
+        sc.prev.resize(n);
+        sc.link_next.resize(n);
+        sc.link_prev.resize(n);
+        sc.state.resize(n);
+        for (IndexT& h : sc.head) h = kNone;
+        pos_ = 0;
+        stage_ = Stage::Init;
+    }
+
+    /** @brief Avança no máximo `budget` unidades; devolve as usadas. */
+    uint32_t run(uint32_t budget) {
+        uint32_t used = 0;
+        while (stage_ != Stage::Done && used < budget) {
+            used++;
+            switch (stage_) {
+                case Stage::Init:    init_unit(); break;
+                case Stage::Search:  search_unit(); break;
+                case Stage::Measure: measure_unit(); break;
+                case Stage::Write:   write_unit(); break;
+                case Stage::Done:    break;
+            }
+        }
+        return used;
+    }
+
+    bool done() const { return stage_ == Stage::Done; }
+    /** @brief Depois de `done()`: true se há caminho (escrito em `out`). */
+    bool found() const { return found_; }
+    int expanded() const { return expanded_; }
+    /** @brief Custo do caminho encontrado. */
+    uint32_t cost() const { return found_ ? sc_->dist[g_] : 0; }
+    /** @brief true se a célula `i` já recebeu custo (só ela pode ter lido paredes). */
+    bool reached(uint32_t i) const {
+        if (stage_ == Stage::Init) return false;
+        if (stage_ == Stage::Done) return true;
+        return sc_->dist[i] != UINT32_MAX;
+    }
+
+private:
+    static constexpr IndexT kNone = CellIdx<IndexT>::kNone;
+    static constexpr uint32_t kMask = DialScratch<IndexT>::kBuckets - 1;
+    enum class Stage : uint8_t { Init, Search, Measure, Write, Done };
+
+    void push(IndexT i) {
+        DialScratch<IndexT>& sc = *sc_;
+        IndexT& h = sc.head[sc.dist[i] & kMask];
+        sc.link_next[i] = h; sc.link_prev[i] = kNone;
+        if (h != kNone) sc.link_prev[h] = i;
+        h = i;
+        sc.state[i] = 1;
+    }
+    void unlink(IndexT i) {
+        DialScratch<IndexT>& sc = *sc_;
+        if (sc.link_prev[i] != kNone) sc.link_next[sc.link_prev[i]] = sc.link_next[i];
+        else sc.head[sc.dist[i] & kMask] = sc.link_next[i];
+        if (sc.link_next[i] != kNone) sc.link_prev[sc.link_next[i]] = sc.link_prev[i];
+    }
+
+    void init_unit() {
+        DialScratch<IndexT>& sc = *sc_;
+        const size_t n = sc.grid->size();
+        const size_t end = std::min(n, pos_ + kInitChunk);
+        std::fill(sc.dist.begin() + pos_, sc.dist.begin() + end, UINT32_MAX);
+        std::fill(sc.prev.begin() + pos_, sc.prev.begin() + end, kNone);
+        std::fill(sc.state.begin() + pos_, sc.state.begin() + end, 0);
+        pos_ = end;
+        if (pos_ < n) return;
+        sc.dist[s_] = 0;
+        push(s_);
+        queued_ = 1;
+        d_ = 0; // custo do balde atual
+        stage_ = Stage::Search;
+    }
+
+    void search_unit() {
+        DialScratch<IndexT>& sc = *sc_;
+        if (queued_ == 0) { stage_ = Stage::Done; return; }
+        while (sc.head[d_ & kMask] == kNone) d_++; // no máximo 255 baldes vazios seguidos
+        const IndexT i = sc.head[d_ & kMask];
+        unlink(i);
+        queued_--;
+        sc.state[i] = 2;
+        if (i == g_) {
+            len_ = 1;
+            cur_ = g_;
+            stage_ = Stage::Measure;
+            return;
+        }
+        expanded_++;
+        const CellIdx<IndexT>& grid = *sc.grid;
+        const uint8_t open = grid.openMask(*map_, i);
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!(open & (1u << dir))) continue;
+            const IndexT j = grid.neighbor(i, dir);
+            if (sc.state[j] == 2 || (use_skip_ && (*skip_)[j])) continue;
+            const uint8_t c = (*cost_)(static_cast<size_t>(i), dir);
+            if (c == 0) continue;
+            const uint32_t nd = d_ + c;
+            if (nd >= sc.dist[j]) continue;
+            if (sc.state[j] == 1) unlink(j);
+            else queued_++;
+            sc.dist[j] = nd;
+            sc.prev[j] = i;
+            push(j);
+        }
+    }
+
+    /** @brief Conta o comprimento; depois o caminho é escrito do goal ao start já na posição final. */
+    void measure_unit() {
+        if (cur_ != s_) { cur_ = sc_->prev[cur_]; len_++; return; }
+        out_->resize(len_);
+        cur_ = g_;
+        stage_ = Stage::Write;
+    }
+
+    void write_unit() {
+        (*out_)[--len_] = sc_->grid->point(cur_);
+        if (cur_ == s_) { found_ = true; stage_ = Stage::Done; return; }
+        cur_ = sc_->prev[cur_];
+    }
+
+    const MazeMap* map_{nullptr};
+    DialScratch<IndexT>* sc_{nullptr};
+    CostFn* cost_{nullptr};
+    const std::vector<uint8_t>* skip_{nullptr};
+    std::pmr::vector<Point>* out_{nullptr};
+    bool use_skip_{false}, found_{false};
+    Stage stage_{Stage::Done};
+    IndexT s_{0}, g_{0}, cur_{kNone};
+    int expanded_{0};
+    size_t pos_{0}, queued_{0}, len_{0};
+    uint32_t d_{0};
+};
+
 /**
  * @brief Planejador simples baseado em BFS (largura) no grafo implícito do labirinto.
  */
@@ -24,48 +467,263 @@ public:
      * @param map  referência ao mapa do labirinto
      * @param start célula inicial
      * @param goal  célula objetivo
+     * @param skip  máscara opcional (w*h bytes, 1 = ignorar célula), ex.: células podadas por `fill_dead_ends()`
+     * @param expansions saída opcional: número de células expandidas (para benchmarks)
+     * @param mr recurso de memória das estruturas temporárias da busca (ex.: `EpisodeArena`)
      * @return sequência de pontos incluindo início e objetivo, ou std::nullopt se inalcançável
      */
-    static std::optional<std::vector<Point>> bfs_path(const MazeMap& map, Point start, Point goal) {
-        const int w = map.width();
-        const int h = map.height();
-        if (!map.in_bounds(start.x, start.y) || !map.in_bounds(goal.x, goal.y)) return std::nullopt;
-        std::vector<int> prev(w*h, -1);
-        std::vector<uint8_t> visited(w*h, 0);
-        auto idx = [&](int x,int y){ return y*w + x; };
-        std::queue<Point> q;
-        q.push(start);
-        visited[idx(start.x,start.y)] = 1;
-
-        while(!q.empty()){
-            Point p = q.front(); q.pop();
-            if (p.x==goal.x && p.y==goal.y) break;
-            const Cell& c = map.at(p.x,p.y);
-            // N
-            if (!c.wall_n && map.in_bounds(p.x, p.y-1)) {
-                int j = idx(p.x, p.y-1); if(!visited[j]){ visited[j]=1; prev[j]=idx(p.x,p.y); q.push({p.x,p.y-1}); }
-            }
-            // E
-            if (!c.wall_e && map.in_bounds(p.x+1, p.y)) {
-                int j = idx(p.x+1, p.y); if(!visited[j]){ visited[j]=1; prev[j]=idx(p.x,p.y); q.push({p.x+1,p.y}); }
-            }
-            // S
-            if (!c.wall_s && map.in_bounds(p.x, p.y+1)) {
-                int j = idx(p.x, p.y+1); if(!visited[j]){ visited[j]=1; prev[j]=idx(p.x,p.y); q.push({p.x,p.y+1}); }
-            }
-            // W
-            if (!c.wall_w && map.in_bounds(p.x-1, p.y)) {
-                int j = idx(p.x-1, p.y); if(!visited[j]){ visited[j]=1; prev[j]=idx(p.x,p.y); q.push({p.x-1,p.y}); }
+    static std::optional<std::vector<Point>> bfs_path(const MazeMap& map, Point start, Point goal,
+                                                      const std::vector<uint8_t>* skip = nullptr,
+                                                      int* expansions = nullptr,
+                                                      std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        if (CellIdx<uint16_t>::fits(map.width(), map.height())) return bfs_search<uint16_t>(map, start, goal, skip, expansions, mr);
+        return bfs_search<uint32_t>(map, start, goal, skip, expansions, mr);
+    }
+
+    /**
+     * @brief Encontra um caminho mínimo do início ao objetivo com BFS bidirecional.
+     *
+     * Mesma interface e mesmo comprimento de caminho de `bfs_path()`. Duas
+     * fronteiras crescem alternadamente, uma camada inteira por vez, sempre
+     * expandindo a menor. Ao terminar a primeira camada em que as buscas se
+     * tocam, escolhe a aresta de encontro com menor `dist_start + 1 + dist_goal`
+     * (parar no primeiro toque pode devolver um caminho mais longo). Em grades
+     * abertas ou com laços expande bem menos células que o BFS unidirecional,
+     * que percorre quase todo o mapa antes de alcançar o objetivo.
+     *
+     * A busca a partir do objetivo percorre as arestas ao contrário (testa a
+     * parede do vizinho voltada para a célula atual), então o resultado é igual
+     * ao de `bfs_path()` mesmo se as paredes não forem simétricas.
+     *
+     * @param map  referência ao mapa do labirinto
+     * @param start célula inicial
+     * @param goal  célula objetivo
+     * @param skip  máscara opcional (w*h bytes, 1 = ignorar célula)
+     * @param expansions saída opcional: número de células expandidas pelas duas buscas
+     * @param mr recurso de memória das estruturas temporárias da busca
+     * @return sequência de pontos incluindo início e objetivo, ou std::nullopt se inalcançável
+     */
+    static std::optional<std::vector<Point>> bibfs_path(const MazeMap& map, Point start, Point goal,
+                                                        const std::vector<uint8_t>* skip = nullptr,
+                                                        int* expansions = nullptr,
+                                                        std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        if (CellIdx<uint16_t>::fits(map.width(), map.height())) return bibfs_search<uint16_t>(map, start, goal, skip, expansions, mr);
+        return bibfs_search<uint32_t>(map, start, goal, skip, expansions, mr);
+    }
+
+    /**
+     * @brief Como `bfs_path()`, escrevendo o caminho em `out` e reaproveitando `ws`.
+     *
+     * Depois da primeira chamada com as mesmas dimensões de mapa não aloca:
+     * as estruturas da busca ficam em `ws` e `out` reaproveita a capacidade
+     * (o caminho é escrito de trás para frente na posição final, sem `reverse`).
+     *
+     * @param out recebe o caminho (início..objetivo); vazio se inalcançável
+     * @param ws estruturas temporárias reaproveitadas entre chamadas
+     * @return true se há caminho
+     */
+    static bool bfs_path_into(const MazeMap& map, Point start, Point goal, std::pmr::vector<Point>& out,
+                              PlannerWorkspace& ws, const std::vector<uint8_t>* skip = nullptr,
+                              int* expansions = nullptr) {
+        if (CellIdx<uint16_t>::fits(map.width(), map.height()))
+            return bfs_run<uint16_t>(map, start, goal, out, ws.scratch<uint16_t>(map), skip, expansions);
+        return bfs_run<uint32_t>(map, start, goal, out, ws.scratch<uint32_t>(map), skip, expansions);
+    }
+
+    /**
+     * @brief Como `bibfs_path()`, escrevendo o caminho em `out` e reaproveitando `ws` (ver `bfs_path_into()`).
+     * @return true se há caminho
+     */
+    static bool bibfs_path_into(const MazeMap& map, Point start, Point goal, std::pmr::vector<Point>& out,
+                                PlannerWorkspace& ws, const std::vector<uint8_t>* skip = nullptr,
+                                int* expansions = nullptr) {
+        if (CellIdx<uint16_t>::fits(map.width(), map.height()))
+            return bibfs_run<uint16_t>(map, start, goal, out, ws.scratch<uint16_t>(map), skip, expansions);
+        return bibfs_run<uint32_t>(map, start, goal, out, ws.scratch<uint32_t>(map), skip, expansions);
+    }
+
+    /**
+     * @brief Implementação de `bfs_path()` com índices de largura `IndexT` (`uint16_t` ou `uint32_t`).
+     *
+     * Fila e `prev` guardam `IndexT`; vizinhos vêm de `CellIdx` (offset + máscara
+     * de borda), sem recalcular `y*w + x` no laço interno. `bfs_path()` escolhe
+     * `uint16_t` quando a grade cabe.
+     */
+    template <typename IndexT>
+    static std::optional<std::vector<Point>> bfs_search(const MazeMap& map, Point start, Point goal,
+                                                        const std::vector<uint8_t>* skip = nullptr,
+                                                        int* expansions = nullptr,
+                                                        std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        PlannerWorkspace ws(mr);
+        std::pmr::vector<Point> out(mr);
+        if (!bfs_run<IndexT>(map, start, goal, out, ws.scratch<IndexT>(map), skip, expansions)) return std::nullopt;
+        return std::vector<Point>(out.begin(), out.end());
+    }
+
+    /**
+     * @brief Implementação de `bibfs_path()` com índices de largura `IndexT` (ver `bfs_search()`).
+     */
+    template <typename IndexT>
+    static std::optional<std::vector<Point>> bibfs_search(const MazeMap& map, Point start, Point goal,
+                                                          const std::vector<uint8_t>* skip = nullptr,
+                                                          int* expansions = nullptr,
+                                                          std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        PlannerWorkspace ws(mr);
+        std::pmr::vector<Point> out(mr);
+        if (!bibfs_run<IndexT>(map, start, goal, out, ws.scratch<IndexT>(map), skip, expansions)) return std::nullopt;
+        return std::vector<Point>(out.begin(), out.end());
+    }
+
+    /**
+     * @brief Encontra um caminho mínimo com Jump Point Search 4-conexo (ver `JumpPointSearch`).
+     *
+     * Mesmo comprimento de `bfs_path()`; indicado para arenas abertas com
+     * poucas paredes. Constrói as máscaras do mapa a cada chamada: para várias
+     * consultas no mesmo mapa, mantenha um `JumpPointSearch`.
+     *
+     * @param map  referência ao mapa do labirinto
+     * @param start célula inicial
+     * @param goal  célula objetivo
+     * @param skip  máscara opcional (w*h bytes, 1 = ignorar célula)
+     * @param expansions saída opcional: número de pontos de salto expandidos
+     * @return sequência de pontos incluindo início e objetivo, ou std::nullopt se inalcançável
+     */
+    static std::optional<std::vector<Point>> jps_path(const MazeMap& map, Point start, Point goal,
+                                                      const std::vector<uint8_t>* skip = nullptr,
+                                                      int* expansions = nullptr) {
+        return JumpPointSearch(map, skip).find(start, goal, expansions);
+    }
+
+    /**
+     * @brief Caminho de menor custo com arestas de custo `uint8_t` (Dijkstra com fila de baldes de Dial).
+     *
+     * `cost(cell, dir)` devolve o custo de sair da célula de índice linear
+     * `cell` (`y*w + x`) para o vizinho na direção `dir` (0=N,1=E,2=S,3=W),
+     * entre 1 e 255; 0 torna a aresta intransponível, como uma parede. Os
+     * custos são por aresta dirigida (ida e volta podem diferir).
+     *
+     * Como o custo de uma aresta é no máximo 255, todas as células abertas têm
+     * custo em `[D, D+255]`, onde D é o custo da última fechada: 256 baldes
+     * circulares (um por `dist % 256`) bastam, e cada inserção, remoção ou
+     * redução de custo é O(1). Fechar uma célula custa no máximo 256 passos
+     * de varredura de baldes vazios, então a busca é O(n + custo do caminho),
+     * perto do BFS; com custo 1 em todas as arestas devolve caminhos do mesmo
+     * comprimento do `bfs_path()`.
+     *
+     * Memória fixa no `ws` (ver `DialScratch`), sem alocação depois da primeira
+     * chamada com as mesmas dimensões: serve ao RP2040 com o `PlannerWorkspace`
+     * do `Navigator` ou sobre uma arena.
+     *
+     * @param out recebe o caminho (início..objetivo); vazio se inalcançável
+     * @param ws estruturas temporárias reaproveitadas entre chamadas
+     * @param cost functor `uint8_t(size_t cell, int dir)`
+     * @param skip máscara opcional (w*h bytes, 1 = ignorar célula)
+     * @param expansions saída opcional: número de células fechadas
+     * @param total_cost saída opcional: custo do caminho encontrado
+     * @return true se há caminho
+     */
+    template <class CostFn>
+    static bool dial_path_into(const MazeMap& map, Point start, Point goal, std::pmr::vector<Point>& out,
+                               PlannerWorkspace& ws, CostFn&& cost, const std::vector<uint8_t>* skip = nullptr,
+                               int* expansions = nullptr, uint32_t* total_cost = nullptr) {
+        if (CellIdx<uint16_t>::fits(map.width(), map.height()))
+            return dial_run<uint16_t>(map, start, goal, out, ws.dial<uint16_t>(map), cost, skip, expansions, total_cost);
+        return dial_run<uint32_t>(map, start, goal, out, ws.dial<uint32_t>(map), cost, skip, expansions, total_cost);
+    }
+
+    /**
+     * @brief Como `dial_path_into()` com custos numa tabela: `edge_cost[4*cell + dir]`.
+     * @param edge_cost 4·w·h custos (0 = intransponível); tamanho diferente equivale a custo 1 em tudo
+     * @return sequência de pontos incluindo início e objetivo, ou std::nullopt se inalcançável
+     */
+    static std::optional<std::vector<Point>> dial_path(const MazeMap& map, Point start, Point goal,
+                                                       const std::vector<uint8_t>& edge_cost,
+                                                       const std::vector<uint8_t>* skip = nullptr,
+                                                       int* expansions = nullptr, uint32_t* total_cost = nullptr,
+                                                       std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        PlannerWorkspace ws(mr);
+        std::pmr::vector<Point> out(mr);
+        const bool table = edge_cost.size() == static_cast<size_t>(map.width()) * map.height() * 4;
+        auto cost = [&](size_t cell, int dir) -> uint8_t { return table ? edge_cost[cell * 4 + static_cast<size_t>(dir)] : 1; };
+        if (!dial_path_into(map, start, goal, out, ws, cost, skip, expansions, total_cost)) return std::nullopt;
+        return std::vector<Point>(out.begin(), out.end());
+    }
+
+private:
+    /** @brief BFS unidirecional sobre as estruturas de `sc`; caminho escrito em `out`. */
+    template <typename IndexT>
+    static bool bfs_run(const MazeMap& map, Point start, Point goal, std::pmr::vector<Point>& out,
+                        BfsScratch<IndexT>& sc, const std::vector<uint8_t>* skip, int* expansions) {
+        out.clear();
+        if (expansions) *expansions = 0;
+        if (!map.in_bounds(start.x, start.y) || !map.in_bounds(goal.x, goal.y)) return false;
+        const CellIdx<IndexT>& grid = *sc.grid;
+        const size_t n = grid.size();
+        auto& prev = sc.prev[0];
+        auto& visited = sc.visited;
+        prev.assign(n, CellIdx<IndexT>::kNone);
+        if (skip && skip->size() == n) visited.assign(skip->begin(), skip->end()); // células ignoradas contam como visitadas
+        else visited.assign(n, 0);
+        const IndexT s = grid.index(start);
+        const IndexT g = grid.index(goal);
+        if (visited[g]) return false;
+        auto& queue = sc.frontier[0];
+        queue.clear();
+        queue.push_back(s);
+        visited[s] = 1;
+        int expanded = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const IndexT i = queue[head];
+            if (i == g) break;
+            expanded++;
+            const uint8_t open = grid.openMask(map, i);
+            for (int d = 0; d < 4; ++d) {
+                if (!(open & (1u << d))) continue;
+                const IndexT j = grid.neighbor(i, d);
+                if (visited[j]) continue;
+                visited[j] = 1;
+                prev[j] = i;
+                queue.push_back(j);
             }
         }
-        if (!visited[idx(goal.x,goal.y)]) return std::nullopt;
-        std::vector<Point> path;
-        for (int cur = idx(goal.x,goal.y); cur!=-1; cur = prev[cur]) {
-            int x = cur % w; int y = cur / w; path.push_back({x,y});
-            if (cur == idx(start.x,start.y)) break;
+        if (expansions) *expansions = expanded;
+        if (!visited[g]) return false;
+        // Conta o comprimento e escreve do goal ao start já na posição final
+        size_t len = 1;
+        for (IndexT cur = g; cur != s; cur = prev[cur]) len++;
+        out.resize(len);
+        size_t k = len;
+        for (IndexT cur = g; ; cur = prev[cur]) {
+            out[--k] = grid.point(cur);
+            if (cur == s) break;
         }
-        std::reverse(path.begin(), path.end()); // reconstrói do goal ao start
-        return path;
+        return true;
+    }
+
+    /** @brief Dijkstra de Dial sobre as estruturas de `sc`; caminho escrito em `out` (ver `DialSearch`). */
+    template <typename IndexT, class CostFn>
+    static bool dial_run(const MazeMap& map, Point start, Point goal, std::pmr::vector<Point>& out,
+                         DialScratch<IndexT>& sc, CostFn& cost, const std::vector<uint8_t>* skip,
+                         int* expansions, uint32_t* total_cost) {
+        DialSearch<IndexT, CostFn> search;
+        search.begin(map, start, goal, sc, cost, skip, out);
+        search.run(UINT32_MAX);
+        if (expansions) *expansions = search.expanded();
+        if (!search.found()) { out.clear(); return false; }
+        if (total_cost) *total_cost = search.cost();
+        return true;
+    }
+
+    /** @brief BFS bidirecional sobre as estruturas de `sc`; caminho escrito em `out` (ver `BibfsSearch`). */
+    template <typename IndexT>
+    static bool bibfs_run(const MazeMap& map, Point start, Point goal, std::pmr::vector<Point>& out,
+                          BfsScratch<IndexT>& sc, const std::vector<uint8_t>* skip, int* expansions) {
+        BibfsSearch<IndexT> search;
+        search.begin(map, start, goal, sc, skip, out);
+        search.run(UINT32_MAX);
+        if (expansions) *expansions = search.expanded();
+        if (!search.found()) { out.clear(); return false; }
+        return true;
     }
 };
 
@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include "core/MazeMap.hpp"
+#include "core/Direction.hpp"
+#include "core/Navigator.hpp"
+
+/**
+ * @file tests/maze_test_utils.hpp
+ * @brief Geração de labirintos e sensores simulados compartilhados pelos testes.
+ *
+ * Labirintos perfeitos por DFS (busca em profundidade com vizinhos
+ * embaralhados), laços extras (`braid`) e a leitura de sensores relativa ao
+ * heading a partir do mapa verdadeiro. A sequência do `std::mt19937` define
+ * o labirinto: a mesma semente gera o mesmo labirinto em todos os testes.
+ */
+
+/** @brief Fecha todas as paredes (bordas e internas). */
+inline void add_all_walls(maze::MazeMap& m) {
+    for (int y = 0; y < m.height(); ++y)
+        for (int x = 0; x < m.width(); ++x) {
+            m.set_wall(x, y, 'N', true); m.set_wall(x, y, 'E', true);
+            m.set_wall(x, y, 'S', true); m.set_wall(x, y, 'W', true);
+        }
+}
+
+/** @brief Abre um labirinto perfeito (árvore geradora) a partir de `start` num mapa todo fechado. */
+inline void carve_maze_dfs(maze::MazeMap& m, std::mt19937& rng, maze::Point start = maze::Point{0, 0}) {
+    using maze::Point;
+    const int w = m.width();
+    const int h = m.height();
+    std::vector<uint8_t> vis(w*h, 0);
+    auto idx = [&](int x,int y){ return y*w + x; };
+    std::vector<Point> stack{start};
+    vis[idx(start.x,start.y)] = 1;
+    while(!stack.empty()){
+        Point p = stack.back();
+        std::vector<std::pair<Point,char>> nbrs;
+        if (p.y>0 && !vis[idx(p.x,p.y-1)]) nbrs.push_back({Point{p.x,p.y-1}, 'N'});
+        if (p.x<w-1 && !vis[idx(p.x+1,p.y)]) nbrs.push_back({Point{p.x+1,p.y}, 'E'});
+        if (p.y<h-1 && !vis[idx(p.x,p.y+1)]) nbrs.push_back({Point{p.x,p.y+1}, 'S'});
+        if (p.x>0 && !vis[idx(p.x-1,p.y)]) nbrs.push_back({Point{p.x-1,p.y}, 'W'});
+        if (nbrs.empty()) { stack.pop_back(); continue; }
+        std::shuffle(nbrs.begin(), nbrs.end(), rng);
+        auto [q,dir] = nbrs.front();
+        m.set_wall(p.x, p.y, dir, false);
+        vis[idx(q.x,q.y)] = 1;
+        stack.push_back(q);
+    }
+}
+
+/** @brief Labirinto perfeito w×h gerado pela semente `seed`, a partir de (0,0). */
+inline maze::MazeMap gen_perfect_maze(int w, int h, uint32_t seed) {
+    maze::MazeMap m(w, h);
+    add_all_walls(m);
+    std::mt19937 rng(seed);
+    carve_maze_dfs(m, rng);
+    return m;
+}
+
+/** @brief Remove paredes internas aleatórias, criando laços (labirinto "braided"). */
+inline void braid(maze::MazeMap& m, std::mt19937& rng, int count) {
+    std::uniform_int_distribution<int> dx(0, m.width()-2), dy(0, m.height()-2), coin(0,1);
+    for (int i=0;i<count;++i) m.set_wall(dx(rng), dy(rng), coin(rng) ? 'E' : 'S', false);
+}
+
+/** @brief Paredes absolutas de `cell` → flags relativas ao heading (tabelas de Direction.hpp). */
+inline maze::SensorRead make_sensor_read(const maze::MazeMap& m, maze::Point cell, uint8_t heading) {
+    using namespace maze;
+    SensorRead sr{};
+    const Dir h = from_heading(heading);
+    sr.left_free  = !m.has_wall(cell.x, cell.y, rel_to_abs(h, Action::Left));
+    sr.front_free = !m.has_wall(cell.x, cell.y, h);
+    sr.right_free = !m.has_wall(cell.x, cell.y, rel_to_abs(h, Action::Right));
+    return sr;
+}
+
+/** @brief Giros atualizam o heading; Forward avança uma célula no heading atual. */
+inline void apply_move(maze::Point& cell, uint8_t& heading, maze::Action a) {
+    using namespace maze;
+    const Dir h = from_heading(heading);
+    if (a == Action::Forward) cell = step(cell, h);
+    else heading = static_cast<uint8_t>(rel_to_abs(h, a));
+}
@@ -0,0 +1,149 @@
+/**
+ * @file tests/test_alloc_audit.cpp
+ * @brief Auditoria de alocações do `Navigator`/`Planner` em regime permanente.
+ *
+ * Substitui `operator new`/`operator delete` globais por versões que contam
+ * alocações (modo de teste). Verifica que, depois do primeiro planejamento,
+ * `observeCellWalls()`, `planRoute()` e `decidePlanned()` não alocam; que
+ * `Planner::bibfs_path_into()`/`bfs_path_into()`/`dial_path_into()` com
+ * `PlannerWorkspace` reaproveitado não alocam e devolvem o mesmo caminho da
+ * API com `std::optional`; e que `setMapDimensions()` reaproveita a memória.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R alloc_audit`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/MazeMap.hpp"
+#include "core/Navigator.hpp"
+#include "core/Planner.hpp"
+#include "maze_test_utils.hpp"
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+using namespace maze;
+
+static size_t g_allocs = 0; ///< Alocações via operator new desde o início do processo
+
+void* operator new(std::size_t n) {
+    g_allocs++;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void setUp() {}
+void tearDown() {}
+
+void test_steady_state_decisions_do_not_allocate() {
+    std::mt19937 rng(87u);
+    const int W = 16, H = 16;
+    MazeMap m(W,H);
+    add_all_walls(m);
+    carve_maze_dfs(m, rng);
+    for (int i = 0; i < 12; ++i) m.set_wall(static_cast<int>(rng() % (W-1)), static_cast<int>(rng() % H), Dir::E, false);
+
+    const size_t at_start = g_allocs;
+    Navigator nav;
+    nav.setMapDimensions(W,H);
+    nav.setStartGoal({0,0}, {W-1,H-1});
+    Point agent{0,0};
+    uint8_t heading = 1;
+    // Aquecimento: primeiro planejamento dimensiona as estruturas
+    SensorRead sr = make_sensor_read(m, agent, heading);
+    nav.observeCellWalls(agent, sr, heading);
+    nav.planRoute();
+    TEST_ASSERT_TRUE(g_allocs > at_start); // o contador vê as alocações do aquecimento
+
+    size_t steady = 0;
+    int steps = 0;
+    while (steps < W * H * 20 && !(agent.x == W-1 && agent.y == H-1)) {
+        sr = make_sensor_read(m, agent, heading);
+        const size_t before = g_allocs;
+        nav.observeCellWalls(agent, sr, heading);
+        nav.planRoute();
+        const Decision d = nav.decidePlanned(agent, heading, sr);
+        steady += g_allocs - before;
+        const Dir h = from_heading(heading);
+        if (d.action == Action::Forward) agent = step(agent, h);
+        else heading = idx(rel_to_abs(h, d.action));
+        steps++;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(agent.x == W-1 && agent.y == H-1, "Agent failed to reach goal");
+    TEST_ASSERT_EQUAL_INT(0, (int)steady);
+
+    // Novo episódio nas mesmas dimensões: memória reaproveitada
+    const size_t before = g_allocs;
+    nav.setMapDimensions(W,H);
+    nav.observeCellWalls({0,0}, make_sensor_read(m, {0,0}, 1), 1);
+    nav.planRoute();
+    TEST_ASSERT_EQUAL_INT(0, (int)(g_allocs - before));
+}
+
+void test_path_into_reuses_workspace() {
+    std::mt19937 rng(870u);
+    // 12x9 usa índices uint16_t; 300x300 (90000 células) usa uint32_t
+    for (int W : {12, 300}) {
+        const int H = W == 12 ? 9 : 300;
+        MazeMap m(W,H);
+        add_all_walls(m);
+        carve_maze_dfs(m, rng);
+        PlannerWorkspace ws;
+        std::pmr::vector<Point> bi, uni, dl;
+        bi.reserve(static_cast<size_t>(W) * H);
+        uni.reserve(static_cast<size_t>(W) * H);
+        dl.reserve(static_cast<size_t>(W) * H);
+        auto unit = [](size_t, int) -> uint8_t { return 1; };
+        TEST_ASSERT_TRUE(Planner::bibfs_path_into(m, {0,0}, {W-1,H-1}, bi, ws));
+        TEST_ASSERT_TRUE(Planner::dial_path_into(m, {0,0}, {W-1,H-1}, dl, ws, unit));
+        for (int k = 0; k < 6; ++k) {
+            const Point s{static_cast<int>(rng() % W), static_cast<int>(rng() % H)};
+            const Point g{static_cast<int>(rng() % W), static_cast<int>(rng() % H)};
+            auto ref_bi = Planner::bibfs_path(m, s, g);
+            auto ref_uni = Planner::bfs_path(m, s, g);
+            const size_t before = g_allocs;
+            const bool ok_bi = Planner::bibfs_path_into(m, s, g, bi, ws);
+            const bool ok_uni = Planner::bfs_path_into(m, s, g, uni, ws);
+            const bool ok_dl = Planner::dial_path_into(m, s, g, dl, ws, unit);
+            TEST_ASSERT_EQUAL_INT(0, (int)(g_allocs - before));
+            TEST_ASSERT_TRUE(ok_bi && ok_uni && ok_dl && ref_bi && ref_uni); // labirinto perfeito: sempre conexo
+            TEST_ASSERT_EQUAL_INT((int)ref_bi->size(), (int)bi.size());
+            TEST_ASSERT_EQUAL_INT((int)ref_uni->size(), (int)uni.size());
+            for (size_t i = 0; i < bi.size(); ++i) {
+                TEST_ASSERT_EQUAL_INT((*ref_bi)[i].x, bi[i].x);
+                TEST_ASSERT_EQUAL_INT((*ref_bi)[i].y, bi[i].y);
+                TEST_ASSERT_EQUAL_INT((*ref_uni)[i].x, uni[i].x);
+                TEST_ASSERT_EQUAL_INT((*ref_uni)[i].y, uni[i].y);
+                TEST_ASSERT_EQUAL_INT((*ref_uni)[i].x, dl[i].x); // caminho único: o mesmo com custo 1
+                TEST_ASSERT_EQUAL_INT((*ref_uni)[i].y, dl[i].y);
+            }
+        }
+    }
+}
+
+void test_path_code_assign_reuses_capacity() {
+    std::vector<Point> pts;
+    for (int x = 0; x < 40; ++x) pts.push_back({x, 0});
+    for (int y = 1; y < 20; ++y) pts.push_back({39, y});
+    PathCode pc;
+    pc.reserve(pts.size());
+    const size_t before = g_allocs;
+    TEST_ASSERT_TRUE(pc.assign(pts.data(), pts.size()));
+    TEST_ASSERT_TRUE(pc.assign(pts.data(), 10));
+    TEST_ASSERT_EQUAL_INT(0, (int)(g_allocs - before));
+    TEST_ASSERT_EQUAL_INT(9, (int)pc.moves());
+    const Point bad[2] = {{0,0}, {2,0}};
+    TEST_ASSERT_FALSE(pc.assign(bad, 2));
+    TEST_ASSERT_TRUE(pc.empty());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_state_decisions_do_not_allocate);
+    RUN_TEST(test_path_into_reuses_workspace);
+    RUN_TEST(test_path_code_assign_reuses_capacity);
+    return UNITY_END();
+}
@@ -0,0 +1,286 @@
+/**
+ * @file tests/test_anytime_planner.cpp
+ * @brief Testes do planejador anytime fatiado (`AnytimePlanner`, ARA*) e de `Navigator::planSliced`.
+ *
+ * Verifica que nenhuma chamada de `step()` passa do orçamento, que todo
+ * caminho publicado é contíguo, atravessa só passagens abertas e respeita o
+ * fator ε anunciado, que ε só diminui e que o resultado final é o mesmo
+ * caminho de `Planner::bibfs_path` (e, com custos, de `Planner::dial_path_into`),
+ * com os mesmos desempates. Também cobre objetivo inalcançável, recomeço quando o
+ * mapa muda no meio da busca (e a busca seguindo quando a parede nova não
+ * toca células alcançadas) e o `Navigator` chegando ao mesmo plano de
+ * `planRoute()` em fatias pequenas.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R anytime_planner`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/AnytimePlanner.hpp"
+#include "core/Navigator.hpp"
+#include "core/Planner.hpp"
+#include "core/EdgeCost.hpp"
+#include "maze_test_utils.hpp"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Caminho contíguo de `s` a `g` que só cruza passagens abertas. */
+static bool valid_path(const MazeMap& m, const std::pmr::vector<Point>& p, Point s, Point g) {
+    if (p.empty() || p.front().x != s.x || p.front().y != s.y || p.back().x != g.x || p.back().y != g.y) return false;
+    for (size_t i = 1; i < p.size(); ++i) {
+        const int ddx = p[i].x - p[i-1].x, ddy = p[i].y - p[i-1].y;
+        if (std::abs(ddx) + std::abs(ddy) != 1) return false;
+        const char d = ddx == 1 ? 'E' : ddx == -1 ? 'W' : ddy == 1 ? 'S' : 'N';
+        if (m.has_wall(p[i-1].x, p[i-1].y, d)) return false;
+    }
+    return true;
+}
+
+/** @brief Mesmos pontos na mesma ordem. */
+template <class A, class B>
+static bool same_path(const A& a, const B& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+                                              [](Point p, Point q) { return p.x == q.x && p.y == q.y; });
+}
+
+/** @brief Roda `ap` até terminar com fatias de `budget`, conferindo cada caminho publicado. */
+static void run_sliced(AnytimePlanner& ap, const MazeMap& m, Point s, Point g, uint32_t budget, size_t bfs_len,
+                       PlanStatus* status, int* publications) {
+    uint32_t version = ap.pathVersion();
+    float last_bound = 1e9f;
+    int pubs = 0;
+    PlanStatus st = PlanStatus::InProgress;
+    for (int tick = 0; tick < 100000 && st == PlanStatus::InProgress; ++tick) {
+        st = ap.step(budget);
+        TEST_ASSERT_TRUE(ap.lastWork() <= budget);
+        if (ap.pathVersion() != version && ap.hasPath()) {
+            version = ap.pathVersion();
+            pubs++;
+            TEST_ASSERT_TRUE(valid_path(m, ap.path(), s, g));
+            TEST_ASSERT_TRUE(ap.bound() <= last_bound);
+            TEST_ASSERT_TRUE(static_cast<float>(ap.path().size() - 1) <= ap.bound() * static_cast<float>(bfs_len - 1) + 1e-3f);
+            last_bound = ap.bound();
+        }
+    }
+    *status = st;
+    if (publications) *publications = pubs;
+}
+
+static void test_sliced_result_matches_bfs() {
+    std::mt19937 rng(11);
+    for (int trial = 0; trial < 8; ++trial) {
+        const int W = 12 + trial * 4, H = 10 + trial * 3;
+        MazeMap m(W, H);
+        add_all_walls(m);
+        carve_maze_dfs(m, rng);
+        if (trial % 2) braid(m, rng, W * H / 4);
+        const Point s{0, 0}, g{W - 1, H - 1};
+        const auto bfs = Planner::bibfs_path(m, s, g);
+        TEST_ASSERT_TRUE(bfs.has_value());
+
+        AnytimePlanner ap;
+        ap.begin(m, s, g);
+        int pubs = 0;
+        const uint32_t budget = 5 + static_cast<uint32_t>(trial) * 7;
+        PlanStatus st;
+        run_sliced(ap, m, s, g, budget, bfs->size(), &st, &pubs);
+        TEST_ASSERT_EQUAL(PlanStatus::Done, st);
+        TEST_ASSERT_TRUE(pubs >= 1);
+        TEST_ASSERT_TRUE(same_path(*bfs, ap.path()));
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, ap.bound());
+    }
+}
+
+static void test_weighted_result_matches_dial() {
+    std::mt19937 rng(19);
+    for (int trial = 0; trial < 6; ++trial) {
+        const int W = 14 + trial * 2, H = 12;
+        MazeMap m(W, H);
+        add_all_walls(m);
+        carve_maze_dfs(m, rng);
+        braid(m, rng, W * H / 3);
+        EdgeCostMap cost;
+        cost.resize(W, H);
+        std::uniform_int_distribution<int> rx(0, W - 1), ry(0, H - 1), rd(0, 3), ms(100, 900);
+        for (int k = 0; k < W * H; ++k) cost.record(Point{rx(rng), ry(rng)}, static_cast<Dir>(rd(rng)), ms(rng));
+        const Point s{0, 0}, g{W - 1, H - 1};
+        PlannerWorkspace ws;
+        std::pmr::vector<Point> dial;
+        TEST_ASSERT_TRUE(Planner::dial_path_into(m, s, g, dial, ws, cost));
+
+        AnytimePlanner ap;
+        ap.begin(m, s, g, nullptr, AnytimeConfig{}, &cost);
+        PlanStatus st = PlanStatus::InProgress;
+        for (int i = 0; i < 100000 && st == PlanStatus::InProgress; ++i) {
+            st = ap.step(9);
+            TEST_ASSERT_TRUE(ap.lastWork() <= 9);
+        }
+        TEST_ASSERT_EQUAL(PlanStatus::Done, st);
+        TEST_ASSERT_TRUE(same_path(dial, ap.path()));
+    }
+}
+
+static void test_open_arena_publishes_early_and_improves() {
+    // Arena aberta com uma barreira: a primeira solução (ε=3) sai antes da busca completa
+    const int W = 40, H = 40;
+    MazeMap m(W, H);
+    for (int y = 0; y < H - 1; ++y) m.set_wall(20, y, 'E', true);
+    const Point s{0, 0}, g{39, 0};
+    const auto bfs = Planner::bfs_path(m, s, g);
+    AnytimePlanner ap;
+    ap.begin(m, s, g);
+    uint64_t first_work = 0;
+    while (ap.step(16) == PlanStatus::InProgress && !ap.hasPath()) {}
+    TEST_ASSERT_TRUE(ap.hasPath());
+    first_work = ap.totalWork();
+    int pubs = 0;
+    PlanStatus st;
+    run_sliced(ap, m, s, g, 16, bfs->size(), &st, &pubs);
+    TEST_ASSERT_EQUAL(PlanStatus::Done, st);
+    TEST_ASSERT_TRUE(first_work < ap.totalWork());
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(bfs->size()), static_cast<int>(ap.path().size()));
+}
+
+static void test_reopened_cells_publish_consistent_paths() {
+    // Arenas com paredes soltas e ε reduzido aos poucos: células fechadas são
+    // melhoradas (INCONS) e a cadeia de predecessores fica mais curta que g(goal)
+    std::mt19937 rng(23);
+    for (int trial = 0; trial < 12; ++trial) {
+        const int W = 24, H = 18;
+        MazeMap m(W, H);
+        std::uniform_int_distribution<int> rx(0, W - 1), ry(0, H - 1), rd(0, 3);
+        for (int k = 0; k < W * H / 2; ++k) m.set_wall(rx(rng), ry(rng), static_cast<Dir>(rd(rng)), true);
+        const Point s{rx(rng), ry(rng)}, g{rx(rng), ry(rng)};
+        const auto bfs = Planner::bibfs_path(m, s, g);
+        AnytimeConfig cfg;
+        cfg.eps_start = 4.0f;
+        cfg.eps_step = 0.25f;
+        AnytimePlanner ap;
+        ap.begin(m, s, g, nullptr, cfg);
+        PlanStatus st;
+        if (!bfs) {
+            for (int i = 0; i < 100000 && ap.step(7) == PlanStatus::InProgress; ++i) {}
+            TEST_ASSERT_EQUAL(PlanStatus::NoPath, ap.status());
+            continue;
+        }
+        run_sliced(ap, m, s, g, 7, bfs->size(), &st, nullptr);
+        TEST_ASSERT_EQUAL(PlanStatus::Done, st);
+        TEST_ASSERT_TRUE(same_path(*bfs, ap.path()));
+    }
+}
+
+static void test_unreachable_goal_reports_no_path() {
+    MazeMap m(8, 8);
+    m.set_wall(6, 6, 'E', true); m.set_wall(6, 6, 'S', true);
+    m.set_wall(7, 6, 'S', true); m.set_wall(6, 7, 'E', true);
+    m.set_wall(7, 6, 'W', true); m.set_wall(6, 7, 'N', true);
+    m.set_wall(7, 7, 'N', true); m.set_wall(7, 7, 'W', true);
+    AnytimePlanner ap;
+    ap.begin(m, Point{0, 0}, Point{7, 7});
+    PlanStatus st = PlanStatus::InProgress;
+    for (int i = 0; i < 1000 && st == PlanStatus::InProgress; ++i) st = ap.step(3);
+    TEST_ASSERT_EQUAL(PlanStatus::NoPath, st);
+    TEST_ASSERT_FALSE(ap.hasPath());
+}
+
+static void test_map_change_restarts_search() {
+    MazeMap m(16, 16);
+    const Point s{0, 0}, g{15, 15};
+    AnytimePlanner ap;
+    ap.begin(m, s, g);
+    ap.step(10);
+    // Barreira nova no meio da busca: o resultado precisa refletir o mapa novo
+    for (int y = 0; y < 15; ++y) m.set_wall(7, y, 'E', true);
+    const auto bfs = Planner::bfs_path(m, s, g);
+    PlanStatus st;
+    run_sliced(ap, m, s, g, 10, bfs->size(), &st, nullptr);
+    TEST_ASSERT_EQUAL(PlanStatus::Done, st);
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(bfs->size()), static_cast<int>(ap.path().size()));
+    TEST_ASSERT_TRUE(valid_path(m, ap.path(), s, g));
+}
+
+static void test_edits_outside_search_keep_it_going() {
+#if MAZE_MAP_JOURNAL
+    MazeMap base(16, 16), m(16, 16);
+    const Point s{0, 0}, g{3, 0};
+    AnytimePlanner ref, ap;
+    ref.begin(base, s, g);
+    ap.begin(m, s, g);
+    TEST_ASSERT_EQUAL(PlanStatus::InProgress, ap.step(1));
+    ref.step(1);
+    // Canto oposto: nenhuma das duas células foi alcançada, a busca não recomeça
+    m.set_wall(15, 15, 'W', true);
+    m.set_wall(15, 14, 'S', true);
+    PlanStatus st = PlanStatus::InProgress, st_ref = PlanStatus::InProgress;
+    for (int i = 0; i < 1000 && st == PlanStatus::InProgress; ++i) st = ap.step(1);
+    for (int i = 0; i < 1000 && st_ref == PlanStatus::InProgress; ++i) st_ref = ref.step(1);
+    TEST_ASSERT_EQUAL(PlanStatus::Done, st);
+    TEST_ASSERT_EQUAL(PlanStatus::Done, st_ref);
+    TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(ref.totalWork()), static_cast<uint32_t>(ap.totalWork()));
+    TEST_ASSERT_EQUAL_UINT32(ref.pathVersion(), ap.pathVersion());
+    TEST_ASSERT_TRUE(valid_path(m, ap.path(), s, g));
+
+    // Parede na árvore de predecessores: recomeça, mas o caminho publicado fica até o próximo
+    MazeMap open(16, 16);
+    AnytimePlanner cut;
+    cut.begin(open, Point{0, 0}, Point{15, 15});
+    for (int i = 0; i < 1000 && !cut.hasPath(); ++i) cut.step(1);
+    TEST_ASSERT_TRUE(cut.hasPath());
+    const uint32_t version = cut.pathVersion();
+    const Point a = cut.path()[0], b = cut.path()[1];
+    open.set_wall(a.x, a.y, b.x > a.x ? 'E' : 'S', true);
+    cut.step(1);
+    TEST_ASSERT_TRUE(cut.hasPath());
+    TEST_ASSERT_EQUAL_UINT32(version, cut.pathVersion());
+    for (int i = 0; i < 10000 && cut.status() == PlanStatus::InProgress; ++i) cut.step(4);
+    TEST_ASSERT_EQUAL(PlanStatus::Done, cut.status());
+    TEST_ASSERT_TRUE(valid_path(open, cut.path(), Point{0, 0}, Point{15, 15}));
+#else
+    TEST_IGNORE_MESSAGE("MAZE_MAP_JOURNAL=0");
+#endif
+}
+
+static void test_navigator_plan_sliced_matches_plan_route() {
+    std::mt19937 rng(5);
+    MazeMap truth(20, 20);
+    add_all_walls(truth);
+    carve_maze_dfs(truth, rng);
+    braid(truth, rng, 60);
+
+    Navigator sliced, full;
+    for (Navigator* nav : {&sliced, &full}) {
+        nav->setMapDimensions(20, 20);
+        nav->setStartGoal(Point{0, 0}, Point{19, 19});
+        nav->map() = truth;
+    }
+    TEST_ASSERT_TRUE(full.planRoute());
+    int calls = 0;
+    while (!sliced.planValid() && calls < 10000) { sliced.planSliced(8); calls++; }
+    TEST_ASSERT_TRUE(sliced.planValid());
+    TEST_ASSERT_TRUE(calls > 1);
+    TEST_ASSERT_TRUE(full.currentPlan() == sliced.currentPlan());
+    TEST_ASSERT_TRUE(sliced.anytimePlanner().lastWork() <= 8);
+    // Válido: as chamadas seguintes não fazem trabalho
+    TEST_ASSERT_TRUE(sliced.planSliced(8));
+    TEST_ASSERT_EQUAL_UINT32(1u, sliced.planStats().replans);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sliced_result_matches_bfs);
+    RUN_TEST(test_weighted_result_matches_dial);
+    RUN_TEST(test_open_arena_publishes_early_and_improves);
+    RUN_TEST(test_reopened_cells_publish_consistent_paths);
+    RUN_TEST(test_unreachable_goal_reports_no_path);
+    RUN_TEST(test_map_change_restarts_search);
+    RUN_TEST(test_edits_outside_search_keep_it_going);
+    RUN_TEST(test_navigator_plan_sliced_matches_plan_route);
+    return UNITY_END();
+}
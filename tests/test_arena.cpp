@@ -0,0 +1,139 @@
+/**
+ * @file tests/test_arena.cpp
+ * @brief Testes da arena por episódio (`EpisodeArena`) e do `Navigator` sobre `std::pmr`.
+ *
+ * Verifica a contagem e a liberação em bloco da arena, que um episódio com
+ * `Navigator(arena.resource())` não recorre ao recurso padrão, que episódios
+ * seguidos reaproveitam o buffer inicial sem alocar do upstream e que o
+ * resultado é o mesmo do alocador global; imprime o tempo dos dois modos.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R arena`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/Arena.hpp"
+#include "core/MazeMap.hpp"
+#include "core/Navigator.hpp"
+#include "maze_test_utils.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Recurso que conta alocações e repassa ao `new`/`delete`. */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations{0};
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+};
+
+/** @brief Episódio de exploração planejada de (0,0) até o canto oposto; retorna os passos. */
+static int run_episode(const MazeMap& m, std::pmr::memory_resource* mr) {
+    Navigator nav(mr);
+    const int W = m.width(), H = m.height();
+    nav.setMapDimensions(W, H);
+    nav.setStartGoal({0,0}, {W-1,H-1});
+    Point agent{0,0};
+    uint8_t heading = 1;
+    int steps = 0;
+    while (steps < W * H * 20 && !(agent.x == W-1 && agent.y == H-1)) {
+        SensorRead sr{};
+        const Dir h = from_heading(heading);
+        sr.left_free  = !m.has_wall(agent.x, agent.y, rel_to_abs(h, Action::Left));
+        sr.front_free = !m.has_wall(agent.x, agent.y, h);
+        sr.right_free = !m.has_wall(agent.x, agent.y, rel_to_abs(h, Action::Right));
+        nav.observeCellWalls(agent, sr, heading);
+        nav.planRoute();
+        const Decision d = nav.decidePlanned(agent, heading, sr);
+        if (d.action == Action::Forward) agent = step(agent, h);
+        else heading = idx(rel_to_abs(h, d.action));
+        steps++;
+    }
+    return steps;
+}
+
+void test_arena_counts_and_resets() {
+    EpisodeArena arena(1024);
+    {
+        std::pmr::vector<int> v(arena.resource());
+        for (int i = 0; i < 1000; ++i) v.push_back(i); // excede o buffer inicial
+        TEST_ASSERT_EQUAL_INT(999, v.back());
+    }
+    TEST_ASSERT_TRUE(arena.bytesAllocated() >= 1000 * sizeof(int));
+    TEST_ASSERT_TRUE(arena.allocations() > 1);
+    const size_t used = arena.bytesAllocated();
+    arena.reset();
+    TEST_ASSERT_EQUAL_INT(0, (int)arena.bytesAllocated());
+    TEST_ASSERT_EQUAL_INT(0, (int)arena.allocations());
+    TEST_ASSERT_EQUAL_INT((int)used, (int)arena.peakBytes());
+}
+
+void test_navigator_uses_only_the_arena() {
+    std::mt19937 rng(86u);
+    MazeMap m(12,12);
+    add_all_walls(m);
+    carve_maze_dfs(m, rng);
+
+    CountingResource fallback;
+    std::pmr::memory_resource* old = std::pmr::set_default_resource(&fallback);
+    EpisodeArena arena(256 * 1024, std::pmr::new_delete_resource());
+    const int with_arena = run_episode(m, arena.resource());
+    const size_t escaped = fallback.allocations;
+    const int with_default = run_episode(m, std::pmr::get_default_resource());
+    std::pmr::set_default_resource(old);
+
+    TEST_ASSERT_EQUAL_INT(0, (int)escaped);          // nada do episódio caiu no recurso padrão
+    TEST_ASSERT_TRUE(arena.allocations() > 0);
+    TEST_ASSERT_TRUE(fallback.allocations > 0);      // sem arena, os mesmos contêineres usam o padrão
+    TEST_ASSERT_EQUAL_INT(with_default, with_arena);
+}
+
+void test_episodes_reuse_initial_buffer() {
+    std::mt19937 rng(860u);
+    MazeMap m(10,10);
+    add_all_walls(m);
+    carve_maze_dfs(m, rng);
+
+    CountingResource upstream;
+    EpisodeArena arena(64 * 1024, &upstream);
+    const int first = run_episode(m, arena.resource());
+    arena.reset();
+    const size_t after_first = upstream.allocations;
+    const int second = run_episode(m, arena.resource());
+    arena.reset();
+    TEST_ASSERT_EQUAL_INT(first, second);
+    if (arena.peakBytes() <= 64 * 1024) TEST_ASSERT_EQUAL_INT((int)after_first, (int)upstream.allocations);
+
+    // Vazão: episódios com alocador global vs. arena reaproveitada
+    const int episodes = 200;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < episodes; ++i) run_episode(m, std::pmr::new_delete_resource());
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < episodes; ++i) { run_episode(m, arena.resource()); arena.reset(); }
+    auto t2 = std::chrono::steady_clock::now();
+    std::printf("%d episodios 10x10: global %.1f ms, arena %.1f ms (pico %zu bytes)\n", episodes,
+                std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                std::chrono::duration<double, std::milli>(t2 - t1).count(), arena.peakBytes());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_arena_counts_and_resets);
+    RUN_TEST(test_navigator_uses_only_the_arena);
+    RUN_TEST(test_episodes_reuse_initial_buffer);
+    return UNITY_END();
+}
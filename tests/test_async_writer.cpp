@@ -0,0 +1,118 @@
+/**
+ * @file tests/test_async_writer.cpp
+ * @brief Testes da gravação assíncrona do simulador (`AsyncWriter`).
+ *
+ * Verifica que um fluxo em vários pedaços vira um único arquivo versionado,
+ * que conteúdo idêntico à última versão não cria arquivo novo (comparação por
+ * hash FNV-1a, inclusive de versões gravadas antes, lidas em blocos), que
+ * fluxos descartados ou não confirmados não deixam `.tmp` e que a numeração
+ * continua a partir das versões existentes.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R async_writer`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "AsyncWriter.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace maze;
+namespace fs = std::filesystem;
+
+static fs::path g_dir;
+static fs::path g_map;
+
+void setUp() {
+    g_dir = fs::temp_directory_path() / "maze_async_writer_test";
+    fs::remove_all(g_dir);
+    fs::create_directories(g_dir);
+    g_map = g_dir / "m.maze";
+}
+void tearDown() { fs::remove_all(g_dir); }
+
+static std::string slurp(const fs::path& p) {
+    std::ifstream ifs(p, std::ios::binary);
+    std::ostringstream ss; ss << ifs.rdbuf();
+    return ss.str();
+}
+
+static int count_ext(const std::string& ext) {
+    int n = 0;
+    for (auto& e : fs::directory_iterator(g_dir)) if (e.path().extension() == ext) ++n;
+    return n;
+}
+
+static void test_stream_in_chunks_is_one_file() {
+    AsyncWriter w(4); // fila pequena: exercita a contrapressão
+    auto id = w.begin(g_map, "_plan_", ".plan", false);
+    std::string expect;
+    for (int i = 0; i < 100; ++i) { std::string c = "line " + std::to_string(i) + "\n"; expect += c; w.append(id, c); }
+    w.commit(id, 7);
+    w.flush();
+    auto rs = w.takeResults();
+    TEST_ASSERT_EQUAL_INT(1, (int)rs.size());
+    TEST_ASSERT_TRUE(rs[0].ok);
+    TEST_ASSERT_EQUAL_UINT32(7u, (uint32_t)rs[0].tag);
+    TEST_ASSERT_EQUAL_STRING((g_dir / "m_plan_1.plan").string().c_str(), rs[0].path.string().c_str());
+    TEST_ASSERT_EQUAL_STRING(expect.c_str(), slurp(rs[0].path).c_str());
+    TEST_ASSERT_EQUAL_INT(0, count_ext(".tmp"));
+}
+
+static void test_dedup_by_hash() {
+    AsyncWriter w;
+    w.writeVersioned(g_map, "_solution_", ".soluct", "abc", true, 1);
+    w.writeVersioned(g_map, "_solution_", ".soluct", "abc", true, 2);
+    w.writeVersioned(g_map, "_solution_", ".soluct", "abd", true, 3);
+    w.flush();
+    auto rs = w.takeResults();
+    TEST_ASSERT_EQUAL_INT(3, (int)rs.size());
+    TEST_ASSERT_FALSE(rs[0].unchanged);
+    TEST_ASSERT_TRUE(rs[1].unchanged);
+    TEST_ASSERT_EQUAL_STRING(rs[0].path.string().c_str(), rs[1].path.string().c_str());
+    TEST_ASSERT_FALSE(rs[2].unchanged);
+    TEST_ASSERT_EQUAL_INT(2, latest_version_index(g_map, "_solution_", ".soluct"));
+}
+
+static void test_dedup_against_previous_session_file() {
+    { std::ofstream(g_dir / "m_solution_4.soluct", std::ios::binary) << "same"; }
+    AsyncWriter w; // cache vazio: o hash vem do arquivo
+    w.writeVersioned(g_map, "_solution_", ".soluct", "same", true, 1);
+    w.writeVersioned(g_map, "_solution_", ".soluct", "new", true, 2);
+    w.flush();
+    auto rs = w.takeResults();
+    TEST_ASSERT_TRUE(rs[0].unchanged);
+    TEST_ASSERT_EQUAL_STRING((g_dir / "m_solution_5.soluct").string().c_str(), rs[1].path.string().c_str());
+}
+
+static void test_abort_and_unfinished_leave_no_files() {
+    {
+        AsyncWriter w;
+        auto a = w.begin(g_map, "_plan_", ".plan", false);
+        w.append(a, "partial");
+        w.abort(a);
+        auto b = w.begin(g_map, "_plan_", ".plan", false);
+        w.append(b, "never committed");
+    } // destrutor descarta o fluxo aberto
+    TEST_ASSERT_EQUAL_INT(0, count_ext(".tmp"));
+    TEST_ASSERT_EQUAL_INT(0, count_ext(".plan"));
+}
+
+static void test_fnv1a_chaining() {
+    const char* s = "hello world";
+    const uint64_t whole = fnv1a64(s, 11);
+    const uint64_t chained = fnv1a64(s + 5, 6, fnv1a64(s, 5));
+    TEST_ASSERT_TRUE(whole == chained);
+    TEST_ASSERT_TRUE(fnv1a64("a", 1) != fnv1a64("b", 1));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_stream_in_chunks_is_one_file);
+    RUN_TEST(test_dedup_by_hash);
+    RUN_TEST(test_dedup_against_previous_session_file);
+    RUN_TEST(test_abort_and_unfinished_leave_no_files);
+    RUN_TEST(test_fnv1a_chaining);
+    return UNITY_END();
+}
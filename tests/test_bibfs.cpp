@@ -0,0 +1,113 @@
+/**
+ * @file tests/test_bibfs.cpp
+ * @brief Testes do BFS bidirecional (`Planner::bibfs_path`) contra o BFS unidirecional.
+ *
+ * Em labirintos perfeitos, braided e abertos aleatórios o caminho deve ter o
+ * mesmo comprimento do `bfs_path()`, ser contíguo e atravessar apenas
+ * passagens abertas. Também imprime a comparação de células expandidas.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R bibfs -V` (mostra o benchmark de expansões)
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/Planner.hpp"
+#include "core/DeadEndFill.hpp"
+#include "maze_test_utils.hpp"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Verifica contiguidade e passagens abertas ao longo do caminho. */
+static void assert_valid_path(const MazeMap& m, const std::vector<Point>& path, Point s, Point g) {
+    TEST_ASSERT_FALSE(path.empty());
+    TEST_ASSERT_TRUE(path.front().x == s.x && path.front().y == s.y);
+    TEST_ASSERT_TRUE(path.back().x == g.x && path.back().y == g.y);
+    for (size_t i=1;i<path.size();++i) {
+        const Point a = path[i-1], b = path[i];
+        TEST_ASSERT_EQUAL_INT(1, std::abs(a.x-b.x) + std::abs(a.y-b.y));
+        char dir = b.y < a.y ? 'N' : b.x > a.x ? 'E' : b.y > a.y ? 'S' : 'W';
+        TEST_ASSERT_FALSE(m.has_wall(a.x, a.y, dir));
+    }
+}
+
+static void check_random_maps(int braid_count, uint32_t seed0, const char* label) {
+    const int W=16, H=16;
+    long bfs_total = 0, bi_total = 0;
+    for (uint32_t seed=0; seed<20; ++seed) {
+        MazeMap m(W,H); add_all_walls(m);
+        std::mt19937 rng(seed0 + seed);
+        carve_maze_dfs(m, rng);
+        braid(m, rng, braid_count);
+        std::uniform_int_distribution<int> rx(0,W-1), ry(0,H-1);
+        for (int q=0;q<5;++q) {
+            Point s{rx(rng), ry(rng)}, g{rx(rng), ry(rng)};
+            int e1 = 0, e2 = 0;
+            auto a = Planner::bfs_path(m, s, g, nullptr, &e1);
+            auto b = Planner::bibfs_path(m, s, g, nullptr, &e2);
+            TEST_ASSERT_EQUAL(a.has_value(), b.has_value());
+            if (!a) continue;
+            TEST_ASSERT_EQUAL_INT((int)a->size(), (int)b->size());
+            assert_valid_path(m, *b, s, g);
+            bfs_total += e1; bi_total += e2;
+        }
+    }
+    std::printf("[bench] %-8s expansoes BFS=%ld bidirecional=%ld (%.1f%%)\n",
+                label, bfs_total, bi_total, bfs_total ? 100.0 * bi_total / bfs_total : 0.0);
+}
+
+void test_perfect_mazes_same_length() { check_random_maps(0, 100u, "perfect"); }
+void test_braided_mazes_same_length() { check_random_maps(60, 200u, "braided"); }
+void test_open_maps_same_length()     { check_random_maps(2000, 300u, "open"); }
+
+void test_edge_cases() {
+    MazeMap m(4,4); add_all_walls(m);
+    // start == goal
+    auto same = Planner::bibfs_path(m, {1,1}, {1,1});
+    TEST_ASSERT_TRUE(same.has_value());
+    TEST_ASSERT_EQUAL_INT(1, (int)same->size());
+    // inalcançável
+    TEST_ASSERT_FALSE(Planner::bibfs_path(m, {0,0}, {3,3}).has_value());
+    // fora dos limites
+    TEST_ASSERT_FALSE(Planner::bibfs_path(m, {0,0}, {4,0}).has_value());
+    // vizinhos adjacentes
+    m.set_wall(0,0,'E',false);
+    auto adj = Planner::bibfs_path(m, {0,0}, {1,0});
+    TEST_ASSERT_TRUE(adj.has_value());
+    TEST_ASSERT_EQUAL_INT(2, (int)adj->size());
+}
+
+void test_skip_mask_matches_bfs() {
+    const int W=12, H=9;
+    for (uint32_t seed=0; seed<6; ++seed) {
+        MazeMap m(W,H); add_all_walls(m);
+        std::mt19937 rng(500u + seed);
+        carve_maze_dfs(m, rng);
+        braid(m, rng, 15);
+        std::vector<uint8_t> pruned;
+        fill_dead_ends(m, {0,0}, {W-1,H-1}, pruned);
+        auto a = Planner::bfs_path(m, {0,0}, {W-1,H-1}, &pruned);
+        auto b = Planner::bibfs_path(m, {0,0}, {W-1,H-1}, &pruned);
+        TEST_ASSERT_TRUE(a.has_value());
+        TEST_ASSERT_TRUE(b.has_value());
+        TEST_ASSERT_EQUAL_INT((int)a->size(), (int)b->size());
+        for (const Point& p : *b) TEST_ASSERT_EQUAL_INT(0, pruned[p.y*W + p.x]);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_perfect_mazes_same_length);
+    RUN_TEST(test_braided_mazes_same_length);
+    RUN_TEST(test_open_maps_same_length);
+    RUN_TEST(test_edge_cases);
+    RUN_TEST(test_skip_mask_matches_bfs);
+    return UNITY_END();
+}
@@ -0,0 +1,75 @@
+/**
+ * @file tests/test_camera.cpp
+ * @brief Testes da câmera da vista do simulador (`Camera`): enquadramento, zoom, pan e recorte.
+ *
+ * Verifica que `fit()` centraliza e respeita o zoom máximo, que `zoomAt()`
+ * mantém fixo o ponto sob o cursor, que o zoom fica entre os limites e que
+ * `visible()` devolve só as células que cruzam a viewport (um labirinto
+ * 512x512 ampliado percorre uma fração pequena das células).
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R camera`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "Camera.hpp"
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+static void test_fit_centers_and_caps_zoom() {
+    Camera cam;
+    cam.setViewport(0, 0, 740, 700);
+    cam.fit(16, 12);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 40.0f, static_cast<float>(cam.cell())); // pequeno: limitado a 40 px
+    TEST_ASSERT_EQUAL_INT((740 - 16 * 40) / 2, cam.toScreenX(0));
+    TEST_ASSERT_EQUAL_INT((700 - 12 * 40) / 2, cam.toScreenY(0));
+
+    cam.fit(512, 512);
+    TEST_ASSERT_TRUE(cam.cell() < 2.0);
+    TEST_ASSERT_TRUE(cam.toScreenY(0) >= 0 && cam.toScreenY(512) <= 700);
+    const Camera::CellRange r = cam.visible(512, 512);
+    TEST_ASSERT_EQUAL_INT(0, r.x0);
+    TEST_ASSERT_EQUAL_INT(512, r.x1);
+    TEST_ASSERT_EQUAL_INT(512, r.y1);
+}
+
+static void test_zoom_at_keeps_point_under_cursor() {
+    Camera cam;
+    cam.setViewport(0, 0, 740, 700);
+    cam.fit(64, 64);
+    const double wx = (300 - cam.toScreenX(0)) / cam.cell();
+    cam.zoomAt(4.0, 300, 200);
+    TEST_ASSERT_TRUE(cam.toScreenX(wx) >= 299 && cam.toScreenX(wx) <= 300);
+    for (int i = 0; i < 100; ++i) cam.zoomAt(2.0, 300, 200);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, static_cast<float>(Camera::kMaxCell), static_cast<float>(cam.cell()));
+    for (int i = 0; i < 100; ++i) cam.zoom(0.5);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, static_cast<float>(Camera::kMinCell), static_cast<float>(cam.cell()));
+}
+
+static void test_visible_culls_to_viewport() {
+    Camera cam;
+    cam.setViewport(0, 0, 740, 700);
+    cam.fit(512, 512);
+    cam.zoom(40.0 / cam.cell()); // 40 px/célula no centro
+    const Camera::CellRange r = cam.visible(512, 512);
+    TEST_ASSERT_FALSE(r.empty());
+    const long cells = static_cast<long>(r.x1 - r.x0) * (r.y1 - r.y0);
+    TEST_ASSERT_TRUE(cells <= 20L * 19L);
+    TEST_ASSERT_TRUE(r.x0 > 200 && r.x1 < 312);
+
+    cam.pan(-1e6, 0); // labirinto fora da vista
+    TEST_ASSERT_TRUE(cam.visible(512, 512).empty());
+    TEST_ASSERT_TRUE(cam.contains(10, 10));
+    TEST_ASSERT_FALSE(cam.contains(740, 10));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fit_centers_and_caps_zoom);
+    RUN_TEST(test_zoom_at_keeps_point_under_cursor);
+    RUN_TEST(test_visible_culls_to_viewport);
+    return UNITY_END();
+}
@@ -0,0 +1,103 @@
+/**
+ * @file tests/test_cell_idx.cpp
+ * @brief Testes de `CellIdx` (índices compactos, offsets de vizinhança e máscaras de borda).
+ *
+ * Verifica vizinhos e bordas contra a aritmética de coordenadas, e que o BFS
+ * com índices de 16 e 32 bits produz caminhos de mesmo comprimento, inclusive
+ * em grades que não cabem em 16 bits.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R cell_idx`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/CellIdx.hpp"
+#include "core/Planner.hpp"
+#include <vector>
+#include <random>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+template <typename IndexT>
+static void check_neighbors(int w, int h) {
+    CellIdx<IndexT> grid(w, h);
+    const int dx[4] = {0, 1, 0, -1};
+    const int dy[4] = {-1, 0, 1, 0};
+    for (int y=0;y<h;++y) {
+        for (int x=0;x<w;++x) {
+            const IndexT i = grid.index(x,y);
+            TEST_ASSERT_EQUAL_INT(x, grid.point(i).x);
+            TEST_ASSERT_EQUAL_INT(y, grid.point(i).y);
+            for (int d=0; d<4; ++d) {
+                const bool inside = x+dx[d] >= 0 && y+dy[d] >= 0 && x+dx[d] < w && y+dy[d] < h;
+                TEST_ASSERT_EQUAL(inside, (grid.border(i) >> d) & 1u);
+                if (!inside) continue;
+                const Point q = grid.point(grid.neighbor(i, d));
+                TEST_ASSERT_EQUAL_INT(x+dx[d], q.x);
+                TEST_ASSERT_EQUAL_INT(y+dy[d], q.y);
+            }
+        }
+    }
+}
+
+void test_neighbors_and_borders() {
+    check_neighbors<uint16_t>(7, 5);
+    check_neighbors<uint32_t>(7, 5);
+    check_neighbors<uint16_t>(1, 1);
+    TEST_ASSERT_TRUE(CellIdx<uint16_t>::fits(255, 255));
+    TEST_ASSERT_FALSE(CellIdx<uint16_t>::fits(256, 256));
+    TEST_ASSERT_TRUE(CellIdx<uint32_t>::fits(256, 256));
+    TEST_ASSERT_EQUAL_INT(2, (int)sizeof(CellIdx<uint16_t>::index_type));
+}
+
+void test_open_mask_matches_walls() {
+    MazeMap m(3,3);
+    m.set_wall(1,1,'N',true);
+    m.set_wall(1,1,'W',true);
+    CellIdx<uint16_t> grid(3,3);
+    TEST_ASSERT_EQUAL_INT(0x6, grid.openMask(m, grid.index(1,1)));  // E,S
+    TEST_ASSERT_EQUAL_INT(0x6, grid.openMask(m, grid.index(0,0)));  // borda N,W
+    TEST_ASSERT_EQUAL_INT(0xB, grid.openMask(m, grid.index(1,2)));  // N,E,W (borda S)
+}
+
+void test_bfs_16_and_32_bit_agree() {
+    std::mt19937 rng(42u);
+    MazeMap m(20,20);
+    std::uniform_int_distribution<int> r(0,19), rd(0,3);
+    const char dirs[4] = {'N','E','S','W'};
+    for (int i=0;i<150;++i) m.set_wall(r(rng), r(rng), dirs[rd(rng)], true);
+    for (int q=0;q<30;++q) {
+        Point s{r(rng), r(rng)}, g{r(rng), r(rng)};
+        auto a = Planner::bfs_search<uint16_t>(m, s, g);
+        auto b = Planner::bfs_search<uint32_t>(m, s, g);
+        auto c = Planner::bibfs_search<uint32_t>(m, s, g);
+        TEST_ASSERT_EQUAL(a.has_value(), b.has_value());
+        TEST_ASSERT_EQUAL(a.has_value(), c.has_value());
+        if (!a) continue;
+        TEST_ASSERT_EQUAL_INT((int)a->size(), (int)b->size());
+        TEST_ASSERT_EQUAL_INT((int)a->size(), (int)c->size());
+    }
+}
+
+void test_large_grid_uses_32_bit_indices() {
+    // 300x300 = 90000 células: não cabe em uint16_t
+    MazeMap m(300,300);
+    auto p = Planner::bfs_path(m, {0,0}, {299,299});
+    TEST_ASSERT_TRUE(p.has_value());
+    TEST_ASSERT_EQUAL_INT(599, (int)p->size());
+    auto q = Planner::bibfs_path(m, {299,0}, {0,299});
+    TEST_ASSERT_TRUE(q.has_value());
+    TEST_ASSERT_EQUAL_INT(599, (int)q->size());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_neighbors_and_borders);
+    RUN_TEST(test_open_mask_matches_walls);
+    RUN_TEST(test_bfs_16_and_32_bit_agree);
+    RUN_TEST(test_large_grid_uses_32_bit_indices);
+    return UNITY_END();
+}
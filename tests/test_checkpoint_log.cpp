@@ -0,0 +1,148 @@
+/**
+ * @file tests/test_checkpoint_log.cpp
+ * @brief Testes do registro de progresso dos lotes (`CheckpointLog`).
+ *
+ * Verifica que os registros voltam ao reabrir, que uma linha cortada ou
+ * corrompida no fim é descartada (e o arquivo truncado, para os acréscimos
+ * seguirem de um ponto limpo), que o `fsync` sai em lotes de `sync_every`,
+ * que um arquivo que não é checkpoint não é tocado e que chaves inválidas são
+ * recusadas.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R checkpoint_log`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "CheckpointLog.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace maze;
+namespace fs = std::filesystem;
+
+static fs::path g_dir;
+static fs::path g_file;
+
+void setUp() {
+    g_dir = fs::temp_directory_path() / "maze_checkpoint_log_test";
+    fs::remove_all(g_dir);
+    fs::create_directories(g_dir);
+    g_file = g_dir / "sweep.ckpt";
+}
+void tearDown() { fs::remove_all(g_dir); }
+
+static std::string read_all(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static void test_records_survive_reopen() {
+    {
+        CheckpointLog log;
+        TEST_ASSERT_TRUE(log.open(g_file));
+        TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(log.resumed()));
+        TEST_ASSERT_TRUE(log.append("a.maze@1|1|planned", "12 3.5 1 1 100"));
+        TEST_ASSERT_TRUE(log.append("a.maze@1|1|mcts/b2000/p0.4500", "20 99.25 2 2 100"));
+        TEST_ASSERT_TRUE(log.append("a.maze@1|1|planned", "13 3.5 1 1 100")); // a última vale
+    }
+    CheckpointLog log;
+    TEST_ASSERT_TRUE(log.open(g_file));
+    TEST_ASSERT_EQUAL_UINT32(2, static_cast<uint32_t>(log.resumed()));
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(log.droppedBytes()));
+    TEST_ASSERT_NOT_NULL(log.find("a.maze@1|1|planned"));
+    TEST_ASSERT_EQUAL_STRING("13 3.5 1 1 100", log.find("a.maze@1|1|planned")->c_str());
+    TEST_ASSERT_EQUAL_STRING("20 99.25 2 2 100", log.find("a.maze@1|1|mcts/b2000/p0.4500")->c_str());
+    TEST_ASSERT_NULL(log.find("b.maze@2|1|planned"));
+}
+
+static void test_torn_tail_is_dropped_and_appends_continue() {
+    {
+        CheckpointLog log;
+        TEST_ASSERT_TRUE(log.open(g_file));
+        for (int i = 0; i < 5; ++i) TEST_ASSERT_TRUE(log.append("k" + std::to_string(i), std::to_string(i * 10)));
+    }
+    const uint64_t clean = fs::file_size(g_file);
+    { std::ofstream out(g_file, std::ios::binary | std::ios::app); out << "0badf00d\tk5\t5"; } // sem '\n': escrita cortada
+    {
+        CheckpointLog log;
+        TEST_ASSERT_TRUE(log.open(g_file));
+        TEST_ASSERT_EQUAL_UINT32(5, static_cast<uint32_t>(log.resumed()));
+        TEST_ASSERT_TRUE(log.droppedBytes() > 0);
+        TEST_ASSERT_TRUE(clean == fs::file_size(g_file));
+        TEST_ASSERT_TRUE(log.append("k5", "50"));
+    }
+    CheckpointLog log;
+    TEST_ASSERT_TRUE(log.open(g_file));
+    TEST_ASSERT_EQUAL_UINT32(6, static_cast<uint32_t>(log.resumed()));
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(log.droppedBytes()));
+    TEST_ASSERT_EQUAL_STRING("50", log.find("k5")->c_str());
+}
+
+static void test_corrupt_line_truncates_from_there() {
+    {
+        CheckpointLog log;
+        TEST_ASSERT_TRUE(log.open(g_file));
+        for (int i = 0; i < 4; ++i) TEST_ASSERT_TRUE(log.append("k" + std::to_string(i), "v" + std::to_string(i)));
+    }
+    // Troca um byte do valor da terceira linha: o hash não confere mais
+    std::string data = read_all(g_file);
+    const size_t at = data.find("\tv2\n");
+    TEST_ASSERT_TRUE(at != std::string::npos);
+    data[at + 2] = '7';
+    { std::ofstream out(g_file, std::ios::binary | std::ios::trunc); out << data; }
+    CheckpointLog log;
+    TEST_ASSERT_TRUE(log.open(g_file));
+    TEST_ASSERT_EQUAL_UINT32(2, static_cast<uint32_t>(log.resumed()));
+    TEST_ASSERT_NOT_NULL(log.find("k1"));
+    TEST_ASSERT_NULL(log.find("k2"));
+    TEST_ASSERT_NULL(log.find("k3"));
+}
+
+static void test_fsync_is_batched() {
+    CheckpointLog::Options opt;
+    opt.sync_every = 4;
+    opt.sync_ms = 60000;
+    CheckpointLog log(opt);
+    TEST_ASSERT_TRUE(log.open(g_file));
+    const size_t base = log.syncs(); // cabeçalho de um arquivo novo
+    for (int i = 0; i < 10; ++i) TEST_ASSERT_TRUE(log.append("k" + std::to_string(i), "v"));
+    TEST_ASSERT_EQUAL_UINT32(2, static_cast<uint32_t>(log.syncs() - base));
+    // Mesmo sem fsync, as linhas já estão no arquivo (sobrevivem ao processo)
+    std::map<std::string, std::string> seen;
+    TEST_ASSERT_TRUE(CheckpointLog::load(g_file, seen));
+    TEST_ASSERT_EQUAL_UINT32(10, static_cast<uint32_t>(seen.size()));
+    log.close();
+    TEST_ASSERT_EQUAL_UINT32(3, static_cast<uint32_t>(log.syncs() - base));
+}
+
+static void test_foreign_file_and_bad_keys_are_rejected() {
+    { std::ofstream out(g_file, std::ios::binary); out << "file,width,height\n"; }
+    CheckpointLog log;
+    TEST_ASSERT_FALSE(log.open(g_file));
+    TEST_ASSERT_EQUAL_STRING("file,width,height\n", read_all(g_file).c_str());
+
+    const fs::path other = g_dir / "other.ckpt";
+    TEST_ASSERT_TRUE(log.open(other));
+    TEST_ASSERT_FALSE(log.append("", "v"));
+    TEST_ASSERT_FALSE(log.append("a\tb", "v"));
+    TEST_ASSERT_FALSE(log.append("k", "linha\nquebrada"));
+    TEST_ASSERT_TRUE(log.append("k", "com\ttab"));
+    log.close();
+    std::map<std::string, std::string> seen;
+    TEST_ASSERT_TRUE(CheckpointLog::load(other, seen));
+    TEST_ASSERT_EQUAL_UINT32(1, static_cast<uint32_t>(seen.size()));
+    TEST_ASSERT_EQUAL_STRING("com\ttab", seen["k"].c_str());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_records_survive_reopen);
+    RUN_TEST(test_torn_tail_is_dropped_and_appends_continue);
+    RUN_TEST(test_corrupt_line_truncates_from_there);
+    RUN_TEST(test_fsync_is_batched);
+    RUN_TEST(test_foreign_file_and_bad_keys_are_rejected);
+    return UNITY_END();
+}
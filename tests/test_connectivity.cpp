@@ -0,0 +1,103 @@
+/**
+ * @file tests/test_connectivity.cpp
+ * @brief Testes dos rótulos de conectividade (union-find) e do atalho no `Navigator::planRoute()`.
+ *
+ * Verifica que remoções de parede unem componentes, que adições tornam os
+ * rótulos stale sem gerar falsos negativos, e que o resultado exato coincide
+ * com o BFS em mapas aleatórios com paredes alteradas.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R connectivity`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/Connectivity.hpp"
+#include "core/Navigator.hpp"
+#include "core/Planner.hpp"
+#include <random>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+static void close_column(MazeMap& m, int x) {
+    for (int y=0; y<m.height(); ++y) m.set_wall(x, y, 'E', true);
+}
+
+void test_union_on_wall_removal() {
+    MazeMap m(4,2);
+    close_column(m, 1);
+    Connectivity c;
+    TEST_ASSERT_FALSE(c.mayConnect(m, {0,0}, {3,1}));
+    TEST_ASSERT_EQUAL_INT(2, c.componentCount(m));
+    m.set_wall(1, 1, 'E', false);
+    c.onWallRemoved(1, 1, 'E');
+    TEST_ASSERT_TRUE(c.exact());
+    TEST_ASSERT_TRUE(c.mayConnect(m, {0,0}, {3,1}));
+    TEST_ASSERT_EQUAL_INT(1, c.componentCount(m));
+}
+
+void test_wall_added_is_conservative_then_exact() {
+    MazeMap m(4,2);
+    Connectivity c;
+    TEST_ASSERT_TRUE(c.connected(m, {0,0}, {3,0}));
+    close_column(m, 1);
+    for (int y=0; y<2; ++y) c.onWallAdded(1, y, 'E');
+    TEST_ASSERT_FALSE(c.exact());
+    // Sobre-aproximação: ainda responde "talvez", nunca um falso "não"
+    TEST_ASSERT_TRUE(c.mayConnect(m, {0,0}, {3,0}));
+    TEST_ASSERT_FALSE(c.connected(m, {0,0}, {3,0}));
+    TEST_ASSERT_TRUE(c.exact());
+}
+
+void test_navigator_skips_bfs_when_goal_walled_off() {
+    Navigator nav;
+    nav.setMapDimensions(4,4);
+    nav.setStartGoal({0,0}, {3,3});
+    TEST_ASSERT_TRUE(nav.isGoalReachable());
+    // Fecha o goal (3,3) observando paredes em seus vizinhos
+    SensorRead closed{}; // left/front/right bloqueados
+    nav.observeCellWalls({3,2}, closed, /*heading=*/1); // N, E, S fechados em (3,2) -> fecha (3,2)-(3,3)
+    nav.observeCellWalls({2,3}, closed, /*heading=*/0); // W, N, E fechados em (2,3) -> fecha (2,3)-(3,3)
+    TEST_ASSERT_FALSE(nav.planRoute());
+    TEST_ASSERT_FALSE(nav.hasPlan());
+    TEST_ASSERT_FALSE(nav.isGoalReachable());
+    // Reabrir uma passagem volta a permitir plano
+    SensorRead open{}; open.left_free = open.front_free = open.right_free = true;
+    nav.observeCellWalls({3,2}, open, /*heading=*/2);
+    TEST_ASSERT_TRUE(nav.isGoalReachable());
+    TEST_ASSERT_TRUE(nav.planRoute());
+}
+
+void test_connected_matches_bfs_on_random_edits() {
+    const int W=7, H=6;
+    const char dirs[4] = {'N','E','S','W'};
+    std::mt19937 rng(2024u);
+    std::uniform_int_distribution<int> dx(0,W-1), dy(0,H-1), dd(0,3), coin(0,2);
+    for (int trial=0; trial<20; ++trial) {
+        MazeMap m(W,H);
+        Connectivity c;
+        for (int step=0; step<60; ++step) {
+            int x = dx(rng), y = dy(rng); char d = dirs[dd(rng)];
+            bool add = coin(rng) != 0; // mais adições que remoções
+            bool had = m.has_wall(x,y,d);
+            m.set_wall(x,y,d,add);
+            if (had && !add) c.onWallRemoved(x,y,d);
+            else if (!had && add) c.onWallAdded(x,y,d);
+            Point a{dx(rng),dy(rng)}, b{dx(rng),dy(rng)};
+            bool bfs = Planner::bfs_path(m, a, b).has_value();
+            if (bfs) TEST_ASSERT_TRUE_MESSAGE(c.mayConnect(m, a, b), "mayConnect must never be a false negative");
+            TEST_ASSERT_EQUAL_INT(bfs, c.connected(m, a, b));
+        }
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_union_on_wall_removal);
+    RUN_TEST(test_wall_added_is_conservative_then_exact);
+    RUN_TEST(test_navigator_skips_bfs_when_goal_walled_off);
+    RUN_TEST(test_connected_matches_bfs_on_random_edits);
+    return UNITY_END();
+}
@@ -0,0 +1,89 @@
+/**
+ * @file tests/test_dead_end_fill.cpp
+ * @brief Testes do preenchimento de becos (`fill_dead_ends`) e da poda no `Navigator`.
+ *
+ * Em labirintos perfeitos, após a poda restam exatamente as células do
+ * caminho único entre start e goal. Em labirintos com laços, o BFS restrito às
+ * células mantidas deve ter o mesmo comprimento do BFS completo.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R dead_end_fill`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/DeadEndFill.hpp"
+#include "core/Navigator.hpp"
+#include "core/Planner.hpp"
+#include "maze_test_utils.hpp"
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+void test_perfect_maze_keeps_only_solution_corridor() {
+    const int W=10, H=8;
+    for (uint32_t seed=0; seed<6; ++seed) {
+        MazeMap m(W,H); add_all_walls(m);
+        std::mt19937 rng(700u + seed);
+        carve_maze_dfs(m, rng);
+        std::vector<uint8_t> pruned;
+        PruneStats st = fill_dead_ends(m, {0,0}, {W-1,H-1}, pruned);
+        auto path = Planner::bfs_path(m, {0,0}, {W-1,H-1});
+        TEST_ASSERT_TRUE(path.has_value());
+        TEST_ASSERT_EQUAL_INT(W*H, st.cells);
+        TEST_ASSERT_EQUAL_INT((int)path->size(), st.remaining);
+        for (const Point& p : *path) TEST_ASSERT_EQUAL_INT(0, pruned[p.y*W + p.x]);
+    }
+}
+
+void test_braided_maze_path_length_unchanged() {
+    const int W=12, H=9;
+    for (uint32_t seed=0; seed<6; ++seed) {
+        MazeMap m(W,H); add_all_walls(m);
+        std::mt19937 rng(900u + seed);
+        carve_maze_dfs(m, rng);
+        braid(m, rng, 15);
+        std::vector<uint8_t> pruned;
+        PruneStats st = fill_dead_ends(m, {0,0}, {W-1,H-1}, pruned);
+        auto full = Planner::bfs_path(m, {0,0}, {W-1,H-1});
+        auto reduced = Planner::bfs_path(m, {0,0}, {W-1,H-1}, &pruned);
+        TEST_ASSERT_TRUE(full.has_value());
+        TEST_ASSERT_TRUE(reduced.has_value());
+        TEST_ASSERT_EQUAL_INT((int)full->size(), (int)reduced->size());
+        TEST_ASSERT_GREATER_OR_EQUAL(0, st.pruned);
+        TEST_ASSERT_EQUAL_INT(st.cells - st.pruned, st.remaining);
+    }
+}
+
+void test_navigator_prune_then_plan() {
+    const int W=8, H=8;
+    MazeMap truth(W,H); add_all_walls(truth);
+    std::mt19937 rng(31337u);
+    carve_maze_dfs(truth, rng);
+    Navigator nav;
+    nav.setMapDimensions(W,H);
+    nav.setStartGoal({0,0}, {W-1,H-1});
+    nav.map() = truth; // mapa totalmente explorado
+    PruneStats st = nav.pruneDeadEnds();
+    TEST_ASSERT_GREATER_THAN(0, st.pruned);
+    TEST_ASSERT_EQUAL_INT(W*H, (int)nav.prunedCells().size());
+    TEST_ASSERT_TRUE(nav.planRoute());
+    auto ref = Planner::bfs_path(truth, {0,0}, {W-1,H-1});
+    TEST_ASSERT_EQUAL_INT((int)ref->size(), (int)nav.currentPlan().size());
+    // Remover uma parede descarta a poda
+    SensorRead open{}; open.left_free = open.front_free = open.right_free = true;
+    nav.observeCellWalls({1,1}, open, 0);
+    TEST_ASSERT_TRUE(nav.prunedCells().empty());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_perfect_maze_keeps_only_solution_corridor);
+    RUN_TEST(test_braided_maze_path_length_unchanged);
+    RUN_TEST(test_navigator_prune_then_plan);
+    return UNITY_END();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file tests/test_dial.cpp
+ * @brief Testes do Dijkstra com fila de baldes (`Planner::dial_path`, `dial_path_into`).
+ *
+ * Com custo 1 em todas as arestas o caminho tem o comprimento do `bfs_path()`;
+ * com custos aleatórios (1..255) o custo total bate com um Dijkstra de
+ * referência com `std::priority_queue`, e o caminho é contíguo, só atravessa
+ * passagens abertas e soma exatamente o custo informado. Também cobre arestas
+ * de custo 0 (bloqueadas), máscara de exclusão, objetivo inalcançável,
+ * start == goal e reuso do `PlannerWorkspace` entre mapas de tamanhos diferentes.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R dial`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/Planner.hpp"
+#include "maze_test_utils.hpp"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Labirinto perfeito com `extra` paredes internas removidas (vários caminhos). */
+static MazeMap braided(int w, int h, std::mt19937& rng, int extra) {
+    MazeMap m(w, h);
+    add_all_walls(m);
+    carve_maze_dfs(m, rng);
+    std::uniform_int_distribution<int> dx(0, w-2), dy(0, h-2), coin(0,1);
+    for (int i = 0; i < extra; ++i) m.set_wall(dx(rng), dy(rng), coin(rng) ? 'E' : 'S', false);
+    return m;
+}
+
+static std::vector<uint8_t> random_costs(const MazeMap& m, std::mt19937& rng, int lo, int hi) {
+    std::uniform_int_distribution<int> c(lo, hi);
+    std::vector<uint8_t> cost(static_cast<size_t>(m.width()) * m.height() * 4);
+    for (auto& v : cost) v = static_cast<uint8_t>(c(rng));
+    return cost;
+}
+
+static const int kDx[4] = {0, 1, 0, -1};
+static const int kDy[4] = {-1, 0, 1, 0};
+
+/** @brief Dijkstra de referência com heap binário; UINT32_MAX se inalcançável. */
+static uint32_t reference_cost(const MazeMap& m, Point s, Point g, const std::vector<uint8_t>& cost) {
+    const int w = m.width();
+    std::vector<uint32_t> dist(static_cast<size_t>(w) * m.height(), UINT32_MAX);
+    using Item = std::pair<uint32_t, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    dist[s.y*w + s.x] = 0;
+    pq.push({0, s.y*w + s.x});
+    while (!pq.empty()) {
+        auto [d, i] = pq.top(); pq.pop();
+        if (d != dist[i]) continue;
+        const int x = i % w, y = i / w;
+        for (int dir = 0; dir < 4; ++dir) {
+            if (m.has_wall(x, y, static_cast<Dir>(dir)) || cost[i*4 + dir] == 0) continue;
+            const int j = (y + kDy[dir]) * w + (x + kDx[dir]);
+            const uint32_t nd = d + cost[i*4 + dir];
+            if (nd < dist[j]) { dist[j] = nd; pq.push({nd, j}); }
+        }
+    }
+    return dist[g.y*w + g.x];
+}
+
+/** @brief Soma dos custos ao longo do caminho; UINT32_MAX se ele pular células ou atravessar parede. */
+static uint32_t path_cost(const MazeMap& m, const std::vector<Point>& p, const std::vector<uint8_t>& cost) {
+    uint32_t total = 0;
+    for (size_t k = 1; k < p.size(); ++k) {
+        int dir = -1;
+        for (int d = 0; d < 4; ++d)
+            if (p[k-1].x + kDx[d] == p[k].x && p[k-1].y + kDy[d] == p[k].y) dir = d;
+        if (dir < 0 || m.has_wall(p[k-1].x, p[k-1].y, static_cast<Dir>(dir))) return UINT32_MAX;
+        total += cost[(p[k-1].y*m.width() + p[k-1].x)*4 + dir];
+    }
+    return total;
+}
+
+static void test_unit_cost_matches_bfs_length() {
+    std::mt19937 rng(5);
+    for (int t = 0; t < 10; ++t) {
+        MazeMap m = braided(24, 17, rng, 60);
+        const Point s{0,0}, g{23,16};
+        auto bfs = Planner::bfs_path(m, s, g);
+        uint32_t total = 0;
+        auto dial = Planner::dial_path(m, s, g, {}, nullptr, nullptr, &total);
+        TEST_ASSERT_TRUE(bfs.has_value());
+        TEST_ASSERT_TRUE(dial.has_value());
+        TEST_ASSERT_EQUAL_INT(static_cast<int>(bfs->size()), static_cast<int>(dial->size()));
+        TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(dial->size() - 1), total);
+    }
+}
+
+static void test_random_costs_match_reference_dijkstra() {
+    std::mt19937 rng(17);
+    for (int t = 0; t < 20; ++t) {
+        MazeMap m = braided(20 + t, 15 + t/2, rng, 80);
+        // Faixas estreitas e largas: custos perto de 255 exercitam a volta dos baldes
+        auto cost = random_costs(m, rng, t % 2 ? 200 : 1, 255);
+        const Point s{static_cast<int>(rng() % m.width()), static_cast<int>(rng() % m.height())};
+        const Point g{m.width()-1, m.height()-1};
+        uint32_t total = 0;
+        int expanded = 0;
+        auto p = Planner::dial_path(m, s, g, cost, nullptr, &expanded, &total);
+        TEST_ASSERT_TRUE(p.has_value());
+        TEST_ASSERT_TRUE(p->front().x == s.x && p->front().y == s.y);
+        TEST_ASSERT_TRUE(p->back().x == g.x && p->back().y == g.y);
+        TEST_ASSERT_EQUAL_UINT32(reference_cost(m, s, g, cost), total);
+        TEST_ASSERT_EQUAL_UINT32(total, path_cost(m, *p, cost));
+        TEST_ASSERT_TRUE(expanded > 0 && expanded <= m.width() * m.height());
+    }
+}
+
+static void test_cheap_detour_beats_short_expensive_path() {
+    // Grade aberta 5x3: a linha do meio é cara, a volta por cima é barata
+    MazeMap m(5, 3);
+    std::vector<uint8_t> cost(5*3*4, 1);
+    for (int x = 0; x < 4; ++x) cost[(1*5 + x)*4 + 1] = 100; // E na linha 1
+    uint32_t total = 0;
+    auto p = Planner::dial_path(m, Point{0,1}, Point{4,1}, cost, nullptr, nullptr, &total);
+    TEST_ASSERT_TRUE(p.has_value());
+    TEST_ASSERT_EQUAL_UINT32(6, total); // N, 4×E, S
+    TEST_ASSERT_EQUAL_INT(7, static_cast<int>(p->size()));
+    TEST_ASSERT_EQUAL_UINT32(6, path_cost(m, *p, cost));
+}
+
+static void test_zero_cost_blocks_edge() {
+    // Corredor 4x1: aresta 1→2 bloqueada só na ida
+    MazeMap m(4, 1);
+    std::vector<uint8_t> cost(4*4, 1);
+    cost[1*4 + 1] = 0;
+    TEST_ASSERT_FALSE(Planner::dial_path(m, Point{0,0}, Point{3,0}, cost).has_value());
+    auto back = Planner::dial_path(m, Point{3,0}, Point{0,0}, cost);
+    TEST_ASSERT_TRUE(back.has_value());
+    TEST_ASSERT_EQUAL_INT(4, static_cast<int>(back->size()));
+}
+
+static void test_skip_unreachable_and_trivial() {
+    MazeMap m(6, 6);
+    std::vector<uint8_t> skip(36, 0);
+    for (int y = 0; y < 6; ++y) skip[y*6 + 3] = 1; // coluna 3 fechada
+    TEST_ASSERT_FALSE(Planner::dial_path(m, Point{0,0}, Point{5,5}, {}, &skip).has_value());
+    skip[2*6 + 3] = 0; // abre uma passagem
+    auto p = Planner::dial_path(m, Point{0,0}, Point{5,5}, {}, &skip);
+    TEST_ASSERT_TRUE(p.has_value());
+    for (const Point& q : *p) TEST_ASSERT_FALSE(skip[q.y*6 + q.x]);
+
+    // Objetivo murado
+    MazeMap w(5, 5);
+    w.set_wall(4,4,'N',true); w.set_wall(4,4,'W',true);
+    TEST_ASSERT_FALSE(Planner::dial_path(w, Point{0,0}, Point{4,4}, {}).has_value());
+    TEST_ASSERT_FALSE(Planner::dial_path(w, Point{0,0}, Point{9,9}, {}).has_value());
+
+    uint32_t total = 7;
+    auto same = Planner::dial_path(w, Point{2,2}, Point{2,2}, {}, nullptr, nullptr, &total);
+    TEST_ASSERT_TRUE(same.has_value());
+    TEST_ASSERT_EQUAL_INT(1, static_cast<int>(same->size()));
+    TEST_ASSERT_EQUAL_UINT32(0, total);
+}
+
+static void test_workspace_reuse_across_sizes() {
+    std::mt19937 rng(29);
+    PlannerWorkspace ws;
+    std::pmr::vector<Point> out;
+    for (int t = 0; t < 6; ++t) {
+        // Alterna entre 16 e 32 bits de índice (300x300 > 65534 células)
+        const int w = t % 3 == 2 ? 300 : 12 + t, h = t % 3 == 2 ? 230 : 9 + t;
+        MazeMap m = braided(w, h, rng, w);
+        auto cost = random_costs(m, rng, 1, 9);
+        auto fn = [&](size_t cell, int dir) { return cost[cell*4 + static_cast<size_t>(dir)]; };
+        uint32_t total = 0;
+        TEST_ASSERT_TRUE(Planner::dial_path_into(m, Point{0,0}, Point{w-1,h-1}, out, ws, fn, nullptr, nullptr, &total));
+        TEST_ASSERT_EQUAL_UINT32(reference_cost(m, Point{0,0}, Point{w-1,h-1}, cost), total);
+        TEST_ASSERT_EQUAL_UINT32(total, path_cost(m, std::vector<Point>(out.begin(), out.end()), cost));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_unit_cost_matches_bfs_length);
+    RUN_TEST(test_random_costs_match_reference_dijkstra);
+    RUN_TEST(test_cheap_detour_beats_short_expensive_path);
+    RUN_TEST(test_zero_cost_blocks_edge);
+    RUN_TEST(test_skip_unreachable_and_trivial);
+    RUN_TEST(test_workspace_reuse_across_sizes);
+    return UNITY_END();
+}
@@ -0,0 +1,97 @@
+/**
+ * @file tests/test_direction.cpp
+ * @brief Testes da álgebra de direções (`Dir`, tabelas constexpr de Direction.hpp).
+ *
+ * Compara as tabelas com a aritmética de heading usada antes (giros módulo 4,
+ * deltas N=y-1), verifica que relativa→absoluta e absoluta→relativa são
+ * inversas e que `set_wall`/`has_wall` com `Dir` e com letras concordam.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R direction`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/Direction.hpp"
+#include "core/MazeMap.hpp"
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+void test_rotate_and_opposite() {
+    for (int h = 0; h < 4; ++h) {
+        const Dir d = from_heading(static_cast<uint8_t>(h));
+        TEST_ASSERT_EQUAL_INT((h + 1) & 3, (int)rotate(d, 1));
+        TEST_ASSERT_EQUAL_INT((h + 3) & 3, (int)rotate(d, -1));
+        TEST_ASSERT_EQUAL_INT((h + 2) & 3, (int)opposite(d));
+        TEST_ASSERT_EQUAL_INT(h, (int)opposite(opposite(d)));
+        TEST_ASSERT_EQUAL_INT(0, dx(d) + dx(opposite(d)));
+        TEST_ASSERT_EQUAL_INT(0, dy(d) + dy(opposite(d)));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, dy(Dir::N));
+    TEST_ASSERT_EQUAL_INT(1, dx(Dir::E));
+    TEST_ASSERT_EQUAL_INT(1, dy(Dir::S));
+    TEST_ASSERT_EQUAL_INT(-1, dx(Dir::W));
+}
+
+void test_relative_absolute_roundtrip() {
+    const Action acts[4] = { Action::Right, Action::Forward, Action::Left, Action::Back };
+    const int turns[4] = { 1, 0, 3, 2 };
+    for (int h = 0; h < 4; ++h) {
+        const Dir hd = from_heading(static_cast<uint8_t>(h));
+        for (int k = 0; k < 4; ++k) {
+            const Dir abs = rel_to_abs(hd, acts[k]);
+            TEST_ASSERT_EQUAL_INT((h + turns[k]) & 3, (int)abs);
+            TEST_ASSERT_EQUAL_INT((int)acts[k], (int)abs_to_action(hd, abs));
+        }
+    }
+}
+
+void test_chars_and_bits() {
+    const char letters[4] = { 'N', 'E', 'S', 'W' };
+    for (int i = 0; i < 4; ++i) {
+        const Dir d = from_heading(static_cast<uint8_t>(i));
+        TEST_ASSERT_EQUAL_INT(letters[i], to_char(d));
+        TEST_ASSERT_TRUE(is_dir_char(letters[i]));
+        TEST_ASSERT_EQUAL_INT(i, (int)from_char(letters[i]));
+        TEST_ASSERT_EQUAL_INT(1 << i, wall_bit(d));
+    }
+    TEST_ASSERT_FALSE(is_dir_char('n'));
+    TEST_ASSERT_FALSE(is_dir_char('X'));
+    TEST_ASSERT_FALSE(is_dir_char('\0'));
+    TEST_ASSERT_FALSE(is_dir_char(static_cast<char>(0xCE)));
+}
+
+void test_set_wall_dir_matches_char() {
+    for (int i = 0; i < 4; ++i) {
+        const Dir d = from_heading(static_cast<uint8_t>(i));
+        MazeMap a(3,3), b(3,3);
+        a.set_wall(1, 1, d, true);
+        b.set_wall(1, 1, to_char(d), true);
+        const Point n = step(Point{1,1}, d);
+        for (int j = 0; j < 4; ++j) {
+            const Dir e = from_heading(static_cast<uint8_t>(j));
+            TEST_ASSERT_EQUAL_INT(i == j, a.has_wall(1, 1, e));
+            TEST_ASSERT_EQUAL_INT(a.has_wall(1, 1, e), b.has_wall(1, 1, to_char(e)));
+            // A parede é bidirecional: o vizinho vê a parede na direção oposta
+            TEST_ASSERT_EQUAL_INT(i == j, a.has_wall(n.x, n.y, opposite(e)));
+        }
+        a.set_wall(1, 1, d, false);
+        TEST_ASSERT_FALSE(a.has_wall(n.x, n.y, opposite(d)));
+    }
+    MazeMap m(2,2);
+    m.set_wall(0, 0, 'X', true);
+    TEST_ASSERT_TRUE(m.has_wall(0, 0, 'X'));
+    TEST_ASSERT_FALSE(m.has_wall(0, 0, Dir::E));
+    TEST_ASSERT_TRUE(m.has_wall(-1, 0, Dir::E));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rotate_and_opposite);
+    RUN_TEST(test_relative_absolute_roundtrip);
+    RUN_TEST(test_chars_and_bits);
+    RUN_TEST(test_set_wall_dir_matches_char);
+    return UNITY_END();
+}
@@ -0,0 +1,198 @@
+/**
+ * @file tests/test_edge_cost.cpp
+ * @brief Testes da camada de custos por aresta aprendida (`EdgeCostMap`) e do planejamento ponderado.
+ *
+ * Verifica a média móvel em ponto fixo (primeira amostra, convergência,
+ * saturação), o custo `uint8_t` (arredondamento e limites 1..255), os
+ * valores assumidos para arestas não medidas (sentido contrário, média,
+ * nominal), a persistência em `PersistentMemory` e que o `Navigator`, com
+ * `setWeightedPlanning(true)`, desvia de um corredor lento medido enquanto o
+ * BFS segue pelo caminho mais curto, tanto pelo Dial (`planIfInvalid`) quanto
+ * pelo ARA* fatiado (`planSliced`).
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R edge_cost`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/EdgeCost.hpp"
+#include "core/Navigator.hpp"
+#include "core/PersistentMemory.hpp"
+#include <vector>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+static size_t cell(const EdgeCostMap& c, int x, int y) { return static_cast<size_t>(y * c.width() + x); }
+
+static void test_ema_fixed_point() {
+    EdgeCostMap c;
+    c.resize(4, 3);
+    TEST_ASSERT_FALSE(c.record(Point{3, 0}, Dir::E, 100)); // sai da grade
+    TEST_ASSERT_FALSE(c.record(Point{0, 0}, Dir::N, 100));
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(c.measured()));
+
+    TEST_ASSERT_TRUE(c.record(Point{1, 1}, Dir::E, 200));
+    TEST_ASSERT_EQUAL_UINT32(1, static_cast<uint32_t>(c.measured()));
+    TEST_ASSERT_EQUAL_UINT32(200 * 16, c.ema(cell(c, 1, 1) * 4 + 1)); // primeira amostra como está
+    c.record(Point{1, 1}, Dir::E, 600);
+    TEST_ASSERT_EQUAL_UINT32(300 * 16, c.ema(cell(c, 1, 1) * 4 + 1)); // 200 + (600-200)/4
+    for (int i = 0; i < 60; ++i) c.record(Point{1, 1}, Dir::E, 600);
+    TEST_ASSERT_TRUE(c.ema(cell(c, 1, 1) * 4 + 1) + 16 >= 600 * 16); // converge (truncamento deixa < 1 ms)
+    for (int i = 0; i < 60; ++i) c.record(Point{1, 1}, Dir::E, 80);
+    TEST_ASSERT_TRUE(c.ema(cell(c, 1, 1) * 4 + 1) <= 80 * 16 + 16);
+    TEST_ASSERT_EQUAL_UINT32(1, static_cast<uint32_t>(c.measured()));
+
+    // Saturação em ~4,1 s e custo limitado a 255 unidades
+    c.record(Point{0, 2}, Dir::E, 100000);
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFu, c.ema(cell(c, 0, 2) * 4 + 1));
+    EdgeCostConfig cfg;
+    cfg.unit_ms = 10;
+    c.setConfig(cfg);
+    TEST_ASSERT_EQUAL_UINT8(255, c(cell(c, 0, 2), 1));
+    // Arredondamento: 80 ms / 10 = 8
+    TEST_ASSERT_EQUAL_UINT8(8, c(cell(c, 1, 1), 1));
+    c.record(Point{2, 2}, Dir::W, 0);
+    TEST_ASSERT_EQUAL_UINT8(1, c(cell(c, 2, 2), 3)); // nunca 0 (0 bloquearia a aresta no Dial)
+}
+
+static void test_unmeasured_edges_fall_back() {
+    EdgeCostMap c;
+    EdgeCostConfig cfg;
+    cfg.unit_ms = 10;
+    cfg.nominal_ms = 150;
+    c.setConfig(cfg);
+    c.resize(5, 5);
+    TEST_ASSERT_EQUAL_UINT8(15, c(cell(c, 2, 2), 0)); // nada medido: nominal
+    c.record(Point{2, 2}, Dir::N, 400);
+    c.record(Point{0, 0}, Dir::S, 200);
+    TEST_ASSERT_EQUAL_UINT8(40, c(cell(c, 2, 2), 0));
+    TEST_ASSERT_EQUAL_UINT8(40, c(cell(c, 2, 1), 2)); // sentido contrário medido
+    TEST_ASSERT_EQUAL_UINT8(30, c(cell(c, 4, 4), 3)); // média das medidas (400+200)/2
+
+    // Mesmas dimensões mantêm as medições; outras começam do zero
+    c.resize(5, 5);
+    TEST_ASSERT_EQUAL_UINT32(2, static_cast<uint32_t>(c.measured()));
+    c.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(c.measured()));
+    TEST_ASSERT_EQUAL_UINT8(15, c(cell(c, 2, 2), 0));
+    c.record(Point{1, 1}, Dir::E, 90);
+    c.resize(6, 5);
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(c.measured()));
+}
+
+static void test_persistence_roundtrip() {
+    (void)PersistentMemory::eraseAll();
+    EdgeCostMap c;
+    c.resize(6, 4);
+    c.record(Point{0, 0}, Dir::E, 120);
+    c.record(Point{3, 2}, Dir::S, 950);
+    c.record(Point{5, 3}, Dir::W, 33);
+    TEST_ASSERT_TRUE(PersistentMemory::saveEdgeCosts(c));
+
+    EdgeCostMap other;
+    other.resize(4, 4);
+    TEST_ASSERT_FALSE(PersistentMemory::loadEdgeCosts(&other)); // dimensões divergentes
+
+    EdgeCostMap back;
+    back.resize(6, 4);
+    TEST_ASSERT_TRUE(PersistentMemory::loadEdgeCosts(&back));
+    TEST_ASSERT_EQUAL_UINT32(3, static_cast<uint32_t>(back.measured()));
+    for (size_t e = 0; e < c.raw().size(); ++e) TEST_ASSERT_EQUAL_UINT16(c.raw()[e], back.raw()[e]);
+    TEST_ASSERT_EQUAL_UINT8(c(cell(c, 2, 1), 0), back(cell(back, 2, 1), 0)); // mesma média de fallback
+
+    (void)PersistentMemory::eraseAll();
+    TEST_ASSERT_FALSE(PersistentMemory::loadEdgeCosts(&back));
+}
+
+/** @brief Linha y=1 de uma arena 7x3 aberta com travessias lentas (giros apertados, p.ex.). */
+static void slow_middle_row(EdgeCostMap& c) {
+    for (int x = 0; x < 6; ++x) c.record(Point{x, 1}, Dir::E, 900);
+    for (int x = 0; x < 6; ++x) c.record(Point{x, 0}, Dir::E, 100);
+    c.record(Point{0, 1}, Dir::N, 100);
+    c.record(Point{6, 0}, Dir::S, 100);
+}
+
+static void test_weighted_planning_avoids_slow_corridor() {
+    Navigator nav;
+    nav.setMapDimensions(7, 3);
+    nav.setStartGoal(Point{0, 1}, Point{6, 1});
+    slow_middle_row(nav.edgeCosts());
+
+    // Sem ponderação: reta pela linha do meio
+    TEST_ASSERT_TRUE(nav.planRoute());
+    TEST_ASSERT_EQUAL_UINT32(6, static_cast<uint32_t>(nav.currentPlan().moves()));
+
+    nav.setWeightedPlanning(true);
+    TEST_ASSERT_FALSE(nav.planValid());
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    const PathCode& p = nav.currentPlan();
+    TEST_ASSERT_EQUAL_UINT32(8, static_cast<uint32_t>(p.moves())); // N, 6×E, S: 800 ms contra 5400 ms
+    TEST_ASSERT_EQUAL_UINT8(0, p.move(0));
+    TEST_ASSERT_EQUAL_UINT8(2, p.move(7));
+
+    // Medições sobrevivem a um novo episódio no mesmo labirinto
+    nav.setMapDimensions(7, 3);
+    nav.setStartGoal(Point{0, 1}, Point{6, 1});
+    TEST_ASSERT_TRUE(nav.planRoute());
+    TEST_ASSERT_EQUAL_UINT32(8, static_cast<uint32_t>(nav.currentPlan().moves()));
+
+    // A parede que corta o desvio obriga a replanejar por outro lado
+    nav.map().set_wall(3, 0, Dir::E, true);
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    Point c = nav.currentPlan().start();
+    for (size_t i = 0; i < nav.currentPlan().moves(); ++i) {
+        const uint8_t d = nav.currentPlan().move(i);
+        TEST_ASSERT_FALSE(nav.map().has_wall(c.x, c.y, from_heading(d)));
+        c = step(c, from_heading(d));
+    }
+    TEST_ASSERT_TRUE(c.x == 6 && c.y == 1);
+}
+
+static void test_weighted_planning_sliced_avoids_slow_corridor() {
+    Navigator nav;
+    nav.setMapDimensions(7, 3);
+    nav.setStartGoal(Point{0, 1}, Point{6, 1});
+    slow_middle_row(nav.edgeCosts());
+    nav.setWeightedPlanning(true);
+
+    int calls = 0;
+    while (!nav.planValid() && calls < 1000) {
+        nav.planSliced(4);
+        TEST_ASSERT_TRUE(nav.anytimePlanner().lastWork() <= 4);
+        calls++;
+    }
+    TEST_ASSERT_TRUE(nav.planValid());
+    const PathCode& p = nav.currentPlan();
+    TEST_ASSERT_EQUAL_UINT32(8, static_cast<uint32_t>(p.moves())); // mesmo desvio do Dial
+    TEST_ASSERT_EQUAL_UINT8(0, p.move(0));
+    TEST_ASSERT_EQUAL_UINT8(2, p.move(7));
+
+    // Desligar a ponderação volta à reta pela linha do meio
+    nav.setWeightedPlanning(false);
+    calls = 0;
+    while (!nav.planValid() && calls < 1000) { nav.planSliced(4); calls++; }
+    TEST_ASSERT_EQUAL_UINT32(6, static_cast<uint32_t>(nav.currentPlan().moves()));
+}
+
+static void test_weighted_without_measurements_matches_bfs() {
+    Navigator nav;
+    nav.setWeightedPlanning(true);
+    nav.setMapDimensions(9, 9);
+    nav.setStartGoal(Point{0, 0}, Point{8, 8});
+    TEST_ASSERT_TRUE(nav.planRoute());
+    TEST_ASSERT_EQUAL_UINT32(16, static_cast<uint32_t>(nav.currentPlan().moves()));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ema_fixed_point);
+    RUN_TEST(test_unmeasured_edges_fall_back);
+    RUN_TEST(test_persistence_roundtrip);
+    RUN_TEST(test_weighted_planning_avoids_slow_corridor);
+    RUN_TEST(test_weighted_planning_sliced_avoids_slow_corridor);
+    RUN_TEST(test_weighted_without_measurements_matches_bfs);
+    return UNITY_END();
+}
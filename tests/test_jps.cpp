@@ -0,0 +1,149 @@
+/**
+ * @file tests/test_jps.cpp
+ * @brief Testes do Jump Point Search 4-conexo (`JumpPointSearch`, `Planner::jps_path`).
+ *
+ * Fuzz contra o BFS em arenas abertas com poucas paredes, labirintos braided e
+ * labirintos perfeitos: o comprimento do caminho deve ser igual e o caminho
+ * deve atravessar apenas passagens abertas. Imprime as expansões e o tempo de
+ * cada planejador para comparação.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R jps -V` (mostra o benchmark)
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/Planner.hpp"
+#include "core/JumpPointSearch.hpp"
+#include "maze_test_utils.hpp"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Arena aberta (apenas bordas) com `count` paredes internas aleatórias. */
+static MazeMap sparse_arena(int w, int h, std::mt19937& rng, int count) {
+    MazeMap m(w,h);
+    std::uniform_int_distribution<int> rx(0,w-1), ry(0,h-1), rd(0,3);
+    const char dirs[4] = {'N','E','S','W'};
+    for (int i=0;i<count;++i) m.set_wall(rx(rng), ry(rng), dirs[rd(rng)], true);
+    return m;
+}
+
+/** @brief Verifica contiguidade e passagens abertas ao longo do caminho. */
+static void assert_valid_path(const MazeMap& m, const std::vector<Point>& path, Point s, Point g) {
+    TEST_ASSERT_FALSE(path.empty());
+    TEST_ASSERT_TRUE(path.front().x == s.x && path.front().y == s.y);
+    TEST_ASSERT_TRUE(path.back().x == g.x && path.back().y == g.y);
+    for (size_t i=1;i<path.size();++i) {
+        const Point a = path[i-1], b = path[i];
+        TEST_ASSERT_EQUAL_INT(1, std::abs(a.x-b.x) + std::abs(a.y-b.y));
+        char dir = b.y < a.y ? 'N' : b.x > a.x ? 'E' : b.y > a.y ? 'S' : 'W';
+        TEST_ASSERT_FALSE(m.has_wall(a.x, a.y, dir));
+    }
+}
+
+/** @brief Compara JPS e BFS em `queries` pares aleatórios e acumula expansões/tempo. */
+static void compare(const MazeMap& m, std::mt19937& rng, int queries,
+                    long& bfs_exp, long& jps_exp, double& bfs_us, double& jps_us) {
+    std::uniform_int_distribution<int> rx(0,m.width()-1), ry(0,m.height()-1);
+    JumpPointSearch jps(m);
+    for (int q=0;q<queries;++q) {
+        Point s{rx(rng), ry(rng)}, g{rx(rng), ry(rng)};
+        int e1 = 0, e2 = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        auto a = Planner::bfs_path(m, s, g, nullptr, &e1);
+        auto t1 = std::chrono::steady_clock::now();
+        auto b = jps.find(s, g, &e2);
+        auto t2 = std::chrono::steady_clock::now();
+        bfs_us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        jps_us += std::chrono::duration<double, std::micro>(t2 - t1).count();
+        TEST_ASSERT_EQUAL(a.has_value(), b.has_value());
+        if (!a) continue;
+        TEST_ASSERT_EQUAL_INT((int)a->size(), (int)b->size());
+        assert_valid_path(m, *b, s, g);
+        bfs_exp += e1; jps_exp += e2;
+    }
+}
+
+static void report(const char* label, long bfs_exp, long jps_exp, double bfs_us, double jps_us) {
+    std::printf("[bench] %-8s expansoes BFS=%ld JPS=%ld | tempo BFS=%.0fus JPS=%.0fus\n",
+                label, bfs_exp, jps_exp, bfs_us, jps_us);
+}
+
+void test_sparse_arenas_match_bfs() {
+    long be = 0, je = 0; double bt = 0, jt = 0;
+    for (uint32_t seed=0; seed<30; ++seed) {
+        std::mt19937 rng(1000u + seed);
+        const int W = 8 + (int)(seed % 5) * 14; // inclui larguras > 64 (mais de uma palavra por linha)
+        MazeMap m = sparse_arena(W, 24, rng, W*24/12);
+        compare(m, rng, 20, be, je, bt, jt);
+    }
+    report("sparse", be, je, bt, jt);
+}
+
+void test_dense_random_walls_match_bfs() {
+    long be = 0, je = 0; double bt = 0, jt = 0;
+    for (uint32_t seed=0; seed<60; ++seed) {
+        std::mt19937 rng(2000u + seed);
+        MazeMap m = sparse_arena(12, 10, rng, 60 + (int)seed * 2);
+        compare(m, rng, 20, be, je, bt, jt);
+    }
+    report("dense", be, je, bt, jt);
+}
+
+void test_mazes_match_bfs() {
+    long be = 0, je = 0; double bt = 0, jt = 0;
+    for (uint32_t seed=0; seed<20; ++seed) {
+        std::mt19937 rng(3000u + seed);
+        MazeMap m(16,16); add_all_walls(m);
+        carve_maze_dfs(m, rng);
+        if (seed % 2) braid(m, rng, 40);
+        TEST_ASSERT_TRUE(JumpPointSearch(m).corridorMode()); // labirinto de corredores usa BFS sobre as máscaras
+        compare(m, rng, 10, be, je, bt, jt);
+    }
+    report("maze", be, je, bt, jt);
+}
+
+void test_open_room_few_expansions() {
+    MazeMap m(64,64);
+    TEST_ASSERT_FALSE(JumpPointSearch(m).corridorMode());
+    int expanded = 0;
+    auto p = Planner::jps_path(m, {0,0}, {63,63}, nullptr, &expanded);
+    TEST_ASSERT_TRUE(p.has_value());
+    TEST_ASSERT_EQUAL_INT(127, (int)p->size());
+    TEST_ASSERT_LESS_THAN(16, expanded);
+}
+
+void test_skip_mask_and_edge_cases() {
+    MazeMap m(5,5);
+    std::vector<uint8_t> skip(25, 0);
+    for (int y=0;y<4;++y) skip[y*5 + 2] = 1; // coluna x=2 bloqueada exceto embaixo
+    auto p = Planner::jps_path(m, {0,0}, {4,0}, &skip);
+    auto ref = Planner::bfs_path(m, {0,0}, {4,0}, &skip);
+    TEST_ASSERT_TRUE(p.has_value());
+    TEST_ASSERT_EQUAL_INT((int)ref->size(), (int)p->size());
+    for (const Point& q : *p) TEST_ASSERT_EQUAL_INT(0, skip[q.y*5 + q.x]);
+    // goal bloqueado, fora dos limites, start == goal
+    TEST_ASSERT_FALSE(Planner::jps_path(m, {0,0}, {2,1}, &skip).has_value());
+    TEST_ASSERT_FALSE(Planner::jps_path(m, {0,0}, {5,0}).has_value());
+    auto same = Planner::jps_path(m, {3,3}, {3,3});
+    TEST_ASSERT_TRUE(same.has_value());
+    TEST_ASSERT_EQUAL_INT(1, (int)same->size());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sparse_arenas_match_bfs);
+    RUN_TEST(test_dense_random_walls_match_bfs);
+    RUN_TEST(test_mazes_match_bfs);
+    RUN_TEST(test_open_room_few_expansions);
+    RUN_TEST(test_skip_mask_and_edge_cases);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ * @file tests/test_map_journal.cpp
+ * @brief Testes da geração e do journal de paredes do `MazeMap` e do `Connectivity::sync`.
+ *
+ * Verifica que a geração só avança quando uma parede de fato muda, que os dois
+ * lados da mesma parede têm o mesmo id de aresta, que `changesSince()` entrega
+ * as alterações em ordem e pede reconstrução quando o journal não cobre o
+ * intervalo (transbordo, `reset`, cópia, `touchAll`), que o `restore` do
+ * `Navigator` desfaz paredes pelo journal (sem pedir reconstrução) e que
+ * `Connectivity::sync` chega aos mesmos rótulos de uma reconstrução.
+ * O mesmo arquivo é compilado com `MAZE_MAP_JOURNAL=0` (`map_journal_off`):
+ * sem journal, qualquer mudança pede reconstrução.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R map_journal`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/Connectivity.hpp"
+#include "core/Navigator.hpp"
+#include <random>
+#include <vector>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+static void test_generation_advances_only_on_change() {
+    MazeMap m(4, 4);
+    const uint64_t g0 = m.generation();
+    m.set_wall(1, 1, Dir::E, false); // já aberta
+    TEST_ASSERT_TRUE(m.generation() == g0);
+    m.set_wall(1, 1, Dir::E, true);
+    TEST_ASSERT_TRUE(m.generation() == g0 + 1);
+    m.set_wall(2, 1, Dir::W, true); // mesma parede, já presente
+    TEST_ASSERT_TRUE(m.generation() == g0 + 1);
+    TEST_ASSERT_EQUAL_UINT32(m.edgeId(1, 1, Dir::E), m.edgeId(2, 1, Dir::W));
+    TEST_ASSERT_EQUAL_UINT32(m.edgeId(1, 2, Dir::S), m.edgeId(1, 3, Dir::N));
+    TEST_ASSERT_TRUE(m.edgeId(0, 0, Dir::N) != m.edgeId(0, 0, Dir::W)); // bordas na própria célula
+    const uint32_t e = m.edgeId(2, 1, Dir::W);
+    TEST_ASSERT_EQUAL_INT(1, m.edgeCell(e).x);
+    TEST_ASSERT_EQUAL_INT(1, m.edgeCell(e).y);
+    TEST_ASSERT_TRUE(MazeMap::edgeDir(e) == Dir::E);
+}
+
+static void test_changes_since_replays_in_order() {
+    MazeMap m(5, 5);
+    const uint64_t g0 = m.generation();
+    int calls = 0;
+    TEST_ASSERT_TRUE(m.changesSince(g0, [&](const WallEdit&) { calls++; }));
+    TEST_ASSERT_EQUAL_INT(0, calls);
+
+    m.set_wall(0, 0, Dir::S, true);
+    m.set_wall(3, 2, Dir::N, true);
+    const uint64_t g2 = m.generation();
+    m.set_wall(0, 1, Dir::N, false);
+
+    std::vector<WallEdit> seen;
+    const bool ok = m.changesSince(g0, [&](const WallEdit& w) { seen.push_back(w); });
+#if MAZE_MAP_JOURNAL
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_INT(3, static_cast<int>(seen.size()));
+    TEST_ASSERT_EQUAL_UINT32(m.edgeId(0, 0, Dir::S), seen[0].edge);
+    TEST_ASSERT_TRUE(!seen[0].old_value && seen[0].new_value);
+    TEST_ASSERT_EQUAL_UINT32(m.edgeId(3, 1, Dir::S), seen[1].edge);
+    TEST_ASSERT_EQUAL_UINT32(seen[0].edge, seen[2].edge);
+    TEST_ASSERT_TRUE(seen[2].old_value && !seen[2].new_value);
+    TEST_ASSERT_TRUE(seen[2].generation == m.generation());
+
+    seen.clear();
+    TEST_ASSERT_TRUE(m.changesSince(g2, [&](const WallEdit& w) { seen.push_back(w); }));
+    TEST_ASSERT_EQUAL_INT(1, static_cast<int>(seen.size()));
+#else
+    TEST_ASSERT_FALSE(ok);
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(seen.size()));
+    (void)g2;
+#endif
+}
+
+static void test_uncovered_intervals_request_rebuild() {
+    MazeMap m(32, 32);
+    const uint64_t g0 = m.generation();
+    // Mais alterações que a capacidade do journal
+    for (int i = 0; i <= MAZE_MAP_JOURNAL_SIZE; ++i) m.set_wall(i % 32, (i / 32) % 32, Dir::E, (i / 1024) % 2 == 0);
+    TEST_ASSERT_FALSE(m.changesSince(g0, [](const WallEdit&) {}));
+#if MAZE_MAP_JOURNAL
+    TEST_ASSERT_TRUE(m.changesSince(m.generation() - 1, [](const WallEdit&) {}));
+#endif
+
+    uint64_t g = m.generation();
+    m.touchAll();
+    TEST_ASSERT_FALSE(m.changesSince(g, [](const WallEdit&) {}));
+
+    g = m.generation();
+    m.reset(8, 8);
+    TEST_ASSERT_FALSE(m.changesSince(g, [](const WallEdit&) {}));
+    TEST_ASSERT_TRUE(m.changesSince(m.generation(), [](const WallEdit&) {}));
+
+    // Cópias e mapas novos nunca repetem a geração de outro mapa
+    MazeMap copy = m;
+    TEST_ASSERT_TRUE(copy.generation() != m.generation());
+    TEST_ASSERT_FALSE(copy.changesSince(m.generation(), [](const WallEdit&) {}));
+    // O anel não mora no objeto: copiar o mapa não copia os registros
+    TEST_ASSERT_TRUE(sizeof(MazeMap) < 128);
+    const uint64_t gc = copy.generation();
+    copy.set_wall(1, 1, Dir::E, true);
+    std::vector<WallEdit> seen;
+    const bool copied_ok = copy.changesSince(gc, [&](const WallEdit& w) { seen.push_back(w); });
+#if MAZE_MAP_JOURNAL
+    TEST_ASSERT_TRUE(copied_ok);
+    TEST_ASSERT_EQUAL_INT(1, static_cast<int>(seen.size()));
+    TEST_ASSERT_EQUAL_UINT32(copy.edgeId(1, 1, Dir::E), seen[0].edge);
+#else
+    TEST_ASSERT_FALSE(copied_ok);
+#endif
+    const uint64_t before = m.generation();
+    m = MazeMap(8, 8);
+    TEST_ASSERT_TRUE(m.generation() != before);
+    TEST_ASSERT_FALSE(m.changesSince(before, [](const WallEdit&) {}));
+}
+
+static void test_connectivity_sync_matches_rebuild() {
+    const int W = 12, H = 12;
+    MazeMap m(W, H);
+    Connectivity incremental, fresh;
+    incremental.rebuild(m);
+    std::mt19937 rng(7);
+    for (int round = 0; round < 40; ++round) {
+        for (int k = 0; k < 6; ++k) {
+            const int x = static_cast<int>(rng() % W), y = static_cast<int>(rng() % H);
+            m.set_wall(x, y, static_cast<Dir>(rng() % 4), (rng() % 3) == 0);
+        }
+        incremental.sync(m);
+        fresh.rebuild(m);
+        TEST_ASSERT_EQUAL_INT(fresh.componentCount(m), incremental.componentCount(m));
+        const Point a{static_cast<int>(rng() % W), static_cast<int>(rng() % H)};
+        const Point b{static_cast<int>(rng() % W), static_cast<int>(rng() % H)};
+        TEST_ASSERT_EQUAL(fresh.connected(m, a, b), incremental.connected(m, a, b));
+    }
+}
+
+static void test_navigator_restore_goes_through_journal() {
+    Navigator nav;
+    nav.setMapDimensions(6, 6);
+    nav.setStartGoal(Point{0, 0}, Point{5, 5});
+    const Navigator& cnav = nav;
+    const Navigator::Snapshot s = nav.snapshot();
+    SensorRead sr; sr.left_free = false; sr.front_free = true; sr.right_free = false;
+    const uint64_t g0 = cnav.map().generation();
+    nav.observeCellWalls(Point{2, 2}, sr, 0); // paredes W e E de (2,2)
+    const uint64_t g = cnav.map().generation();
+    nav.restore(s);
+    nav.release(s);
+    // O restore desfaz pelo set_wall: as mesmas arestas, na ordem inversa, sem pedir reconstrução
+    std::vector<WallEdit> undone;
+    const bool ok = cnav.map().changesSince(g, [&](const WallEdit& w) { undone.push_back(w); });
+#if MAZE_MAP_JOURNAL
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_INT(2, static_cast<int>(undone.size()));
+    TEST_ASSERT_EQUAL_UINT32(cnav.map().edgeId(2, 2, Dir::E), undone[0].edge);
+    TEST_ASSERT_EQUAL_UINT32(cnav.map().edgeId(2, 2, Dir::W), undone[1].edge);
+    for (const WallEdit& w : undone) TEST_ASSERT_TRUE(w.old_value && !w.new_value);
+    TEST_ASSERT_TRUE(cnav.map().changesSince(g0, [](const WallEdit&) {}));
+#else
+    TEST_ASSERT_FALSE(ok);
+    (void)g0;
+#endif
+    TEST_ASSERT_FALSE(cnav.map().has_wall(2, 2, Dir::E));
+    TEST_ASSERT_FALSE(cnav.map().has_wall(2, 2, Dir::W));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_generation_advances_only_on_change);
+    RUN_TEST(test_changes_since_replays_in_order);
+    RUN_TEST(test_uncovered_intervals_request_rebuild);
+    RUN_TEST(test_connectivity_sync_matches_rebuild);
+    RUN_TEST(test_navigator_restore_goes_through_journal);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+/**
+ * @file tests/test_map_snapshot.cpp
+ * @brief Testes das versões imutáveis do mapa (`MapPublisher`, `MapVersion`).
+ *
+ * Verifica que uma versão publicada reproduz o `MazeMap` (paredes, geração,
+ * `copyTo`), que só os ladrilhos alterados são copiados e que uma versão
+ * fixada não muda quando o escritor publica outras, que versões aposentadas
+ * só são liberadas depois que o último leitor solta o `Pin`, que mudanças sem
+ * journal ainda compartilham ladrilhos iguais, e, com threads, que leitores
+ * sempre veem um estado consistente entre ladrilhos enquanto o escritor segue.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R map_snapshot`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/MapSnapshot.hpp"
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Conta as diferenças entre a versão e o mapa (paredes nos quatro lados). */
+static int mismatches(const MapVersion& v, const MazeMap& m) {
+    if (v.width() != m.width() || v.height() != m.height()) return -1;
+    int bad = 0;
+    for (int y = -1; y <= m.height(); ++y)
+        for (int x = -1; x <= m.width(); ++x)
+            for (int d = 0; d < 4; ++d)
+                if (v.has_wall(x, y, static_cast<Dir>(d)) != m.has_wall(x, y, static_cast<Dir>(d))) bad++;
+    return bad;
+}
+
+static void random_walls(MazeMap& m, std::mt19937& rng, int n) {
+    for (int k = 0; k < n; ++k)
+        m.set_wall(static_cast<int>(rng() % m.width()), static_cast<int>(rng() % m.height()),
+                   static_cast<Dir>(rng() % 4), (rng() % 2) == 0);
+}
+
+static void test_published_version_matches_map() {
+    MapPublisher pub;
+    MapPublisher::Reader rd = pub.reader();
+    TEST_ASSERT_FALSE(static_cast<bool>(rd.pin())); // nada publicado
+    MazeMap m(37, 21); // não múltiplo do ladrilho
+    std::mt19937 rng(3);
+    random_walls(m, rng, 400);
+    TEST_ASSERT_TRUE(pub.publish(m));
+    TEST_ASSERT_FALSE(pub.publish(m)); // mesma geração
+    MapPublisher::Pin p = rd.pin();
+    TEST_ASSERT_TRUE(static_cast<bool>(p));
+    TEST_ASSERT_EQUAL_INT(0, mismatches(*p, m));
+    TEST_ASSERT_TRUE(p->generation() == m.generation());
+    MazeMap copy(1, 1);
+    p->copyTo(copy);
+    TEST_ASSERT_EQUAL_STRING(m.to_string_ascii().c_str(), copy.to_string_ascii().c_str());
+}
+
+static void test_only_changed_tiles_are_copied() {
+    MapPublisher pub;
+    MapPublisher::Reader rd = pub.reader();
+    MazeMap m(48, 48); // 3×3 ladrilhos
+    pub.publish(m);
+    MapPublisher::Pin old = rd.pin();
+    const MapVersion* v0 = old.get();
+
+    // Parede entre (15,20) e (16,20): dois ladrilhos da linha 1
+    m.set_wall(15, 20, Dir::E, true);
+    pub.publish(m);
+    MapPublisher::Reader rd2 = pub.reader();
+    MapPublisher::Pin now = rd2.pin();
+    int shared = 0;
+    for (int ty = 0; ty < 3; ++ty)
+        for (int tx = 0; tx < 3; ++tx) shared += (now->tile(tx, ty) == v0->tile(tx, ty));
+    TEST_ASSERT_EQUAL_INT(7, shared);
+    TEST_ASSERT_TRUE(now->tile(0, 1) != v0->tile(0, 1));
+    TEST_ASSERT_TRUE(now->tile(1, 1) != v0->tile(1, 1));
+    TEST_ASSERT_TRUE(now->has_wall(16, 20, Dir::W));
+    // A versão fixada antes continua como era
+    TEST_ASSERT_FALSE(v0->has_wall(15, 20, Dir::E));
+    TEST_ASSERT_EQUAL_INT(0, mismatches(*now, m));
+}
+
+static void test_retired_versions_wait_for_last_reader() {
+    MapPublisher pub;
+    MapPublisher::Reader a = pub.reader();
+    MapPublisher::Reader b = pub.reader();
+    MazeMap m(20, 20);
+    pub.publish(m);
+    MapPublisher::Pin pa = a.pin();
+    m.set_wall(1, 1, Dir::S, true);
+    pub.publish(m);
+    MapPublisher::Pin pb = b.pin(); // vê a segunda versão
+    for (int i = 0; i < 3; ++i) { m.set_wall(2 + i, 2, Dir::E, true); pub.publish(m); }
+    TEST_ASSERT_EQUAL_INT(4, static_cast<int>(pub.retiredCount()));
+    TEST_ASSERT_FALSE(pa->has_wall(1, 1, Dir::S));
+    TEST_ASSERT_TRUE(pb->has_wall(1, 1, Dir::S));
+
+    pa.release();
+    pub.collect();
+    // A primeira saiu; as que `b` pode ter visto esperam por ele
+    TEST_ASSERT_EQUAL_INT(3, static_cast<int>(pub.retiredCount()));
+    TEST_ASSERT_TRUE(pb->has_wall(1, 1, Dir::S));
+    pb.release();
+    pub.collect();
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(pub.retiredCount()));
+
+    // Registros de leitores destruídos são reaproveitados
+    { MapPublisher::Reader tmp = pub.reader(); MapPublisher::Pin p = tmp.pin(); TEST_ASSERT_TRUE(static_cast<bool>(p)); }
+    m.set_wall(9, 9, Dir::N, true);
+    pub.publish(m);
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(pub.retiredCount()));
+}
+
+static void test_bulk_change_rebuilds_and_shares_equal_tiles() {
+    MapPublisher pub;
+    MapPublisher::Reader rd = pub.reader();
+    MazeMap m(40, 40);
+    std::mt19937 rng(11);
+    random_walls(m, rng, 300);
+    pub.publish(m);
+    MapPublisher::Reader keep = pub.reader();
+    MapPublisher::Pin hold = keep.pin(); // mantém a versão viva para comparar ponteiros
+    const MapVersion* before = hold.get();
+
+    // Escrita direta + touchAll: sem journal, mas só um ladrilho mudou de fato
+    m.at(35, 35).wall_n = !m.at(35, 35).wall_n;
+    m.touchAll();
+    TEST_ASSERT_TRUE(pub.publish(m));
+    MapPublisher::Pin p1 = rd.pin();
+    TEST_ASSERT_EQUAL_INT(0, mismatches(*p1, m));
+    TEST_ASSERT_TRUE(p1->tile(0, 0) == before->tile(0, 0));
+    TEST_ASSERT_TRUE(p1->tile(2, 2) != before->tile(2, 2));
+
+    // Outro tamanho: tudo refeito
+    m.reset(10, 7);
+    random_walls(m, rng, 50);
+    pub.publish(m);
+    p1.release();
+    MapPublisher::Pin p2 = rd.pin();
+    TEST_ASSERT_EQUAL_INT(0, mismatches(*p2, m));
+}
+
+static void test_concurrent_readers_see_consistent_versions() {
+    // O escritor grava o contador n em binário nas paredes E da linha 0 e da
+    // linha 31 (ladrilhos diferentes): uma versão consistente tem os dois iguais.
+    const int W = 32, H = 32, kBits = 30;
+    const uint32_t kVersions = 3000;
+    MapPublisher pub;
+    MazeMap m(W, H);
+    pub.publish(m);
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0}, backwards{0}, reads{0};
+    auto decode = [&](const MapVersion& v, int row) {
+        uint32_t n = 0;
+        for (int b = 0; b < kBits; ++b) if (v.has_wall(b, row, Dir::E)) n |= 1u << b;
+        return n;
+    };
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            MapPublisher::Reader rd = pub.reader();
+            uint32_t last = 0;
+            while (!done.load()) {
+                MapPublisher::Pin p = rd.pin();
+                const uint32_t top = decode(*p, 0), bottom = decode(*p, H - 1);
+                if (top != bottom) torn++;
+                if (top < last) backwards++;
+                last = top;
+                reads++;
+            }
+        });
+    }
+    for (uint32_t n = 1; n <= kVersions; ++n) {
+        for (int b = 0; b < kBits; ++b) {
+            m.set_wall(b, 0, Dir::E, (n >> b) & 1u);
+            m.set_wall(b, H - 1, Dir::E, (n >> b) & 1u);
+        }
+        pub.publish(m);
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+    pub.collect();
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+    TEST_ASSERT_TRUE(reads.load() > 0);
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(pub.retiredCount()));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_published_version_matches_map);
+    RUN_TEST(test_only_changed_tiles_are_copied);
+    RUN_TEST(test_retired_versions_wait_for_last_reader);
+    RUN_TEST(test_bulk_change_rebuilds_and_shares_equal_tiles);
+    RUN_TEST(test_concurrent_readers_see_consistent_versions);
+    return UNITY_END();
+}
@@ -0,0 +1,77 @@
+/**
+ * @file tests/test_maze_analyzer.cpp
+ * @brief Testes do `MazeAnalyzer` (histograma de graus, laços, caminho ótimo e curvas).
+ *
+ * Usa mapas pequenos montados à mão, cujas métricas são conhecidas, e
+ * labirintos perfeitos aleatórios (árvores: zero laços, uma componente).
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R maze_analyzer`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/MazeAnalyzer.hpp"
+#include "core/Planner.hpp"
+#include "maze_test_utils.hpp"
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+void test_open_room_histogram_and_loops() {
+    MazeMap m(3,3); // sem paredes internas
+    MazeStats st = MazeAnalyzer::analyze(m, {0,0}, {2,2});
+    TEST_ASSERT_EQUAL_INT(0, st.dead_ends);
+    TEST_ASSERT_EQUAL_INT(4, st.corridors);   // cantos
+    TEST_ASSERT_EQUAL_INT(4, st.curves);      // cantos são curvas
+    TEST_ASSERT_EQUAL_INT(4, st.t_junctions); // meios das bordas
+    TEST_ASSERT_EQUAL_INT(1, st.crossroads);  // centro
+    TEST_ASSERT_EQUAL_INT(12, st.edges);
+    TEST_ASSERT_EQUAL_INT(1, st.components);
+    TEST_ASSERT_EQUAL_INT(4, st.loops);       // 12 - 9 + 1
+    TEST_ASSERT_EQUAL_INT(4, st.shortest_path);
+    TEST_ASSERT_EQUAL_INT(4, st.longest_path);
+}
+
+void test_l_shaped_corridor_turns() {
+    // Corredor em L: (0,0)->(1,0)->(2,0)->(2,1)->(2,2)
+    MazeMap m(3,3);
+    add_all_walls(m);
+    m.set_wall(0,0,'E',false); m.set_wall(1,0,'E',false);
+    m.set_wall(2,0,'S',false); m.set_wall(2,1,'S',false);
+    MazeStats st = MazeAnalyzer::analyze(m, {0,0}, {2,2});
+    TEST_ASSERT_EQUAL_INT(4, st.shortest_path);
+    TEST_ASSERT_EQUAL_INT(1, st.optimal_turns);
+    TEST_ASSERT_EQUAL_INT(2, st.dead_ends);
+    TEST_ASSERT_EQUAL_INT(1, st.curves);
+    TEST_ASSERT_EQUAL_INT(4, st.isolated);
+    TEST_ASSERT_EQUAL_INT(5, st.components); // corredor + 4 células isoladas
+    TEST_ASSERT_EQUAL_INT(0, st.loops);
+}
+
+void test_perfect_mazes_are_trees() {
+    for (uint32_t seed=0; seed<5; ++seed) {
+        const int W=12, H=9;
+        MazeMap m = gen_perfect_maze(W,H, 4200u + seed);
+        MazeStats st = MazeAnalyzer::analyze(m, {0,0}, {W-1,H-1});
+        TEST_ASSERT_EQUAL_INT(0, st.loops);
+        TEST_ASSERT_EQUAL_INT(1, st.components);
+        TEST_ASSERT_EQUAL_INT(W*H - 1, st.edges);
+        TEST_ASSERT_EQUAL_INT(W*H, st.isolated + st.dead_ends + st.corridors + st.t_junctions + st.crossroads);
+        auto path = Planner::bfs_path(m, {0,0}, {W-1,H-1});
+        TEST_ASSERT_EQUAL_INT((int)path->size() - 1, st.shortest_path);
+        TEST_ASSERT_GREATER_OR_EQUAL(st.shortest_path, st.longest_path);
+    }
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_open_room_histogram_and_loops);
+    RUN_TEST(test_l_shaped_corridor_turns);
+    RUN_TEST(test_perfect_mazes_are_trees);
+    return UNITY_END();
+}
@@ -0,0 +1,135 @@
+/**
+ * @file tests/test_mcts.cpp
+ * @brief Testes do modo de decisão MCTS (`MctsPlanner`, `Navigator::decideMcts`).
+ *
+ * Verifica o prior de parede das estatísticas, o corte pelo orçamento (com
+ * relógio simulado), o determinismo com número fixo de iterações, que a busca
+ * não altera o navegador e que o agente chega ao objetivo; imprime os passos
+ * em comparação com `decidePlanned()`.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R mcts`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/MazeMap.hpp"
+#include "core/Navigator.hpp"
+#include "core/Mcts.hpp"
+#include "maze_test_utils.hpp"
+#include <vector>
+#include <random>
+#include <cstdio>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+static uint32_t fake_now = 0;
+/** @brief Relógio simulado: cada leitura avança 50 µs. */
+static uint32_t fake_clock() { fake_now += 50; return fake_now; }
+
+void test_prior_from_stats() {
+    std::mt19937 rng(85u);
+    MazeMap m(8,8);
+    add_all_walls(m);
+    carve_maze_dfs(m, rng);
+    const MazeStats st = MazeAnalyzer::analyze(m, {0,0}, {7,7});
+    // Labirinto perfeito 8x8: 63 passagens em 112 arestas internas
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f - 63.0f / 112.0f, MctsPlanner::priorFromStats(st));
+}
+
+void test_budget_stops_search() {
+    MazeMap m(16,16);
+    std::vector<uint8_t> known(16*16, 0);
+    known[0] = 1;
+    MctsPlanner mcts;
+    MctsConfig cfg;
+    cfg.budget_us = 1000;
+    cfg.clock_us = fake_clock;
+    const MctsPlanner::Result r = mcts.search(m, known.data(), {0,0}, Dir::E, {15,15}, cfg);
+    TEST_ASSERT_TRUE(r.iterations > 0);
+    TEST_ASSERT_TRUE(r.dir == 1 || r.dir == 2);
+    // O relógio é consultado a cada poucas iterações: o corte fica perto do orçamento
+    TEST_ASSERT_TRUE(r.elapsed_us >= 1000 && r.elapsed_us <= 1200);
+    TEST_ASSERT_TRUE(r.nodes <= cfg.max_nodes);
+}
+
+void test_fixed_iterations_are_deterministic() {
+    std::mt19937 rng(850u);
+    MazeMap truth(12,12);
+    add_all_walls(truth);
+    carve_maze_dfs(truth, rng);
+    MctsConfig cfg;
+    cfg.budget_us = 0;
+    cfg.max_iterations = 400;
+    MctsPlanner::Result a, b;
+    for (int k = 0; k < 2; ++k) {
+        Navigator nav;
+        nav.setMapDimensions(12,12);
+        nav.setStartGoal({0,0}, {11,11});
+        const SensorRead sr = make_sensor_read(truth, {0,0}, 1);
+        nav.observeCellWalls({0,0}, sr, 1);
+        nav.decideMcts({0,0}, 1, sr, cfg, k == 0 ? &a : &b);
+    }
+    TEST_ASSERT_EQUAL_INT(400, (int)a.iterations);
+    TEST_ASSERT_EQUAL_INT(a.dir, b.dir);
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, a.expected_cost, b.expected_cost);
+    TEST_ASSERT_EQUAL_INT((int)a.nodes, (int)b.nodes);
+}
+
+void test_mcts_reaches_goal() {
+    const int W = 16, H = 16;
+    long planned = 0, mcts = 0;
+    double iters = 0.0;
+    int decisions = 0;
+    MctsConfig cfg;
+    cfg.budget_us = 0;
+    cfg.max_iterations = 300;
+    for (uint32_t seed = 0; seed < 6; ++seed) {
+        std::mt19937 rng(7000u + seed);
+        MazeMap m(W,H);
+        add_all_walls(m);
+        carve_maze_dfs(m, rng);
+        braid(m, rng, 10);
+        for (int mode = 0; mode < 2; ++mode) {
+            Navigator nav;
+            nav.setMapDimensions(W,H);
+            nav.setStartGoal({0,0}, {W-1,H-1});
+            Point agent{0,0};
+            uint8_t heading = 1;
+            int steps = 0;
+            while (steps < W * H * 20 && !(agent.x == W-1 && agent.y == H-1)) {
+                const SensorRead sr = make_sensor_read(m, agent, heading);
+                nav.observeCellWalls(agent, sr, heading);
+                nav.planRoute();
+                Decision d;
+                if (mode == 0) {
+                    d = nav.decidePlanned(agent, heading, sr);
+                } else {
+                    const uint8_t seen_before = nav.seenCount(agent.x, agent.y);
+                    MctsPlanner::Result r;
+                    d = nav.decideMcts(agent, heading, sr, cfg, &r);
+                    TEST_ASSERT_EQUAL_INT(seen_before, nav.seenCount(agent.x, agent.y));
+                    iters += r.iterations;
+                    decisions++;
+                }
+                apply_move(agent, heading, d.action);
+                steps++;
+            }
+            TEST_ASSERT_TRUE_MESSAGE(agent.x == W-1 && agent.y == H-1, "Agent failed to reach goal");
+            (mode == 0 ? planned : mcts) += steps;
+        }
+    }
+    std::printf("passos: planned=%ld mcts=%ld (%.0f iteracoes/decisao)\n",
+                planned, mcts, decisions ? iters / decisions : 0.0);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_prior_from_stats);
+    RUN_TEST(test_budget_stops_search);
+    RUN_TEST(test_fixed_iterations_are_deterministic);
+    RUN_TEST(test_mcts_reaches_goal);
+    return UNITY_END();
+}
@@ -4,7 +4,11 @@
  *
  * Garante que quando a orientação atual coincide com o próximo passo do plano,
  * a ação seja `Forward`, e que giros relativos corretos sejam escolhidos quando
- * necessário para alinhar com o plano.
+ * necessário para alinhar com o plano. Cobre também `planIfInvalid()`: paredes
+ * fora do plano não replanejam, paredes que cortam o plano sim, e numa
+ * exploração completa o comprimento do plano é o mesmo de replanejar a cada
+ * passo, com menos chamadas ao planejador. Paredes alteradas por `map()` são
+ * conferidas pela geração do mapa, não no acesso.
  *
  * Como executar:
  * - Via CTest: `ctest -R test_navigator_planned`
@@ -12,6 +16,10 @@
  */
 #include "unity.h"
 #include "core/Navigator.hpp"
+#include "maze_test_utils.hpp"
+#include <cstdio>
+#include <random>
+#include <vector>
 
 using namespace maze;
 
@@ -44,9 +52,147 @@ void test_decidePlanned_turns_right_when_needed() {
     TEST_ASSERT_EQUAL_UINT8((uint8_t)Action::Right, (uint8_t)d.action);
 }
 
+void test_planIfInvalid_ignores_walls_off_the_plan() {
+    Navigator nav;
+    nav.setMapDimensions(4,3);
+    nav.setStartGoal({0,0},{3,0});
+    TEST_ASSERT_TRUE(nav.planIfInvalid());          // primeiro: planeja
+    TEST_ASSERT_EQUAL_INT(3, (int)nav.currentPlan().moves());
+    // Em (1,1) olhando para leste: só a parede sul aparece, fora do plano
+    SensorRead sr; sr.left_free = true; sr.front_free = true; sr.right_free = false; // heading E: direita = S
+    WallChanges ch = nav.observeCellWalls({1,1}, sr, 1);
+    TEST_ASSERT_EQUAL_UINT8(1u << idx(Dir::S), ch.added);
+    TEST_ASSERT_EQUAL_UINT8(0, ch.removed);
+    TEST_ASSERT_TRUE(nav.planValid());
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    TEST_ASSERT_EQUAL_UINT32(2u, nav.planStats().requests);
+    TEST_ASSERT_EQUAL_UINT32(1u, nav.planStats().replans);
+
+    // Parede que corta o plano (leste de (1,0)) invalida e força novo caminho
+    sr.left_free = false; sr.front_free = false; sr.right_free = true; // heading E: esquerda N, frente E
+    ch = nav.observeCellWalls({1,0}, sr, 1);
+    TEST_ASSERT_TRUE((ch.added & (1u << idx(Dir::E))) != 0);
+    TEST_ASSERT_FALSE(nav.planValid());
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    TEST_ASSERT_EQUAL_UINT32(2u, nav.planStats().replans);
+    TEST_ASSERT_EQUAL_INT(5, (int)nav.currentPlan().moves());
+}
+
+void test_planIfInvalid_opening_uses_bound() {
+    Navigator nav;
+    nav.setMapDimensions(3,3);
+    nav.setStartGoal({0,0},{2,0});
+    // Parede E de (0,0): rota contorna por (0,1),(1,1),(1,0). Parede E de (1,2), longe do atalho
+    nav.map().set_wall(0,0,Dir::E,true);
+    nav.map().set_wall(1,2,Dir::E,true);
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    TEST_ASSERT_EQUAL_INT(4, (int)nav.currentPlan().moves());
+    SensorRead sr; sr.left_free = true; sr.front_free = true; sr.right_free = true;
+    // Abrir E de (1,2): qualquer rota por ali mede >= 3+1+2 = 6 > 4, plano continua válido
+    WallChanges ch = nav.observeCellWalls({1,2}, sr, 1);
+    TEST_ASSERT_EQUAL_UINT8(1u << idx(Dir::E), ch.removed);
+    TEST_ASSERT_TRUE(nav.planValid());
+    // Abrir E de (0,0) permite caminho mais curto: invalida
+    nav.observeCellWalls({0,0}, sr, 1);
+    TEST_ASSERT_FALSE(nav.planValid());
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    TEST_ASSERT_EQUAL_INT(2, (int)nav.currentPlan().moves());
+}
+
+void test_planIfInvalid_matches_replan_every_step() {
+    std::mt19937 rng(9101u);
+    long requests = 0, replans = 0;
+    for (int trial = 0; trial < 20; ++trial) {
+        const int W = 6 + static_cast<int>(rng() % 14), H = 6 + static_cast<int>(rng() % 14);
+        MazeMap m(W,H);
+        add_all_walls(m);
+        carve_maze_dfs(m, rng);
+        for (int i = 0; i < W; ++i) m.set_wall(static_cast<int>(rng() % (W-1)), static_cast<int>(rng() % H), Dir::E, false);
+        Navigator lazy, eager;
+        for (Navigator* n : {&lazy, &eager}) { n->setMapDimensions(W,H); n->setStartGoal({0,0},{W-1,H-1}); }
+        Point agent{0,0};
+        uint8_t heading = 1;
+        int steps = 0;
+        while (steps < W * H * 20 && !(agent.x == W-1 && agent.y == H-1)) {
+            const SensorRead sr = make_sensor_read(m, agent, heading);
+            lazy.observeCellWalls(agent, sr, heading);
+            eager.observeCellWalls(agent, sr, heading);
+            TEST_ASSERT_TRUE(lazy.planIfInvalid());
+            TEST_ASSERT_TRUE(eager.planRoute());
+            // Plano guardado continua ótimo: mesmo comprimento do BFS novo
+            TEST_ASSERT_EQUAL_INT((int)eager.currentPlan().moves(), (int)lazy.currentPlan().moves());
+            const Decision d = lazy.decidePlanned(agent, heading, sr);
+            const Dir h = from_heading(heading);
+            if (d.action == Action::Forward) agent = step(agent, h);
+            else heading = idx(rel_to_abs(h, d.action));
+            steps++;
+        }
+        TEST_ASSERT_TRUE_MESSAGE(agent.x == W-1 && agent.y == H-1, "Agent failed to reach goal");
+        requests += lazy.planStats().requests;
+        replans += lazy.planStats().replans;
+    }
+    std::printf("planIfInvalid: %ld replanejamentos em %ld chamadas\n", replans, requests);
+    TEST_ASSERT_TRUE(replans * 2 < requests);
+}
+
+void test_planIfInvalid_restored_by_snapshot() {
+    Navigator nav;
+    nav.setMapDimensions(4,3);
+    nav.setStartGoal({0,0},{3,0});
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    const Navigator::Snapshot s = nav.snapshot();
+    SensorRead sr; sr.left_free = false; sr.front_free = false; sr.right_free = true;
+    nav.observeCellWalls({1,0}, sr, 1); // corta o plano
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    TEST_ASSERT_EQUAL_INT(5, (int)nav.currentPlan().moves());
+    nav.restore(s);
+    nav.release(s);
+    TEST_ASSERT_TRUE(nav.planValid());
+    TEST_ASSERT_EQUAL_INT(3, (int)nav.currentPlan().moves());
+    // As arestas marcadas voltaram a ser as do plano restaurado
+    nav.observeCellWalls({1,1}, sr, 1); // paredes N/E de (1,1): fora do plano
+    TEST_ASSERT_TRUE(nav.planValid());
+    sr.left_free = true; sr.front_free = false; sr.right_free = true;
+    nav.observeCellWalls({2,0}, sr, 1); // parede E de (2,0): no plano
+    TEST_ASSERT_FALSE(nav.planValid());
+}
+
+void test_planIfInvalid_external_map_edits() {
+    Navigator nav;
+    nav.setMapDimensions(4,3);
+    nav.setStartGoal({0,0},{3,0});
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    // Acesso mutável sem alteração (ex.: salvar o mapa) não descarta o plano
+    TEST_ASSERT_EQUAL_INT(4, nav.map().width());
+    TEST_ASSERT_TRUE(nav.planValid());
+    // Parede fora do plano: com journal, continua válido depois de conferir
+    nav.map().set_wall(1,2,Dir::E,true);
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+#if MAZE_MAP_JOURNAL
+    TEST_ASSERT_EQUAL_UINT32(1u, nav.planStats().replans);
+#endif
+    // Parede que corta o plano: invalida e replaneja
+    nav.map().set_wall(1,0,Dir::E,true);
+    TEST_ASSERT_FALSE(nav.planValid());
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    TEST_ASSERT_EQUAL_INT(5, (int)nav.currentPlan().moves());
+    // Mapa substituído por inteiro (sem journal): tudo é refeito
+    MazeMap closed(4,3);
+    closed.set_wall(0,0,Dir::E,true);
+    closed.set_wall(0,0,Dir::S,true);
+    nav.map() = closed;
+    TEST_ASSERT_FALSE(nav.isGoalReachable());
+    TEST_ASSERT_FALSE(nav.planIfInvalid());
+}
+
 int main(int, char**) {
     UNITY_BEGIN();
     RUN_TEST(test_decidePlanned_follows_forward_when_heading_matches);
     RUN_TEST(test_decidePlanned_turns_right_when_needed);
+    RUN_TEST(test_planIfInvalid_ignores_walls_off_the_plan);
+    RUN_TEST(test_planIfInvalid_opening_uses_bound);
+    RUN_TEST(test_planIfInvalid_matches_replan_every_step);
+    RUN_TEST(test_planIfInvalid_restored_by_snapshot);
+    RUN_TEST(test_planIfInvalid_external_map_edits);
     return UNITY_END();
 }
@@ -0,0 +1,211 @@
+/**
+ * @file tests/test_navigator_snapshot.cpp
+ * @brief Testes de snapshot/restore do `Navigator` (log de desfazer) e do modo `decideRollout`.
+ *
+ * Verifica que `restore()` devolve mapa, visitas, plano, poda e heurísticas
+ * ao estado capturado (inclusive com snapshots aninhados) e que os rollouts
+ * não alteram o navegador e levam o agente ao objetivo. O giro comprometido
+ * por `decideRollout` vale só para a decisão seguinte e cai com `setStartGoal`.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R navigator_snapshot`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/MazeMap.hpp"
+#include "core/Navigator.hpp"
+#include "maze_test_utils.hpp"
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Estado observável do navegador, para comparação. */
+struct NavState {
+    std::vector<uint8_t> walls;
+    std::vector<uint8_t> seen;
+    std::vector<Point> plan;
+    std::vector<uint8_t> pruned;
+    Heuristics heur;
+};
+
+static NavState capture(const Navigator& nav) {
+    NavState s;
+    const MazeMap& m = nav.map();
+    for (int y=0;y<m.height();++y) {
+        for (int x=0;x<m.width();++x) {
+            const Cell& c = m.at(x,y);
+            s.walls.push_back(static_cast<uint8_t>(c.wall_n | (c.wall_e << 1) | (c.wall_s << 2) | (c.wall_w << 3)));
+            s.seen.push_back(nav.seenCount(x,y));
+        }
+    }
+    s.plan = nav.currentPlan().toPoints();
+    s.pruned = nav.prunedCells();
+    s.heur = nav.heuristics();
+    return s;
+}
+
+static void assert_same(const NavState& a, const NavState& b) {
+    TEST_ASSERT_TRUE(a.walls == b.walls);
+    TEST_ASSERT_TRUE(a.seen == b.seen);
+    TEST_ASSERT_TRUE(a.pruned == b.pruned);
+    TEST_ASSERT_EQUAL_INT((int)a.plan.size(), (int)b.plan.size());
+    for (size_t i = 0; i < a.plan.size(); ++i) {
+        TEST_ASSERT_EQUAL_INT(a.plan[i].x, b.plan[i].x);
+        TEST_ASSERT_EQUAL_INT(a.plan[i].y, b.plan[i].y);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, a.heur.w_right, b.heur.w_right);
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, a.heur.w_front, b.heur.w_front);
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, a.heur.w_left, b.heur.w_left);
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, a.heur.w_back, b.heur.w_back);
+}
+
+/** @brief Altera o navegador com observações aleatórias, planos, poda e recompensas. */
+static void scramble(Navigator& nav, std::mt19937& rng, int steps) {
+    const Navigator& cnav = nav; // só leitura do mapa
+    const int w = cnav.map().width(), h = cnav.map().height();
+    for (int i = 0; i < steps; ++i) {
+        Point p{static_cast<int>(rng() % w), static_cast<int>(rng() % h)};
+        SensorRead sr{ (rng() & 1) != 0, (rng() & 1) != 0, (rng() & 1) != 0 };
+        nav.observeCellWalls(p, sr, static_cast<uint8_t>(rng() & 3));
+        if (i % 7 == 0) nav.planRoute();
+        if (i % 11 == 0) nav.pruneDeadEnds();
+        if (i % 5 == 0) nav.applyReward(static_cast<Action>(rng() & 3), 1.0f);
+    }
+}
+
+void test_restore_undoes_changes() {
+    const int W = 10, H = 10;
+    std::mt19937 rng(84u);
+    Navigator nav;
+    nav.setMapDimensions(W,H);
+    nav.setStartGoal({0,0}, {W-1,H-1});
+    scramble(nav, rng, 40);
+    nav.planRoute();
+    nav.pruneDeadEnds();
+    const NavState before = capture(nav);
+
+    Navigator::Snapshot s = nav.snapshot();
+    for (int round = 0; round < 3; ++round) {
+        scramble(nav, rng, 60);
+        nav.restore(s);
+        assert_same(before, capture(nav));
+    }
+    nav.release(s);
+    assert_same(before, capture(nav));
+    // Rótulos de conectividade reconstruídos após o restore continuam corretos
+    TEST_ASSERT_EQUAL_INT(nav.planRoute() ? 1 : 0, nav.isGoalReachable() ? 1 : 0);
+}
+
+void test_nested_snapshots() {
+    const int W = 8, H = 8;
+    std::mt19937 rng(1984u);
+    Navigator nav;
+    nav.setMapDimensions(W,H);
+    nav.setStartGoal({0,0}, {W-1,H-1});
+    const NavState s0 = capture(nav);
+    Navigator::Snapshot outer = nav.snapshot();
+    scramble(nav, rng, 30);
+    const NavState s1 = capture(nav);
+    Navigator::Snapshot inner = nav.snapshot();
+    scramble(nav, rng, 30);
+    nav.restore(inner);
+    assert_same(s1, capture(nav));
+    nav.release(inner);
+    scramble(nav, rng, 30);
+    nav.restore(outer);
+    assert_same(s0, capture(nav));
+    nav.release(outer);
+}
+
+void test_rollout_keeps_state_and_reaches_goal() {
+    const int W = 12, H = 12;
+    long planned_steps = 0, rollout_steps = 0;
+    double rollout_us = 0.0;
+    int decisions = 0;
+    for (uint32_t seed = 0; seed < 4; ++seed) {
+        std::mt19937 rng(7000u + seed);
+        MazeMap m(W,H);
+        add_all_walls(m);
+        carve_maze_dfs(m, rng);
+        braid(m, rng, 20);
+        for (int mode = 0; mode < 2; ++mode) {
+            Navigator nav;
+            nav.setMapDimensions(W,H);
+            nav.setStartGoal({0,0}, {W-1,H-1});
+            Point agent{0,0};
+            uint8_t heading = 1;
+            int guard = W * H * 20, steps = 0;
+            nav.planRoute();
+            while (guard-- > 0 && !(agent.x == W-1 && agent.y == H-1)) {
+                const SensorRead sr = make_sensor_read(m, agent, heading);
+                nav.observeCellWalls(agent, sr, heading);
+                nav.planRoute();
+                Decision d;
+                if (mode == 0) {
+                    d = nav.decidePlanned(agent, heading, sr);
+                } else {
+                    const NavState before = capture(nav);
+                    auto t0 = std::chrono::steady_clock::now();
+                    d = nav.decideRollout(agent, heading, sr);
+                    auto t1 = std::chrono::steady_clock::now();
+                    rollout_us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+                    decisions++;
+                    assert_same(before, capture(nav));
+                }
+                apply_move(agent, heading, d.action);
+                if (d.action == Action::Forward) steps++;
+            }
+            TEST_ASSERT_TRUE_MESSAGE(agent.x == W-1 && agent.y == H-1, "Agent failed to reach goal");
+            (mode == 0 ? planned_steps : rollout_steps) += steps;
+        }
+    }
+    std::printf("passos: planned=%ld rollout=%ld; rollout %.1f us/decisao\n",
+                planned_steps, rollout_steps, decisions ? rollout_us / decisions : 0.0);
+}
+
+void test_rollout_commit_is_reset_and_goal_checked() {
+    SensorRead open{}; open.left_free = open.front_free = open.right_free = true;
+    auto fresh = [&](Point goal) {
+        auto n = std::make_unique<Navigator>();
+        n->setMapDimensions(3,3);
+        n->setStartGoal({1,1}, goal);
+        n->observeCellWalls({1,1}, open, 0);
+        return n;
+    };
+    // Rumo N em (1,1) com goal a leste: giro à direita, que fica comprometido
+    auto nav = fresh({2,1});
+    TEST_ASSERT_EQUAL_INT((int)Action::Right, (int)nav->decideRollout({1,1}, 0, open).action);
+    // Novo goal ao norte: o giro anterior não vale mais; decide como um navegador novo
+    nav->setStartGoal({1,1}, {1,0});
+    auto ref = fresh({1,0});
+    const Action expected = ref->decideRollout({1,1}, 1, open).action;
+    TEST_ASSERT_TRUE(expected != Action::Forward);
+    TEST_ASSERT_EQUAL_INT((int)expected, (int)nav->decideRollout({1,1}, 1, open).action);
+    // O compromisso é consumido pela decisão seguinte, usado ou não
+    auto once = fresh({2,1});
+    TEST_ASSERT_EQUAL_INT((int)Action::Right, (int)once->decideRollout({1,1}, 0, open).action);
+    once->decidePlanned({1,1}, 1, open);
+    TEST_ASSERT_EQUAL_INT((int)Action::Forward, (int)once->decideRollout({1,1}, 1, open).action);
+    once->setStartGoal({1,1}, {1,0});
+    TEST_ASSERT_EQUAL_INT((int)expected, (int)once->decideRollout({1,1}, 1, open).action);
+    // Goal fora do mapa: cai para decidePlanned sem tocar a grade de distâncias
+    auto far = fresh({7,7});
+    TEST_ASSERT_EQUAL_INT((int)far->decidePlanned({1,1}, 0, open).action, (int)far->decideRollout({1,1}, 0, open).action);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_restore_undoes_changes);
+    RUN_TEST(test_nested_snapshots);
+    RUN_TEST(test_rollout_keeps_state_and_reaches_goal);
+    RUN_TEST(test_rollout_commit_is_reset_and_goal_checked);
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+/**
+ * @file tests/test_path_code.cpp
+ * @brief Testes de `PathCode` (caminho compacto com movimentos de 2 bits).
+ *
+ * Valida conversão de/para `std::vector<Point>`, indexação de movimentos,
+ * visão run-length, forma textual (com limite de movimentos), bytes empacotados,
+ * persistência e o uso do plano compacto pelo `Navigator`.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R path_code`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "core/PathCode.hpp"
+#include "core/Navigator.hpp"
+#include "core/Planner.hpp"
+#include "core/PersistentMemory.hpp"
+#include <vector>
+#include <random>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+static std::vector<Point> random_walk(uint32_t seed, int n) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dir(0,3);
+    std::vector<Point> pts{{5,5}};
+    for (int i=0;i<n;++i) pts.push_back(PathCode::step(pts.back(), (uint8_t)dir(rng)));
+    return pts;
+}
+
+static void expect_same_points(const std::vector<Point>& a, const std::vector<Point>& b) {
+    TEST_ASSERT_EQUAL_INT((int)a.size(), (int)b.size());
+    for (size_t i=0;i<a.size();++i) {
+        TEST_ASSERT_EQUAL_INT(a[i].x, b[i].x);
+        TEST_ASSERT_EQUAL_INT(a[i].y, b[i].y);
+    }
+}
+
+void test_points_roundtrip_and_indexing() {
+    for (uint32_t seed=0; seed<10; ++seed) {
+        auto pts = random_walk(seed, 1 + (int)seed * 37);
+        auto pc = PathCode::fromPoints(pts);
+        TEST_ASSERT_TRUE(pc.has_value());
+        TEST_ASSERT_EQUAL_INT((int)pts.size(), (int)pc->size());
+        TEST_ASSERT_EQUAL_INT((int)(pts.size() + 2) / 4, (int)pc->bytes().size()); // 2 bits por movimento
+        expect_same_points(pts, pc->toPoints());
+        for (size_t i=0;i+1<pts.size();++i)
+            TEST_ASSERT_EQUAL_INT(PathCode::dirBetween(pts[i], pts[i+1]), pc->move(i));
+        TEST_ASSERT_EQUAL_INT(pts.back().x, pc->back().x);
+        TEST_ASSERT_EQUAL_INT(pts.back().y, pc->back().y);
+    }
+    // Células não vizinhas são rejeitadas
+    TEST_ASSERT_FALSE(PathCode::fromPoints({{0,0},{2,0}}).has_value());
+    TEST_ASSERT_TRUE(PathCode::fromPoints({}).value().empty());
+}
+
+void test_runs_and_text() {
+    // E E E S S W
+    auto pc = PathCode::fromPoints({{0,0},{1,0},{2,0},{3,0},{3,1},{3,2},{2,2}});
+    TEST_ASSERT_TRUE(pc.has_value());
+    std::vector<PathCode::Run> runs;
+    for (const auto& r : pc->runs()) runs.push_back(r);
+    TEST_ASSERT_EQUAL_INT(3, (int)runs.size());
+    TEST_ASSERT_EQUAL_INT(1, runs[0].dir); TEST_ASSERT_EQUAL_INT(3, (int)runs[0].count);
+    TEST_ASSERT_EQUAL_INT(2, runs[1].dir); TEST_ASSERT_EQUAL_INT(2, (int)runs[1].count);
+    TEST_ASSERT_EQUAL_INT(3, runs[2].dir); TEST_ASSERT_EQUAL_INT(1, (int)runs[2].count);
+    TEST_ASSERT_EQUAL_STRING("E3S2W", pc->toText().c_str());
+    auto back = PathCode::fromText({0,0}, "E3S2W");
+    TEST_ASSERT_TRUE(back.has_value());
+    TEST_ASSERT_TRUE(*back == *pc);
+    TEST_ASSERT_FALSE(PathCode::fromText({0,0}, "E3X").has_value());
+    // Contagens que estouram ou passam do limite são rejeitadas sem expandir
+    TEST_ASSERT_FALSE(PathCode::fromText({0,0}, "E4000000000").has_value());
+    TEST_ASSERT_FALSE(PathCode::fromText({0,0}, "E99999999999999999999999").has_value());
+    TEST_ASSERT_FALSE(PathCode::fromText({0,0}, "E65535S").has_value());
+    TEST_ASSERT_EQUAL_UINT32(65535u, (uint32_t)PathCode::fromText({0,0}, "E65535")->moves());
+    TEST_ASSERT_FALSE(PathCode::fromText({0,0}, "E3S2W", 5).has_value());
+    TEST_ASSERT_EQUAL_UINT32(6u, (uint32_t)PathCode::fromText({0,0}, "E3S2W", 6)->moves());
+    TEST_ASSERT_EQUAL_UINT32(1u, (uint32_t)PathCode::fromText({0,0}, "E0")->moves());
+    TEST_ASSERT_EQUAL_INT(5, pc->find({3,2}));
+    TEST_ASSERT_EQUAL_INT(-1, pc->find({9,9}));
+}
+
+void test_bytes_and_persistence_roundtrip() {
+    auto pts = random_walk(77u, 301);
+    PathCode pc = *PathCode::fromPoints(pts);
+    auto copy = PathCode::fromBytes(pc.start(), pc.moves(), pc.bytes().data(), pc.bytes().size());
+    TEST_ASSERT_TRUE(copy.has_value());
+    TEST_ASSERT_TRUE(*copy == pc);
+    TEST_ASSERT_FALSE(PathCode::fromBytes(pc.start(), pc.moves(), pc.bytes().data(), 3).has_value());
+
+    (void)PersistentMemory::eraseAll();
+    TEST_ASSERT_TRUE(PersistentMemory::savePath(pc));
+    PathCode loaded;
+    TEST_ASSERT_TRUE(PersistentMemory::loadPath(&loaded));
+    TEST_ASSERT_TRUE(loaded == pc);
+    TEST_ASSERT_FALSE(PersistentMemory::savePath(PathCode{}));
+}
+
+void test_navigator_follows_compact_plan() {
+    Navigator nav;
+    nav.setMapDimensions(4,4);
+    nav.setStartGoal({0,0}, {3,0});
+    TEST_ASSERT_TRUE(nav.planRoute());
+    TEST_ASSERT_EQUAL_INT(4, (int)nav.currentPlan().size());
+    SensorRead sr{}; sr.left_free = sr.front_free = sr.right_free = true;
+    // Todas as células vizinhas já visitadas igualmente: desempate pelo plano (leste)
+    // Heading S (2): leste é à esquerda
+    Decision d = nav.decidePlanned({1,0}, 2, sr);
+    TEST_ASSERT_EQUAL_INT((int)Action::Left, (int)d.action);
+    // Plano substituído explicitamente (ex.: carregado da flash)
+    // Não começa no start: vira só sugestão e o próximo planIfInvalid() replaneja
+    TEST_ASSERT_FALSE(nav.setPlan(*PathCode::fromText({1,0}, "S3")));
+    TEST_ASSERT_FALSE(nav.planValid());
+    d = nav.decidePlanned({1,0}, 2, sr);
+    TEST_ASSERT_EQUAL_INT((int)Action::Forward, (int)d.action);
+    // Do start ao goal por arestas abertas: válido
+    TEST_ASSERT_TRUE(nav.setPlan(*PathCode::fromText({0,0}, "SE3N")));
+    TEST_ASSERT_TRUE(nav.planValid());
+    // Termina fora do goal, sai do mapa ou atravessa parede: inválido
+    TEST_ASSERT_FALSE(nav.setPlan(*PathCode::fromText({0,0}, "E2")));
+    TEST_ASSERT_FALSE(nav.setPlan(*PathCode::fromText({0,0}, "NE3S")));
+    nav.map().set_wall(1,0,Dir::E,true);
+    TEST_ASSERT_FALSE(nav.setPlan(*PathCode::fromText({0,0}, "E3")));
+    TEST_ASSERT_TRUE(nav.planIfInvalid());
+    TEST_ASSERT_EQUAL_INT(5, (int)nav.currentPlan().moves());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_points_roundtrip_and_indexing);
+    RUN_TEST(test_runs_and_text);
+    RUN_TEST(test_bytes_and_persistence_roundtrip);
+    RUN_TEST(test_navigator_follows_compact_plan);
+    return UNITY_END();
+}
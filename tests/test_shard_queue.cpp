@@ -0,0 +1,145 @@
+/**
+ * @file tests/test_shard_queue.cpp
+ * @brief Testes da fila de shards em diretório compartilhado (`ShardQueue`).
+ *
+ * Verifica que só um de vários processos (simulados por threads com filas
+ * próprias) reivindica um shard, que trabalhadores concorrentes concluem cada
+ * shard exatamente uma vez, que o batimento renova a reivindicação pelo
+ * arquivo temporário do dono, que uma reivindicação sem batimento é tomada,
+ * que o dono antigo perde a posse sem tocar nem apagar a reivindicação do
+ * novo, que soltar libera o shard e que um manifesto diferente é recusado.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R shard_queue`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "ShardQueue.hpp"
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace maze;
+namespace fs = std::filesystem;
+
+static fs::path g_dir;
+static const char* kManifest = "maze_batch navigate v1\nunits=200\nshard_units=4\nkeys=0000abcd\n";
+
+void setUp() {
+    g_dir = fs::temp_directory_path() / "maze_shard_queue_test";
+    fs::remove_all(g_dir);
+}
+void tearDown() { fs::remove_all(g_dir); }
+
+static void test_single_winner_per_shard() {
+    const int kWorkers = 8;
+    std::atomic<int> acquired{0}, busy{0};
+    std::vector<std::thread> ts;
+    for (int w = 0; w < kWorkers; ++w) {
+        ts.emplace_back([&, w] {
+            ShardQueue q;
+            if (!q.open(g_dir, "w" + std::to_string(w), kManifest)) return;
+            const ShardQueue::Claim c = q.claim(0, 0);
+            if (c == ShardQueue::Claim::Acquired) acquired++;
+            else if (c == ShardQueue::Claim::Busy) busy++;
+        });
+    }
+    for (auto& t : ts) t.join();
+    TEST_ASSERT_EQUAL_INT(1, acquired.load());
+    TEST_ASSERT_EQUAL_INT(kWorkers - 1, busy.load());
+}
+
+static void test_concurrent_workers_complete_each_shard_once() {
+    const uint32_t kShards = 60;
+    std::vector<std::atomic<int>> runs(kShards);
+    for (auto& r : runs) r = 0;
+    std::vector<std::thread> ts;
+    for (int w = 0; w < 4; ++w) {
+        ts.emplace_back([&, w] {
+            ShardQueue q;
+            if (!q.open(g_dir, "w" + std::to_string(w), kManifest)) return;
+            for (uint32_t s = 0; s < kShards; ++s) {
+                if (q.claim(s, 0) != ShardQueue::Claim::Acquired) continue;
+                runs[s]++;
+                q.heartbeat(s);
+                q.complete(s);
+            }
+        });
+    }
+    for (auto& t : ts) t.join();
+    ShardQueue q;
+    TEST_ASSERT_TRUE(q.open(g_dir, "check", kManifest));
+    for (uint32_t s = 0; s < kShards; ++s) {
+        TEST_ASSERT_EQUAL_INT(1, runs[s].load());
+        TEST_ASSERT_TRUE(q.isDone(s));
+        TEST_ASSERT_TRUE(q.claim(s, 0) == ShardQueue::Claim::Done);
+    }
+}
+
+static void test_stale_claim_is_taken_over() {
+    ShardQueue a, b;
+    TEST_ASSERT_TRUE(a.open(g_dir, "a", kManifest));
+    TEST_ASSERT_TRUE(b.open(g_dir, "b", kManifest));
+    TEST_ASSERT_TRUE(a.claim(3, 60) == ShardQueue::Claim::Acquired);
+    TEST_ASSERT_TRUE(a.owns(3));
+    TEST_ASSERT_TRUE(b.claim(3, 60) == ShardQueue::Claim::Busy); // batimento recente
+    // O batimento toca o arquivo temporário de `a`, que é a própria reivindicação
+    const fs::path claim = g_dir / "claims" / "00003";
+    fs::last_write_time(claim, fs::file_time_type::clock::now() - std::chrono::hours(2));
+    TEST_ASSERT_TRUE(a.heartbeat(3));
+    TEST_ASSERT_TRUE(b.claim(3, 60) == ShardQueue::Claim::Busy);
+    // Último batimento de `a` há duas horas
+    fs::last_write_time(claim, fs::file_time_type::clock::now() - std::chrono::hours(2));
+    TEST_ASSERT_TRUE(b.claim(3, 0) == ShardQueue::Claim::Busy); // 0 = nunca tomar
+    TEST_ASSERT_TRUE(b.claim(3, 60) == ShardQueue::Claim::Acquired);
+    TEST_ASSERT_EQUAL_UINT32(1, static_cast<uint32_t>(b.stolen()));
+    TEST_ASSERT_FALSE(a.owns(3));
+    // O dono antigo não renova, conclui nem solta a reivindicação de `b`
+    const auto old_beat = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    fs::last_write_time(claim, old_beat);
+    TEST_ASSERT_FALSE(a.heartbeat(3));
+    TEST_ASSERT_TRUE(fs::last_write_time(claim) == old_beat);
+    TEST_ASSERT_FALSE(a.complete(3));
+    TEST_ASSERT_FALSE(a.isDone(3));
+    a.release(3);
+    TEST_ASSERT_TRUE(b.owns(3));
+    TEST_ASSERT_TRUE(b.heartbeat(3));
+    TEST_ASSERT_TRUE(b.complete(3));
+    TEST_ASSERT_TRUE(a.claim(3, 60) == ShardQueue::Claim::Done);
+}
+
+static void test_release_frees_shard_and_result_paths() {
+    ShardQueue a, b;
+    TEST_ASSERT_TRUE(a.open(g_dir, "a", kManifest));
+    TEST_ASSERT_TRUE(b.open(g_dir, "b", kManifest));
+    TEST_ASSERT_TRUE(a.claim(7, 60) == ShardQueue::Claim::Acquired);
+    b.release(7); // não é dono: nada muda
+    TEST_ASSERT_TRUE(a.owns(7));
+    a.release(7);
+    TEST_ASSERT_TRUE(b.claim(7, 60) == ShardQueue::Claim::Acquired);
+    TEST_ASSERT_EQUAL_STRING((g_dir / "results" / "shard-00007.ckpt").string().c_str(), b.resultPath(7).string().c_str());
+    { std::ofstream(b.resultPath(7)) << "x"; std::ofstream(b.resultPath(2)) << "x"; }
+    const auto files = a.resultFiles();
+    TEST_ASSERT_EQUAL_UINT32(2, static_cast<uint32_t>(files.size()));
+    TEST_ASSERT_EQUAL_STRING("shard-00002.ckpt", files[0].filename().string().c_str());
+}
+
+static void test_manifest_mismatch_is_rejected() {
+    ShardQueue a, b;
+    TEST_ASSERT_TRUE(a.open(g_dir, "a", kManifest));
+    std::string err;
+    TEST_ASSERT_FALSE(b.open(g_dir, "b", "maze_batch navigate v1\nunits=200\nshard_units=8\nkeys=0000abcd\n", &err));
+    TEST_ASSERT_TRUE(err.find("manifesto") != std::string::npos);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_winner_per_shard);
+    RUN_TEST(test_concurrent_workers_complete_each_shard_once);
+    RUN_TEST(test_stale_claim_is_taken_over);
+    RUN_TEST(test_release_frees_shard_and_result_paths);
+    RUN_TEST(test_manifest_mismatch_is_rejected);
+    return UNITY_END();
+}
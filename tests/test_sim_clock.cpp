@@ -0,0 +1,99 @@
+/**
+ * @file tests/test_sim_clock.cpp
+ * @brief Testes do relógio de passo fixo do simulador (`SimClock`).
+ *
+ * Verifica o número de passos por tempo de parede em 1x e 2x, o limite de
+ * acúmulo após um quadro lento, pausa e passo único, o nível ilimitado e que
+ * `simTime()` conta apenas passos executados (tempo do robô), não tempo de
+ * parede.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R sim_clock`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "SimClock.hpp"
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Executa todos os passos devidos e retorna quantos foram. */
+static int drain(SimClock& c) {
+    int n = 0;
+    while (n < 1000 && c.shouldStep()) ++n;
+    return n;
+}
+
+static void test_fixed_steps_at_1x_and_2x() {
+    SimClock c(0.25);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0, c.speed());
+    int steps = 0;
+    for (int i = 0; i < 60; ++i) { c.update(1.0 / 60.0); steps += drain(c); } // 1 s de parede
+    TEST_ASSERT_TRUE(steps >= 4 - 1 && steps <= 4 + 1);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, steps * 0.25, c.simTime());
+
+    c.reset();
+    c.faster();
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0, c.speed());
+    steps = 0;
+    for (int i = 0; i < 60; ++i) { c.update(1.0 / 60.0); steps += drain(c); }
+    TEST_ASSERT_TRUE(steps >= 8 - 1 && steps <= 8 + 1);
+}
+
+static void test_backlog_is_capped_after_slow_frame() {
+    SimClock c(0.25, 8);
+    c.update(10.0); // quadro de 10 s (ex.: janela arrastada)
+    TEST_ASSERT_EQUAL_INT(8, drain(c));
+    TEST_ASSERT_EQUAL_INT(0, drain(c));
+}
+
+static void test_pause_and_single_step() {
+    SimClock c(0.25);
+    c.setPaused(true);
+    c.update(1.0);
+    TEST_ASSERT_EQUAL_INT(0, drain(c));
+    c.requestStep();
+    TEST_ASSERT_EQUAL_INT(1, drain(c));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.25, c.simTime());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0, c.alpha());
+    c.setPaused(false);
+    c.update(0.125);
+    TEST_ASSERT_EQUAL_INT(0, drain(c));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5, c.alpha());
+}
+
+static void test_unlimited_and_speed_bounds() {
+    SimClock c;
+    for (int i = 0; i < 2 * SimClock::kSpeedCount; ++i) c.faster();
+    TEST_ASSERT_TRUE(c.unlimited());
+    TEST_ASSERT_EQUAL_INT(SimClock::kSpeedCount - 1, c.speedIndex());
+    for (int i = 0; i < 100; ++i) TEST_ASSERT_TRUE(c.shouldStep()); // chamador limita por quadro
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 25.0, c.simTime());
+    for (int i = 0; i < 2 * SimClock::kSpeedCount; ++i) c.slower();
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1, c.speed());
+    c.setSpeedIndex(SimClock::kNormalSpeed);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0, c.speed());
+}
+
+static void test_sim_time_independent_of_wall_time() {
+    // Mesmo número de passos => mesmo tempo simulado, em qualquer velocidade
+    SimClock slow(0.25), fast(0.25);
+    fast.setSpeedIndex(SimClock::kSpeedCount - 2); // 100x
+    int n_slow = 0, n_fast = 0;
+    while (n_slow < 20) { slow.update(0.05); n_slow += drain(slow); }
+    while (n_fast < 20) { fast.update(0.001); n_fast += drain(fast); }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, n_slow * 0.25, slow.simTime());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, n_fast * 0.25, fast.simTime());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_steps_at_1x_and_2x);
+    RUN_TEST(test_backlog_is_capped_after_slow_frame);
+    RUN_TEST(test_pause_and_single_step);
+    RUN_TEST(test_unlimited_and_speed_bounds);
+    RUN_TEST(test_sim_time_independent_of_wall_time);
+    return UNITY_END();
+}
@@ -0,0 +1,174 @@
+/**
+ * @file tests/test_telemetry_ring.cpp
+ * @brief Testes do anel de telemetria em memória compartilhada (`TelemetryWriter`, `TelemetryReader`).
+ *
+ * Verifica que o leitor recebe os registros em ordem e os episódios
+ * publicados, que um leitor atrasado perde só os mais antigos (e os conta),
+ * que o produtor segue sem leitor algum, que o leitor percebe quando o
+ * segmento é recriado e, com threads, que nenhum registro lido está pela
+ * metade enquanto o produtor escreve sem parar. Um segundo produtor não toma
+ * um segmento existente sem pedir a substituição.
+ *
+ * Como executar:
+ * - Via CTest: `ctest -R telemetry_ring`
+ * - Ou executando diretamente o binário deste teste.
+ */
+#include "unity.h"
+#include "TelemetryRing.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace maze;
+
+void setUp() {}
+void tearDown() {}
+
+/** @brief Nome exclusivo por processo (testes em paralelo não se cruzam). */
+static std::string ring_name(const char* tag) {
+    return std::string("/maze_tel_test_") + tag + "_" + std::to_string(static_cast<long>(::getpid()));
+}
+
+/** @brief Registro cujos campos derivam todos de `n` (detecta leitura pela metade). */
+static TelemetryRecord make_record(uint32_t n) {
+    TelemetryRecord r;
+    r.episode = n / 100;
+    r.step = n;
+    r.x = static_cast<int16_t>(n & 0x7FFF);
+    r.y = static_cast<int16_t>((n >> 3) & 0x7FFF);
+    r.heading = static_cast<uint8_t>(n & 3);
+    r.action = static_cast<uint8_t>((n >> 2) & 3);
+    r.plan_len = static_cast<uint16_t>(n * 7);
+    r.decide_us = n ^ 0xA5A5A5A5u;
+    r.t_us = ~n;
+    return r;
+}
+
+static bool consistent(const TelemetryRecord& r) {
+    const TelemetryRecord e = make_record(r.step);
+    return r.episode == e.episode && r.x == e.x && r.y == e.y && r.heading == e.heading && r.action == e.action &&
+           r.plan_len == e.plan_len && r.decide_us == e.decide_us && r.t_us == e.t_us;
+}
+
+static void test_records_and_episodes_round_trip() {
+    const std::string name = ring_name("rt");
+    TelemetryReader rd;
+    TEST_ASSERT_FALSE(rd.attach(name)); // ainda não existe
+    TelemetryWriter w;
+    TEST_ASSERT_TRUE(w.open(name, 64, 4));
+    TelemetryEpisode ep;
+    ep.agent = 2; ep.width = 16; ep.height = 12; ep.goal_x = 15; ep.goal_y = 11;
+    ep.setAgentName("mcts");
+    ep.setMaze("maze/exemplo.maze");
+    TEST_ASSERT_EQUAL_UINT32(0, w.beginEpisode(ep));
+    for (uint32_t n = 0; n < 10; ++n) w.push(make_record(n));
+
+    TEST_ASSERT_TRUE(rd.attach(name));
+    TEST_ASSERT_EQUAL_UINT32(1, static_cast<uint32_t>(rd.episodeCount()));
+    TelemetryEpisode got;
+    TEST_ASSERT_TRUE(rd.episode(0, got));
+    TEST_ASSERT_EQUAL_STRING("mcts", got.agent_name);
+    TEST_ASSERT_EQUAL_STRING("maze/exemplo.maze", got.maze);
+    TEST_ASSERT_EQUAL_INT(16, got.width);
+    TEST_ASSERT_FALSE(rd.episode(1, got));
+
+    uint32_t expect = 0;
+    bool ok = true;
+    TEST_ASSERT_EQUAL_UINT32(10, static_cast<uint32_t>(rd.poll([&](const TelemetryRecord& r) {
+        ok = ok && r.step == expect++ && consistent(r);
+    })));
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(rd.poll([](const TelemetryRecord&) {})));
+    w.push(make_record(10));
+    TEST_ASSERT_EQUAL_UINT32(1, static_cast<uint32_t>(rd.poll([&](const TelemetryRecord& r) { ok = ok && r.step == 10; })));
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(rd.lost()));
+
+    // A tabela de episódios é circular: o id 0 some depois de 4 novos
+    for (int i = 0; i < 4; ++i) w.beginEpisode(ep);
+    TEST_ASSERT_FALSE(rd.episode(0, got));
+    TEST_ASSERT_TRUE(rd.episode(4, got));
+    TEST_ASSERT_EQUAL_UINT32(4, got.id);
+    rd.detach();
+    w.close();
+    ::shm_unlink(name.c_str());
+}
+
+static void test_slow_reader_loses_only_oldest() {
+    const std::string name = ring_name("lag");
+    TelemetryWriter w;
+    TEST_ASSERT_TRUE(w.open(name, 100, 1)); // arredonda para 128
+    TelemetryReader rd;
+    TEST_ASSERT_TRUE(rd.attach(name));
+    for (uint32_t n = 0; n < 1000; ++n) w.push(make_record(n)); // sem leitor consumindo: nunca espera
+    TEST_ASSERT_EQUAL_UINT32(1000, static_cast<uint32_t>(w.published()));
+    uint32_t first = UINT32_MAX, last = 0, count = 0;
+    rd.poll([&](const TelemetryRecord& r) {
+        if (first == UINT32_MAX) first = r.step;
+        last = r.step;
+        count++;
+    });
+    TEST_ASSERT_EQUAL_UINT32(128, count);
+    TEST_ASSERT_EQUAL_UINT32(1000 - 128, first);
+    TEST_ASSERT_EQUAL_UINT32(999, last);
+    TEST_ASSERT_EQUAL_UINT32(1000 - 128, static_cast<uint32_t>(rd.lost()));
+
+    // Leitor que chega depois e só quer o que vier
+    TelemetryReader late;
+    TEST_ASSERT_TRUE(late.attach(name, false));
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(late.poll([](const TelemetryRecord&) {})));
+    w.push(make_record(1000));
+    TEST_ASSERT_EQUAL_UINT32(1, static_cast<uint32_t>(late.poll([](const TelemetryRecord&) {})));
+
+    // Produtor recriou o segmento: o leitor antigo percebe e reconecta
+    TEST_ASSERT_FALSE(rd.replaced());
+    TelemetryWriter w2;
+    TEST_ASSERT_FALSE(w2.open(name, 16, 1)); // já existe: não toma o anel de outro produtor
+    TEST_ASSERT_FALSE(rd.replaced());
+    TEST_ASSERT_TRUE(w2.open(name, 16, 1, true));
+    TEST_ASSERT_TRUE(rd.replaced());
+    TEST_ASSERT_TRUE(rd.attach(name));
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(rd.published()));
+    ::shm_unlink(name.c_str());
+}
+
+static void test_concurrent_reader_sees_whole_records() {
+    const std::string name = ring_name("mt");
+    TelemetryWriter w;
+    TEST_ASSERT_TRUE(w.open(name, 256, 1));
+    TelemetryReader rd;
+    TEST_ASSERT_TRUE(rd.attach(name));
+    const uint32_t kRecords = 200000;
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        for (uint32_t n = 0; n < kRecords; ++n) w.push(make_record(n));
+        done = true;
+    });
+    uint32_t torn = 0, backwards = 0, got = 0;
+    int64_t last = -1;
+    for (;;) {
+        const bool finished = done.load();
+        rd.poll([&](const TelemetryRecord& r) {
+            got++;
+            if (!consistent(r)) torn++;
+            if (static_cast<int64_t>(r.step) <= last) backwards++;
+            last = r.step;
+        });
+        if (finished && rd.published() == kRecords && rd.poll([](const TelemetryRecord&) {}) == 0) break;
+    }
+    producer.join();
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TEST_ASSERT_EQUAL_UINT32(kRecords, static_cast<uint32_t>(got + rd.lost()));
+    TEST_ASSERT_EQUAL_UINT32(kRecords - 1, static_cast<uint32_t>(last)); // o último sempre chega
+    ::shm_unlink(name.c_str());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_records_and_episodes_round_trip);
+    RUN_TEST(test_slow_reader_loses_only_oldest);
+    RUN_TEST(test_concurrent_reader_sees_whole_records);
+    return UNITY_END();
+}